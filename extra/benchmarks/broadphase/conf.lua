@@ -0,0 +1,7 @@
+function love.conf(t)
+  t.console = true
+  t.modules.audio = false
+  t.modules.graphics = false
+  t.modules.sound = false
+  t.modules.window = false
+end
@@ -0,0 +1,67 @@
+-- Compares the 'binary' and 'wide' World broad phase layouts.
+-- Run with: love extra/benchmarks/broadphase [bodycount]
+
+local function newworld(layout, count)
+  local world = love.physics.newWorld(0, 9.81*64, true)
+  world:setBroadPhaseLayout(layout)
+
+  local ground = love.physics.newBody(world, 0, 0, 'static')
+  love.physics.newChainShape(ground, false, -6000, -20000, -6000, 0, 6000, 0, 6000, -20000)
+
+  love.math.setRandomSeed(1)
+  for i = 1, count do
+    local x = love.math.random(-5900, 5900)
+    local y = -love.math.random(32, 10000)
+    local body = love.physics.newBody(world, x, y, 'dynamic')
+    love.physics.newCircleShape(body, 16)
+  end
+
+  return world
+end
+
+local function run(layout, count)
+  local world = newworld(layout, count)
+  local time = love.timer.getTime
+
+  local start = time()
+  for i = 1, 300 do
+    world:update(1/60)
+  end
+  local steptime = time() - start
+
+  love.math.setRandomSeed(2)
+  local found = 0
+  start = time()
+  for i = 1, 20000 do
+    local x = love.math.random(-5900, 5900)
+    local y = -love.math.random(0, 10000)
+    world:queryShapesInArea(x - 100, y - 100, x + 100, y + 100, function()
+      found = found + 1
+      return true
+    end)
+  end
+  local querytime = time() - start
+
+  local hits = 0
+  start = time()
+  for i = 1, 20000 do
+    local x1 = love.math.random(-5900, 5900)
+    local x2 = love.math.random(-5900, 5900)
+    if world:rayCastClosest(x1, -10000, x2, 0) then
+      hits = hits + 1
+    end
+  end
+  local raytime = time() - start
+
+  print(string.format("%-6s %6d bodies: 300 updates %8.1f ms, 20000 queries %7.1f ms (%d shapes), 20000 ray casts %7.1f ms (%d hits)",
+    layout, count, steptime * 1000, querytime * 1000, found, raytime * 1000, hits))
+
+  world:destroy()
+end
+
+function love.load(args)
+  local count = tonumber(args[1]) or 4000
+  run('binary', count)
+  run('wide', count)
+  love.event.quit()
+end
@@ -20,6 +20,7 @@
 
 // LOVE
 #include "Data.h"
+#include "Exception.h"
 #include "thread/threads.h"
 
 namespace love
@@ -37,6 +38,11 @@ static void createMutex(love::thread::Mutex **mutexAddress)
 	*mutexAddress = love::thread::newMutex();
 }
 
+Data *Data::transfer()
+{
+	throw love::Exception("This Data type does not support transferring its memory.");
+}
+
 love::thread::Mutex *Data::getMutex()
 {
 	std::call_once(mutexCreated, createMutex, &mutex);
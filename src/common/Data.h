@@ -63,12 +63,28 @@ class Data : public Object
 	 **/
 	virtual size_t getSize() const = 0;
 
+	/**
+	 * Creates a new Data object which takes ownership of this Data's memory
+	 * without copying it. This Data is left empty and can't be used anymore.
+	 * Throws an exception if the Data type doesn't support transfers.
+	 **/
+	virtual Data *transfer();
+
+	/**
+	 * Gets whether this Data's memory has been moved to another Data object.
+	 **/
+	bool isTransferred() const { return transferred; }
+
 	/**
 	 * Gets the Mutex associated with this Data object. Creates it in a thread-
 	 * safe manner if necessary.
 	 **/
 	love::thread::Mutex *getMutex();
 
+protected:
+
+	bool transferred = false;
+
 private:
 
 	love::thread::Mutex *mutex = nullptr;
@@ -48,6 +48,7 @@ class Module : public Object
 		M_IMAGE,
 		M_JOYSTICK,
 		M_KEYBOARD,
+		M_LOADER,
 		M_MATH,
 		M_MOUSE,
 		M_PHYSICS,
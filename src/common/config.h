@@ -157,6 +157,7 @@
 #	define LOVE_ENABLE_IMAGE
 #	define LOVE_ENABLE_JOYSTICK
 #	define LOVE_ENABLE_KEYBOARD
+#	define LOVE_ENABLE_LOADER
 #	define LOVE_ENABLE_MATH
 #	define LOVE_ENABLE_MOUSE
 #	define LOVE_ENABLE_PHYSICS
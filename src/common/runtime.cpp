@@ -25,6 +25,7 @@
 #include "Module.h"
 #include "Object.h"
 #include "Reference.h"
+#include "Data.h"
 #include "StringMap.h"
 
 // C++
@@ -1110,6 +1111,12 @@ extern "C" int luax_typerror(lua_State *L, int narg, const char *tname)
 	return luaL_argerror(L, narg, msg);
 }
 
+void luax_checktransferred(lua_State *L, const Proxy *p)
+{
+	if (p->type->isa(Data::type) && static_cast<Data *>(p->object)->isTransferred())
+		luaL_error(L, "Attempt to use a %s after its memory was transferred.", p->type->getName());
+}
+
 int luax_enumerror(lua_State *L, const char *enumName, const char *value)
 {
 	return luaL_error(L, "Invalid %s: %s", enumName, value);
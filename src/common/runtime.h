@@ -489,6 +489,12 @@ extern "C" { // Also called from luasocket
 	int luax_typerror(lua_State *L, int narg, const char *tname);
 }
 
+/**
+ * Raises a Lua error if the object is a Data whose memory has been moved to
+ * another Data with transfer().
+ **/
+void luax_checktransferred(lua_State *L, const Proxy *p);
+
 int luax_enumerror(lua_State *L, const char *enumName, const char *value);
 int luax_enumerror(lua_State *L, const char *enumName, const std::vector<std::string> &values, const char *value);
 
@@ -553,6 +559,8 @@ T *luax_checktype(lua_State *L, int idx, const love::Type &type)
 	if (u->object == nullptr)
 		luaL_error(L, "Cannot use object after it has been released.");
 
+	luax_checktransferred(L, u);
+
 	return (T *)u->object;
 }
 
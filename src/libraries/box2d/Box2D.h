@@ -36,6 +36,7 @@
 
 #include "b2_broad_phase.h"
 #include "b2_dynamic_tree.h"
+#include "b2_wide_tree.h" // LOVE
 
 #include "b2_body.h"
 #include "b2_contact.h"
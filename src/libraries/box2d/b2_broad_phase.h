@@ -27,6 +27,7 @@
 #include "b2_settings.h"
 #include "b2_collision.h"
 #include "b2_dynamic_tree.h"
+#include "b2_wide_tree.h"
 
 struct B2_API b2Pair
 {
@@ -34,6 +35,17 @@ struct B2_API b2Pair
 	int32 proxyIdB;
 };
 
+/* LOVE: Added b2BroadPhaseLayout. */
+/// The tree layout used for broad-phase queries. The wide layout keeps a
+/// b2WideTree copy of the dynamic tree, which is rebuilt when the dynamic tree
+/// has changed. Both find the same proxies, but may report them in a
+/// different order.
+enum b2BroadPhaseLayout
+{
+	b2_binaryTreeLayout = 0,
+	b2_wideTreeLayout
+};
+
 /// The broad-phase is used for computing pairs and performing volume queries and ray casts.
 /// This broad-phase does not persist pairs. Instead, this reports potentially new pairs.
 /// It is up to the client to consume the new pairs and to track subsequent overlap.
@@ -94,6 +106,17 @@ class B2_API b2BroadPhase
 	template <typename T>
 	void RayCast(T* callback, const b2RayCastInput& input) const;
 
+	/// Set the tree layout used for queries.
+	void SetLayout(b2BroadPhaseLayout layout);
+
+	/// Get the tree layout used for queries.
+	b2BroadPhaseLayout GetLayout() const;
+
+	/// Rebuild the wide tree if the dynamic tree has changed since. Queries do
+	/// this as needed, so it only has to be called before querying from
+	/// several threads at once.
+	void UpdateWideTree() const;
+
 	/// Get the height of the embedded tree.
 	int32 GetTreeHeight() const;
 
@@ -111,6 +134,7 @@ class B2_API b2BroadPhase
 private:
 
 	friend class b2DynamicTree;
+	friend class b2WideTree; // LOVE
 
 	void BufferMove(int32 proxyId);
 	void UnBufferMove(int32 proxyId);
@@ -119,6 +143,12 @@ class B2_API b2BroadPhase
 
 	b2DynamicTree m_tree;
 
+	b2BroadPhaseLayout m_layout;
+
+	// Built lazily by queries.
+	mutable b2WideTree m_wideTree;
+	mutable bool m_wideTreeValid;
+
 	int32 m_proxyCount;
 
 	int32* m_moveBuffer;
@@ -154,6 +184,11 @@ inline int32 b2BroadPhase::GetProxyCount() const
 	return m_proxyCount;
 }
 
+inline b2BroadPhaseLayout b2BroadPhase::GetLayout() const
+{
+	return m_layout;
+}
+
 inline int32 b2BroadPhase::GetTreeHeight() const
 {
 	return m_tree.GetHeight();
@@ -175,6 +210,14 @@ void b2BroadPhase::UpdatePairs(T* callback)
 	// Reset pair buffer
 	m_pairCount = 0;
 
+	// Rebuilding the wide tree is linear in the number of proxies, so it only
+	// pays off when a good share of them is queried.
+	bool wide = m_layout == b2_wideTreeLayout && (m_wideTreeValid || m_moveCount >= m_proxyCount / b2_wideTreeMinMoveRatio);
+	if (wide)
+	{
+		UpdateWideTree();
+	}
+
 	// Perform tree queries for all moving proxies.
 	for (int32 i = 0; i < m_moveCount; ++i)
 	{
@@ -189,7 +232,14 @@ void b2BroadPhase::UpdatePairs(T* callback)
 		const b2AABB& fatAABB = m_tree.GetFatAABB(m_queryProxyId);
 
 		// Query tree, create pairs and add them pair buffer.
-		m_tree.Query(this, fatAABB);
+		if (wide)
+		{
+			m_wideTree.Query(this, fatAABB);
+		}
+		else
+		{
+			m_tree.Query(this, fatAABB);
+		}
 	}
 
 	// Send pairs to caller
@@ -221,18 +271,35 @@ void b2BroadPhase::UpdatePairs(T* callback)
 template <typename T>
 inline void b2BroadPhase::Query(T* callback, const b2AABB& aabb) const
 {
-	m_tree.Query(callback, aabb);
+	if (m_layout == b2_wideTreeLayout)
+	{
+		UpdateWideTree();
+		m_wideTree.Query(callback, aabb);
+	}
+	else
+	{
+		m_tree.Query(callback, aabb);
+	}
 }
 
 template <typename T>
 inline void b2BroadPhase::RayCast(T* callback, const b2RayCastInput& input) const
 {
-	m_tree.RayCast(callback, input);
+	if (m_layout == b2_wideTreeLayout)
+	{
+		UpdateWideTree();
+		m_wideTree.RayCast(callback, input);
+	}
+	else
+	{
+		m_tree.RayCast(callback, input);
+	}
 }
 
 inline void b2BroadPhase::ShiftOrigin(const b2Vec2& newOrigin)
 {
 	m_tree.ShiftOrigin(newOrigin);
+	m_wideTreeValid = false;
 }
 
 #endif
@@ -210,6 +210,12 @@ class B2_API b2Contact
 
 	void Update(b2ContactListener* listener);
 
+	/* LOVE: Update is split in two, so the narrow phase of different contacts
+	   can run in parallel. UpdateManifold only writes to its arguments and is
+	   thread safe. ApplyUpdate stores the result and calls the listener. */
+	void UpdateManifold(b2Manifold* manifold, bool* touching);
+	void ApplyUpdate(b2ContactListener* listener, const b2Manifold& manifold, bool touching);
+
 	static b2ContactRegister s_registers[b2Shape::e_typeCount][b2Shape::e_typeCount];
 	static bool s_initialized;
 
@@ -234,6 +240,10 @@ class B2_API b2Contact
 	int32 m_toiCount;
 	float m_toi;
 
+	// LOVE: Index of the manifold computed ahead by a parallel
+	// b2ContactManager::Collide, or -1.
+	int32 m_collideIndex;
+
 	float m_friction;
 	float m_restitution;
 	float m_restitutionThreshold;
@@ -30,6 +30,8 @@ class b2Contact;
 class b2ContactFilter;
 class b2ContactListener;
 class b2BlockAllocator;
+class b2ArenaAllocator;
+class b2TaskExecutor;
 
 // Delegate of b2World.
 class B2_API b2ContactManager
@@ -52,6 +54,22 @@ class B2_API b2ContactManager
 	b2ContactFilter* m_contactFilter;
 	b2ContactListener* m_contactListener;
 	b2BlockAllocator* m_allocator;
+
+	// LOVE: Used to run the narrow phase in parallel, if set.
+	b2TaskExecutor* m_taskExecutor;
+	b2ArenaAllocator* m_arena;
+
+private:
+
+	struct b2CollideResults
+	{
+		b2Contact** contacts;
+		b2Manifold* manifolds;
+		bool* touching;
+	};
+
+	bool UpdateManifoldsParallel(b2CollideResults* results);
+	static void UpdateManifolds(int32 begin, int32 end, void* context);
 };
 
 #endif
@@ -135,6 +135,9 @@ class B2_API b2DynamicTree
 
 private:
 
+	/* LOVE: The wide tree is built straight from the nodes. */
+	friend class b2WideTree;
+
 	int32 AllocateNode();
 	void FreeNode(int32 node);
 
@@ -62,4 +62,25 @@ class B2_API b2StackAllocator
 	int32 m_entryCount;
 };
 
+/* LOVE: Added b2ArenaAllocator. */
+
+struct b2ArenaBlock;
+
+// This is an arena allocator used for per step allocations that don't nest,
+// such as the islands solved in parallel. Allocations are released all at
+// once by Reset, which keeps the memory for the next step.
+class B2_API b2ArenaAllocator
+{
+public:
+	b2ArenaAllocator();
+	~b2ArenaAllocator();
+
+	void* Allocate(int32 size);
+	void Reset();
+
+private:
+
+	b2ArenaBlock* m_blocks;
+};
+
 #endif
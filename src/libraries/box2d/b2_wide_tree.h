@@ -0,0 +1,291 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/* LOVE: Added b2WideTree. */
+
+#ifndef B2_WIDE_TREE_H
+#define B2_WIDE_TREE_H
+
+#include "b2_api.h"
+#include "b2_collision.h"
+#include "b2_dynamic_tree.h"
+#include "b2_growable_stack.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define B2_WIDE_TREE_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define B2_WIDE_TREE_NEON
+#endif
+
+#define b2_wideTreeWidth 4
+
+/// The broad-phase only rebuilds a changed wide tree to find new pairs when at
+/// least one in this many proxies has moved.
+#define b2_wideTreeMinMoveRatio 16
+
+/// A node in the wide tree. The bounds of the children are stored as separate
+/// arrays so one query can be tested against all of them at once.
+struct B2_API b2WideNode
+{
+	float lowerX[b2_wideTreeWidth];
+	float lowerY[b2_wideTreeWidth];
+	float upperX[b2_wideTreeWidth];
+	float upperY[b2_wideTreeWidth];
+
+	/// A child is a wide node index if it's >= 0, or a proxy id encoded with
+	/// b2WideTree::EncodeLeaf. Unused children are b2_nullNode.
+	int32 children[b2_wideTreeWidth];
+
+	/// Children are packed at the front.
+	int32 childCount;
+};
+
+/// A read-only, 4-ary copy of a b2DynamicTree. Each wide node replaces up to
+/// three levels of the binary tree, so traversals visit fewer nodes, and the
+/// children of a node sit next to each other in memory.
+/// Proxy ids are the same as in the dynamic tree it was built from.
+class B2_API b2WideTree
+{
+public:
+	b2WideTree();
+	~b2WideTree();
+
+	/// Rebuild from the current state of a dynamic tree. This is linear in the
+	/// number of nodes, and has to be done again after the dynamic tree changes.
+	void Build(const b2DynamicTree& tree);
+
+	/// Query an AABB for overlapping proxies. The callback class
+	/// is called for each proxy that overlaps the supplied AABB.
+	template <typename T>
+	void Query(T* callback, const b2AABB& aabb) const;
+
+	/// Ray-cast against the proxies in the tree. Same as b2DynamicTree::RayCast.
+	template <typename T>
+	void RayCast(T* callback, const b2RayCastInput& input) const;
+
+	/// Get the number of wide nodes.
+	int32 GetNodeCount() const;
+
+	static int32 EncodeLeaf(int32 proxyId);
+	static int32 DecodeLeaf(int32 child);
+
+private:
+
+	int32 AllocateNode();
+
+	int32 m_root;
+
+	b2WideNode* m_nodes;
+	int32 m_nodeCount;
+	int32 m_nodeCapacity;
+};
+
+/// Get a bit mask of the children of a wide node that overlap an AABB.
+inline int32 b2TestOverlap(const b2WideNode* node, const b2AABB& aabb)
+{
+	int32 valid = (1 << node->childCount) - 1;
+
+	// Same test as b2TestOverlap(const b2AABB&, const b2AABB&), done on all
+	// children at once.
+#if defined(B2_WIDE_TREE_SSE2)
+	__m128 lx = _mm_loadu_ps(node->lowerX);
+	__m128 ly = _mm_loadu_ps(node->lowerY);
+	__m128 ux = _mm_loadu_ps(node->upperX);
+	__m128 uy = _mm_loadu_ps(node->upperY);
+
+	__m128 sx = _mm_or_ps(_mm_cmpgt_ps(lx, _mm_set1_ps(aabb.upperBound.x)), _mm_cmplt_ps(ux, _mm_set1_ps(aabb.lowerBound.x)));
+	__m128 sy = _mm_or_ps(_mm_cmpgt_ps(ly, _mm_set1_ps(aabb.upperBound.y)), _mm_cmplt_ps(uy, _mm_set1_ps(aabb.lowerBound.y)));
+
+	return ~_mm_movemask_ps(_mm_or_ps(sx, sy)) & valid;
+#elif defined(B2_WIDE_TREE_NEON)
+	float32x4_t lx = vld1q_f32(node->lowerX);
+	float32x4_t ly = vld1q_f32(node->lowerY);
+	float32x4_t ux = vld1q_f32(node->upperX);
+	float32x4_t uy = vld1q_f32(node->upperY);
+
+	uint32x4_t sx = vorrq_u32(vcgtq_f32(lx, vdupq_n_f32(aabb.upperBound.x)), vcltq_f32(ux, vdupq_n_f32(aabb.lowerBound.x)));
+	uint32x4_t sy = vorrq_u32(vcgtq_f32(ly, vdupq_n_f32(aabb.upperBound.y)), vcltq_f32(uy, vdupq_n_f32(aabb.lowerBound.y)));
+
+	static const uint32 bits[b2_wideTreeWidth] = {1, 2, 4, 8};
+	uint32x4_t separated = vandq_u32(vorrq_u32(sx, sy), vld1q_u32(bits));
+
+	return ~(int32)vaddvq_u32(separated) & valid;
+#else
+	int32 mask = 0;
+	for (int32 i = 0; i < b2_wideTreeWidth; ++i)
+	{
+		bool separated = node->lowerX[i] > aabb.upperBound.x || node->upperX[i] < aabb.lowerBound.x
+			|| node->lowerY[i] > aabb.upperBound.y || node->upperY[i] < aabb.lowerBound.y;
+		mask |= (separated ? 0 : 1) << i;
+	}
+	return mask & valid;
+#endif
+}
+
+inline int32 b2WideTree::GetNodeCount() const
+{
+	return m_nodeCount;
+}
+
+inline int32 b2WideTree::EncodeLeaf(int32 proxyId)
+{
+	return -proxyId - 2;
+}
+
+inline int32 b2WideTree::DecodeLeaf(int32 child)
+{
+	return -child - 2;
+}
+
+template <typename T>
+inline void b2WideTree::Query(T* callback, const b2AABB& aabb) const
+{
+	if (m_root == b2_nullNode)
+	{
+		return;
+	}
+
+	b2GrowableStack<int32, 256> stack;
+	stack.Push(m_root);
+
+	while (stack.GetCount() > 0)
+	{
+		const b2WideNode* node = m_nodes + stack.Pop();
+
+		int32 mask = b2TestOverlap(node, aabb);
+		for (int32 i = 0; mask != 0; ++i, mask >>= 1)
+		{
+			if ((mask & 1) == 0)
+			{
+				continue;
+			}
+
+			int32 child = node->children[i];
+			if (child >= 0)
+			{
+				stack.Push(child);
+			}
+			else
+			{
+				bool proceed = callback->QueryCallback(DecodeLeaf(child));
+				if (proceed == false)
+				{
+					return;
+				}
+			}
+		}
+	}
+}
+
+template <typename T>
+inline void b2WideTree::RayCast(T* callback, const b2RayCastInput& input) const
+{
+	if (m_root == b2_nullNode)
+	{
+		return;
+	}
+
+	b2Vec2 p1 = input.p1;
+	b2Vec2 p2 = input.p2;
+	b2Vec2 r = p2 - p1;
+	b2Assert(r.LengthSquared() > 0.0f);
+	r.Normalize();
+
+	// v is perpendicular to the segment.
+	b2Vec2 v = b2Cross(1.0f, r);
+	b2Vec2 abs_v = b2Abs(v);
+
+	float maxFraction = input.maxFraction;
+
+	// Build a bounding box for the segment.
+	b2AABB segmentAABB;
+	{
+		b2Vec2 t = p1 + maxFraction * (p2 - p1);
+		segmentAABB.lowerBound = b2Min(p1, t);
+		segmentAABB.upperBound = b2Max(p1, t);
+	}
+
+	b2GrowableStack<int32, 256> stack;
+	stack.Push(m_root);
+
+	while (stack.GetCount() > 0)
+	{
+		const b2WideNode* node = m_nodes + stack.Pop();
+
+		int32 mask = b2TestOverlap(node, segmentAABB);
+		for (int32 i = 0; mask != 0; ++i, mask >>= 1)
+		{
+			if ((mask & 1) == 0)
+			{
+				continue;
+			}
+
+			// Separating axis for segment (Gino, p80).
+			// |dot(v, p1 - c)| > dot(|v|, h)
+			b2Vec2 lower(node->lowerX[i], node->lowerY[i]);
+			b2Vec2 upper(node->upperX[i], node->upperY[i]);
+			b2Vec2 c = 0.5f * (lower + upper);
+			b2Vec2 h = 0.5f * (upper - lower);
+			float separation = b2Abs(b2Dot(v, p1 - c)) - b2Dot(abs_v, h);
+			if (separation > 0.0f)
+			{
+				continue;
+			}
+
+			int32 child = node->children[i];
+			if (child >= 0)
+			{
+				stack.Push(child);
+				continue;
+			}
+
+			b2RayCastInput subInput;
+			subInput.p1 = input.p1;
+			subInput.p2 = input.p2;
+			subInput.maxFraction = maxFraction;
+
+			float value = callback->RayCastCallback(subInput, DecodeLeaf(child));
+
+			if (value == 0.0f)
+			{
+				// The client has terminated the ray cast.
+				return;
+			}
+
+			if (value > 0.0f)
+			{
+				// Update segment bounding box. Later children of this node
+				// are still tested against the old one, the callback clips
+				// them.
+				maxFraction = value;
+				b2Vec2 t = p1 + maxFraction * (p2 - p1);
+				segmentAABB.lowerBound = b2Min(p1, t);
+				segmentAABB.upperBound = b2Max(p1, t);
+			}
+		}
+	}
+}
+
+#endif
@@ -66,6 +66,15 @@ class B2_API b2World
 	/// remain in scope.
 	void SetContactListener(b2ContactListener* listener);
 
+	/// LOVE: Register a task executor used to solve islands and update
+	/// contacts in parallel. Listeners are still called on the stepping
+	/// thread, but all islands are solved before PostSolve is reported for
+	/// any of them, so bodies changed in PostSolve don't affect islands
+	/// solved later in the same step as they do without an executor. The
+	/// executor is owned by you and must remain in scope.
+	void SetTaskExecutor(b2TaskExecutor* executor);
+	b2TaskExecutor* GetTaskExecutor() const { return m_taskExecutor; }
+
 	/// Register a routine for debug drawing. The debug draw functions are called
 	/// inside with b2World::DebugDraw method. The debug draw object is owned
 	/// by you and must remain in scope.
@@ -174,6 +183,10 @@ class B2_API b2World
 	/// Get the number of contacts (each may have 0 or more contact points).
 	int32 GetContactCount() const;
 
+	/// LOVE: Set the tree layout used by the broad-phase and world queries.
+	void SetBroadPhaseLayout(b2BroadPhaseLayout layout);
+	b2BroadPhaseLayout GetBroadPhaseLayout() const;
+
 	/// Get the height of the dynamic tree.
 	int32 GetTreeHeight() const;
 
@@ -223,14 +236,18 @@ class B2_API b2World
 
 	void Solve(const b2TimeStep& step);
 	void SolveTOI(const b2TimeStep& step);
+	static void SolveIslands(int32 begin, int32 end, void* context);
 
 	void DrawShape(b2Fixture* shape, const b2Transform& xf, const b2Color& color);
 
 	b2BlockAllocator m_blockAllocator;
 	b2StackAllocator m_stackAllocator;
+	b2ArenaAllocator m_arena;
 
 	b2ContactManager m_contactManager;
 
+	b2TaskExecutor* m_taskExecutor;
+
 	b2Body* m_bodyList;
 	b2Joint* m_jointList;
 
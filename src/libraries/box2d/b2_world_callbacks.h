@@ -158,4 +158,25 @@ class B2_API b2RayCastCallback
 									const b2Vec2& normal, float fraction) = 0;
 };
 
+/* LOVE: Added b2TaskExecutor. */
+
+/// A task run by b2TaskExecutor::ParallelFor on the items [begin, end).
+typedef void b2ParallelTask(int32 begin, int32 end, void* context);
+
+/// Runs parts of the world step on several threads.
+/// See b2World::SetTaskExecutor
+class B2_API b2TaskExecutor
+{
+public:
+	virtual ~b2TaskExecutor() {}
+
+	/// The number of threads tasks can run on, including the calling thread.
+	virtual int32 GetWorkerCount() const = 0;
+
+	/// Call task on ranges covering [0, count), possibly in parallel, and
+	/// return once all of them have finished. Ranges should hold at least
+	/// minRange items, apart from the last one.
+	virtual void ParallelFor(int32 count, int32 minRange, b2ParallelTask* task, void* context) = 0;
+};
+
 #endif
@@ -27,6 +27,9 @@ b2BroadPhase::b2BroadPhase()
 {
 	m_proxyCount = 0;
 
+	m_layout = b2_binaryTreeLayout;
+	m_wideTreeValid = false;
+
 	m_pairCapacity = 16;
 	m_pairCount = 0;
 	m_pairBuffer = (b2Pair*)b2Alloc(m_pairCapacity * sizeof(b2Pair));
@@ -46,6 +49,7 @@ int32 b2BroadPhase::CreateProxy(const b2AABB& aabb, void* userData)
 {
 	int32 proxyId = m_tree.CreateProxy(aabb, userData);
 	++m_proxyCount;
+	m_wideTreeValid = false;
 	BufferMove(proxyId);
 	return proxyId;
 }
@@ -55,6 +59,7 @@ void b2BroadPhase::DestroyProxy(int32 proxyId)
 	UnBufferMove(proxyId);
 	--m_proxyCount;
 	m_tree.DestroyProxy(proxyId);
+	m_wideTreeValid = false;
 }
 
 void b2BroadPhase::MoveProxy(int32 proxyId, const b2AABB& aabb, const b2Vec2& displacement)
@@ -63,6 +68,7 @@ void b2BroadPhase::MoveProxy(int32 proxyId, const b2AABB& aabb, const b2Vec2& di
 	if (buffer)
 	{
 		BufferMove(proxyId);
+		m_wideTreeValid = false;
 	}
 }
 
@@ -71,6 +77,20 @@ void b2BroadPhase::TouchProxy(int32 proxyId)
 	BufferMove(proxyId);
 }
 
+void b2BroadPhase::SetLayout(b2BroadPhaseLayout layout)
+{
+	m_layout = layout;
+}
+
+void b2BroadPhase::UpdateWideTree() const
+{
+	if (m_wideTreeValid == false)
+	{
+		m_wideTree.Build(m_tree);
+		m_wideTreeValid = true;
+	}
+}
+
 void b2BroadPhase::BufferMove(int32 proxyId)
 {
 	if (m_moveCount == m_moveCapacity)
@@ -0,0 +1,165 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/* LOVE: Added b2WideTree. */
+
+#include "box2d/b2_wide_tree.h"
+#include <string.h>
+
+struct b2WideBuildEntry
+{
+	int32 treeNode;
+	int32 wideNode;
+};
+
+b2WideTree::b2WideTree()
+{
+	m_root = b2_nullNode;
+
+	m_nodeCapacity = 16;
+	m_nodeCount = 0;
+	m_nodes = (b2WideNode*)b2Alloc(m_nodeCapacity * sizeof(b2WideNode));
+}
+
+b2WideTree::~b2WideTree()
+{
+	b2Free(m_nodes);
+}
+
+int32 b2WideTree::AllocateNode()
+{
+	if (m_nodeCount == m_nodeCapacity)
+	{
+		b2WideNode* oldNodes = m_nodes;
+		m_nodeCapacity *= 2;
+		m_nodes = (b2WideNode*)b2Alloc(m_nodeCapacity * sizeof(b2WideNode));
+		memcpy(m_nodes, oldNodes, m_nodeCount * sizeof(b2WideNode));
+		b2Free(oldNodes);
+	}
+
+	return m_nodeCount++;
+}
+
+void b2WideTree::Build(const b2DynamicTree& tree)
+{
+	m_root = b2_nullNode;
+	m_nodeCount = 0;
+
+	if (tree.m_root == b2_nullNode)
+	{
+		return;
+	}
+
+	const b2TreeNode* treeNodes = tree.m_nodes;
+
+	b2GrowableStack<b2WideBuildEntry, 256> stack;
+
+	m_root = AllocateNode();
+	stack.Push({tree.m_root, m_root});
+
+	while (stack.GetCount() > 0)
+	{
+		b2WideBuildEntry entry = stack.Pop();
+		const b2TreeNode* treeNode = treeNodes + entry.treeNode;
+
+		int32 lanes[b2_wideTreeWidth];
+		int32 count = 0;
+
+		if (treeNode->IsLeaf())
+		{
+			// Only happens for a root that's a leaf.
+			lanes[count++] = entry.treeNode;
+		}
+		else
+		{
+			lanes[count++] = treeNode->child1;
+			lanes[count++] = treeNode->child2;
+
+			// Pull up the children of the largest internal nodes until the
+			// wide node is full.
+			while (count < b2_wideTreeWidth)
+			{
+				int32 best = -1;
+				float bestPerimeter = -1.0f;
+				for (int32 i = 0; i < count; ++i)
+				{
+					const b2TreeNode* lane = treeNodes + lanes[i];
+					if (lane->IsLeaf() == false && lane->aabb.GetPerimeter() > bestPerimeter)
+					{
+						best = i;
+						bestPerimeter = lane->aabb.GetPerimeter();
+					}
+				}
+
+				if (best == -1)
+				{
+					break;
+				}
+
+				const b2TreeNode* opened = treeNodes + lanes[best];
+				lanes[best] = opened->child1;
+				lanes[count++] = opened->child2;
+			}
+		}
+
+		int32 children[b2_wideTreeWidth];
+		for (int32 i = 0; i < count; ++i)
+		{
+			if (treeNodes[lanes[i]].IsLeaf())
+			{
+				children[i] = EncodeLeaf(lanes[i]);
+			}
+			else
+			{
+				children[i] = AllocateNode();
+				stack.Push({lanes[i], children[i]});
+			}
+		}
+
+		// AllocateNode may have moved the nodes.
+		b2WideNode* node = m_nodes + entry.wideNode;
+		node->childCount = count;
+
+		for (int32 i = 0; i < b2_wideTreeWidth; ++i)
+		{
+			if (i < count)
+			{
+				const b2AABB& aabb = treeNodes[lanes[i]].aabb;
+				node->lowerX[i] = aabb.lowerBound.x;
+				node->lowerY[i] = aabb.lowerBound.y;
+				node->upperX[i] = aabb.upperBound.x;
+				node->upperY[i] = aabb.upperBound.y;
+				node->children[i] = children[i];
+			}
+			else
+			{
+				// Empty bounds, which never overlap anything.
+				node->lowerX[i] = b2_maxFloat;
+				node->lowerY[i] = b2_maxFloat;
+				node->upperX[i] = -b2_maxFloat;
+				node->upperY[i] = -b2_maxFloat;
+				node->children[i] = b2_nullNode;
+			}
+		}
+	}
+}
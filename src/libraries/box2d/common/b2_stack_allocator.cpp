@@ -85,3 +85,82 @@ int32 b2StackAllocator::GetMaxAllocation() const
 {
 	return m_maxAllocation;
 }
+
+/* LOVE: Added b2ArenaAllocator. */
+
+struct b2ArenaBlock
+{
+	b2ArenaBlock* next;
+	int32 size;
+	int32 used;
+};
+
+// Keeps allocations aligned for any solver data.
+static const int32 b2_arenaAlignment = 16;
+static const int32 b2_arenaHeaderSize = (sizeof(b2ArenaBlock) + b2_arenaAlignment - 1) & ~(b2_arenaAlignment - 1);
+
+static b2ArenaBlock* b2NewArenaBlock(int32 size, b2ArenaBlock* next)
+{
+	b2ArenaBlock* block = (b2ArenaBlock*)b2Alloc(b2_arenaHeaderSize + size);
+	block->next = next;
+	block->size = size;
+	block->used = 0;
+	return block;
+}
+
+b2ArenaAllocator::b2ArenaAllocator()
+{
+	m_blocks = nullptr;
+}
+
+b2ArenaAllocator::~b2ArenaAllocator()
+{
+	while (m_blocks)
+	{
+		b2ArenaBlock* next = m_blocks->next;
+		b2Free(m_blocks);
+		m_blocks = next;
+	}
+}
+
+void* b2ArenaAllocator::Allocate(int32 size)
+{
+	size = (size + b2_arenaAlignment - 1) & ~(b2_arenaAlignment - 1);
+
+	if (m_blocks == nullptr || m_blocks->used + size > m_blocks->size)
+	{
+		int32 blockSize = m_blocks ? 2 * m_blocks->size : b2_stackSize;
+		m_blocks = b2NewArenaBlock(b2Max(blockSize, size), m_blocks);
+	}
+
+	char* data = (char*)m_blocks + b2_arenaHeaderSize + m_blocks->used;
+	m_blocks->used += size;
+	return data;
+}
+
+void b2ArenaAllocator::Reset()
+{
+	if (m_blocks == nullptr)
+	{
+		return;
+	}
+
+	if (m_blocks->next == nullptr)
+	{
+		m_blocks->used = 0;
+		return;
+	}
+
+	// Replace the blocks with one that fits everything, so the next step
+	// doesn't need to allocate.
+	int32 size = 0;
+	while (m_blocks)
+	{
+		b2ArenaBlock* next = m_blocks->next;
+		size += m_blocks->size;
+		b2Free(m_blocks);
+		m_blocks = next;
+	}
+
+	m_blocks = b2NewArenaBlock(size, nullptr);
+}
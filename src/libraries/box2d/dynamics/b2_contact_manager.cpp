@@ -24,8 +24,12 @@
 #include "box2d/b2_contact.h"
 #include "box2d/b2_contact_manager.h"
 #include "box2d/b2_fixture.h"
+#include "box2d/b2_stack_allocator.h"
 #include "box2d/b2_world_callbacks.h"
 
+// LOVE: Below this many contacts the narrow phase isn't worth splitting up.
+static const int32 b2_minParallelContacts = 256;
+
 b2ContactFilter b2_defaultFilter;
 b2ContactListener b2_defaultListener;
 
@@ -36,6 +40,8 @@ b2ContactManager::b2ContactManager()
 	m_contactFilter = &b2_defaultFilter;
 	m_contactListener = &b2_defaultListener;
 	m_allocator = nullptr;
+	m_taskExecutor = nullptr;
+	m_arena = nullptr;
 }
 
 void b2ContactManager::Destroy(b2Contact* c)
@@ -108,6 +114,9 @@ void b2ContactManager::Destroy(b2Contact* c)
 // contact list.
 void b2ContactManager::Collide()
 {
+	b2CollideResults results;
+	bool precomputed = UpdateManifoldsParallel(&results);
+
 	// Update awake contacts.
 	b2Contact* c = m_contactList;
 	while (c)
@@ -168,11 +177,81 @@ void b2ContactManager::Collide()
 		}
 
 		// The contact persists.
-		c->Update(m_contactListener);
+		if (precomputed && c->m_collideIndex >= 0)
+		{
+			int32 i = c->m_collideIndex;
+			c->ApplyUpdate(m_contactListener, results.manifolds[i], results.touching[i]);
+		}
+		else
+		{
+			c->Update(m_contactListener);
+		}
 		c = c->GetNext();
 	}
 }
 
+void b2ContactManager::UpdateManifolds(int32 begin, int32 end, void* context)
+{
+	b2CollideResults* results = (b2CollideResults*)context;
+	for (int32 i = begin; i < end; ++i)
+	{
+		results->contacts[i]->UpdateManifold(results->manifolds + i, results->touching + i);
+	}
+}
+
+// LOVE: Computes the new manifolds of the contacts Collide will update, using
+// the task executor. Collide then applies them in list order, so listener
+// calls and results match the serial version. Contacts which need filtering
+// are left to Collide, since the filter can call user code.
+bool b2ContactManager::UpdateManifoldsParallel(b2CollideResults* results)
+{
+	if (m_taskExecutor == nullptr || m_arena == nullptr ||
+		m_taskExecutor->GetWorkerCount() <= 1 || m_contactCount < b2_minParallelContacts)
+	{
+		return false;
+	}
+
+	results->contacts = (b2Contact**)m_arena->Allocate(m_contactCount * sizeof(b2Contact*));
+	results->manifolds = (b2Manifold*)m_arena->Allocate(m_contactCount * sizeof(b2Manifold));
+	results->touching = (bool*)m_arena->Allocate(m_contactCount * sizeof(bool));
+
+	int32 count = 0;
+	for (b2Contact* c = m_contactList; c; c = c->GetNext())
+	{
+		c->m_collideIndex = -1;
+
+		if (c->m_flags & b2Contact::e_filterFlag)
+		{
+			continue;
+		}
+
+		b2Fixture* fixtureA = c->GetFixtureA();
+		b2Fixture* fixtureB = c->GetFixtureB();
+		b2Body* bodyA = fixtureA->GetBody();
+		b2Body* bodyB = fixtureB->GetBody();
+
+		bool activeA = bodyA->IsAwake() && bodyA->m_type != b2_staticBody;
+		bool activeB = bodyB->IsAwake() && bodyB->m_type != b2_staticBody;
+		if (activeA == false && activeB == false)
+		{
+			continue;
+		}
+
+		int32 proxyIdA = fixtureA->m_proxies[c->GetChildIndexA()].proxyId;
+		int32 proxyIdB = fixtureB->m_proxies[c->GetChildIndexB()].proxyId;
+		if (m_broadPhase.TestOverlap(proxyIdA, proxyIdB) == false)
+		{
+			continue;
+		}
+
+		c->m_collideIndex = count;
+		results->contacts[count++] = c;
+	}
+
+	m_taskExecutor->ParallelFor(count, 32, UpdateManifolds, results);
+	return true;
+}
+
 void b2ContactManager::FindNewContacts()
 {
 	m_broadPhase.UpdatePairs(this);
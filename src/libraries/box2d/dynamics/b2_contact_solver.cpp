@@ -52,9 +52,18 @@ b2ContactSolver::b2ContactSolver(b2ContactSolverDef* def)
 {
 	m_step = def->step;
 	m_allocator = def->allocator;
+	m_arena = def->arena;
 	m_count = def->count;
-	m_positionConstraints = (b2ContactPositionConstraint*)m_allocator->Allocate(m_count * sizeof(b2ContactPositionConstraint));
-	m_velocityConstraints = (b2ContactVelocityConstraint*)m_allocator->Allocate(m_count * sizeof(b2ContactVelocityConstraint));
+	if (m_arena)
+	{
+		m_positionConstraints = (b2ContactPositionConstraint*)m_arena->Allocate(m_count * sizeof(b2ContactPositionConstraint));
+		m_velocityConstraints = (b2ContactVelocityConstraint*)m_arena->Allocate(m_count * sizeof(b2ContactVelocityConstraint));
+	}
+	else
+	{
+		m_positionConstraints = (b2ContactPositionConstraint*)m_allocator->Allocate(m_count * sizeof(b2ContactPositionConstraint));
+		m_velocityConstraints = (b2ContactVelocityConstraint*)m_allocator->Allocate(m_count * sizeof(b2ContactVelocityConstraint));
+	}
 	m_positions = def->positions;
 	m_velocities = def->velocities;
 	m_contacts = def->contacts;
@@ -138,8 +147,12 @@ b2ContactSolver::b2ContactSolver(b2ContactSolverDef* def)
 
 b2ContactSolver::~b2ContactSolver()
 {
-	m_allocator->Free(m_velocityConstraints);
-	m_allocator->Free(m_positionConstraints);
+	// Arena memory is released by b2ArenaAllocator::Reset.
+	if (m_arena == nullptr)
+	{
+		m_allocator->Free(m_velocityConstraints);
+		m_allocator->Free(m_positionConstraints);
+	}
 }
 
 // Initialize position dependent portions of the velocity constraints.
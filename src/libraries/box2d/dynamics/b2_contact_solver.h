@@ -30,6 +30,7 @@
 class b2Contact;
 class b2Body;
 class b2StackAllocator;
+class b2ArenaAllocator;
 struct b2ContactPositionConstraint;
 
 struct b2VelocityConstraintPoint
@@ -69,6 +70,7 @@ struct b2ContactSolverDef
 	b2Position* positions;
 	b2Velocity* velocities;
 	b2StackAllocator* allocator;
+	b2ArenaAllocator* arena; // LOVE: used instead of allocator if set.
 };
 
 class b2ContactSolver
@@ -90,6 +92,7 @@ class b2ContactSolver
 	b2Position* m_positions;
 	b2Velocity* m_velocities;
 	b2StackAllocator* m_allocator;
+	b2ArenaAllocator* m_arena;
 	b2ContactPositionConstraint* m_positionConstraints;
 	b2ContactVelocityConstraint* m_velocityConstraints;
 	b2Contact** m_contacts;
@@ -32,6 +32,8 @@
 #include "b2_island.h"
 #include "b2_contact_solver.h"
 
+#include <new>
+
 /*
 Position Correction Notes
 =========================
@@ -165,27 +167,86 @@ b2Island::b2Island(
 	m_jointCount = 0;
 
 	m_allocator = allocator;
+	m_arena = nullptr;
 	m_listener = listener;
+	m_contactSolver = nullptr;
+	m_positionSolved = false;
 
-	m_bodies = (b2Body**)m_allocator->Allocate(bodyCapacity * sizeof(b2Body*));
-	m_contacts = (b2Contact**)m_allocator->Allocate(contactCapacity	 * sizeof(b2Contact*));
-	m_joints = (b2Joint**)m_allocator->Allocate(jointCapacity * sizeof(b2Joint*));
+	m_bodies = (b2Body**)Allocate(bodyCapacity * sizeof(b2Body*));
+	m_contacts = (b2Contact**)Allocate(contactCapacity	 * sizeof(b2Contact*));
+	m_joints = (b2Joint**)Allocate(jointCapacity * sizeof(b2Joint*));
 
-	m_velocities = (b2Velocity*)m_allocator->Allocate(m_bodyCapacity * sizeof(b2Velocity));
-	m_positions = (b2Position*)m_allocator->Allocate(m_bodyCapacity * sizeof(b2Position));
+	m_velocities = (b2Velocity*)Allocate(m_bodyCapacity * sizeof(b2Velocity));
+	m_positions = (b2Position*)Allocate(m_bodyCapacity * sizeof(b2Position));
+}
+
+b2Island::b2Island(
+	int32 bodyCapacity,
+	int32 contactCapacity,
+	int32 jointCapacity,
+	b2ArenaAllocator* arena,
+	b2ContactListener* listener)
+{
+	m_bodyCapacity = bodyCapacity;
+	m_contactCapacity = contactCapacity;
+	m_jointCapacity	 = jointCapacity;
+	m_bodyCount = 0;
+	m_contactCount = 0;
+	m_jointCount = 0;
+
+	m_allocator = nullptr;
+	m_arena = arena;
+	m_listener = listener;
+	m_contactSolver = nullptr;
+	m_positionSolved = false;
+
+	m_bodies = (b2Body**)Allocate(bodyCapacity * sizeof(b2Body*));
+	m_contacts = (b2Contact**)Allocate(contactCapacity	 * sizeof(b2Contact*));
+	m_joints = (b2Joint**)Allocate(jointCapacity * sizeof(b2Joint*));
+
+	m_velocities = (b2Velocity*)Allocate(m_bodyCapacity * sizeof(b2Velocity));
+	m_positions = (b2Position*)Allocate(m_bodyCapacity * sizeof(b2Position));
 }
 
 b2Island::~b2Island()
 {
+	b2Assert(m_contactSolver == nullptr);
+
 	// Warning: the order should reverse the constructor order.
-	m_allocator->Free(m_positions);
-	m_allocator->Free(m_velocities);
-	m_allocator->Free(m_joints);
-	m_allocator->Free(m_contacts);
-	m_allocator->Free(m_bodies);
+	Free(m_positions);
+	Free(m_velocities);
+	Free(m_joints);
+	Free(m_contacts);
+	Free(m_bodies);
+}
+
+void* b2Island::Allocate(int32 size)
+{
+	if (m_arena)
+	{
+		return m_arena->Allocate(size);
+	}
+
+	return m_allocator->Allocate(size);
+}
+
+void b2Island::Free(void* p)
+{
+	// Arena memory is released by b2ArenaAllocator::Reset.
+	if (m_arena == nullptr)
+	{
+		m_allocator->Free(p);
+	}
 }
 
 void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& gravity, bool allowSleep)
+{
+	InitSolve(profile, step, gravity);
+	SolveConstraints(profile, step);
+	FinishSolve(step, allowSleep);
+}
+
+void b2Island::InitSolve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& gravity)
 {
 	b2Timer timer;
 
@@ -231,10 +292,9 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	timer.Reset();
 
 	// Solver data
-	b2SolverData solverData;
-	solverData.step = step;
-	solverData.positions = m_positions;
-	solverData.velocities = m_velocities;
+	m_solverData.step = step;
+	m_solverData.positions = m_positions;
+	m_solverData.velocities = m_velocities;
 
 	// Initialize velocity constraints.
 	b2ContactSolverDef contactSolverDef;
@@ -244,29 +304,39 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	contactSolverDef.positions = m_positions;
 	contactSolverDef.velocities = m_velocities;
 	contactSolverDef.allocator = m_allocator;
+	contactSolverDef.arena = m_arena;
 
-	b2ContactSolver contactSolver(&contactSolverDef);
-	contactSolver.InitializeVelocityConstraints();
+	void* mem = Allocate(sizeof(b2ContactSolver));
+	m_contactSolver = new (mem) b2ContactSolver(&contactSolverDef);
+	m_contactSolver->InitializeVelocityConstraints();
 
 	if (step.warmStarting)
 	{
-		contactSolver.WarmStart();
+		m_contactSolver->WarmStart();
 	}
 	
 	for (int32 i = 0; i < m_jointCount; ++i)
 	{
-		m_joints[i]->InitVelocityConstraints(solverData);
+		m_joints[i]->InitVelocityConstraints(m_solverData);
 	}
 
 	profile->solveInit = timer.GetMilliseconds();
+}
+
+void b2Island::SolveConstraints(b2Profile* profile, const b2TimeStep& step)
+{
+	b2Timer timer;
+
+	float h = step.dt;
+
+	b2ContactSolver& contactSolver = *m_contactSolver;
 
 	// Solve velocity constraints
-	timer.Reset();
 	for (int32 i = 0; i < step.velocityIterations; ++i)
 	{
 		for (int32 j = 0; j < m_jointCount; ++j)
 		{
-			m_joints[j]->SolveVelocityConstraints(solverData);
+			m_joints[j]->SolveVelocityConstraints(m_solverData);
 		}
 
 		contactSolver.SolveVelocityConstraints();
@@ -311,7 +381,7 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 
 	// Solve position constraints
 	timer.Reset();
-	bool positionSolved = false;
+	m_positionSolved = false;
 	for (int32 i = 0; i < step.positionIterations; ++i)
 	{
 		bool contactsOkay = contactSolver.SolvePositionConstraints();
@@ -319,14 +389,14 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 		bool jointsOkay = true;
 		for (int32 j = 0; j < m_jointCount; ++j)
 		{
-			bool jointOkay = m_joints[j]->SolvePositionConstraints(solverData);
+			bool jointOkay = m_joints[j]->SolvePositionConstraints(m_solverData);
 			jointsOkay = jointsOkay && jointOkay;
 		}
 
 		if (contactsOkay && jointsOkay)
 		{
 			// Exit early if the position errors are small.
-			positionSolved = true;
+			m_positionSolved = true;
 			break;
 		}
 	}
@@ -335,6 +405,14 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	for (int32 i = 0; i < m_bodyCount; ++i)
 	{
 		b2Body* body = m_bodies[i];
+
+		// LOVE: Static bodies can be in several islands at once, and the
+		// solver never moves them.
+		if (body->m_type == b2_staticBody)
+		{
+			continue;
+		}
+
 		body->m_sweep.c = m_positions[i].c;
 		body->m_sweep.a = m_positions[i].a;
 		body->m_linearVelocity = m_velocities[i].v;
@@ -343,8 +421,17 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	}
 
 	profile->solvePosition = timer.GetMilliseconds();
+}
 
-	Report(contactSolver.m_velocityConstraints);
+void b2Island::FinishSolve(const b2TimeStep& step, bool allowSleep)
+{
+	float h = step.dt;
+
+	Report(m_contactSolver->m_velocityConstraints);
+
+	m_contactSolver->~b2ContactSolver();
+	Free(m_contactSolver);
+	m_contactSolver = nullptr;
 
 	if (allowSleep)
 	{
@@ -375,7 +462,7 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 			}
 		}
 
-		if (minSleepTime >= b2_timeToSleep && positionSolved)
+		if (minSleepTime >= b2_timeToSleep && m_positionSolved)
 		{
 			for (int32 i = 0; i < m_bodyCount; ++i)
 			{
@@ -405,6 +492,7 @@ void b2Island::SolveTOI(const b2TimeStep& subStep, int32 toiIndexA, int32 toiInd
 	contactSolverDef.contacts = m_contacts;
 	contactSolverDef.count = m_contactCount;
 	contactSolverDef.allocator = m_allocator;
+	contactSolverDef.arena = m_arena;
 	contactSolverDef.step = subStep;
 	contactSolverDef.positions = m_positions;
 	contactSolverDef.velocities = m_velocities;
@@ -30,7 +30,9 @@
 class b2Contact;
 class b2Joint;
 class b2StackAllocator;
+class b2ArenaAllocator;
 class b2ContactListener;
+class b2ContactSolver;
 struct b2ContactVelocityConstraint;
 struct b2Profile;
 
@@ -40,6 +42,9 @@ class b2Island
 public:
 	b2Island(int32 bodyCapacity, int32 contactCapacity, int32 jointCapacity,
 			b2StackAllocator* allocator, b2ContactListener* listener);
+	// LOVE: Allocates from an arena, so islands can be kept alive in any order.
+	b2Island(int32 bodyCapacity, int32 contactCapacity, int32 jointCapacity,
+			b2ArenaAllocator* arena, b2ContactListener* listener);
 	~b2Island();
 
 	void Clear()
@@ -51,6 +56,14 @@ class b2Island
 
 	void Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& gravity, bool allowSleep);
 
+	/* LOVE: Solve is split into three parts, so the constraint iterations of
+	   different islands can run in parallel. Only SolveConstraints is thread
+	   safe. InitSolve reads the bodies' island indices, so it must run right
+	   after the island is built. FinishSolve calls the contact listener. */
+	void InitSolve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& gravity);
+	void SolveConstraints(b2Profile* profile, const b2TimeStep& step);
+	void FinishSolve(const b2TimeStep& step, bool allowSleep);
+
 	void SolveTOI(const b2TimeStep& subStep, int32 toiIndexA, int32 toiIndexB);
 
 	void Add(b2Body* body)
@@ -75,9 +88,18 @@ class b2Island
 
 	void Report(const b2ContactVelocityConstraint* constraints);
 
+	void* Allocate(int32 size);
+	void Free(void* p);
+
 	b2StackAllocator* m_allocator;
+	b2ArenaAllocator* m_arena;
 	b2ContactListener* m_listener;
 
+	// State kept between InitSolve and FinishSolve.
+	b2ContactSolver* m_contactSolver;
+	b2SolverData m_solverData;
+	bool m_positionSolved;
+
 	b2Body** m_bodies;
 	b2Contact** m_contacts;
 	b2Joint** m_joints;
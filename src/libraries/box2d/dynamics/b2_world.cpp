@@ -67,6 +67,9 @@ b2World::b2World(const b2Vec2& gravity)
 	m_inv_dt0 = 0.0f;
 
 	m_contactManager.m_allocator = &m_blockAllocator;
+	m_contactManager.m_arena = &m_arena;
+
+	m_taskExecutor = nullptr;
 
 	memset(&m_profile, 0, sizeof(b2Profile));
 }
@@ -107,6 +110,12 @@ void b2World::SetContactListener(b2ContactListener* listener)
 	m_contactManager.m_contactListener = listener;
 }
 
+void b2World::SetTaskExecutor(b2TaskExecutor* executor)
+{
+	m_taskExecutor = executor;
+	m_contactManager.m_taskExecutor = executor;
+}
+
 void b2World::SetDebugDraw(b2Draw* debugDraw)
 {
 	m_debugDraw = debugDraw;
@@ -391,12 +400,51 @@ void b2World::SetAllowSleeping(bool flag)
 }
 
 // Find islands, integrate and solve constraints, solve position constraints
+// LOVE: Islands waiting for their constraints to be solved in parallel.
+struct b2ParallelIslands
+{
+	b2Island** islands;
+	b2Profile* profiles;
+	b2TimeStep step;
+};
+
+// LOVE: Below this many bodies solving in parallel isn't worth it.
+static const int32 b2_minParallelBodies = 64;
+
+void b2World::SolveIslands(int32 begin, int32 end, void* context)
+{
+	b2ParallelIslands* parallel = (b2ParallelIslands*)context;
+	for (int32 i = begin; i < end; ++i)
+	{
+		parallel->islands[i]->SolveConstraints(parallel->profiles + i, parallel->step);
+	}
+}
+
 void b2World::Solve(const b2TimeStep& step)
 {
 	m_profile.solveInit = 0.0f;
 	m_profile.solveVelocity = 0.0f;
 	m_profile.solvePosition = 0.0f;
 
+	// LOVE: With a task executor, each island is copied out of the scratch
+	// island below and its solver is initialized right away, while the bodies'
+	// island indices are valid. The constraint iterations then run in
+	// parallel, and the islands are finished in the order they were built so
+	// the listener sees the same calls as when solving serially.
+	bool solveParallel = m_taskExecutor != nullptr && m_taskExecutor->GetWorkerCount() > 1 && m_bodyCount >= b2_minParallelBodies;
+
+	b2ParallelIslands parallel;
+	parallel.islands = nullptr;
+	parallel.profiles = nullptr;
+	parallel.step = step;
+	int32 islandCount = 0;
+
+	if (solveParallel)
+	{
+		parallel.islands = (b2Island**)m_arena.Allocate(m_bodyCount * sizeof(b2Island*));
+		parallel.profiles = (b2Profile*)m_arena.Allocate(m_bodyCount * sizeof(b2Profile));
+	}
+
 	// Size the island for the worst case.
 	b2Island island(m_bodyCount,
 					m_contactManager.m_contactCount,
@@ -535,11 +583,37 @@ void b2World::Solve(const b2TimeStep& step)
 			}
 		}
 
-		b2Profile profile;
-		island.Solve(&profile, step, m_gravity, m_allowSleep);
-		m_profile.solveInit += profile.solveInit;
-		m_profile.solveVelocity += profile.solveVelocity;
-		m_profile.solvePosition += profile.solvePosition;
+		if (solveParallel)
+		{
+			void* mem = m_arena.Allocate(sizeof(b2Island));
+			b2Island* copy = new (mem) b2Island(island.m_bodyCount, island.m_contactCount, island.m_jointCount,
+				&m_arena, m_contactManager.m_contactListener);
+
+			for (int32 i = 0; i < island.m_bodyCount; ++i)
+			{
+				copy->Add(island.m_bodies[i]);
+			}
+			for (int32 i = 0; i < island.m_contactCount; ++i)
+			{
+				copy->Add(island.m_contacts[i]);
+			}
+			for (int32 i = 0; i < island.m_jointCount; ++i)
+			{
+				copy->Add(island.m_joints[i]);
+			}
+
+			b2Profile* profile = parallel.profiles + islandCount;
+			copy->InitSolve(profile, step, m_gravity);
+			parallel.islands[islandCount++] = copy;
+		}
+		else
+		{
+			b2Profile profile;
+			island.Solve(&profile, step, m_gravity, m_allowSleep);
+			m_profile.solveInit += profile.solveInit;
+			m_profile.solveVelocity += profile.solveVelocity;
+			m_profile.solvePosition += profile.solvePosition;
+		}
 
 		// Post solve cleanup.
 		for (int32 i = 0; i < island.m_bodyCount; ++i)
@@ -555,6 +629,23 @@ void b2World::Solve(const b2TimeStep& step)
 
 	m_stackAllocator.Free(stack);
 
+	if (solveParallel)
+	{
+		m_taskExecutor->ParallelFor(islandCount, 1, SolveIslands, &parallel);
+
+		for (int32 i = 0; i < islandCount; ++i)
+		{
+			b2Island* solved = parallel.islands[i];
+			solved->FinishSolve(step, m_allowSleep);
+			solved->~b2Island();
+
+			const b2Profile& profile = parallel.profiles[i];
+			m_profile.solveInit += profile.solveInit;
+			m_profile.solveVelocity += profile.solveVelocity;
+			m_profile.solvePosition += profile.solvePosition;
+		}
+	}
+
 	{
 		b2Timer timer;
 		// Synchronize fixtures, check for out of range bodies.
@@ -965,6 +1056,8 @@ void b2World::Step(float dt, int32 velocityIterations, int32 positionIterations)
 		ClearForces();
 	}
 
+	m_arena.Reset();
+
 	m_locked = false;
 
 	m_profile.step = stepTimer.GetMilliseconds();
@@ -1219,6 +1312,16 @@ int32 b2World::GetProxyCount() const
 	return m_contactManager.m_broadPhase.GetProxyCount();
 }
 
+void b2World::SetBroadPhaseLayout(b2BroadPhaseLayout layout)
+{
+	m_contactManager.m_broadPhase.SetLayout(layout);
+}
+
+b2BroadPhaseLayout b2World::GetBroadPhaseLayout() const
+{
+	return m_contactManager.m_broadPhase.GetLayout();
+}
+
 int32 b2World::GetTreeHeight() const
 {
 	return m_contactManager.m_broadPhase.GetTreeHeight();
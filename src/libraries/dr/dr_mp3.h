@@ -3823,13 +3823,20 @@ static drmp3_bool32 drmp3_find_closest_seek_point(drmp3* pMP3, drmp3_uint64 fram
         return DRMP3_FALSE;
     }
 
-    /* Linear search for simplicity to begin with while I'm getting this thing working. Once it's all working change this to a binary search. */
-    for (iSeekPoint = 0; iSeekPoint < pMP3->seekPointCount; ++iSeekPoint) {
-        if (pMP3->pSeekPoints[iSeekPoint].pcmFrameIndex > frameIndex) {
-            break;  /* Found it. */
+    /* LOVE: Binary search for the last seek point at or before frameIndex. Seek points are sorted by PCM frame. */
+    {
+        drmp3_uint32 lo = 0;
+        drmp3_uint32 hi = pMP3->seekPointCount;
+        while (hi - lo > 1) {
+            iSeekPoint = lo + (hi - lo) / 2;
+            if (pMP3->pSeekPoints[iSeekPoint].pcmFrameIndex > frameIndex) {
+                hi = iSeekPoint;
+            } else {
+                lo = iSeekPoint;
+            }
         }
 
-        *pSeekPointIndex = iSeekPoint;
+        *pSeekPointIndex = lo;
     }
 
     return DRMP3_TRUE;
@@ -3180,6 +3180,43 @@ PHYSFS_sint64 PHYSFS_fileLength(PHYSFS_File *handle)
 } /* PHYSFS_filelength */
 
 
+/* LOVE: see physfs.h. */
+int PHYSFS_getNativeRange(PHYSFS_File *handle, const char **path,
+                          PHYSFS_uint64 *offset, PHYSFS_uint64 *len)
+{
+    FileHandle *fh = (FileHandle *) handle;
+    PHYSFS_Io *io = fh->io;
+    PHYSFS_uint64 start = 0;
+    PHYSFS_uint64 stored = 0;
+    int isStored = 0;
+
+    BAIL_IF(!fh->forReading, PHYSFS_ERR_OPEN_FOR_WRITING, 0);
+
+    /* Files in writable mounts can change or shrink while they're mapped. */
+    BAIL_IF(fh->dirHandle->forWriting, PHYSFS_ERR_UNSUPPORTED, 0);
+
+#if PHYSFS_SUPPORTS_ZIP
+    isStored = __PHYSFS_ZIP_getStoredRange(io, &io, &start, &stored);
+#endif
+
+    /* Only native i/o has a path we can hand out. */
+    BAIL_IF(io->read != nativeIo_read, PHYSFS_ERR_UNSUPPORTED, 0);
+
+    if (isStored)
+        *len = stored;
+    else
+    {
+        const PHYSFS_sint64 length = io->length(io);
+        BAIL_IF_ERRPASS(length < 0, 0);
+        *len = (PHYSFS_uint64) length;
+    } /* else */
+
+    *path = ((NativeIoInfo *) io->opaque)->path;
+    *offset = start;
+    return 1;
+} /* PHYSFS_getNativeRange */
+
+
 int PHYSFS_setBuffer(PHYSFS_File *handle, PHYSFS_uint64 _bufsize)
 {
     FileHandle *fh = (FileHandle *) handle;
@@ -3928,6 +3928,32 @@ PHYSFS_DECL int PHYSFS_setRoot(const char *archive, const char *subdir);
 /* Everything above this line is part of the PhysicsFS 3.1 API. */
 
 
+/* LOVE: not part of upstream PhysicsFS. */
+
+/**
+ * \fn int PHYSFS_getNativeRange(PHYSFS_File *handle, const char **path, PHYSFS_uint64 *offset, PHYSFS_uint64 *len)
+ * \brief Find where an open file's bytes are stored on the native filesystem.
+ *
+ * This succeeds for files in native directories, and for entries of zip
+ *  archives which are stored without compression or encryption, if the
+ *  archive was mounted from a native file. Files in directories mounted for
+ *  writing (PHYSFS_mountRW) are never reported, since they can be modified
+ *  or truncated while in use. The bytes of the file are then
+ *  exactly the (*len) bytes starting at (*offset) in the native file (*path),
+ *  which can be used to memory-map them.
+ *
+ *    \param handle a file opened for reading.
+ *    \param path receives the platform-dependent path of the native file. The
+ *                 string is valid until (handle) is closed.
+ *    \param offset receives the offset of the file's data in (*path).
+ *    \param len receives the length of the file's data.
+ *   \return nonzero on success, zero if the file isn't stored that way.
+ */
+PHYSFS_DECL int PHYSFS_getNativeRange(PHYSFS_File *handle, const char **path,
+                                      PHYSFS_uint64 *offset,
+                                      PHYSFS_uint64 *len);
+
+
 #ifdef __cplusplus
 }
 #endif
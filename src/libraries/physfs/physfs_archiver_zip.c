@@ -526,6 +526,29 @@ static const PHYSFS_Io ZIP_Io =
 };
 
 
+/* LOVE: find the range of an open entry's data in its archive, if it's stored
+   without compression or encryption. */
+int __PHYSFS_ZIP_getStoredRange(PHYSFS_Io *io, PHYSFS_Io **archiveio,
+                                PHYSFS_uint64 *offset, PHYSFS_uint64 *len)
+{
+    ZIPfileinfo *finfo;
+
+    if (io->read != ZIP_read)
+        return 0;
+
+    finfo = (ZIPfileinfo *) io->opaque;
+    if (finfo->entry->compression_method != COMPMETH_NONE)
+        return 0;
+    else if (zip_entry_is_tradional_crypto(finfo->entry))
+        return 0;
+
+    *archiveio = finfo->io;
+    *offset = finfo->entry->offset;
+    *len = finfo->entry->uncompressed_size;
+    return 1;
+} /* __PHYSFS_ZIP_getStoredRange */
+
+
 
 static PHYSFS_sint64 zip_find_end_of_central_dir(PHYSFS_Io *io, PHYSFS_sint64 *len)
 {
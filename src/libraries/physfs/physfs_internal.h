@@ -92,6 +92,10 @@ extern const PHYSFS_Archiver __PHYSFS_Archiver_SLB;
 extern const PHYSFS_Archiver __PHYSFS_Archiver_ISO9660;
 extern const PHYSFS_Archiver __PHYSFS_Archiver_VDF;
 
+/* LOVE: used by PHYSFS_getNativeRange(). */
+int __PHYSFS_ZIP_getStoredRange(PHYSFS_Io *io, PHYSFS_Io **archiveio,
+                                PHYSFS_uint64 *offset, PHYSFS_uint64 *len);
+
 /* a real C99-compliant snprintf() is in Visual Studio 2015,
    but just use this everywhere for binary compatibility. */
 #if defined(_MSC_VER)
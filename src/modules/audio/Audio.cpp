@@ -70,8 +70,39 @@ void showRecordingPermissionMissingDialog()
 
 Audio::Audio(const char *name)
 	: Module(M_AUDIO, name)
+	, sourceCache(DEFAULT_SOURCE_CACHE_BUDGET)
 {}
 
+Source *Audio::newCachedSource(uint64 hash)
+{
+	return sourceCache.newSource(hash);
+}
+
+void Audio::cacheSource(uint64 hash, Source *source, size_t size)
+{
+	sourceCache.add(hash, source, size);
+}
+
+void Audio::setSourceCacheBudget(size_t bytes)
+{
+	sourceCache.setBudget(bytes);
+}
+
+size_t Audio::getSourceCacheBudget() const
+{
+	return sourceCache.getBudget();
+}
+
+size_t Audio::getSourceCacheSize() const
+{
+	return sourceCache.getSize();
+}
+
+void Audio::clearSourceCache()
+{
+	sourceCache.clear();
+}
+
 bool Audio::setMixWithSystem(bool mix)
 {
 #ifdef LOVE_IOS
@@ -30,6 +30,7 @@
 #include "Source.h"
 #include "Effect.h"
 #include "RecordingDevice.h"
+#include "SourceCache.h"
 
 namespace love
 {
@@ -105,6 +106,28 @@ class Audio : public Module
 	virtual Source *newSource(love::sound::SoundData *soundData) = 0;
 	virtual Source *newSource(int sampleRate, int bitDepth, int channels, int buffers) = 0;
 
+	/**
+	 * Creates a static Source which shares the decoded audio of one cached
+	 * under the given content hash, or returns null if none is cached.
+	 **/
+	Source *newCachedSource(uint64 hash);
+
+	/**
+	 * Caches a static Source under the content hash of the audio it was
+	 * created from, so newCachedSource can reuse it without decoding again.
+	 * @param size The size in bytes of the Source's decoded audio.
+	 **/
+	void cacheSource(uint64 hash, Source *source, size_t size);
+
+	/**
+	 * Sets the maximum number of bytes of decoded audio kept in the Source
+	 * cache. Least recently used entries are evicted when it's exceeded.
+	 **/
+	void setSourceCacheBudget(size_t bytes);
+	size_t getSourceCacheBudget() const;
+	size_t getSourceCacheSize() const;
+	void clearSourceCache();
+
 	/**
 	 * Gets the current number of simultaneous playing sources.
 	 * @return The current number of simultaneous playing sources.
@@ -117,6 +140,21 @@ class Audio : public Module
 	 **/
 	virtual int getMaxSources() const = 0;
 
+	/**
+	 * Enables or disables software mixing of static Sources which can't get
+	 * one of the limited hardware voices. The quietest voices are mixed in
+	 * software and the loudest keep (or take over) hardware voices. Only
+	 * Sources created while software mixing is enabled can be mixed.
+	 * @return Whether software mixing could be enabled.
+	 **/
+	virtual bool setSoftwareMixing(bool enable) = 0;
+	virtual bool isSoftwareMixing() const = 0;
+
+	/**
+	 * Gets the number of playing Sources which are mixed in software.
+	 **/
+	virtual int getVirtualSourceCount() const = 0;
+
 	/**
 	 * Play the specified Source.
 	 * @param source The Source to play.
@@ -313,6 +351,10 @@ class Audio : public Module
 
 	Audio(const char *name);
 
+	static const size_t DEFAULT_SOURCE_CACHE_BUDGET = 64 * 1024 * 1024;
+
+	SourceCache sourceCache;
+
 private:
 
 	static StringMap<DistanceModel, DISTANCE_MAX_ENUM>::Entry distanceModelEntries[];
@@ -0,0 +1,110 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "SourceCache.h"
+
+namespace love
+{
+namespace audio
+{
+
+SourceCache::SourceCache(size_t budget)
+	: budget(budget)
+	, size(0)
+{
+}
+
+SourceCache::~SourceCache()
+{
+	clear();
+}
+
+Source *SourceCache::newSource(uint64 hash)
+{
+	thread::Lock lock(mutex);
+
+	auto it = lookup.find(hash);
+	if (it == lookup.end())
+		return nullptr;
+
+	entries.splice(entries.begin(), entries, it->second);
+
+	return it->second->source->clone();
+}
+
+void SourceCache::add(uint64 hash, Source *source, size_t size)
+{
+	if (source->getType() != Source::TYPE_STATIC)
+		return;
+
+	thread::Lock lock(mutex);
+
+	if (size > budget || lookup.find(hash) != lookup.end())
+		return;
+
+	evict(budget - size);
+
+	// The cached Source is a clone so changes to the original's properties
+	// don't carry over to Sources created from the cache.
+	StrongRef<Source> cached(source->clone(), Acquire::NORETAIN);
+
+	entries.push_front({hash, cached, size});
+	lookup[hash] = entries.begin();
+	this->size += size;
+}
+
+void SourceCache::evict(size_t budget)
+{
+	while (size > budget && !entries.empty())
+	{
+		const Entry &entry = entries.back();
+		size -= entry.size;
+		lookup.erase(entry.hash);
+		entries.pop_back();
+	}
+}
+
+void SourceCache::setBudget(size_t budget)
+{
+	thread::Lock lock(mutex);
+	this->budget = budget;
+	evict(budget);
+}
+
+size_t SourceCache::getBudget() const
+{
+	thread::Lock lock(mutex);
+	return budget;
+}
+
+size_t SourceCache::getSize() const
+{
+	thread::Lock lock(mutex);
+	return size;
+}
+
+void SourceCache::clear()
+{
+	thread::Lock lock(mutex);
+	evict(0);
+}
+
+} // audio
+} // love
@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_AUDIO_SOURCE_CACHE_H
+#define LOVE_AUDIO_SOURCE_CACHE_H
+
+// LOVE
+#include "common/int.h"
+#include "common/Object.h"
+#include "thread/threads.h"
+#include "Source.h"
+
+// STD
+#include <list>
+#include <unordered_map>
+
+namespace love
+{
+namespace audio
+{
+
+/**
+ * Keeps static Sources around, keyed by a hash of the audio they were made
+ * from, so identical audio only has to be decoded and uploaded once. New
+ * Sources are clones which share the cached one's decoded data. The least
+ * recently used entries are evicted once the memory budget is exceeded.
+ **/
+class SourceCache
+{
+public:
+
+	SourceCache(size_t budget);
+	~SourceCache();
+
+	/**
+	 * Creates a clone of the Source cached for the hash, or returns null if
+	 * there isn't one.
+	 **/
+	Source *newSource(uint64 hash);
+
+	/**
+	 * Caches a clone of a static Source whose decoded audio takes 'size'
+	 * bytes. Nothing is cached if it doesn't fit in the budget.
+	 **/
+	void add(uint64 hash, Source *source, size_t size);
+
+	void setBudget(size_t budget);
+	size_t getBudget() const;
+
+	/**
+	 * Gets the number of bytes of decoded audio currently cached.
+	 **/
+	size_t getSize() const;
+
+	void clear();
+
+private:
+
+	struct Entry
+	{
+		uint64 hash;
+		StrongRef<Source> source;
+		size_t size;
+	};
+
+	void evict(size_t budget);
+
+	// Most recently used first.
+	std::list<Entry> entries;
+	std::unordered_map<uint64, std::list<Entry>::iterator> lookup;
+
+	size_t budget;
+	size_t size;
+
+	love::thread::MutexRef mutex;
+
+}; // SourceCache
+
+} // audio
+} // love
+
+#endif // LOVE_AUDIO_SOURCE_CACHE_H
@@ -62,6 +62,21 @@ int Audio::getMaxSources() const
 	return 0;
 }
 
+bool Audio::setSoftwareMixing(bool)
+{
+	return false;
+}
+
+bool Audio::isSoftwareMixing() const
+{
+	return false;
+}
+
+int Audio::getVirtualSourceCount() const
+{
+	return 0;
+}
+
 bool Audio::play(love::audio::Source *)
 {
 	return false;
@@ -61,15 +61,21 @@ void Audio::PoolThread::threadFunction()
 			}
 		}
 
-		pool->update();
-		sleep(5);
+		// Sleep until a Source runs out of processed buffers or finishes, or
+		// until something changes the playing Sources.
+		double delay = pool->update();
+		pool->waitForUpdate(delay);
 	}
 }
 
 void Audio::PoolThread::setFinish()
 {
-	thread::Lock lock(mutex);
-	finish = true;
+	{
+		thread::Lock lock(mutex);
+		finish = true;
+	}
+
+	pool->wake();
 }
 
 ALenum Audio::getFormat(int bitDepth, int channels)
@@ -230,6 +236,10 @@ Audio::~Audio()
 	poolThread->setFinish();
 	poolThread->wait();
 
+	// Cached Sources own OpenAL buffers, which have to be freed while the
+	// context still exists.
+	clearSourceCache();
+
 	delete poolThread;
 	delete pool;
 
@@ -282,6 +292,30 @@ int Audio::getMaxSources() const
 	return pool->getMaxSources();
 }
 
+bool Audio::setSoftwareMixing(bool enable)
+{
+	bool wasEnabled = pool->isSoftwareMixing();
+	if (!pool->setSoftwareMixing(enable))
+		return false;
+
+	// Cached Sources were created without the copy of their samples which
+	// software mixing needs.
+	if (enable && !wasEnabled)
+		clearSourceCache();
+
+	return true;
+}
+
+bool Audio::isSoftwareMixing() const
+{
+	return pool->isSoftwareMixing();
+}
+
+int Audio::getVirtualSourceCount() const
+{
+	return pool->getVirtualSourceCount();
+}
+
 bool Audio::play(love::audio::Source *source)
 {
 	return source->play();
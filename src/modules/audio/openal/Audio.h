@@ -84,6 +84,9 @@ class Audio : public love::audio::Audio
 	love::audio::Source *newSource(int sampleRate, int bitDepth, int channels, int buffers);
 	int getActiveSourceCount() const;
 	int getMaxSources() const;
+	bool setSoftwareMixing(bool enable);
+	bool isSoftwareMixing() const;
+	int getVirtualSourceCount() const;
 	bool play(love::audio::Source *source);
 	bool play(const std::vector<love::audio::Source*> &sources);
 	void stop(love::audio::Source *source);
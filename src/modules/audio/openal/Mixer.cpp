@@ -0,0 +1,203 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "Mixer.h"
+#include "Source.h"
+
+// STD
+#include <algorithm>
+
+#if defined(LOVE_SIMD_SSE)
+#include <xmmintrin.h>
+#define LOVE_MIXER_SIMD_SSE
+#elif defined(LOVE_SIMD_NEON)
+#include <arm_neon.h>
+#define LOVE_MIXER_SIMD_NEON
+#endif
+
+namespace love
+{
+namespace audio
+{
+namespace openal
+{
+
+Mixer::Mixer(ALuint source, int sampleRate)
+	: source(source)
+	, sampleRate(sampleRate)
+	, left(BUFFER_FRAMES)
+	, right(BUFFER_FRAMES)
+	, output(BUFFER_FRAMES * 2)
+{
+	alGenBuffers(BUFFER_COUNT, buffers);
+	freeBuffers.assign(buffers, buffers + BUFFER_COUNT);
+
+	// The mix is already panned and attenuated, play it back as-is.
+	float zero[3] = {0.0f, 0.0f, 0.0f};
+	alSourcei(source, AL_BUFFER, AL_NONE);
+	alSourcei(source, AL_SOURCE_RELATIVE, AL_TRUE);
+	alSourcefv(source, AL_POSITION, zero);
+	alSourcefv(source, AL_VELOCITY, zero);
+	alSourcef(source, AL_ROLLOFF_FACTOR, 0.0f);
+	alSourcef(source, AL_PITCH, 1.0f);
+	alSourcef(source, AL_GAIN, 1.0f);
+	alSourcei(source, AL_LOOPING, AL_FALSE);
+}
+
+Mixer::~Mixer()
+{
+	alSourceStop(source);
+	alSourcei(source, AL_BUFFER, AL_NONE);
+	alDeleteBuffers(BUFFER_COUNT, buffers);
+}
+
+double Mixer::update(const std::vector<Source *> &voices, std::vector<Source *> &finished)
+{
+	ALint processed = 0;
+	alGetSourcei(source, AL_BUFFERS_PROCESSED, &processed);
+
+	for (ALint i = 0; i < processed; i++)
+	{
+		ALuint buffer;
+		alSourceUnqueueBuffers(source, 1, &buffer);
+		freeBuffers.push_back(buffer);
+	}
+
+	// Without any voices left the queued buffers are allowed to run dry.
+	while (!freeBuffers.empty() && finished.size() < voices.size())
+	{
+		mix(voices, finished);
+		toInt16(left.data(), right.data(), output.data(), BUFFER_FRAMES);
+
+		ALuint buffer = freeBuffers.back();
+		alBufferData(buffer, AL_FORMAT_STEREO16, output.data(), BUFFER_FRAMES * 2 * sizeof(int16), sampleRate);
+		alSourceQueueBuffers(source, 1, &buffer);
+		freeBuffers.pop_back();
+	}
+
+	ALint queued = 0;
+	alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
+	if (queued == 0)
+		return -1.0;
+
+	// Starts the stream, or restarts it if mixing fell behind and it ran out.
+	ALint state;
+	alGetSourcei(source, AL_SOURCE_STATE, &state);
+	if (state != AL_PLAYING)
+		alSourcePlay(source);
+
+	ALint offset = 0;
+	alGetSourcei(source, AL_SAMPLE_OFFSET, &offset);
+
+	return (BUFFER_FRAMES - offset % BUFFER_FRAMES) / (double) sampleRate;
+}
+
+void Mixer::rewind(const std::vector<Source *> &voices)
+{
+	ALint queued = 0;
+	ALint offset = 0;
+	ALint state = AL_STOPPED;
+	alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
+	alGetSourcei(source, AL_SAMPLE_OFFSET, &offset);
+	alGetSourcei(source, AL_SOURCE_STATE, &state);
+
+	// A stopped stream has played everything it had queued.
+	int pending = 0;
+	if (state == AL_PLAYING || state == AL_PAUSED)
+		pending = std::max(queued * BUFFER_FRAMES - offset, 0);
+
+	alSourceStop(source);
+	alSourcei(source, AL_BUFFER, AL_NONE);
+	freeBuffers.assign(buffers, buffers + BUFFER_COUNT);
+
+	for (Source *voice : voices)
+		voice->rewindVirtual(pending, sampleRate);
+}
+
+void Mixer::mix(const std::vector<Source *> &voices, std::vector<Source *> &finished)
+{
+	std::fill(left.begin(), left.end(), 0.0f);
+	std::fill(right.begin(), right.end(), 0.0f);
+
+	for (Source *voice : voices)
+	{
+		// Voices which ended in an earlier buffer of this update.
+		if (std::find(finished.begin(), finished.end(), voice) != finished.end())
+			continue;
+
+		if (!voice->mixVirtual(left.data(), right.data(), BUFFER_FRAMES, sampleRate))
+			finished.push_back(voice);
+	}
+}
+
+ALuint Mixer::getSource() const
+{
+	return source;
+}
+
+int Mixer::getSampleRate() const
+{
+	return sampleRate;
+}
+
+void Mixer::addScaled(float *dst, const float *src, float gain, int count)
+{
+	int i = 0;
+
+#if defined(LOVE_MIXER_SIMD_SSE)
+
+	__m128 g = _mm_set1_ps(gain);
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 d = _mm_loadu_ps(dst + i);
+		__m128 s = _mm_loadu_ps(src + i);
+		_mm_storeu_ps(dst + i, _mm_add_ps(d, _mm_mul_ps(s, g)));
+	}
+
+#elif defined(LOVE_MIXER_SIMD_NEON)
+
+	for (; i + 4 <= count; i += 4)
+	{
+		float32x4_t d = vld1q_f32(dst + i);
+		float32x4_t s = vld1q_f32(src + i);
+		vst1q_f32(dst + i, vmlaq_n_f32(d, s, gain));
+	}
+
+#endif
+
+	// Remaining samples (or all of them, without SIMD support.)
+	for (; i < count; i++)
+		dst[i] += src[i] * gain;
+}
+
+void Mixer::toInt16(const float *left, const float *right, int16 *dst, int frames)
+{
+	for (int i = 0; i < frames; i++)
+	{
+		float l = std::min(std::max(left[i], -1.0f), 1.0f);
+		float r = std::min(std::max(right[i], -1.0f), 1.0f);
+		dst[i * 2 + 0] = (int16) (l * 32767.0f);
+		dst[i * 2 + 1] = (int16) (r * 32767.0f);
+	}
+}
+
+} // openal
+} // audio
+} // love
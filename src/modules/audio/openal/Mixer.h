@@ -0,0 +1,122 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_AUDIO_OPENAL_MIXER_H
+#define LOVE_AUDIO_OPENAL_MIXER_H
+
+// STD
+#include <vector>
+
+// LOVE
+#include "common/config.h"
+#include "common/int.h"
+
+// OpenAL
+#ifdef LOVE_APPLE_USE_FRAMEWORKS
+#ifdef LOVE_IOS
+#include <OpenAL/alc.h>
+#include <OpenAL/al.h>
+#else
+#include <OpenAL-Soft/alc.h>
+#include <OpenAL-Soft/al.h>
+#endif
+#else
+#include <alc.h>
+#include <al.h>
+#endif
+
+namespace love
+{
+namespace audio
+{
+namespace openal
+{
+
+class Source;
+
+/**
+ * Mixes Sources which don't have an OpenAL source of their own ("virtual"
+ * voices) in software, and streams the result through a single OpenAL
+ * source. Only used by the Pool, with its lock held.
+ **/
+class Mixer
+{
+public:
+
+	// Length of each mixed buffer, in sample frames.
+	static const int BUFFER_FRAMES = 1024;
+
+	// Number of buffers queued on the output source.
+	static const int BUFFER_COUNT = 4;
+
+	Mixer(ALuint source, int sampleRate);
+	~Mixer();
+
+	/**
+	 * Mixes the given virtual voices into every buffer the output source has
+	 * finished playing, and keeps it playing. Voices which reach their end
+	 * are appended to 'finished'.
+	 * @return The time in seconds until the next buffer needs mixing, or a
+	 * negative value if there's nothing left to play.
+	 **/
+	double update(const std::vector<Source *> &voices, std::vector<Source *> &finished);
+
+	/**
+	 * Drops everything that has been mixed but not played yet, and moves the
+	 * given voices back to the position that's actually being heard. The next
+	 * update mixes again from there, so voices can be added or removed
+	 * without waiting for the queued buffers to play out.
+	 **/
+	void rewind(const std::vector<Source *> &voices);
+
+	ALuint getSource() const;
+	int getSampleRate() const;
+
+	/**
+	 * dst[i] += src[i] * gain, for 'count' samples.
+	 **/
+	static void addScaled(float *dst, const float *src, float gain, int count);
+
+	/**
+	 * Interleaves and clamps two float channels into signed 16 bit samples.
+	 **/
+	static void toInt16(const float *left, const float *right, int16 *dst, int frames);
+
+private:
+
+	void mix(const std::vector<Source *> &voices, std::vector<Source *> &finished);
+
+	ALuint source;
+	int sampleRate;
+
+	ALuint buffers[BUFFER_COUNT];
+	std::vector<ALuint> freeBuffers;
+
+	std::vector<float> left;
+	std::vector<float> right;
+	std::vector<int16> output;
+
+}; // Mixer
+
+} // openal
+} // audio
+} // love
+
+#endif // LOVE_AUDIO_OPENAL_MIXER_H
@@ -23,6 +23,8 @@
 #include "event/Event.h"
 #include "Source.h"
 
+#include <algorithm>
+
 namespace love
 {
 namespace audio
@@ -44,7 +46,10 @@ Pool::Pool(ALCdevice *device)
 	: device(device)
 	, sources()
 	, disconnectNotified(false)
+	, wakeRequested(false)
 	, totalSources(0)
+	, mixer(nullptr)
+	, prefetcher(nullptr)
 {
 	// Clear errors.
 	alGetError();
@@ -82,12 +87,17 @@ Pool::Pool(ALCdevice *device)
 
 		available.push(sources[i]);
 	}
+
+	prefetcher = new Prefetcher(this);
 }
 
 Pool::~Pool()
 {
 	Source::stop(this);
 
+	delete mixer;
+	delete prefetcher;
+
 	// Free all sources.
 	alDeleteSources(totalSources, sources);
 }
@@ -112,7 +122,7 @@ bool Pool::isPlaying(Source *s)
 	return p;
 }
 
-void Pool::update()
+double Pool::update()
 {
 #ifndef ALC_CONNECTED
 	constexpr ALCenum ALC_CONNECTED = 0x313;
@@ -161,16 +171,110 @@ void Pool::update()
 
 	for (Source *s : torelease)
 		releaseSource(s);
+
+	double delay = disconnectExtSupported ? DISCONNECT_CHECK_INTERVAL : -1.0;
+
+	if (mixer != nullptr)
+	{
+		rebalance();
+
+		std::vector<Source *> finished;
+		delay = mixer->update(virtualVoices, finished);
+
+		for (Source *s : finished)
+			releaseVirtual(s);
+
+		if (disconnectExtSupported && (delay < 0.0 || delay > DISCONNECT_CHECK_INTERVAL))
+			delay = DISCONNECT_CHECK_INTERVAL;
+	}
+
+	for (const auto &i : playing)
+	{
+		double sourcedelay = i.first->getUpdateDelay();
+		if (sourcedelay >= 0.0 && (delay < 0.0 || sourcedelay < delay))
+			delay = sourcedelay;
+	}
+
+	return delay;
+}
+
+void Pool::wake()
+{
+	thread::Lock lock(mutex);
+	wakeRequested = true;
+	cond->broadcast();
+}
+
+void Pool::waitForUpdate(double seconds)
+{
+	thread::Lock lock(mutex);
+
+	if (!wakeRequested)
+	{
+		if (seconds < 0.0)
+			cond->wait(mutex);
+		else
+			cond->wait(mutex, std::max((int) std::ceil(seconds * 1000.0), 1));
+	}
+
+	wakeRequested = false;
 }
 
 int Pool::getActiveSourceCount() const
 {
-	return (int) playing.size();
+	return (int) (playing.size() + virtualVoices.size());
 }
 
 int Pool::getMaxSources() const
 {
-	return totalSources;
+	// The software mixer's output source can't be used by a Source.
+	return mixer != nullptr ? totalSources - 1 : totalSources;
+}
+
+bool Pool::setSoftwareMixing(bool enable)
+{
+	thread::Lock lock(mutex);
+
+	if (enable == (mixer != nullptr))
+		return true;
+
+	if (enable)
+	{
+		if (available.empty())
+			return false;
+
+		ALCint frequency = 44100;
+		alcGetIntegerv(device, ALC_FREQUENCY, 1, &frequency);
+
+		mixer = new Mixer(available.front(), frequency);
+		available.pop();
+	}
+	else
+	{
+		while (!virtualVoices.empty())
+			releaseVirtual(virtualVoices.back());
+
+		ALuint s = mixer->getSource();
+		delete mixer;
+		mixer = nullptr;
+		available.push(s);
+	}
+
+	wakeRequested = true;
+	cond->broadcast();
+	return true;
+}
+
+bool Pool::isSoftwareMixing() const
+{
+	thread::Lock lock(mutex);
+	return mixer != nullptr;
+}
+
+int Pool::getVirtualSourceCount() const
+{
+	thread::Lock lock(mutex);
+	return (int) virtualVoices.size();
 }
 
 bool Pool::assignSource(Source *source, ALuint &out, char &wasPlaying)
@@ -210,6 +314,111 @@ bool Pool::releaseSource(Source *source, bool stop)
 	return false;
 }
 
+bool Pool::playVirtual(Source *source)
+{
+	if (mixer == nullptr || !source->canPlayVirtual())
+		return false;
+
+	source->playVirtualAtomic();
+	source->retain();
+	virtualVoices.push_back(source);
+
+	wake();
+	return true;
+}
+
+bool Pool::releaseVirtual(Source *source)
+{
+	auto it = std::find(virtualVoices.begin(), virtualVoices.end(), source);
+	if (it == virtualVoices.end())
+		return false;
+
+	virtualVoices.erase(it);
+	source->stopVirtualAtomic();
+	source->release();
+	return true;
+}
+
+void Pool::flushVirtual()
+{
+	if (mixer != nullptr)
+		mixer->rewind(virtualVoices);
+}
+
+bool Pool::promote(Source *source)
+{
+	auto it = std::find(virtualVoices.begin(), virtualVoices.end(), source);
+	if (it == virtualVoices.end() || available.empty())
+		return false;
+
+	// Start the OpenAL source where the mix is being heard, and take the
+	// voice out of the audio which is already queued so it doesn't play
+	// twice.
+	flushVirtual();
+	it = std::find(virtualVoices.begin(), virtualVoices.end(), source);
+
+	ALuint s = available.front();
+	available.pop();
+
+	// The reference held for the virtual voice moves to the playing map. If
+	// playing fails, promoteAtomic stops the Source which releases it.
+	virtualVoices.erase(it);
+	playing.insert(std::make_pair(source, s));
+
+	source->retain();
+	bool success = source->promoteAtomic(s);
+	source->release();
+
+	return success;
+}
+
+void Pool::demote(Source *source)
+{
+	ALuint s;
+	if (!findSource(source, s))
+		return;
+
+	// The virtual voice continues from the OpenAL source's offset, so the
+	// mix has to restart from what's being heard as well.
+	flushVirtual();
+
+	// The reference held for the playing map moves to the virtual voices.
+	source->demoteAtomic();
+	playing.erase(source);
+	available.push(s);
+	virtualVoices.push_back(source);
+}
+
+void Pool::rebalance()
+{
+	while (!virtualVoices.empty())
+	{
+		auto loudest = std::max_element(virtualVoices.begin(), virtualVoices.end(), [](Source *a, Source *b) {
+			return a->getMixGain() < b->getMixGain();
+		});
+
+		Source *source = *loudest;
+
+		if (available.empty())
+		{
+			Source *quietest = nullptr;
+			for (const auto &i : playing)
+			{
+				if (i.first->canPlayVirtual() && (quietest == nullptr || i.first->getMixGain() < quietest->getMixGain()))
+					quietest = i.first;
+			}
+
+			if (quietest == nullptr || source->getMixGain() <= quietest->getMixGain() * PROMOTE_GAIN_RATIO)
+				break;
+
+			demote(quietest);
+		}
+
+		if (!promote(source))
+			break;
+	}
+}
+
 bool Pool::findSource(Source *source, ALuint &out)
 {
 	std::map<Source *, ALuint>::const_iterator i = playing.find(source);
@@ -229,9 +438,11 @@ thread::Lock Pool::lock()
 std::vector<love::audio::Source*> Pool::getPlayingSources()
 {
 	std::vector<love::audio::Source*> sources;
-	sources.reserve(playing.size());
+	sources.reserve(playing.size() + virtualVoices.size());
 	for (auto &i : playing)
 		sources.push_back(i.first);
+	for (Source *s : virtualVoices)
+		sources.push_back(s);
 	return sources;
 }
 
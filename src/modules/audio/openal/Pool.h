@@ -32,6 +32,8 @@
 #include "common/Exception.h"
 #include "thread/threads.h"
 #include "audio/Source.h"
+#include "Prefetcher.h"
+#include "Mixer.h"
 
 // OpenAL
 #ifdef LOVE_APPLE_USE_FRAMEWORKS
@@ -78,11 +80,43 @@ class Pool
 	 **/
 	bool isPlaying(Source *s);
 
-	void update();
+	/**
+	 * Updates all playing Sources.
+	 * @return The time in seconds until the next update is needed, or a
+	 * negative value if nothing needs an update until wake is called.
+	 **/
+	double update();
+
+	/**
+	 * Makes the current or next call to waitForUpdate return immediately.
+	 * Called when a Source's state changes in a way which affects when it
+	 * needs to be updated.
+	 **/
+	void wake();
+
+	/**
+	 * Waits until the given amount of time has passed (forever if negative),
+	 * or until wake is called.
+	 **/
+	void waitForUpdate(double seconds);
 
 	int getActiveSourceCount() const;
 	int getMaxSources() const;
 
+	/**
+	 * Enables or disables mixing static Sources in software when there are
+	 * more of them playing than there are OpenAL sources. Software mixing
+	 * reserves one OpenAL source for its output.
+	 * @return False if no OpenAL source could be reserved.
+	 **/
+	bool setSoftwareMixing(bool enable);
+	bool isSoftwareMixing() const;
+
+	/**
+	 * Gets the number of playing Sources which are mixed in software.
+	 **/
+	int getVirtualSourceCount() const;
+
 private:
 
 	friend class Source;
@@ -98,6 +132,33 @@ class Pool
 	bool assignSource(Source *source, ALuint &out, char &wasPlaying);
 	bool findSource(Source *source, ALuint &out);
 
+	/**
+	 * Starts mixing a Source in software, if software mixing is enabled and
+	 * the Source supports it.
+	 **/
+	bool playVirtual(Source *source);
+	bool releaseVirtual(Source *source);
+
+	/**
+	 * Discards mixed audio which hasn't been played yet, so changes to the
+	 * virtual voices are heard right away instead of after the mixer's
+	 * queued buffers.
+	 **/
+	void flushVirtual();
+
+	// Moves Sources between OpenAL sources and the software mixer.
+	bool promote(Source *source);
+	void demote(Source *source);
+
+	/**
+	 * Gives free OpenAL sources to the loudest virtual voices, and swaps
+	 * virtual voices with clearly quieter ones which have an OpenAL source.
+	 **/
+	void rebalance();
+
+	// How much louder a virtual voice must be to take over an OpenAL source.
+	static constexpr float PROMOTE_GAIN_RATIO = 1.25f;
+
 	// Maximum possible number of OpenAL sources the pool attempts to generate.
 	static const int MAX_SOURCES = 64;
 
@@ -110,6 +171,12 @@ class Pool
 	// Is device disconnection has been notified?
 	bool disconnectNotified;
 
+	// How often device disconnection is checked for, in seconds.
+	static constexpr double DISCONNECT_CHECK_INTERVAL = 0.1;
+
+	// Set by wake, and cleared once waitForUpdate returns.
+	bool wakeRequested;
+
 	// Total number of created sources in the pool.
 	int totalSources;
 
@@ -119,10 +186,22 @@ class Pool
 	// A map of playing sources.
 	std::map<Source *, ALuint> playing;
 
+	// Playing sources which are mixed in software.
+	std::vector<Source *> virtualVoices;
+
+	// Mixes virtualVoices, when software mixing is enabled.
+	Mixer *mixer;
+
 	// Only one thread can access this object at the same time. This mutex will
 	// make sure of that.
 	love::thread::MutexRef mutex;
 
+	// Signalled by wake.
+	love::thread::ConditionalRef cond;
+
+	// Decodes streaming Sources on worker threads.
+	Prefetcher *prefetcher;
+
 }; // Pool
 
 } // openal
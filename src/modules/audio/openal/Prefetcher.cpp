@@ -0,0 +1,270 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "Prefetcher.h"
+#include "Pool.h"
+
+// STD
+#include <algorithm>
+#include <string.h>
+
+namespace love
+{
+namespace audio
+{
+namespace openal
+{
+
+Prefetcher::Stream::Stream(Prefetcher *prefetcher, love::sound::Decoder *decoder, int slotCount)
+	: prefetcher(prefetcher)
+	, decoder(decoder)
+	, slots(std::max(slotCount, 1))
+	, writePos(0)
+	, readPos(0)
+	, looping(false)
+	, decoderFinished(false)
+	, scheduled(false)
+	, starved(false)
+{
+	for (Slot &slot : slots)
+		slot.data.resize(decoder->getSize());
+}
+
+Prefetcher::Stream::~Stream()
+{
+}
+
+int Prefetcher::Stream::getReadyCount() const
+{
+	return (int) (writePos.load(std::memory_order_acquire) - readPos.load(std::memory_order_acquire));
+}
+
+const Prefetcher::Slot *Prefetcher::Stream::front()
+{
+	uint64 read = readPos.load(std::memory_order_relaxed);
+
+	if (writePos.load(std::memory_order_acquire) == read)
+	{
+		if (!decoderFinished || looping)
+		{
+			starved = true;
+			prefetcher->schedule(this);
+		}
+		return nullptr;
+	}
+
+	return &slots[read % slots.size()];
+}
+
+void Prefetcher::Stream::pop()
+{
+	readPos.fetch_add(1, std::memory_order_release);
+
+	if (!decoderFinished || looping)
+		prefetcher->schedule(this);
+}
+
+bool Prefetcher::Stream::decodeSlot()
+{
+	uint64 write = writePos.load(std::memory_order_relaxed);
+
+	// Full.
+	if (write - readPos.load(std::memory_order_acquire) >= slots.size())
+		return false;
+
+	Slot &slot = slots[write % slots.size()];
+
+	if (decoderFinished)
+	{
+		if (!looping)
+			return false;
+
+		// Looping was enabled after the end of the stream was reached.
+		decoder->rewind();
+		decoderFinished = false;
+
+		slot.size = 0;
+		slot.looped = true;
+	}
+	else
+	{
+		int decoded = std::max(decoder->decode(), 0);
+		bool finished = decoder->isFinished();
+
+		// Probably a decoding error, try again later.
+		if (decoded == 0 && !finished)
+			return false;
+
+		if (decoded > 0)
+			memcpy(slot.data.data(), decoder->getBuffer(), std::min(decoded, (int) slot.data.size()));
+
+		slot.size = std::min(decoded, (int) slot.data.size());
+		slot.looped = false;
+
+		if (finished)
+		{
+			if (looping)
+			{
+				decoder->rewind();
+				slot.looped = true;
+			}
+			else
+			{
+				decoderFinished = true;
+				if (decoded == 0)
+					return false;
+			}
+		}
+	}
+
+	writePos.store(write + 1, std::memory_order_release);
+	return true;
+}
+
+void Prefetcher::Stream::fill()
+{
+	{
+		thread::Lock lock(decoderMutex);
+		while (decodeSlot());
+	}
+
+	// The Pool lock is taken before the decoder lock elsewhere, so this has
+	// to happen after the decoder lock is released.
+	if (starved.exchange(false) && getReadyCount() > 0)
+		prefetcher->pool->wake();
+}
+
+void Prefetcher::Stream::prime(int count)
+{
+	thread::Lock lock(decoderMutex);
+
+	while (getReadyCount() < count && decodeSlot());
+}
+
+void Prefetcher::Stream::reset()
+{
+	readPos.store(writePos.load(std::memory_order_relaxed), std::memory_order_release);
+	decoderFinished = false;
+	starved = false;
+}
+
+void Prefetcher::Stream::seek(double offset)
+{
+	thread::Lock lock(decoderMutex);
+	decoder->seek(offset);
+	reset();
+}
+
+void Prefetcher::Stream::rewind()
+{
+	thread::Lock lock(decoderMutex);
+	decoder->rewind();
+	reset();
+}
+
+bool Prefetcher::Stream::isFinished() const
+{
+	return decoderFinished && getReadyCount() == 0;
+}
+
+void Prefetcher::Stream::setLooping(bool looping)
+{
+	this->looping = looping;
+}
+
+thread::Lock Prefetcher::Stream::lockDecoder()
+{
+	return thread::Lock(decoderMutex);
+}
+
+Prefetcher::Worker::Worker(Prefetcher *prefetcher)
+	: prefetcher(prefetcher)
+{
+	threadName = "AudioDecode";
+}
+
+void Prefetcher::Worker::threadFunction()
+{
+	while (true)
+	{
+		StrongRef<Stream> stream;
+
+		{
+			thread::Lock lock(prefetcher->mutex);
+
+			while (prefetcher->work.empty() && !prefetcher->finish)
+				prefetcher->cond->wait(prefetcher->mutex);
+
+			if (prefetcher->finish)
+				return;
+
+			stream = prefetcher->work.front();
+			prefetcher->work.pop();
+		}
+
+		// Cleared before decoding, so a Slot popped while this is running
+		// schedules the Stream again instead of being missed.
+		stream->scheduled = false;
+		stream->fill();
+	}
+}
+
+Prefetcher::Prefetcher(Pool *pool)
+	: pool(pool)
+	, finish(false)
+{
+	int count = love::thread::getWorkerThreadCount(MAX_WORKERS);
+
+	for (int i = 0; i < count; i++)
+	{
+		Worker *worker = new Worker(this);
+		worker->start();
+		workers.push_back(worker);
+	}
+}
+
+Prefetcher::~Prefetcher()
+{
+	{
+		thread::Lock lock(mutex);
+		finish = true;
+		cond->broadcast();
+	}
+
+	for (Worker *worker : workers)
+	{
+		worker->wait();
+		delete worker;
+	}
+}
+
+void Prefetcher::schedule(Stream *stream)
+{
+	if (stream->scheduled.exchange(true))
+		return;
+
+	thread::Lock lock(mutex);
+	work.push(stream);
+	cond->signal();
+}
+
+} // openal
+} // audio
+} // love
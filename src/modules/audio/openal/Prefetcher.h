@@ -0,0 +1,192 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_AUDIO_OPENAL_PREFETCHER_H
+#define LOVE_AUDIO_OPENAL_PREFETCHER_H
+
+// LOVE
+#include "common/config.h"
+#include "common/int.h"
+#include "common/Object.h"
+#include "sound/Decoder.h"
+#include "thread/threads.h"
+
+// STD
+#include <atomic>
+#include <queue>
+#include <vector>
+
+namespace love
+{
+namespace audio
+{
+namespace openal
+{
+
+class Pool;
+
+/**
+ * Decodes streaming Sources ahead of time on a set of worker threads, so a
+ * slow Decoder doesn't hold up the Pool thread (and every other Source).
+ **/
+class Prefetcher
+{
+public:
+
+	/**
+	 * A block of decoded data, the size of the Decoder's buffer.
+	 **/
+	struct Slot
+	{
+		std::vector<char> data;
+		int size = 0;
+
+		// Whether the Decoder was rewound after this block for looping.
+		bool looped = false;
+	};
+
+	/**
+	 * The decoded data of a single streaming Source. It's a ring of Slots
+	 * which is filled by whichever thread holds the decoder lock (normally a
+	 * worker) and drained by the thread holding the Pool lock.
+	 **/
+	class Stream : public love::Object
+	{
+	public:
+
+		Stream(Prefetcher *prefetcher, love::sound::Decoder *decoder, int slotCount);
+		virtual ~Stream();
+
+		/**
+		 * Gets the oldest decoded Slot, or null if none is ready. A worker is
+		 * scheduled to decode more if there's room.
+		 **/
+		const Slot *front();
+
+		/**
+		 * Frees the Slot returned by front so it can be decoded into again.
+		 **/
+		void pop();
+
+		/**
+		 * Decodes on the calling thread until at least 'count' Slots are ready,
+		 * or the end of the stream is reached.
+		 **/
+		void prime(int count);
+
+		/**
+		 * Seeks or rewinds the Decoder and throws away all decoded data.
+		 **/
+		void seek(double offset);
+		void rewind();
+
+		/**
+		 * Whether the Decoder has finished and all of its data was popped.
+		 **/
+		bool isFinished() const;
+
+		void setLooping(bool looping);
+
+		/**
+		 * Waits for any in-progress decode and keeps workers from using the
+		 * Decoder while the returned Lock exists.
+		 **/
+		LOVE_WARN_UNUSED thread::Lock lockDecoder();
+
+	private:
+
+		friend class Prefetcher;
+
+		// Decodes into the next free Slot. The decoder lock must be held.
+		bool decodeSlot();
+		void fill();
+		void reset();
+
+		int getReadyCount() const;
+
+		Prefetcher *prefetcher;
+		StrongRef<love::sound::Decoder> decoder;
+
+		std::vector<Slot> slots;
+
+		// Total number of Slots written and read. Only changed by the thread
+		// holding the decoder lock and the Pool lock, respectively.
+		std::atomic<uint64> writePos;
+		std::atomic<uint64> readPos;
+
+		std::atomic<bool> looping;
+		std::atomic<bool> decoderFinished;
+
+		// Whether the Stream is in (or being processed from) the work queue.
+		std::atomic<bool> scheduled;
+
+		// Set when front found nothing ready, so the worker wakes the Pool
+		// thread as soon as there's data.
+		std::atomic<bool> starved;
+
+		love::thread::MutexRef decoderMutex;
+
+	}; // Stream
+
+	Prefetcher(Pool *pool);
+	~Prefetcher();
+
+	/**
+	 * Queues the Stream to be decoded by a worker, unless it already is.
+	 **/
+	void schedule(Stream *stream);
+
+private:
+
+	class Worker : public thread::Threadable
+	{
+	public:
+
+		Worker(Prefetcher *prefetcher);
+		virtual ~Worker() {}
+
+		void threadFunction() override;
+
+	private:
+
+		Prefetcher *prefetcher;
+
+	}; // Worker
+
+	// Upper limit on the number of worker threads.
+	static const int MAX_WORKERS = 4;
+
+	Pool *pool;
+
+	std::vector<Worker *> workers;
+
+	std::queue<StrongRef<Stream>> work;
+	bool finish;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef cond;
+
+}; // Prefetcher
+
+} // openal
+} // audio
+} // love
+
+#endif // LOVE_AUDIO_OPENAL_PREFETCHER_H
@@ -22,11 +22,14 @@
 #include "Filter.h"
 #include "Pool.h"
 #include "Audio.h"
+#include "Mixer.h"
 #include "common/math.h"
+#include "common/int.h"
 
 // STD
 #include <iostream>
 #include <algorithm>
+#include <cmath>
 
 #define audiomodule() (Module::getInstance<Audio>(Module::M_AUDIO))
 
@@ -106,11 +109,29 @@ class QueueLoopingException : public love::Exception
 
 };
 
-StaticDataBuffer::StaticDataBuffer(ALenum format, const ALvoid *data, ALsizei size, ALsizei freq)
+StaticDataBuffer::StaticDataBuffer(ALenum format, const ALvoid *data, ALsizei size, ALsizei freq, int channels, int bitDepth, bool keepSamples)
 	: size(size)
 {
 	alGenBuffers(1, &buffer);
 	alBufferData(buffer, format, data, size, freq);
+
+	if (!keepSamples || channels > 2)
+		return;
+
+	int frames = size / (channels * (bitDepth / 8));
+	for (int c = 0; c < channels; c++)
+		samples[c].resize(frames);
+
+	for (int i = 0; i < frames; i++)
+	{
+		for (int c = 0; c < channels; c++)
+		{
+			if (bitDepth == 16)
+				samples[c][i] = ((const int16 *) data)[i * channels + c] / 32768.0f;
+			else
+				samples[c][i] = (((const uint8 *) data)[i * channels + c] - 128) / 128.0f;
+		}
+	}
 }
 
 StaticDataBuffer::~StaticDataBuffer()
@@ -129,7 +150,7 @@ Source::Source(Pool *pool, love::sound::SoundData *soundData)
 	if (fmt == AL_NONE)
 		throw InvalidFormatException(soundData->getChannelCount(), soundData->getBitDepth());
 
-	staticBuffer.set(new StaticDataBuffer(fmt, soundData->getData(), (ALsizei) soundData->getSize(), sampleRate), Acquire::NORETAIN);
+	staticBuffer.set(new StaticDataBuffer(fmt, soundData->getData(), (ALsizei) soundData->getSize(), sampleRate, channels, bitDepth, pool->isSoftwareMixing()), Acquire::NORETAIN);
 
 	float z[3] = {0, 0, 0};
 
@@ -166,6 +187,8 @@ Source::Source(Pool *pool, love::sound::Decoder *decoder)
 		}
 	}
 
+	prefetch.set(new Prefetcher::Stream(pool->prefetcher, decoder, buffers), Acquire::NORETAIN);
+
 	float z[3] = {0, 0, 0};
 
 	setFloatv(position, z);
@@ -242,7 +265,10 @@ Source::Source(const Source &s)
 	if (sourceType == TYPE_STREAM)
 	{
 		if (s.decoder.get())
+		{
+			auto lock = s.prefetch->lockDecoder();
 			decoder.set(s.decoder->clone(), Acquire::NORETAIN);
+		}
 	}
 	if (sourceType != TYPE_STATIC)
 	{
@@ -260,6 +286,12 @@ Source::Source(const Source &s)
 		}
 	}
 
+	if (decoder.get())
+	{
+		prefetch.set(new Prefetcher::Stream(pool->prefetcher, decoder.get(), buffers), Acquire::NORETAIN);
+		prefetch->setLooping(looping);
+	}
+
 	if (s.directfilter)
 		directfilter = s.directfilter->clone();
 
@@ -328,9 +360,26 @@ bool Source::play()
 	Lock l = pool->lock();
 	ALuint out;
 
+	if (virtualVoice)
+	{
+		if (virtualPaused)
+			pool->flushVirtual();
+		virtualPaused = false;
+		pool->wake();
+		return true;
+	}
+
 	char wasPlaying;
 	if (!pool->assignSource(this, out, wasPlaying))
+	{
+		// Mixed in software until an OpenAL source frees up, if possible.
+		if (pool->playVirtual(this))
+			return true;
+
 		return valid = false;
+	}
+
+	pool->wake();
 
 	if (!wasPlaying)
 		return valid = playAtomic(out);
@@ -341,22 +390,42 @@ bool Source::play()
 
 void Source::stop()
 {
-	if (!valid)
+	if (!valid && !virtualVoice)
 		return;
 
 	Lock l = pool->lock();
-	pool->releaseSource(this);
+	if (virtualVoice)
+	{
+		// Cut the voice out of the audio the mixer has already queued.
+		pool->flushVirtual();
+		pool->releaseVirtual(this);
+	}
+	else
+		pool->releaseSource(this);
+	pool->wake();
 }
 
 void Source::pause()
 {
 	Lock l = pool->lock();
-	if (pool->isPlaying(this))
+	if (virtualVoice)
+	{
+		if (!virtualPaused)
+		{
+			pool->flushVirtual();
+			pool->wake();
+		}
+		virtualPaused = true;
+	}
+	else if (pool->isPlaying(this))
 		pauseAtomic();
 }
 
 bool Source::isPlaying() const
 {
+	if (virtualVoice)
+		return !virtualPaused;
+
 	if (!valid)
 		return false;
 
@@ -370,7 +439,7 @@ bool Source::isFinished() const
 	if (!valid)
 		return false;
 
-	if (sourceType == TYPE_STREAM && (isLooping() || !decoder->isFinished()))
+	if (sourceType == TYPE_STREAM && (isLooping() || !prefetch->isFinished()))
 		return false;
 
 	ALenum state;
@@ -419,7 +488,7 @@ bool Source::update()
 
 					offsetSamples += (curOffsetSamples - newOffsetSamples);
 
-					if (streamAtomic(buffer, decoder.get()) > 0)
+					if (streamAtomic(buffer) > 0)
 						alSourceQueueBuffers(source, 1, &buffer);
 					else
 						unusedBuffers.push(buffer);
@@ -428,7 +497,7 @@ bool Source::update()
 				while (!unusedBuffers.empty())
 				{
 					ALuint b = unusedBuffers.top();
-					if (streamAtomic(b, decoder.get()) > 0)
+					if (streamAtomic(b) > 0)
 					{
 						alSourceQueueBuffers(source, 1, &b);
 						unusedBuffers.pop();
@@ -464,10 +533,54 @@ bool Source::update()
 	return false;
 }
 
+double Source::getUpdateDelay() const
+{
+	if (!valid)
+		return -1.0;
+
+	ALenum state;
+	alGetSourcei(source, AL_SOURCE_STATE, &state);
+
+	// Paused and stopped Sources don't consume buffers.
+	if (state != AL_PLAYING)
+		return -1.0;
+
+	if (sourceType == TYPE_QUEUE)
+		return QUEUE_UPDATE_DELAY;
+
+	ALint offset = 0;
+	alGetSourcei(source, AL_SAMPLE_OFFSET, &offset);
+
+	ALfloat curpitch = 1.0f;
+	alGetSourcef(source, AL_PITCH, &curpitch);
+
+	int framesize = channels * (bitDepth / 8);
+	double samplerate = (double) sampleRate * std::max(curpitch, 0.001f);
+
+	if (sourceType == TYPE_STATIC)
+	{
+		// Looping static Sources are handled entirely by OpenAL.
+		if (isLooping())
+			return -1.0;
+
+		int samples = (int) (staticBuffer->getSize() / framesize);
+		return std::max(samples - offset, 0) / samplerate;
+	}
+
+	// Streaming buffers are filled with the decoder's buffer size, and the
+	// processed ones are unqueued in update, so the sample offset is within
+	// the first queued buffer. It needs to be refilled once that's done.
+	int buffersamples = std::max((int) (decoder->getSize() / framesize), 1);
+	return (buffersamples - (offset % buffersamples)) / samplerate;
+}
+
 void Source::setPitch(float pitch)
 {
 	if (valid)
+	{
 		alSourcef(source, AL_PITCH, pitch);
+		pool->wake();
+	}
 
 	this->pitch = pitch;
 }
@@ -535,6 +648,11 @@ void Source::seek(double offset, Source::Unit unit)
 				alSourcei(source, AL_SAMPLE_OFFSET, offsetSamples);
 				offsetSamples = offsetSeconds = 0;
 			}
+			else if (virtualVoice)
+			{
+				virtualOffset = offsetSamples;
+				offsetSamples = offsetSeconds = 0;
+			}
 			break;
 		case TYPE_STREAM:
 		{
@@ -542,7 +660,7 @@ void Source::seek(double offset, Source::Unit unit)
 			if (valid)
 				stop();
 
-			decoder->seek(offsetSeconds);
+			prefetch->seek(offsetSeconds);
 
 			if (wasPlaying)
 				play();
@@ -580,6 +698,8 @@ void Source::seek(double offset, Source::Unit unit)
 			break;
 	}
 
+	pool->wake();
+
 	if (wasPlaying && (alGetError() == AL_INVALID_VALUE || (sourceType == TYPE_STREAM && !isPlaying())))
 	{
 		stop();
@@ -599,6 +719,8 @@ double Source::tell(Source::Unit unit)
 
 	if (valid)
 		alGetSourcei(source, AL_SAMPLE_OFFSET, &offset);
+	else if (virtualVoice)
+		offset = (int) virtualOffset;
 
 	offset += offsetSamples;
 
@@ -626,6 +748,7 @@ double Source::getDuration(Unit unit)
 	}
 	case TYPE_STREAM:
 	{
+		auto lock = prefetch->lockDecoder();
 		double seconds = decoder->getDuration();
 
 		if (unit == UNIT_SECONDS)
@@ -771,7 +894,13 @@ void Source::setLooping(bool enable)
 		throw QueueLoopingException();
 
 	if (valid && sourceType == TYPE_STATIC)
+	{
 		alSourcei(source, AL_LOOPING, enable ? AL_TRUE : AL_FALSE);
+		pool->wake();
+	}
+
+	if (prefetch.get())
+		prefetch->setLooping(enable);
 
 	looping = enable;
 }
@@ -842,17 +971,18 @@ void Source::prepareAtomic()
 		alSourcei(source, AL_BUFFER, staticBuffer->getBuffer());
 		break;
 	case TYPE_STREAM:
+		// Decode enough to fill every buffer before playing starts. The
+		// Prefetcher's workers keep ahead of playback after that.
+		prefetch->prime((int) unusedBuffers.size());
+
 		while (!unusedBuffers.empty())
 		{
 			auto b = unusedBuffers.top();
-			if (streamAtomic(b, decoder.get()) == 0)
+			if (streamAtomic(b) == 0)
 				break;
 
 			alSourceQueueBuffers(source, 1, &b);
 			unusedBuffers.pop();
-
-			if (decoder->isFinished())
-				break;
 		}
 		break;
 	case TYPE_QUEUE:
@@ -884,7 +1014,7 @@ void Source::teardownAtomic()
 		ALuint buffers[MAX_BUFFERS];
 
 		// Some decoders (e.g. ModPlug) can rewind() more reliably than seek(0).
-		decoder->rewind();
+		prefetch->rewind();
 
 		// Drain buffers.
 		// NOTE: The Apple implementation of OpenAL on iOS doesn't return
@@ -978,6 +1108,170 @@ void Source::resumeAtomic()
 	}
 }
 
+bool Source::canPlayVirtual() const
+{
+	return sourceType == TYPE_STATIC && staticBuffer->hasSamples();
+}
+
+bool Source::isVirtual() const
+{
+	return virtualVoice;
+}
+
+float Source::getMixGain() const
+{
+	return std::min(std::max(volume, minVolume), maxVolume);
+}
+
+bool Source::mixVirtual(float *left, float *right, int frames, int outputRate)
+{
+	if (virtualPaused)
+		return true;
+
+	const StaticDataBuffer *buffer = staticBuffer.get();
+	const float *l = buffer->getSamples(0);
+	const float *r = buffer->getSamples(1);
+	int total = buffer->getFrameCount();
+
+	if (total <= 0)
+		return false;
+
+	float gain = getMixGain();
+	double step = (double) sampleRate * pitch / (double) outputRate;
+	double pos = virtualOffset;
+
+	if (step == 1.0 && pos == std::floor(pos))
+	{
+		// Same rate: add whole runs of samples at a time.
+		int i = 0;
+		while (i < frames)
+		{
+			if (pos >= total)
+			{
+				if (!looping)
+				{
+					virtualOffset = pos;
+					return false;
+				}
+				pos = 0.0;
+			}
+
+			int p = (int) pos;
+			int count = std::min(frames - i, total - p);
+
+			Mixer::addScaled(left + i, l + p, gain, count);
+			Mixer::addScaled(right + i, r + p, gain, count);
+
+			i += count;
+			pos += count;
+		}
+	}
+	else
+	{
+		// Linear interpolation for differing rates and pitch.
+		for (int i = 0; i < frames; i++)
+		{
+			if (pos >= total)
+			{
+				if (!looping)
+				{
+					virtualOffset = pos;
+					return false;
+				}
+				pos = std::fmod(pos, (double) total);
+			}
+
+			int p0 = (int) pos;
+			int p1 = p0 + 1 < total ? p0 + 1 : (looping ? 0 : p0);
+			float t = (float) (pos - p0);
+
+			left[i] += (l[p0] + (l[p1] - l[p0]) * t) * gain;
+			right[i] += (r[p0] + (r[p1] - r[p0]) * t) * gain;
+
+			pos += step;
+		}
+	}
+
+	virtualOffset = pos;
+	virtualMixed += frames;
+	return true;
+}
+
+void Source::rewindVirtual(int frames, int outputRate)
+{
+	// Only the part of the discarded audio which this voice was mixed into.
+	frames = std::min(frames, virtualMixed);
+	virtualMixed = 0;
+
+	if (frames <= 0)
+		return;
+
+	int total = staticBuffer->getFrameCount();
+	double step = (double) sampleRate * pitch / (double) outputRate;
+	double pos = virtualOffset - frames * step;
+
+	if (pos < 0.0)
+	{
+		if (looping && total > 0)
+			pos = std::fmod(pos, (double) total) + total;
+		else
+			pos = 0.0;
+	}
+
+	virtualOffset = pos;
+}
+
+void Source::playVirtualAtomic()
+{
+	virtualVoice = true;
+	virtualPaused = false;
+	virtualMixed = 0;
+
+	// Start from the pending offset, like playAtomic.
+	virtualOffset = offsetSamples;
+	offsetSamples = 0;
+}
+
+void Source::stopVirtualAtomic()
+{
+	virtualVoice = false;
+	virtualPaused = false;
+	virtualOffset = 0.0;
+	virtualMixed = 0;
+}
+
+void Source::demoteAtomic()
+{
+	ALint offset = 0;
+	ALint state = AL_PLAYING;
+	alGetSourcei(source, AL_SAMPLE_OFFSET, &offset);
+	alGetSourcei(source, AL_SOURCE_STATE, &state);
+
+	stopAtomic();
+
+	virtualVoice = true;
+	virtualPaused = state == AL_PAUSED;
+	virtualOffset = offset;
+	virtualMixed = 0;
+}
+
+bool Source::promoteAtomic(ALuint source)
+{
+	bool paused = virtualPaused;
+	offsetSamples = (int) virtualOffset;
+
+	stopVirtualAtomic();
+
+	if (!playAtomic(source))
+		return false;
+
+	valid = true;
+	if (paused)
+		pauseAtomic();
+
+	return true;
+}
+
 bool Source::play(const std::vector<love::audio::Source*> &sources)
 {
 	if (sources.size() == 0)
@@ -989,23 +1283,54 @@ bool Source::play(const std::vector<love::audio::Source*> &sources)
 	// NOTE: not bool, because std::vector<bool> is implemented as a bitvector
 	// which means no bool references can be created.
 	std::vector<char> wasPlaying(sources.size());
+	std::vector<char> isVirtual(sources.size());
 	std::vector<ALuint> ids(sources.size());
 
 	for (size_t i = 0; i < sources.size(); i++)
 	{
-		if (!pool->assignSource((Source*) sources[i], ids[i], wasPlaying[i]))
+		Source *source = (Source*) sources[i];
+
+		if (source->virtualVoice)
+		{
+			isVirtual[i] = wasPlaying[i] = true;
+			continue;
+		}
+
+		if (!pool->assignSource(source, ids[i], wasPlaying[i]))
 		{
+			// Mixed in software until an OpenAL source frees up, if possible.
+			if (pool->playVirtual(source))
+			{
+				isVirtual[i] = true;
+				continue;
+			}
+
 			for (size_t j = 0; j < i; j++)
-				if (!wasPlaying[j])
+			{
+				if (wasPlaying[j])
+					continue;
+				else if (isVirtual[j])
+					pool->releaseVirtual((Source*) sources[j]);
+				else
 					pool->releaseSource((Source*) sources[j], false);
+			}
 			return false;
 		}
 	}
 
 	std::vector<ALuint> toPlay;
 	toPlay.reserve(sources.size());
+	bool flushVirtual = false;
 	for (size_t i = 0; i < sources.size(); i++)
 	{
+		if (isVirtual[i])
+		{
+			Source *source = (Source*) sources[i];
+			flushVirtual = flushVirtual || source->virtualPaused;
+			source->virtualPaused = false;
+			continue;
+		}
+
 		// If the source was paused, wasPlaying[i] will be true but we still
 		// want to resume it. We don't want to call alSourcePlay on sources
 		// that are actually playing though.
@@ -1023,12 +1348,23 @@ bool Source::play(const std::vector<love::audio::Source*> &sources)
 	}
 
 	alGetError();
-	alSourcePlayv((ALsizei) toPlay.size(), &toPlay[0]);
+	if (!toPlay.empty())
+		alSourcePlayv((ALsizei) toPlay.size(), &toPlay[0]);
 	bool success = alGetError() == AL_NO_ERROR;
 
-	for (auto &_source : sources)
+	// Resumed virtual voices start with the next mixed buffer instead of
+	// after the ones which are already queued.
+	if (flushVirtual)
+		pool->flushVirtual();
+
+	pool->wake();
+
+	for (size_t i = 0; i < sources.size(); i++)
 	{
-		Source *source = (Source*) _source;
+		Source *source = (Source*) sources[i];
+		if (isVirtual[i])
+			continue;
+
 		source->valid = source->valid || success;
 
 		if (success && source->sourceType != TYPE_STREAM)
@@ -1048,22 +1384,38 @@ void Source::stop(const std::vector<love::audio::Source*> &sources)
 
 	std::vector<ALuint> sourceIds;
 	sourceIds.reserve(sources.size());
+	bool flushVirtual = false;
 	for (auto &_source : sources)
 	{
 		Source *source = (Source*) _source;
 		if (source->valid)
 			sourceIds.push_back(source->source);
+		else if (source->virtualVoice)
+			flushVirtual = true;
 	}
 
-	alSourceStopv((ALsizei) sourceIds.size(), &sourceIds[0]);
+	if (!sourceIds.empty())
+		alSourceStopv((ALsizei) sourceIds.size(), &sourceIds[0]);
+
+	// Cut stopped virtual voices out of the audio the mixer has already queued.
+	if (flushVirtual)
+		pool->flushVirtual();
 
 	for (auto &_source : sources)
 	{
 		Source *source = (Source*) _source;
+		if (source->virtualVoice)
+		{
+			pool->releaseVirtual(source);
+			continue;
+		}
+
 		if (source->valid)
 			source->teardownAtomic();
 		pool->releaseSource(source, false);
 	}
+
+	pool->wake();
 }
 
 void Source::pause(const std::vector<love::audio::Source*> &sources)
@@ -1071,18 +1423,38 @@ void Source::pause(const std::vector<love::audio::Source*> &sources)
 	if (sources.size() == 0)
 		return;
 
-	Lock l = ((Source*) sources[0])->pool->lock();
+	Pool *pool = ((Source*) sources[0])->pool;
+	Lock l = pool->lock();
 
 	std::vector<ALuint> sourceIds;
 	sourceIds.reserve(sources.size());
+	bool flushVirtual = false;
 	for (auto &_source : sources)
 	{
 		Source *source = (Source*) _source;
 		if (source->valid)
 			sourceIds.push_back(source->source);
+		else if (source->virtualVoice && !source->virtualPaused)
+			flushVirtual = true;
 	}
 
-	alSourcePausev((ALsizei) sourceIds.size(), &sourceIds[0]);
+	if (!sourceIds.empty())
+		alSourcePausev((ALsizei) sourceIds.size(), &sourceIds[0]);
+
+	// Rewind to what's being heard before pausing, so nothing more of the
+	// paused voices is played and they resume from the same point.
+	if (flushVirtual)
+	{
+		pool->flushVirtual();
+		pool->wake();
+	}
+
+	for (auto &_source : sources)
+	{
+		Source *source = (Source*) _source;
+		if (source->virtualVoice)
+			source->virtualPaused = true;
+	}
 }
 
 std::vector<love::audio::Source*> Source::pause(Pool *pool)
@@ -1144,22 +1516,29 @@ void Source::setFloatv(float *dst, const float *src) const
 	dst[2] = src[2];
 }
 
-int Source::streamAtomic(ALuint buffer, love::sound::Decoder *d)
+int Source::streamAtomic(ALuint buffer)
 {
-	// Get more sound data.
-	int decoded = std::max(d->decode(), 0);
+	// Get more sound data, which was decoded ahead of time by a worker.
+	const Prefetcher::Slot *slot = prefetch->front();
+	if (slot == nullptr)
+		return 0;
+
+	int decoded = slot->size;
+	bool looped = slot->looped;
 
 	// OpenAL implementations are allowed to ignore 0-size alBufferData calls.
 	if (decoded > 0)
 	{
-		int fmt = Audio::getFormat(d->getBitDepth(), d->getChannelCount());
+		int fmt = Audio::getFormat(bitDepth, channels);
 
 		if (fmt != AL_NONE)
-			alBufferData(buffer, fmt, d->getBuffer(), decoded, d->getSampleRate());
+			alBufferData(buffer, fmt, slot->data.data(), decoded, sampleRate);
 		else
 			decoded = 0;
 	}
 
+	prefetch->pop();
+
 	// This shouldn't run after toLoop is calculated in this streamAtomic call,
 	// otherwise it'll decrease too quickly.
 	// TODO: this code is hard to understand, can it be made more clear?
@@ -1173,7 +1552,8 @@ int Source::streamAtomic(ALuint buffer, love::sound::Decoder *d)
 		}
 	}
 
-	if (decoder->isFinished() && isLooping())
+	// The worker already rewound the decoder after this data.
+	if (looped)
 	{
 		int queued, processed;
 		alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
@@ -1182,7 +1562,6 @@ int Source::streamAtomic(ALuint buffer, love::sound::Decoder *d)
 			toLoop = queued-processed;
 		else
 			toLoop = buffers-processed;
-		d->rewind();
 	}
 
 	return decoded;
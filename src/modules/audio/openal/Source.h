@@ -30,6 +30,7 @@
 #include "sound/Decoder.h"
 #include "Audio.h"
 #include "Filter.h"
+#include "Prefetcher.h"
 
 // STL
 #include <vector>
@@ -74,7 +75,11 @@ class StaticDataBuffer : public love::Object
 {
 public:
 
-	StaticDataBuffer(ALenum format, const ALvoid *data, ALsizei size, ALsizei freq);
+	/**
+	 * @param keepSamples Also keeps a float copy of mono or stereo data in
+	 * memory, so Sources using it can be mixed in software.
+	 **/
+	StaticDataBuffer(ALenum format, const ALvoid *data, ALsizei size, ALsizei freq, int channels, int bitDepth, bool keepSamples);
 	virtual ~StaticDataBuffer();
 
 	inline ALuint getBuffer() const
@@ -87,11 +92,30 @@ class StaticDataBuffer : public love::Object
 		return size;
 	}
 
+	inline bool hasSamples() const
+	{
+		return !samples[0].empty();
+	}
+
+	// Stereo data has its own right channel, mono data reuses the left one.
+	inline const float *getSamples(int channel) const
+	{
+		return samples[channel].empty() ? samples[0].data() : samples[channel].data();
+	}
+
+	inline int getFrameCount() const
+	{
+		return (int) samples[0].size();
+	}
+
 private:
 
 	ALuint buffer;
 	ALsizei size;
 
+	// Planar copy of the sample data for software mixing, if kept.
+	std::vector<float> samples[2];
+
 }; // StaticDataBuffer
 
 class Source : public love::audio::Source
@@ -111,6 +135,13 @@ class Source : public love::audio::Source
 	virtual bool isPlaying() const;
 	virtual bool isFinished() const;
 	virtual bool update();
+
+	/**
+	 * Gets the time in seconds until this Source needs to be updated again,
+	 * or a negative value if it doesn't need an update until its state
+	 * changes.
+	 **/
+	double getUpdateDelay() const;
 	virtual void setPitch(float pitch);
 	virtual float getPitch() const;
 	virtual void setVolume(float volume);
@@ -160,6 +191,38 @@ class Source : public love::audio::Source
 	void prepareAtomic();
 	void teardownAtomic();
 
+	/**
+	 * Whether this Source can be mixed in software when there are no free
+	 * OpenAL sources.
+	 **/
+	bool canPlayVirtual() const;
+	bool isVirtual() const;
+
+	/**
+	 * The volume used to decide which Sources get OpenAL sources, when they
+	 * can't all have one.
+	 **/
+	float getMixGain() const;
+
+	/**
+	 * Adds this virtual voice to the given buffers and advances its offset.
+	 * @return False once a non-looping Source reaches its end.
+	 **/
+	bool mixVirtual(float *left, float *right, int frames, int outputRate);
+
+	/**
+	 * Moves this virtual voice back by up to 'frames' output frames, for
+	 * mixed audio which is discarded before it was played.
+	 **/
+	void rewindVirtual(int frames, int outputRate);
+
+	void playVirtualAtomic();
+	void stopVirtualAtomic();
+
+	// Moves between an OpenAL source and software mixing at the same offset.
+	void demoteAtomic();
+	bool promoteAtomic(ALuint source);
+
 	bool playAtomic(ALuint source);
 	void stopAtomic();
 	void pauseAtomic();
@@ -178,12 +241,23 @@ class Source : public love::audio::Source
 
 	void setFloatv(float *dst, const float *src) const;
 
-	int streamAtomic(ALuint buffer, love::sound::Decoder *d);
+	int streamAtomic(ALuint buffer);
 
 	Pool *pool = nullptr;
 	ALuint source = 0;
 	bool valid = false;
 
+	// Mixed in software by the Pool instead of playing on an OpenAL source.
+	bool virtualVoice = false;
+	bool virtualPaused = false;
+	double virtualOffset = 0.0;
+
+	// Output frames mixed since the voice started or was last rewound.
+	int virtualMixed = 0;
+
+	// Update interval for queueable Sources, whose buffers can be any size.
+	static constexpr double QUEUE_UPDATE_DELAY = 0.005;
+
 	const static int DEFAULT_BUFFERS = 8;
 	const static int MAX_BUFFERS = 64;
 	std::queue<ALuint> streamBuffers;
@@ -221,6 +295,9 @@ class Source : public love::audio::Source
 
 	StrongRef<love::sound::Decoder> decoder;
 
+	// Decoded data for streaming Sources.
+	StrongRef<Prefetcher::Stream> prefetch;
+
 	unsigned int toLoop = 0;
 	ALsizei bufferedBytes = 0;
 	int buffers = 0;
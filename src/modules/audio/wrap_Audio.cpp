@@ -27,6 +27,8 @@
 
 #include "common/runtime.h"
 
+#include "libraries/xxHash/xxhash.h"
+
 // C++
 #include <iostream>
 #include <cmath>
@@ -44,9 +46,18 @@ int w_getActiveSourceCount(lua_State *L)
 	return 1;
 }
 
+static uint64 getSoundDataHash(love::sound::SoundData *s)
+{
+	// Identical samples in different formats aren't interchangeable.
+	uint64 seed = ((uint64) s->getSampleRate() << 16) | ((uint64) s->getBitDepth() << 8) | (uint64) s->getChannelCount();
+	return XXH64(s->getData(), s->getSize(), seed);
+}
+
 int w_newSource(lua_State *L)
 {
 	Source::Type stype = Source::TYPE_STREAM;
+	uint64 hash = 0;
+	bool hashed = false;
 
 	if (!luax_istype(L, 1, love::sound::SoundData::type))
 	{
@@ -62,6 +73,34 @@ int w_newSource(lua_State *L)
 
 		if (love::filesystem::luax_cangetdata(L, 1))
 		{
+			if (stype == Source::TYPE_STATIC)
+			{
+				// Static Sources from identical files can share decoded audio,
+				// so check the cache before decoding anything.
+				love::Data *data = love::filesystem::luax_getdata(L, 1);
+				hash = XXH64(data->getData(), data->getSize(), 0);
+				hashed = true;
+
+				Source *t = nullptr;
+				luax_catchexcept(L,
+					[&]() { t = instance()->newCachedSource(hash); },
+					[&](bool should_error) { if (should_error) data->release(); }
+				);
+
+				if (t != nullptr)
+				{
+					data->release();
+					luax_pushtype(L, t);
+					t->release();
+					return 1;
+				}
+
+				// Decode the data which was just read, instead of the file.
+				luax_pushtype(L, data);
+				data->release();
+				lua_replace(L, 1);
+			}
+
 			// stream type
 			if (stype == Source::TYPE_STATIC)
 				lua_pushstring(L, "memory");
@@ -86,7 +125,24 @@ int w_newSource(lua_State *L)
 
 	luax_catchexcept(L, [&]() {
 		if (luax_istype(L, 1, love::sound::SoundData::type))
-			t = instance()->newSource(luax_totype<love::sound::SoundData>(L, 1));
+		{
+			auto s = luax_totype<love::sound::SoundData>(L, 1);
+			Audio *audio = instance();
+
+			if (!hashed && s->getSize() <= audio->getSourceCacheBudget())
+			{
+				hash = getSoundDataHash(s);
+				hashed = true;
+				t = audio->newCachedSource(hash);
+			}
+
+			if (t == nullptr)
+			{
+				t = audio->newSource(s);
+				if (hashed)
+					audio->cacheSource(hash, t, s->getSize());
+			}
+		}
 		else if (luax_istype(L, 1, love::sound::Decoder::type))
 			t = instance()->newSource(luax_totype<love::sound::Decoder>(L, 1));
 	});
@@ -540,6 +596,51 @@ int w_isEffectsSupported(lua_State *L)
 	return 1;
 }
 
+int w_setSourceCacheBudget(lua_State *L)
+{
+	lua_Number bytes = luaL_checknumber(L, 1);
+	if (bytes < 0)
+		return luaL_error(L, "Source cache budget must not be negative.");
+	instance()->setSourceCacheBudget((size_t) bytes);
+	return 0;
+}
+
+int w_getSourceCacheBudget(lua_State *L)
+{
+	lua_pushnumber(L, (lua_Number) instance()->getSourceCacheBudget());
+	return 1;
+}
+
+int w_getSourceCacheSize(lua_State *L)
+{
+	lua_pushnumber(L, (lua_Number) instance()->getSourceCacheSize());
+	return 1;
+}
+
+int w_clearSourceCache(lua_State *L)
+{
+	instance()->clearSourceCache();
+	return 0;
+}
+
+int w_setSoftwareMixing(lua_State *L)
+{
+	luax_pushboolean(L, instance()->setSoftwareMixing(luax_checkboolean(L, 1)));
+	return 1;
+}
+
+int w_isSoftwareMixing(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isSoftwareMixing());
+	return 1;
+}
+
+int w_getVirtualSourceCount(lua_State *L)
+{
+	lua_pushinteger(L, instance()->getVirtualSourceCount());
+	return 1;
+}
+
 int w_setMixWithSystem(lua_State *L)
 {
 	luax_pushboolean(L, Audio::setMixWithSystem(luax_checkboolean(L, 1)));
@@ -622,6 +723,13 @@ static const luaL_Reg functions[] =
 	{ "getMaxSceneEffects", w_getMaxSceneEffects },
 	{ "getMaxSourceEffects", w_getMaxSourceEffects },
 	{ "isEffectsSupported", w_isEffectsSupported },
+	{ "setSourceCacheBudget", w_setSourceCacheBudget },
+	{ "getSourceCacheBudget", w_getSourceCacheBudget },
+	{ "getSourceCacheSize", w_getSourceCacheSize },
+	{ "clearSourceCache", w_clearSourceCache },
+	{ "setSoftwareMixing", w_setSoftwareMixing },
+	{ "isSoftwareMixing", w_isSoftwareMixing },
+	{ "getVirtualSourceCount", w_getVirtualSourceCount },
 	{ "setMixWithSystem", w_setMixWithSystem },
 	{ "getPlaybackDevice", w_getPlaybackDevice },
 	{ "getPlaybackDevices", w_getPlaybackDevices },
@@ -21,6 +21,7 @@
 #include "ByteData.h"
 #include "common/Exception.h"
 #include "common/int.h"
+#include "thread/threads.h"
 
 #include <string.h>
 
@@ -102,5 +103,21 @@ size_t ByteData::getSize() const
 	return size;
 }
 
+ByteData *ByteData::transfer()
+{
+	love::thread::Lock lock(getMutex());
+
+	if (transferred)
+		throw love::Exception("ByteData has already been transferred.");
+
+	ByteData *d = new ByteData(data, size, true);
+
+	data = nullptr;
+	size = 0;
+	transferred = true;
+
+	return d;
+}
+
 } // data
 } // love
@@ -45,6 +45,7 @@ class ByteData : public love::Data
 	ByteData *clone() const override;
 	void *getData() const override;
 	size_t getSize() const override;
+	ByteData *transfer() override;
 
 private:
 
@@ -44,6 +44,16 @@ int w_ByteData_clone(lua_State *L)
 	return 1;
 }
 
+int w_ByteData_transfer(lua_State *L)
+{
+	ByteData *t = luax_checkbytedata(L, 1);
+	ByteData *d = nullptr;
+	luax_catchexcept(L, [&](){ d = t->transfer(); });
+	luax_pushtype(L, d);
+	d->release();
+	return 1;
+}
+
 int w_ByteData_setString(lua_State *L)
 {
 	Data *t = luax_checkdata(L, 1);
@@ -138,6 +148,7 @@ int w_ByteData_setUInt32(lua_State *L)
 static const luaL_Reg w_ByteData_functions[] =
 {
 	{ "clone", w_ByteData_clone },
+	{ "transfer", w_ByteData_transfer },
 	{ "setString", w_ByteData_setString },
 	{ "setFloat", w_ByteData_setFloat },
 	{ "setDouble", w_ByteData_setDouble },
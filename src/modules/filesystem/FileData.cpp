@@ -45,15 +45,15 @@ FileData::FileData(uint64 size, const std::string &filename)
 		throw love::Exception("Out of memory.");
 	}
 
-	size_t dotpos = filename.rfind('.');
+	splitFilename();
+}
 
-	if (dotpos != std::string::npos)
-	{
-		extension = filename.substr(dotpos + 1);
-		name = filename.substr(0, dotpos);
-	}
-	else
-		name = filename;
+FileData::FileData(const std::string &filename)
+	: data(nullptr)
+	, size(0)
+	, filename(filename)
+{
+	splitFilename();
 }
 
 FileData::FileData(const FileData &c)
@@ -79,6 +79,19 @@ FileData::~FileData()
 	delete [] data;
 }
 
+void FileData::splitFilename()
+{
+	size_t dotpos = filename.rfind('.');
+
+	if (dotpos != std::string::npos)
+	{
+		extension = filename.substr(dotpos + 1);
+		name = filename.substr(0, dotpos);
+	}
+	else
+		name = filename;
+}
+
 FileData *FileData::clone() const
 {
 	return new FileData(*this);
@@ -52,7 +52,13 @@ class FileData : public Data
 	const std::string &getExtension() const;
 	const std::string &getName() const;
 
-private:
+protected:
+
+	/**
+	 * For subclasses which provide their own memory. The data pointer must be
+	 * reset to null before this class' destructor runs.
+	 **/
+	FileData(const std::string &filename);
 
 	// The actual data.
 	char *data;
@@ -60,6 +66,11 @@ class FileData : public Data
 	// Size of the data.
 	uint64 size;
 
+private:
+
+	// Sets the extension and name from the filename.
+	void splitFilename();
+
 	// The filename used for error purposes.
 	std::string filename;
 
@@ -251,6 +251,16 @@ class Filesystem : public Module
 	virtual FileData *read(const char *filename, int64 size) const = 0;
 	virtual FileData *read(const char *filename) const = 0;
 
+	/**
+	 * Gets the contents of a file without copying them where possible. Files
+	 * in read-only native directories and uncompressed files in zip archives
+	 * are memory-mapped, other files (including those in the save directory)
+	 * are read like with read().
+	 * @param filename The name of the file.
+	 * @param mapped Set to whether the file was memory-mapped.
+	 **/
+	virtual FileData *map(const char *filename, bool &mapped) const = 0;
+
 	/**
 	 * Write data to a file.
 	 * @param filename The name of the file to write to.
@@ -283,6 +293,25 @@ class Filesystem : public Module
 	 **/
 	virtual bool areSymlinksEnabled() const = 0;
 
+	/**
+	 * Enable or disable the file index. When enabled, exists, getInfo and
+	 * getDirectoryItems are answered from a hash table of every file in the
+	 * search path, which is rebuilt after the search path or the save
+	 * directory are changed through love.filesystem. Changes made by other
+	 * means aren't seen until then.
+	 **/
+	virtual void setFileIndexEnabled(bool enable) = 0;
+
+	/**
+	 * Gets whether the file index is enabled.
+	 **/
+	virtual bool isFileIndexEnabled() const = 0;
+
+	/**
+	 * Discards the file index. It's rebuilt on the next lookup.
+	 **/
+	virtual void invalidateFileIndex() const = 0;
+
 	// Require path accessors
 	// Not const because it's R/W
 	virtual std::vector<std::string> &getRequirePath() = 0;
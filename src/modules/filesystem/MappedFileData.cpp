@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "MappedFileData.h"
+#include "common/config.h"
+#include "common/utf8.h"
+
+#ifdef LOVE_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace love
+{
+namespace filesystem
+{
+
+MappedFileData::MappedFileData(const std::string &path, uint64 offset, uint64 size, const std::string &filename)
+	: FileData(filename)
+	, mapping(nullptr)
+	, mappingSize(0)
+{
+	if (size == 0 || size > (uint64) SIZE_MAX)
+		throw love::Exception("Could not map file %s: invalid size.", filename.c_str());
+
+#ifdef LOVE_WINDOWS
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	uint64 alignedOffset = offset - (offset % info.dwAllocationGranularity);
+#else
+	long pageSize = sysconf(_SC_PAGESIZE);
+	uint64 alignedOffset = offset - (offset % (uint64) pageSize);
+#endif
+
+	mappingSize = (size_t) (size + (offset - alignedOffset));
+
+#ifdef LOVE_WINDOWS
+	std::wstring wpath = to_widestr(path);
+	HANDLE file = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		throw love::Exception("Could not open file %s.", filename.c_str());
+
+	HANDLE filemapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+	CloseHandle(file);
+
+	if (filemapping == nullptr)
+		throw love::Exception("Could not map file %s.", filename.c_str());
+
+	// The view keeps the file mapping object alive.
+	mapping = MapViewOfFile(filemapping, FILE_MAP_COPY, (DWORD) (alignedOffset >> 32), (DWORD) (alignedOffset & 0xFFFFFFFF), mappingSize);
+	CloseHandle(filemapping);
+
+	if (mapping == nullptr)
+		throw love::Exception("Could not map file %s.", filename.c_str());
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd == -1)
+		throw love::Exception("Could not open file %s.", filename.c_str());
+
+	// The mapping keeps its own reference to the file.
+	void *p = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, (off_t) alignedOffset);
+	close(fd);
+
+	if (p == MAP_FAILED)
+		throw love::Exception("Could not map file %s.", filename.c_str());
+
+	mapping = p;
+#endif
+
+	data = (char *) mapping + (offset - alignedOffset);
+	this->size = size;
+}
+
+MappedFileData::~MappedFileData()
+{
+#ifdef LOVE_WINDOWS
+	UnmapViewOfFile(mapping);
+#else
+	munmap(mapping, mappingSize);
+#endif
+
+	// Stop FileData from deleting it.
+	data = nullptr;
+}
+
+} // filesystem
+} // love
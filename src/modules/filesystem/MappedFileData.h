@@ -0,0 +1,57 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "FileData.h"
+
+namespace love
+{
+namespace filesystem
+{
+
+/**
+ * FileData whose contents are a private, copy-on-write memory mapping of a
+ * range of a native file, instead of a heap copy. Writes to the data never
+ * reach the file.
+ **/
+class MappedFileData : public FileData
+{
+public:
+
+	/**
+	 * Maps 'size' bytes starting at 'offset' in the native file at 'path'.
+	 * Throws if the range can't be mapped.
+	 **/
+	MappedFileData(const std::string &path, uint64 offset, uint64 size, const std::string &filename);
+	virtual ~MappedFileData();
+
+private:
+
+	// Start and length of the mapped view, which begins at an address the
+	// OS can map at (page or allocation granularity) before the data.
+	void *mapping;
+	size_t mappingSize;
+
+}; // MappedFileData
+
+} // filesystem
+} // love
@@ -45,6 +45,13 @@ static bool setupWriteDirectory()
 	return fs != nullptr && fs->setupWriteDirectory();
 }
 
+static void invalidateFileIndex()
+{
+	auto fs = Module::getInstance<love::filesystem::Filesystem>(Module::M_FILESYSTEM);
+	if (fs != nullptr)
+		fs->invalidateFileIndex();
+}
+
 File::File(const std::string &filename, Mode mode)
 	: filename(filename)
 	, file(nullptr)
@@ -145,6 +152,10 @@ bool File::open(Mode mode)
 
 	this->mode = mode;
 
+	// Opening for writing can create the file or change its size.
+	if (mode == MODE_APPEND || mode == MODE_WRITE)
+		invalidateFileIndex();
+
 	if (file != nullptr && !setBuffer(bufferMode, bufferSize))
 	{
 		// Revert to buffer defaults if we don't successfully set the buffer.
@@ -160,6 +171,9 @@ bool File::close()
 	if (file == nullptr || !PHYSFS_close(file))
 		return false;
 
+	if (mode == MODE_APPEND || mode == MODE_WRITE)
+		invalidateFileIndex();
+
 	mode = MODE_CLOSED;
 	file = nullptr;
 
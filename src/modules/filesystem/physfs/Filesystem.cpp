@@ -28,6 +28,7 @@
 #include "Filesystem.h"
 #include "File.h"
 #include "PhysfsIo.h"
+#include "filesystem/MappedFileData.h"
 
 // PhysFS
 #include "libraries/physfs/physfs.h"
@@ -88,6 +89,60 @@ static std::string normalize(const std::string &input)
 	return out.str();
 }
 
+static void statToInfo(const PHYSFS_Stat &stat, Filesystem::Info &info)
+{
+	info.size = (int64) stat.filesize;
+	info.modtime = (int64) stat.modtime;
+	info.readonly = stat.readonly != 0;
+
+	if (stat.filetype == PHYSFS_FILETYPE_REGULAR)
+		info.type = Filesystem::FILETYPE_FILE;
+	else if (stat.filetype == PHYSFS_FILETYPE_DIRECTORY)
+		info.type = Filesystem::FILETYPE_DIRECTORY;
+	else if (stat.filetype == PHYSFS_FILETYPE_SYMLINK)
+		info.type = Filesystem::FILETYPE_SYMLINK;
+	else
+		info.type = Filesystem::FILETYPE_OTHER;
+}
+
+// Converts a path to the form used as a file index key, following PhysFS' own
+// rules: leading, trailing and repeated slashes are ignored. Returns false for
+// paths PhysFS would reject.
+static bool toIndexKey(const char *path, std::string &key)
+{
+	key.clear();
+
+	const char *start = path;
+	while (true)
+	{
+		const char *end = start;
+		while (*end != '\0' && *end != '/')
+			end++;
+
+		size_t len = end - start;
+		if (len > 0)
+		{
+			if ((len == 1 && start[0] == '.') || (len == 2 && start[0] == '.' && start[1] == '.'))
+				return false;
+
+			for (const char *c = start; c != end; c++)
+			{
+				if (*c == ':' || *c == '\\')
+					return false;
+			}
+
+			if (!key.empty())
+				key += '/';
+			key.append(start, len);
+		}
+
+		if (*end == '\0')
+			return true;
+
+		start = end + 1;
+	}
+}
+
 static const Filesystem::CommonPath appCommonPaths[] =
 {
 	Filesystem::COMMONPATH_APP_SAVEDIR,
@@ -114,6 +169,8 @@ Filesystem::Filesystem()
 	, fullPaths()
 	, commonPathMountInfo()
 	, saveDirectoryNeedsMounting(false)
+	, fileIndexEnabled(false)
+	, fileIndexValid(false)
 {
 	requirePath = {"?.lua", "?/init.lua"};
 	cRequirePath = {"??"};
@@ -252,6 +309,7 @@ bool Filesystem::setSource(const char *source)
 		if (gameLoveIO)
 		{
 			if (PHYSFS_mountIo(gameLoveIO, ".zip", nullptr, 0)) {
+				invalidateFileIndex();
 				gameSource = new_search_path;
 				return true;
 			}
@@ -282,6 +340,7 @@ bool Filesystem::setSource(const char *source)
 
 			if (PHYSFS_mountIo(io, "LOVE.FD", nullptr, 0))
 			{
+				invalidateFileIndex();
 				gameSource = new_search_path;
 				return true;
 			}
@@ -312,9 +371,12 @@ bool Filesystem::setSource(const char *source)
 			delete io;
 			return false;
 		}
+		invalidateFileIndex();
 		return true;
 	}
 
+	invalidateFileIndex();
+
 	// Save the game source.
 	gameSource = new_search_path;
 
@@ -395,10 +457,16 @@ bool Filesystem::mountFullPath(const char *archive, const char *mountpoint, Moun
 	if (!PHYSFS_isInit() || !archive)
 		return false;
 
+	bool success = false;
 	if (permissions == MOUNT_PERMISSIONS_READWRITE)
-		return PHYSFS_mountRW(archive, mountpoint, appendToPath) != 0;
+		success = PHYSFS_mountRW(archive, mountpoint, appendToPath) != 0;
+	else
+		success = PHYSFS_mount(archive, mountpoint, appendToPath) != 0;
 
-	return PHYSFS_mount(archive, mountpoint, appendToPath) != 0;
+	if (success)
+		invalidateFileIndex();
+
+	return success;
 }
 
 bool Filesystem::mountCommonPathInternal(CommonPath path, const char *mountpoint, MountPermissions permissions, bool appendToPath, bool createDir)
@@ -436,6 +504,7 @@ bool Filesystem::mount(Data *data, const char *archivename, const char *mountpoi
 	if (PHYSFS_mountMemory(data->getData(), data->getSize(), nullptr, archivename, mountpoint, appendToPath) != 0)
 	{
 		mountedData[archivename] = data;
+		invalidateFileIndex();
 		return true;
 	}
 
@@ -452,6 +521,7 @@ bool Filesystem::unmount(const char *archive)
 	if (datait != mountedData.end() && PHYSFS_unmount(archive) != 0)
 	{
 		mountedData.erase(datait);
+		invalidateFileIndex();
 		return true;
 	}
 
@@ -477,7 +547,7 @@ bool Filesystem::unmount(const char *archive)
 	if (PHYSFS_getMountPoint(realPath.c_str()) == nullptr)
 		return false;
 
-	return PHYSFS_unmount(realPath.c_str()) != 0;
+	return unmountFullPath(realPath.c_str());
 }
 
 bool Filesystem::unmountFullPath(const char *fullpath)
@@ -485,7 +555,11 @@ bool Filesystem::unmountFullPath(const char *fullpath)
 	if (!PHYSFS_isInit() || !fullpath)
 		return false;
 
-	return PHYSFS_unmount(fullpath) != 0;
+	if (PHYSFS_unmount(fullpath) == 0)
+		return false;
+
+	invalidateFileIndex();
+	return true;
 }
 
 bool Filesystem::unmount(CommonPath path)
@@ -762,6 +836,15 @@ bool Filesystem::exists(const char *filepath) const
 	if (!PHYSFS_isInit())
 		return false;
 
+	if (fileIndexEnabled)
+	{
+		love::thread::Lock lock(fileIndexMutex);
+		bool indexed = false;
+		const IndexEntry *entry = findIndexEntry(filepath, indexed);
+		if (indexed)
+			return entry != nullptr;
+	}
+
 	return PHYSFS_exists(filepath) != 0;
 }
 
@@ -770,23 +853,26 @@ bool Filesystem::getInfo(const char *filepath, Info &info) const
 	if (!PHYSFS_isInit())
 		return false;
 
+	if (fileIndexEnabled)
+	{
+		love::thread::Lock lock(fileIndexMutex);
+		bool indexed = false;
+		const IndexEntry *entry = findIndexEntry(filepath, indexed);
+		if (indexed)
+		{
+			if (entry == nullptr)
+				return false;
+
+			info = entry->info;
+			return true;
+		}
+	}
+
 	PHYSFS_Stat stat = {};
 	if (!PHYSFS_stat(filepath, &stat))
 		return false;
 
-	info.size = (int64) stat.filesize;
-	info.modtime = (int64) stat.modtime;
-	info.readonly = stat.readonly != 0;
-
-	if (stat.filetype == PHYSFS_FILETYPE_REGULAR)
-		info.type = FILETYPE_FILE;
-	else if (stat.filetype == PHYSFS_FILETYPE_DIRECTORY)
-		info.type = FILETYPE_DIRECTORY;
-	else if (stat.filetype == PHYSFS_FILETYPE_SYMLINK)
-		info.type = FILETYPE_SYMLINK;
-	else
-		info.type = FILETYPE_OTHER;
-
+	statToInfo(stat, info);
 	return true;
 }
 
@@ -801,6 +887,8 @@ bool Filesystem::createDirectory(const char *dir)
 	if (!PHYSFS_mkdir(dir))
 		return false;
 
+	invalidateFileIndex();
+
 #ifdef LOVE_ANDROID
 	// In Android with t.externalstorage = true, make sure the directory
     // created in the save directory has permissions of ugo+rwx (0777) so that
@@ -825,6 +913,8 @@ bool Filesystem::remove(const char *file)
 	if (!PHYSFS_delete(file))
 		return false;
 
+	invalidateFileIndex();
+
 	return true;
 }
 
@@ -844,6 +934,50 @@ FileData* Filesystem::read(const char* filename) const
 	return file.read();
 }
 
+FileData *Filesystem::map(const char *filename, bool &mapped) const
+{
+	mapped = false;
+
+	if (!PHYSFS_isInit())
+		throw love::Exception("PhysFS is not initialized.");
+
+	std::string path;
+	PHYSFS_uint64 offset = 0;
+	PHYSFS_uint64 size = 0;
+
+	PHYSFS_File *file = PHYSFS_openRead(filename);
+	if (file != nullptr)
+	{
+		const char *nativepath = nullptr;
+		bool native = PHYSFS_getNativeRange(file, &nativepath, &offset, &size) != 0;
+
+		if (native)
+			path = nativepath;
+
+		PHYSFS_close(file);
+	}
+
+	// Empty files can't be mapped, read() gives them an empty FileData. Files
+	// in writable mounts such as the save directory aren't given a native
+	// range, since writing to them while mapped would change or invalidate
+	// the mapping.
+	if (!path.empty() && size > 0)
+	{
+		try
+		{
+			FileData *data = new MappedFileData(path, offset, size, filename);
+			mapped = true;
+			return data;
+		}
+		catch (love::Exception &)
+		{
+			// Fall back to reading the file.
+		}
+	}
+
+	return read(filename);
+}
+
 void Filesystem::write(const char *filename, const void *data, int64 size) const
 {
 	File file(filename, File::MODE_WRITE);
@@ -867,6 +1001,20 @@ bool Filesystem::getDirectoryItems(const char *dir, std::vector<std::string> &it
 	if (!PHYSFS_isInit())
 		return false;
 
+	if (fileIndexEnabled)
+	{
+		love::thread::Lock lock(fileIndexMutex);
+		bool indexed = false;
+		const IndexEntry *entry = findIndexEntry(dir, indexed);
+		if (indexed)
+		{
+			// PhysFS gives an empty list for files and missing directories.
+			if (entry != nullptr)
+				items.insert(items.end(), entry->items.begin(), entry->items.end());
+			return true;
+		}
+	}
+
 	char **rc = PHYSFS_enumerateFiles(dir);
 
 	if (rc == nullptr)
@@ -885,6 +1033,7 @@ void Filesystem::setSymlinksEnabled(bool enable)
 		return;
 
 	PHYSFS_permitSymbolicLinks(enable ? 1 : 0);
+	invalidateFileIndex();
 }
 
 bool Filesystem::areSymlinksEnabled() const
@@ -895,6 +1044,88 @@ bool Filesystem::areSymlinksEnabled() const
 	return PHYSFS_symbolicLinksPermitted() != 0;
 }
 
+void Filesystem::setFileIndexEnabled(bool enable)
+{
+	love::thread::Lock lock(fileIndexMutex);
+	fileIndexEnabled = enable;
+	fileIndex.clear();
+	fileIndexValid = false;
+}
+
+bool Filesystem::isFileIndexEnabled() const
+{
+	return fileIndexEnabled;
+}
+
+void Filesystem::invalidateFileIndex() const
+{
+	love::thread::Lock lock(fileIndexMutex);
+	fileIndex.clear();
+	fileIndexValid = false;
+}
+
+const Filesystem::IndexEntry *Filesystem::findIndexEntry(const char *path, bool &indexed) const
+{
+	// Paths through symlinked directories aren't in the index, since it
+	// doesn't follow them.
+	std::string key;
+	indexed = PHYSFS_symbolicLinksPermitted() == 0 && toIndexKey(path, key);
+	if (!indexed)
+		return nullptr;
+
+	if (!fileIndexValid)
+		buildFileIndex();
+
+	auto it = fileIndex.find(key);
+	return it != fileIndex.end() ? &it->second : nullptr;
+}
+
+void Filesystem::buildFileIndex() const
+{
+	fileIndex.clear();
+
+	PHYSFS_Stat stat = {};
+	if (!PHYSFS_stat("/", &stat))
+		stat.filetype = PHYSFS_FILETYPE_DIRECTORY;
+
+	statToInfo(stat, fileIndex[""].info);
+
+	std::vector<std::string> pending = {""};
+
+	while (!pending.empty())
+	{
+		std::string dir = pending.back();
+		pending.pop_back();
+
+		char **rc = PHYSFS_enumerateFiles(dir.empty() ? "/" : dir.c_str());
+		if (rc == nullptr)
+			continue;
+
+		std::vector<std::string> items;
+
+		for (char **i = rc; *i != nullptr; i++)
+		{
+			std::string path = dir.empty() ? *i : dir + "/" + *i;
+
+			if (!PHYSFS_stat(path.c_str(), &stat))
+				continue;
+
+			items.push_back(*i);
+
+			statToInfo(stat, fileIndex[path].info);
+
+			if (stat.filetype == PHYSFS_FILETYPE_DIRECTORY)
+				pending.push_back(path);
+		}
+
+		PHYSFS_freeList(rc);
+
+		fileIndex[dir].items = std::move(items);
+	}
+
+	fileIndexValid = true;
+}
+
 std::vector<std::string> &Filesystem::getRequirePath()
 {
 	return requirePath;
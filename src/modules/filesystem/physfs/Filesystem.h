@@ -25,9 +25,11 @@
 #include <cstdlib>
 #include <cstring>
 #include <map>
+#include <unordered_map>
 
 // LOVE
 #include "filesystem/Filesystem.h"
+#include "thread/threads.h"
 
 namespace love
 {
@@ -88,6 +90,7 @@ class Filesystem final : public love::filesystem::Filesystem
 
 	FileData *read(const char *filename, int64 size) const override;
 	FileData *read(const char *filename) const override;
+	FileData *map(const char *filename, bool &mapped) const override;
 	void write(const char *filename, const void *data, int64 size) const override;
 	void append(const char *filename, const void *data, int64 size) const override;
 
@@ -96,6 +99,10 @@ class Filesystem final : public love::filesystem::Filesystem
 	void setSymlinksEnabled(bool enable) override;
 	bool areSymlinksEnabled() const override;
 
+	void setFileIndexEnabled(bool enable) override;
+	bool isFileIndexEnabled() const override;
+	void invalidateFileIndex() const override;
+
 	std::vector<std::string> &getRequirePath() override;
 	std::vector<std::string> &getCRequirePath() override;
 
@@ -110,8 +117,22 @@ class Filesystem final : public love::filesystem::Filesystem
 		MountPermissions permissions;
 	};
 
+	struct IndexEntry
+	{
+		Info info;
+
+		// Names of the directory's items, if it's a directory.
+		std::vector<std::string> items;
+	};
+
 	bool mountCommonPathInternal(CommonPath path, const char *mountpoint, MountPermissions permissions, bool appendToPath, bool createDir);
 
+	// Returns the index entry for the path, or null if it doesn't exist. Sets
+	// 'indexed' to false if the index can't answer for this path. fileIndexMutex
+	// must be locked.
+	const IndexEntry *findIndexEntry(const char *path, bool &indexed) const;
+	void buildFileIndex() const;
+
 	// Contains the current working directory (UTF8).
 	std::string cwd;
 
@@ -140,6 +161,14 @@ class Filesystem final : public love::filesystem::Filesystem
 
 	bool saveDirectoryNeedsMounting;
 
+	bool fileIndexEnabled;
+
+	// Every file and directory in the search path, keyed by its normalized
+	// path. Built on demand, and discarded whenever it may be out of date.
+	mutable std::unordered_map<std::string, IndexEntry> fileIndex;
+	mutable bool fileIndexValid;
+	mutable love::thread::MutexRef fileIndexMutex;
+
 }; // Filesystem
 
 } // physfs
@@ -628,6 +628,27 @@ int w_read(lua_State *L)
 	return 2;
 }
 
+int w_map(lua_State *L)
+{
+	const char *filename = luaL_checkstring(L, 1);
+
+	FileData *data = nullptr;
+	bool mapped = false;
+	try
+	{
+		data = instance()->map(filename, mapped);
+	}
+	catch (love::Exception &e)
+	{
+		return luax_ioError(L, "%s", e.what());
+	}
+
+	luax_pushtype(L, data);
+	data->release();
+	luax_pushboolean(L, mapped);
+	return 2;
+}
+
 static int w_write_or_append(lua_State *L, File::Mode mode)
 {
 	const char *filename = luaL_checkstring(L, 1);
@@ -782,6 +803,18 @@ int w_areSymlinksEnabled(lua_State *L)
 	return 1;
 }
 
+int w_setFileIndexEnabled(lua_State *L)
+{
+	instance()->setFileIndexEnabled(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isFileIndexEnabled(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isFileIndexEnabled());
+	return 1;
+}
+
 int w_getRequirePath(lua_State *L)
 {
 	std::stringstream path;
@@ -1037,6 +1070,7 @@ static const luaL_Reg functions[] =
 	{ "createDirectory", w_createDirectory },
 	{ "remove", w_remove },
 	{ "read", w_read },
+	{ "map", w_map },
 	{ "write", w_write },
 	{ "append", w_append },
 	{ "getDirectoryItems", w_getDirectoryItems },
@@ -1046,6 +1080,8 @@ static const luaL_Reg functions[] =
 	{ "getInfo", w_getInfo },
 	{ "setSymlinksEnabled", w_setSymlinksEnabled },
 	{ "areSymlinksEnabled", w_areSymlinksEnabled },
+	{ "setFileIndexEnabled", w_setFileIndexEnabled },
+	{ "isFileIndexEnabled", w_isFileIndexEnabled },
 	{ "newFileData", w_newFileData },
 	{ "getRequirePath", w_getRequirePath },
 	{ "setRequirePath", w_setRequirePath },
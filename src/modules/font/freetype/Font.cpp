@@ -49,7 +49,7 @@ Font::~Font()
 
 Rasterizer *Font::newRasterizer(love::filesystem::FileData *data)
 {
-	if (TrueTypeRasterizer::accepts(library, data))
+	if (TrueTypeRasterizer::accepts(library, libraryMutex, data))
 		return newTrueTypeRasterizer(data, 12, font::TrueTypeRasterizer::Settings());
 	else if (BMFontRasterizer::accepts(data))
 		return newBMFontRasterizer(data, {}, 1.0f);
@@ -64,7 +64,7 @@ Rasterizer *Font::newTrueTypeRasterizer(love::Data *data, int size, const font::
 	if (window != nullptr)
 		defaultdpiscale = window->getDPIScale();
 
-	return new TrueTypeRasterizer(library, data, size, settings, defaultdpiscale);
+	return new TrueTypeRasterizer(library, libraryMutex, data, size, settings, defaultdpiscale);
 }
 
 } // freetype
@@ -23,6 +23,7 @@
 
 // LOVE
 #include "font/Font.h"
+#include "thread/threads.h"
 
 // FreeType2
 #include <ft2build.h>
@@ -52,6 +53,11 @@ class Font : public love::font::Font
 	// FreeType library
 	FT_Library library;
 
+	// Faces are created and destroyed on the loader's worker threads as well
+	// as the main thread, and FreeType requires that to be serialized for
+	// each library.
+	love::thread::MutexRef libraryMutex;
+
 }; // Font
 
 } // freetype
@@ -33,8 +33,9 @@ namespace font
 namespace freetype
 {
 
-TrueTypeRasterizer::TrueTypeRasterizer(FT_Library library, love::Data *data, int size, const Settings &settings, float defaultdpiscale)
-	: data(data)
+TrueTypeRasterizer::TrueTypeRasterizer(FT_Library library, love::thread::Mutex *libraryMutex, love::Data *data, int size, const Settings &settings, float defaultdpiscale)
+	: libraryMutex(libraryMutex)
+	, data(data)
 	, hinting(settings.hinting)
 {
 	dpiScale = settings.dpiScale.get(defaultdpiscale);
@@ -46,11 +47,14 @@ TrueTypeRasterizer::TrueTypeRasterizer(FT_Library library, love::Data *data, int
 		throw love::Exception("Invalid TrueType font size: %d", size);
 
 	FT_Error err = FT_Err_Ok;
-	err = FT_New_Memory_Face(library,
-	                         (const FT_Byte *)data->getData(), /* first byte in memory */
-	                         data->getSize(),                  /* size in bytes        */
-	                         0,                                /* face_index           */
-	                         &face);
+	{
+		love::thread::Lock lock(libraryMutex);
+		err = FT_New_Memory_Face(library,
+		                         (const FT_Byte *)data->getData(), /* first byte in memory */
+		                         data->getSize(),                  /* size in bytes        */
+		                         0,                                /* face_index           */
+		                         &face);
+	}
 
 	if (err != FT_Err_Ok)
 		throw love::Exception("TrueType Font loading error: FT_New_Face failed: 0x%x (problem with font file?)", err);
@@ -58,7 +62,11 @@ TrueTypeRasterizer::TrueTypeRasterizer(FT_Library library, love::Data *data, int
 	err = FT_Set_Pixel_Sizes(face, size, size);
 
 	if (err != FT_Err_Ok)
+	{
+		love::thread::Lock lock(libraryMutex);
+		FT_Done_Face(face);
 		throw love::Exception("TrueType Font loading error: FT_Set_Pixel_Sizes failed: 0x%x (invalid size?)", err);
+	}
 
 	// Set global metrics
 	FT_Size_Metrics s = face->size->metrics;
@@ -70,6 +78,7 @@ TrueTypeRasterizer::TrueTypeRasterizer(FT_Library library, love::Data *data, int
 
 TrueTypeRasterizer::~TrueTypeRasterizer()
 {
+	love::thread::Lock lock(libraryMutex);
 	FT_Done_Face(face);
 }
 
@@ -231,11 +240,13 @@ TextShaper *TrueTypeRasterizer::newTextShaper()
 	return new HarfbuzzShaper(this);
 }
 
-bool TrueTypeRasterizer::accepts(FT_Library library, love::Data *data)
+bool TrueTypeRasterizer::accepts(FT_Library library, love::thread::Mutex *libraryMutex, love::Data *data)
 {
 	const FT_Byte *fbase = (const FT_Byte *) data->getData();
 	FT_Long fsize = (FT_Long) data->getSize();
 
+	love::thread::Lock lock(libraryMutex);
+
 	// Pasing in -1 for the face index lets us test if the data is valid.
 	return FT_New_Memory_Face(library, fbase, fsize, -1, nullptr) == 0;
 }
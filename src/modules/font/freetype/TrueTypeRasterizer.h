@@ -24,6 +24,7 @@
 // LOVE
 #include "filesystem/FileData.h"
 #include "font/TrueTypeRasterizer.h"
+#include "thread/threads.h"
 
 // FreeType2
 #include <ft2build.h>
@@ -44,7 +45,7 @@ class TrueTypeRasterizer : public love::font::TrueTypeRasterizer
 {
 public:
 
-	TrueTypeRasterizer(FT_Library library, love::Data *data, int size, const Settings &settings, float defaultdpiscale);
+	TrueTypeRasterizer(FT_Library library, love::thread::Mutex *libraryMutex, love::Data *data, int size, const Settings &settings, float defaultdpiscale);
 	virtual ~TrueTypeRasterizer();
 
 	// Implement Rasterizer
@@ -60,7 +61,7 @@ class TrueTypeRasterizer : public love::font::TrueTypeRasterizer
 
 	ptrdiff_t getHandle() const override { return (ptrdiff_t) face; }
 
-	static bool accepts(FT_Library library, love::Data *data);
+	static bool accepts(FT_Library library, love::thread::Mutex *libraryMutex, love::Data *data);
 
 private:
 
@@ -69,6 +70,9 @@ class TrueTypeRasterizer : public love::font::TrueTypeRasterizer
 	// TrueType face
 	FT_Face face;
 
+	// Guards creating and destroying faces of the FT_Library.
+	love::thread::Mutex *libraryMutex;
+
 	// Font data
 	StrongRef<love::Data> data;
 
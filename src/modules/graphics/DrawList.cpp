@@ -0,0 +1,282 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "DrawList.h"
+#include "Graphics.h"
+#include "Buffer.h"
+#include "Texture.h"
+#include "Shader.h"
+
+// C++
+#include <algorithm>
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type DrawList::type("DrawList", &Drawable::type);
+
+DrawList::DrawList(Graphics */*gfx*/)
+	: indexType(INDEX_UINT16)
+	, totalVertexCount(0)
+	, modified(false)
+{
+}
+
+DrawList::~DrawList()
+{
+}
+
+Graphics::BatchedVertexData DrawList::addBatchedDraw(Graphics *gfx, const Graphics::BatchedDrawCommand &cmd)
+{
+	Command *last = commands.empty() ? nullptr : &commands.back();
+
+	Shader *shader = gfx->getShader();
+	const BlendState &blend = gfx->getBlendState();
+
+	// Same rules as Graphics::requestBatchedDraw: consecutive draws that
+	// share state are merged into a single command.
+	bool newcommand = last == nullptr
+		|| cmd.primitiveMode != last->primitiveMode
+		|| cmd.formats[0] != last->formats[0] || cmd.formats[1] != last->formats[1]
+		|| ((cmd.indexMode != TRIANGLEINDEX_NONE) != (last->indexCount > 0))
+		|| cmd.texture != last->texture.get()
+		|| cmd.standardShaderType != last->standardShaderType
+		|| shader != last->shader.get()
+		|| !(blend == last->blend);
+
+	if (newcommand)
+	{
+		Command c;
+		c.primitiveMode = cmd.primitiveMode;
+		c.formats[0] = cmd.formats[0];
+		c.formats[1] = cmd.formats[1];
+		c.texture.set(cmd.texture);
+		c.standardShaderType = cmd.standardShaderType;
+		c.shader.set(shader);
+		c.blend = blend;
+		c.vertexOffsets[0] = vertexData[0].size();
+		c.vertexOffsets[1] = vertexData[1].size();
+		c.indexStart = (int) indexData.size();
+
+		commands.push_back(c);
+		last = &commands.back();
+	}
+
+	Graphics::BatchedVertexData d;
+
+	for (int i = 0; i < 2; i++)
+	{
+		d.stream[i] = nullptr;
+
+		if (cmd.formats[i] == CommonFormat::NONE)
+			continue;
+
+		size_t offset = vertexData[i].size();
+		vertexData[i].resize(offset + getFormatStride(cmd.formats[i]) * cmd.vertexCount);
+		d.stream[i] = &vertexData[i][offset];
+	}
+
+	if (cmd.indexMode != TRIANGLEINDEX_NONE)
+	{
+		int indexcount = getIndexCount(cmd.indexMode, cmd.vertexCount);
+
+		size_t offset = indexData.size();
+		indexData.resize(offset + indexcount);
+		fillIndices(cmd.indexMode, (uint32) last->vertexCount, (uint32) cmd.vertexCount, &indexData[offset]);
+
+		last->indexCount += indexcount;
+	}
+
+	last->vertexCount += cmd.vertexCount;
+	totalVertexCount += cmd.vertexCount;
+	modified = true;
+
+	return d;
+}
+
+void DrawList::clear()
+{
+	commands.clear();
+	vertexData[0].clear();
+	vertexData[1].clear();
+	indexData.clear();
+	totalVertexCount = 0;
+	modified = true;
+}
+
+int DrawList::getDrawCount() const
+{
+	return (int) commands.size();
+}
+
+int DrawList::getVertexCount() const
+{
+	return totalVertexCount;
+}
+
+void DrawList::upload(Graphics *gfx)
+{
+	Buffer::Settings settings(BUFFERUSAGEFLAG_VERTEX, BUFFERDATAUSAGE_STATIC);
+
+	// Commands use different vertex formats, so the buffers are treated as
+	// raw bytes and each command sets up its own vertex attributes.
+	std::vector<Buffer::DataDeclaration> format = {
+		Buffer::DataDeclaration("DrawListVertexData", DATAFORMAT_UNORM8_VEC4)
+	};
+
+	for (int i = 0; i < 2; i++)
+	{
+		vertexBuffers[i].set(nullptr);
+
+		if (!vertexData[i].empty())
+		{
+			Buffer *b = gfx->newBuffer(settings, format, vertexData[i].data(), vertexData[i].size(), 0);
+			vertexBuffers[i].set(b, Acquire::NORETAIN);
+		}
+	}
+
+	indexBuffer.set(nullptr);
+
+	if (!indexData.empty())
+	{
+		// Indices are relative to the first vertex of their command.
+		int maxvertices = 0;
+		for (const Command &c : commands)
+		{
+			if (c.indexCount > 0)
+				maxvertices = std::max(maxvertices, c.vertexCount);
+		}
+
+		Buffer::Settings indexsettings(BUFFERUSAGEFLAG_INDEX, BUFFERDATAUSAGE_STATIC);
+		Buffer *b = nullptr;
+
+		if (maxvertices <= LOVE_UINT16_MAX)
+		{
+			std::vector<uint16> indices(indexData.begin(), indexData.end());
+			b = gfx->newBuffer(indexsettings, DATAFORMAT_UINT16, indices.data(), indices.size() * sizeof(uint16), 0);
+			indexType = INDEX_UINT16;
+		}
+		else
+		{
+			b = gfx->newBuffer(indexsettings, DATAFORMAT_UINT32, indexData.data(), indexData.size() * sizeof(uint32), 0);
+			indexType = INDEX_UINT32;
+		}
+
+		indexBuffer.set(b, Acquire::NORETAIN);
+	}
+
+	modified = false;
+}
+
+void DrawList::draw(Graphics *gfx, const Matrix4 &m)
+{
+	if (commands.empty())
+		return;
+
+	gfx->flushBatchedDraws();
+
+	if (modified)
+		upload(gfx);
+
+	// Puts back the caller's state, also when a draw throws.
+	struct StateRestore
+	{
+		Graphics *gfx;
+		Colorf color;
+		StrongRef<Shader> shader;
+		BlendState blend;
+
+		StateRestore(Graphics *gfx)
+			: gfx(gfx)
+			, color(gfx->getColor())
+			, shader(gfx->getShader())
+			, blend(gfx->getBlendState())
+		{}
+
+		~StateRestore()
+		{
+			gfx->setColor(color);
+			gfx->setShader(shader.get());
+			gfx->setBlendState(blend);
+		}
+	};
+
+	StateRestore restore(gfx);
+
+	// Vertex colors already include the color active at record time.
+	gfx->setColor(Colorf(1.0f, 1.0f, 1.0f, 1.0f));
+
+	Graphics::TempTransform transform(gfx, m);
+
+	for (const Command &c : commands)
+	{
+		if (c.shader.get() != gfx->getShader())
+			gfx->setShader(c.shader.get());
+
+		if (!(c.blend == gfx->getBlendState()))
+			gfx->setBlendState(c.blend);
+
+		if (Shader::isDefaultActive())
+			Shader::attachDefault(c.standardShaderType);
+
+		if (Shader::current != nullptr)
+			Shader::current->validateDrawState(c.primitiveMode, c.texture);
+
+		VertexAttributes attributes;
+		BufferBindings buffers;
+
+		for (int i = 0; i < 2; i++)
+		{
+			if (c.formats[i] == CommonFormat::NONE)
+				continue;
+
+			attributes.setCommonFormat(c.formats[i], (uint8) i);
+			buffers.set(i, vertexBuffers[i], c.vertexOffsets[i]);
+		}
+
+		Texture *texture = gfx->getTextureOrDefaultForActiveShader(c.texture);
+
+		if (c.indexCount > 0)
+		{
+			Graphics::DrawIndexedCommand cmd(&attributes, &buffers, indexBuffer);
+			cmd.primitiveType = c.primitiveMode;
+			cmd.indexCount = c.indexCount;
+			cmd.indexType = indexType;
+			cmd.indexBufferOffset = c.indexStart * getIndexDataSize(indexType);
+			cmd.texture = texture;
+			gfx->draw(cmd);
+		}
+		else
+		{
+			Graphics::DrawCommand cmd(&attributes, &buffers);
+			cmd.primitiveType = c.primitiveMode;
+			cmd.vertexStart = 0;
+			cmd.vertexCount = c.vertexCount;
+			cmd.texture = texture;
+			gfx->draw(cmd);
+		}
+	}
+}
+
+} // graphics
+} // love
@@ -0,0 +1,117 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/int.h"
+#include "Drawable.h"
+#include "Graphics.h"
+#include "vertex.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+class Texture;
+class Buffer;
+
+/**
+ * A DrawList captures the batched draws (shapes, textures, text, etc.) made
+ * while it's the active draw list, and keeps the resulting vertices in GPU
+ * buffers so they can be drawn again without redoing any of the CPU work.
+ * The vertex color and the transform active at record time are baked into
+ * the captured vertices, and the shader and blend mode are recorded with each
+ * draw. Other state (scissor, stencil, render targets, etc.) is taken from
+ * the state active when the DrawList is drawn.
+ **/
+class DrawList : public Drawable
+{
+public:
+
+	static love::Type type;
+
+	DrawList(Graphics *gfx);
+	virtual ~DrawList();
+
+	/**
+	 * Used by Graphics::requestBatchedDraw while this DrawList is capturing.
+	 **/
+	Graphics::BatchedVertexData addBatchedDraw(Graphics *gfx, const Graphics::BatchedDrawCommand &cmd);
+
+	void clear();
+
+	int getDrawCount() const;
+	int getVertexCount() const;
+
+	// Implements Drawable.
+	void draw(Graphics *gfx, const Matrix4 &m) override;
+
+private:
+
+	struct Command
+	{
+		PrimitiveType primitiveMode = PRIMITIVE_TRIANGLES;
+		CommonFormat formats[2];
+		StrongRef<Texture> texture;
+		Shader::StandardShader standardShaderType = Shader::STANDARD_DEFAULT;
+
+		// Null when the default shader was active.
+		StrongRef<Shader> shader;
+		BlendState blend;
+
+		// Byte offsets of the command's first vertex in each vertex stream.
+		size_t vertexOffsets[2];
+		int vertexCount = 0;
+
+		int indexStart = 0;
+		int indexCount = 0;
+
+		Command()
+		{
+			formats[0] = formats[1] = CommonFormat::NONE;
+			vertexOffsets[0] = vertexOffsets[1] = 0;
+		}
+	};
+
+	void upload(Graphics *gfx);
+
+	std::vector<Command> commands;
+
+	std::vector<uint8> vertexData[2];
+	// Converted to 16 bit indices on upload if every command fits.
+	std::vector<uint32> indexData;
+	IndexDataType indexType;
+
+	StrongRef<Buffer> vertexBuffers[2];
+	StrongRef<Buffer> indexBuffer;
+
+	int totalVertexCount;
+	bool modified;
+
+}; // DrawList
+
+} // graphics
+} // love
@@ -28,11 +28,14 @@
 #include "window/Window.h"
 #include "SpriteBatch.h"
 #include "ParticleSystem.h"
+#include "DrawList.h"
 #include "Font.h"
 #include "Video.h"
 #include "TextBatch.h"
 #include "common/deprecation.h"
 #include "common/config.h"
+#include "common/memory.h"
+#include "timer/Timer.h"
 
 // C++
 #include <algorithm>
@@ -191,10 +194,15 @@ Graphics::Graphics(const char *name)
 	, created(false)
 	, active(true)
 	, batchedDrawState()
+	, drawList(nullptr)
+	, arrayTextureBatching(false)
 	, deviceProjectionMatrix()
 	, renderTargetSwitchCount(0)
 	, drawCalls(0)
 	, drawCallsBatched(0)
+	, batchedDrawsUint16Indices(0)
+	, batchedDrawsUint32Indices(0)
+	, profileFrameIndex(0)
 	, quadIndexBuffer(nullptr)
 	, fanIndexBuffer(nullptr)
 	, capabilities()
@@ -223,6 +231,9 @@ Graphics::~Graphics()
 	if (fanIndexBuffer != nullptr)
 		fanIndexBuffer->release();
 
+	if (drawList != nullptr)
+		drawList->release();
+
 	releaseDefaultResources();
 
 	// Clean up standard shaders before the active shader. If we do it after,
@@ -322,9 +333,14 @@ love::graphics::SpriteBatch *Graphics::newSpriteBatch(Texture *texture, int size
 	return new SpriteBatch(this, texture, size, usage);
 }
 
-love::graphics::ParticleSystem *Graphics::newParticleSystem(Texture *texture, int size)
+love::graphics::ParticleSystem *Graphics::newParticleSystem(Texture *texture, int size, ParticleSystem::SimulationMode mode)
 {
-	return new ParticleSystem(texture, size);
+	return new ParticleSystem(texture, size, mode);
+}
+
+DrawList *Graphics::newDrawList()
+{
+	return new DrawList(this);
 }
 
 ShaderStage *Graphics::newShaderStage(ShaderStageType stage, const std::string &source, const Shader::CompileOptions &options, const Shader::SourceInfo &info, bool cache)
@@ -782,6 +798,14 @@ void Graphics::reset()
 	DisplayState s;
 	restoreState(s);
 	origin();
+
+	// Scopes left open (for example by an error between a push and its pop)
+	// are discarded, along with everything recorded inside them.
+	if (!profileScopeStack.empty())
+	{
+		profileScopes.resize(profileScopeStack.front());
+		profileScopeStack.clear();
+	}
 }
 
 void Graphics::backbufferChanged(int width, int height, int pixelwidth, int pixelheight)
@@ -1278,6 +1302,43 @@ bool Graphics::isRenderTargetActive(Texture *texture, int slice) const
 	return false;
 }
 
+void Graphics::setDrawList(DrawList *list)
+{
+	if (list == drawList)
+		return;
+
+	// Anything batched before this point belongs to the previous target.
+	flushBatchedDraws();
+
+	if (list != nullptr)
+		list->retain();
+
+	if (drawList != nullptr)
+		drawList->release();
+
+	drawList = list;
+}
+
+void Graphics::setDrawList()
+{
+	setDrawList(nullptr);
+}
+
+DrawList *Graphics::getDrawList() const
+{
+	return drawList;
+}
+
+void Graphics::setArrayTextureBatching(bool enable)
+{
+	arrayTextureBatching = enable;
+}
+
+bool Graphics::isArrayTextureBatching() const
+{
+	return arrayTextureBatching;
+}
+
 Texture *Graphics::getTemporaryTexture(PixelFormat format, int w, int h, int samples)
 {
 	Texture *texture = nullptr;
@@ -1889,6 +1950,9 @@ void Graphics::dispatchIndirect(Shader *shader, Buffer *indirectargs, int argsin
 
 Graphics::BatchedVertexData Graphics::requestBatchedDraw(const BatchedDrawCommand &cmd)
 {
+	if (drawList != nullptr)
+		return drawList->addBatchedDraw(this, cmd);
+
 	BatchedDrawState &state = batchedDrawState;
 
 	bool shouldflush = false;
@@ -1905,12 +1969,14 @@ Graphics::BatchedVertexData Graphics::requestBatchedDraw(const BatchedDrawComman
 
 	int totalvertices = state.vertexCount + cmd.vertexCount;
 
-	// We only support uint16 index buffers for now.
+	// Batches start out with uint16 indices and are widened to uint32 indices
+	// once they reference more vertices than uint16 can address, rather than
+	// being flushed.
+	IndexDataType indextype = state.indexType;
 	if (totalvertices > LOVE_UINT16_MAX && cmd.indexMode != TRIANGLEINDEX_NONE)
-		shouldflush = true;
+		indextype = INDEX_UINT32;
 
 	int reqIndexCount = getIndexCount(cmd.indexMode, cmd.vertexCount);
-	size_t reqIndexSize = reqIndexCount * sizeof(uint16);
 
 	size_t newdatasizes[2] = {0, 0};
 	size_t buffersizes[3] = {0, 0, 0};
@@ -1937,14 +2003,14 @@ Graphics::BatchedVertexData Graphics::requestBatchedDraw(const BatchedDrawComman
 
 	if (cmd.indexMode != TRIANGLEINDEX_NONE)
 	{
-		size_t datasize = (state.indexCount + reqIndexCount) * sizeof(uint16);
+		size_t datasize = (state.indexCount + reqIndexCount) * getIndexDataSize(indextype);
 
 		if (state.indexBufferMap.data != nullptr && datasize > state.indexBufferMap.size)
 			shouldflush = true;
 
 		if (datasize > state.indexBuffer->getUsableSize())
 		{
-			buffersizes[2] = std::max(datasize, state.indexBuffer->getSize() * 2);
+			buffersizes[2] = alignUp(std::max(datasize, state.indexBuffer->getSize() * 2), sizeof(uint32));
 			shouldresize = true;
 		}
 	}
@@ -1962,6 +2028,8 @@ Graphics::BatchedVertexData Graphics::requestBatchedDraw(const BatchedDrawComman
 
 	if (state.vertexCount == 0)
 	{
+		indextype = cmd.vertexCount > LOVE_UINT16_MAX ? INDEX_UINT32 : INDEX_UINT16;
+
 		if (Shader::isDefaultActive())
 			Shader::attachDefault(state.standardShaderType);
 
@@ -1989,11 +2057,50 @@ Graphics::BatchedVertexData Graphics::requestBatchedDraw(const BatchedDrawComman
 
 	if (cmd.indexMode != TRIANGLEINDEX_NONE)
 	{
+		size_t reqIndexSize = reqIndexCount * getIndexDataSize(indextype);
+
 		if (state.indexBufferMap.data == nullptr)
 			state.indexBufferMap = state.indexBuffer->map(reqIndexSize);
 
-		uint16 *indices = (uint16 *) state.indexBufferMap.data;
-		fillIndices(cmd.indexMode, state.vertexCount, cmd.vertexCount, indices);
+		if (indextype != state.indexType && state.indexCount > 0)
+		{
+			// Stream buffer mappings are write-only, so rather than converting
+			// the batch's existing indices in place we regenerate them.
+			state.indexBufferMap.data -= state.indexCount * getIndexDataSize(state.indexType);
+
+			uint32 *indices = (uint32 *) state.indexBufferMap.data;
+			for (const BatchedIndexRange &range : state.indexRanges)
+			{
+				fillIndices(range.mode, (uint32) range.vertexStart, (uint32) range.vertexCount, indices);
+				indices += getIndexCount(range.mode, range.vertexCount);
+			}
+
+			state.indexBufferMap.data = (uint8 *) indices;
+			state.indexRanges.clear();
+		}
+
+		state.indexType = indextype;
+
+		if (indextype == INDEX_UINT32)
+		{
+			uint32 *indices = (uint32 *) state.indexBufferMap.data;
+			fillIndices(cmd.indexMode, (uint32) state.vertexCount, (uint32) cmd.vertexCount, indices);
+		}
+		else
+		{
+			uint16 *indices = (uint16 *) state.indexBufferMap.data;
+			fillIndices(cmd.indexMode, (uint16) state.vertexCount, (uint16) cmd.vertexCount, indices);
+
+			// Consecutive quad ranges can be merged since each quad's indices
+			// don't depend on the others.
+			if (!state.indexRanges.empty() && cmd.indexMode == TRIANGLEINDEX_QUADS
+				&& state.indexRanges.back().mode == TRIANGLEINDEX_QUADS)
+			{
+				state.indexRanges.back().vertexCount += cmd.vertexCount;
+			}
+			else
+				state.indexRanges.push_back({cmd.indexMode, state.vertexCount, cmd.vertexCount});
+		}
 
 		state.indexBufferMap.data += reqIndexSize;
 	}
@@ -2061,16 +2168,21 @@ void Graphics::flushBatchedDraws()
 
 	if (sbstate.indexCount > 0)
 	{
-		usedsizes[2] = sizeof(uint16) * sbstate.indexCount;
+		usedsizes[2] = getIndexDataSize(sbstate.indexType) * sbstate.indexCount;
 
 		DrawIndexedCommand cmd(&attributes, &buffers, sbstate.indexBuffer);
 		cmd.primitiveType = sbstate.primitiveMode;
 		cmd.indexCount = sbstate.indexCount;
-		cmd.indexType = INDEX_UINT16;
+		cmd.indexType = sbstate.indexType;
 		cmd.indexBufferOffset = sbstate.indexBuffer->unmap(usedsizes[2]);
 		cmd.texture = getTextureOrDefaultForActiveShader(sbstate.texture);
 		draw(cmd);
 
+		if (sbstate.indexType == INDEX_UINT32)
+			batchedDrawsUint32Indices++;
+		else
+			batchedDrawsUint16Indices++;
+
 		sbstate.indexBufferMap = StreamBuffer::MapInfo();
 	}
 	else
@@ -2090,7 +2202,11 @@ void Graphics::flushBatchedDraws()
 	}
 
 	if (usedsizes[2] > 0)
-		sbstate.indexBuffer->markUsed(usedsizes[2]);
+	{
+		// Keep the start of the next batch's indices aligned for uint32 data.
+		size_t alignedsize = alignUp(usedsizes[2], sizeof(uint32));
+		sbstate.indexBuffer->markUsed(std::min(alignedsize, sbstate.indexBuffer->getUsableSize()));
+	}
 
 	popTransform();
 
@@ -2099,6 +2215,8 @@ void Graphics::flushBatchedDraws()
 
 	sbstate.vertexCount = 0;
 	sbstate.indexCount = 0;
+	sbstate.indexType = INDEX_UINT16;
+	sbstate.indexRanges.clear();
 	sbstate.flushing = false;
 }
 
@@ -2113,8 +2231,20 @@ void Graphics::flushBatchedDrawsGlobal()
  * Drawing
  **/
 
+void Graphics::checkDrawListInactive(const char *funcname) const
+{
+	if (drawList != nullptr)
+		throw love::Exception("%s cannot be used while a DrawList is active.", funcname);
+}
+
 void Graphics::draw(Drawable *drawable, const Matrix4 &m)
 {
+	// Textures and Videos go through the batching system, which is what a
+	// DrawList captures. Everything else draws its own buffers directly.
+	if (drawList != nullptr && dynamic_cast<Texture *>(drawable) == nullptr && dynamic_cast<Video *>(drawable) == nullptr
+		&& dynamic_cast<ParticleSystem *>(drawable) == nullptr)
+		throw love::Exception("Only shapes, text, Textures, Videos, and ParticleSystems can be drawn while a DrawList is active.");
+
 	drawable->draw(this, m);
 }
 
@@ -2135,16 +2265,20 @@ void Graphics::drawLayer(Texture *texture, int layer, Quad *quad, const Matrix4
 
 void Graphics::drawInstanced(Mesh *mesh, const Matrix4 &m, int instancecount)
 {
+	checkDrawListInactive("drawInstanced");
 	mesh->drawInstanced(this, m, instancecount);
 }
 
 void Graphics::drawIndirect(Mesh *mesh, const Matrix4 &m, Buffer *indirectargs, int argsindex)
 {
+	checkDrawListInactive("drawIndirect");
 	mesh->drawIndirect(this, m, indirectargs, argsindex);
 }
 
 void Graphics::drawFromShader(PrimitiveType primtype, int vertexcount, int instancecount, Texture *maintexture)
 {
+	checkDrawListInactive("drawFromShader");
+
 	if (primtype == PRIMITIVE_TRIANGLE_FAN && vertexcount > LOVE_UINT16_MAX)
 		throw love::Exception("drawFromShader cannot draw more than %d vertices when the 'fan' draw mode is used.", LOVE_UINT16_MAX);
 
@@ -2181,6 +2315,8 @@ void Graphics::drawFromShader(PrimitiveType primtype, int vertexcount, int insta
 
 void Graphics::drawFromShader(Buffer *indexbuffer, int indexcount, int instancecount, int startindex, Texture *maintexture)
 {
+	checkDrawListInactive("drawFromShader");
+
 	flushBatchedDraws();
 
 	if (!(indexbuffer->getUsageFlags() & BUFFERUSAGEFLAG_INDEX))
@@ -2219,6 +2355,8 @@ void Graphics::drawFromShader(Buffer *indexbuffer, int indexcount, int instancec
 
 void Graphics::drawFromShaderIndirect(PrimitiveType primtype, Buffer *indirectargs, int argsindex, Texture *maintexture)
 {
+	checkDrawListInactive("drawFromShaderIndirect");
+
 	flushBatchedDraws();
 
 	if (primtype == PRIMITIVE_TRIANGLE_FAN)
@@ -2246,6 +2384,8 @@ void Graphics::drawFromShaderIndirect(PrimitiveType primtype, Buffer *indirectar
 
 void Graphics::drawFromShaderIndirect(Buffer *indexbuffer, Buffer *indirectargs, int argsindex, Texture *maintexture)
 {
+	checkDrawListInactive("drawFromShaderIndirect");
+
 	flushBatchedDraws();
 
 	if (!(indexbuffer->getUsageFlags() & BUFFERUSAGEFLAG_INDEX))
@@ -2671,7 +2811,7 @@ Graphics::Stats Graphics::getStats() const
 {
 	Stats stats;
 
-	getAPIStats(stats.shaderSwitches);
+	getAPIStats(stats.shaderSwitches, stats.pipelineCacheHits, stats.pipelineCacheMisses, stats.pipelineCacheUnknown);
 
 	stats.drawCalls = drawCalls;
 	if (batchedDrawState.vertexCount > 0)
@@ -2679,6 +2819,17 @@ Graphics::Stats Graphics::getStats() const
 
 	stats.renderTargetSwitches = renderTargetSwitchCount;
 	stats.drawCallsBatched = drawCallsBatched;
+
+	stats.batchedDrawsUint16Indices = batchedDrawsUint16Indices;
+	stats.batchedDrawsUint32Indices = batchedDrawsUint32Indices;
+	if (batchedDrawState.indexCount > 0)
+	{
+		if (batchedDrawState.indexType == INDEX_UINT32)
+			stats.batchedDrawsUint32Indices++;
+		else
+			stats.batchedDrawsUint16Indices++;
+	}
+
 	stats.textures = Texture::textureCount;
 	stats.fonts = Font::fontCount;
 	stats.buffers = Buffer::bufferCount;
@@ -2688,6 +2839,194 @@ Graphics::Stats Graphics::getStats() const
 	return stats;
 }
 
+void Graphics::pushProfileScope(const std::string &name)
+{
+	if (profileScopeStack.size() == MAX_PROFILE_SCOPE_DEPTH)
+		throw Exception("Maximum profile scope depth reached (more pushes than pops?)");
+
+	// Batched work from before the scope shouldn't be counted in it.
+	flushBatchedDraws();
+
+	ProfileScope scope;
+	scope.name = name;
+	scope.depth = (int) profileScopeStack.size();
+	scope.gpuStartQuery = writeTimestampQuery();
+	scope.cpuStart = timer::Timer::getTime();
+
+	profileScopeStack.push_back(profileScopes.size());
+	profileScopes.push_back(scope);
+}
+
+void Graphics::popProfileScope()
+{
+	if (profileScopeStack.empty())
+		throw Exception("Minimum profile scope depth reached (more pops than pushes?)");
+
+	flushBatchedDraws();
+
+	ProfileScope &scope = profileScopes[profileScopeStack.back()];
+	scope.cpuEnd = timer::Timer::getTime();
+
+	if (scope.gpuStartQuery >= 0)
+		scope.gpuEndQuery = writeTimestampQuery();
+
+	profileScopeStack.pop_back();
+}
+
+const Graphics::ProfileFrame *Graphics::getLatestProfileFrame() const
+{
+	if (completedProfileFrames.empty())
+		return nullptr;
+
+	return &completedProfileFrames.back();
+}
+
+static void appendJSONString(std::string &json, const std::string &str)
+{
+	json += '"';
+
+	for (char c : str)
+	{
+		if (c == '"' || c == '\\')
+		{
+			json += '\\';
+			json += c;
+		}
+		else if ((unsigned char) c < 0x20)
+		{
+			char escaped[8];
+			snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned int) c);
+			json += escaped;
+		}
+		else
+			json += c;
+	}
+
+	json += '"';
+}
+
+static void appendTraceEvent(std::string &json, const Graphics::ProfileScope &scope, uint64 frame, int tid, double start, double end)
+{
+	char buffer[256];
+
+	json += ",\n{\"name\":";
+	appendJSONString(json, scope.name);
+
+	snprintf(buffer, sizeof(buffer), ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%llu,\"depth\":%d}}",
+		tid, start * 1000000.0, (end - start) * 1000000.0, (unsigned long long) frame, scope.depth);
+
+	json += buffer;
+}
+
+std::string Graphics::getProfileTrace() const
+{
+	std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+	json += "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}}";
+	json += ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}";
+
+	for (const ProfileFrame &frame : completedProfileFrames)
+	{
+		// The GPU clock isn't synchronized with the CPU one, so GPU events are
+		// placed relative to the CPU start of the frame's first GPU-timed scope.
+		bool hasgpuoffset = false;
+		double gpuoffset = 0.0;
+
+		for (const ProfileScope &scope : frame.scopes)
+		{
+			appendTraceEvent(json, scope, frame.index, 1, scope.cpuStart, scope.cpuEnd);
+
+			if (scope.gpuStart < 0.0 || scope.gpuEnd < 0.0)
+				continue;
+
+			if (!hasgpuoffset)
+			{
+				gpuoffset = scope.cpuStart - scope.gpuStart;
+				hasgpuoffset = true;
+			}
+
+			appendTraceEvent(json, scope, frame.index, 2, scope.gpuStart + gpuoffset, scope.gpuEnd + gpuoffset);
+		}
+	}
+
+	json += "\n]}\n";
+	return json;
+}
+
+void Graphics::clearProfileFrames()
+{
+	completedProfileFrames.clear();
+}
+
+void Graphics::endProfileFrame()
+{
+	// Unbalanced pushes shouldn't make present fail, since it's also used
+	// to show errors. Close them where the frame ends instead.
+	while (!profileScopeStack.empty())
+		popProfileScope();
+
+	uint64 frame = profileFrameIndex++;
+
+	if (profileScopes.empty())
+	{
+		endTimestampQueries(frame);
+		return;
+	}
+
+	ProfileFrame profileframe;
+	profileframe.index = frame;
+	std::swap(profileframe.scopes, profileScopes);
+
+	bool hasgpuqueries = false;
+	for (const ProfileScope &scope : profileframe.scopes)
+		hasgpuqueries = hasgpuqueries || scope.gpuStartQuery >= 0;
+
+	if (hasgpuqueries)
+	{
+		// Don't let frames pile up if the backend loses track of their queries.
+		if (pendingProfileFrames.size() == MAX_PENDING_PROFILE_FRAMES)
+			resolveProfileFrame(pendingProfileFrames.front().index, {});
+
+		pendingProfileFrames.push_back(std::move(profileframe));
+	}
+	else
+	{
+		completedProfileFrames.push_back(std::move(profileframe));
+		if (completedProfileFrames.size() > MAX_COMPLETED_PROFILE_FRAMES)
+			completedProfileFrames.pop_front();
+	}
+
+	endTimestampQueries(frame);
+}
+
+void Graphics::resolveProfileFrame(uint64 frame, const std::vector<double> &timestamps)
+{
+	for (auto it = pendingProfileFrames.begin(); it != pendingProfileFrames.end(); ++it)
+	{
+		if (it->index != frame)
+			continue;
+
+		int count = (int) timestamps.size();
+
+		for (ProfileScope &scope : it->scopes)
+		{
+			if (scope.gpuStartQuery >= 0 && scope.gpuStartQuery < count && scope.gpuEndQuery >= 0 && scope.gpuEndQuery < count)
+			{
+				scope.gpuStart = timestamps[scope.gpuStartQuery];
+				scope.gpuEnd = timestamps[scope.gpuEndQuery];
+			}
+		}
+
+		completedProfileFrames.push_back(std::move(*it));
+		pendingProfileFrames.erase(it);
+
+		if (completedProfileFrames.size() > MAX_COMPLETED_PROFILE_FRAMES)
+			completedProfileFrames.pop_front();
+
+		return;
+	}
+}
+
 size_t Graphics::getStackDepth() const
 {
 	return stackTypeStack.size();
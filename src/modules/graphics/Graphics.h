@@ -37,6 +37,7 @@
 #include "Shader.h"
 #include "Quad.h"
 #include "Mesh.h"
+#include "ParticleSystem.h"
 #include "GraphicsReadback.h"
 #include "Deprecations.h"
 #include "renderstate.h"
@@ -49,6 +50,7 @@
 // C++
 #include <string>
 #include <vector>
+#include <deque>
 
 namespace love
 {
@@ -57,7 +59,7 @@ namespace graphics
 {
 
 class SpriteBatch;
-class ParticleSystem;
+class DrawList;
 class TextBatch;
 class Video;
 class Buffer;
@@ -220,8 +222,13 @@ class Graphics : public Module
 	{
 		int drawCalls;
 		int drawCallsBatched;
+		int batchedDrawsUint16Indices;
+		int batchedDrawsUint32Indices;
 		int renderTargetSwitches;
 		int shaderSwitches;
+		int pipelineCacheHits;
+		int pipelineCacheMisses;
+		int pipelineCacheUnknown;
 		int textures;
 		int fonts;
 		int buffers;
@@ -229,6 +236,29 @@ class Graphics : public Module
 		int64 bufferMemory;
 	};
 
+	struct ProfileScope
+	{
+		std::string name;
+		int depth = 0;
+
+		// In seconds, from love.timer.getTime.
+		double cpuStart = 0.0;
+		double cpuEnd = 0.0;
+
+		// In seconds on the GPU's own clock, or negative if unavailable.
+		double gpuStart = -1.0;
+		double gpuEnd = -1.0;
+
+		int gpuStartQuery = -1;
+		int gpuEndQuery = -1;
+	};
+
+	struct ProfileFrame
+	{
+		uint64 index = 0;
+		std::vector<ProfileScope> scopes;
+	};
+
 	struct DrawCommand
 	{
 		PrimitiveType primitiveType = PRIMITIVE_TRIANGLES;
@@ -457,7 +487,8 @@ class Graphics : public Module
 	Video *newVideo(love::video::VideoStream *stream, float dpiscale);
 
 	SpriteBatch *newSpriteBatch(Texture *texture, int size, BufferDataUsage usage);
-	ParticleSystem *newParticleSystem(Texture *texture, int size);
+	ParticleSystem *newParticleSystem(Texture *texture, int size, ParticleSystem::SimulationMode mode);
+	DrawList *newDrawList();
 
 	Shader *newShader(const std::vector<std::string> &stagessource, const Shader::CompileOptions &options);
 	Shader *newComputeShader(const std::string &source, const Shader::CompileOptions &options);
@@ -587,6 +618,22 @@ class Graphics : public Module
 	bool isRenderTargetActive(Texture *texture) const;
 	bool isRenderTargetActive(Texture *texture, int slice) const;
 
+	/**
+	 * While a DrawList is set, batched draws are captured into it instead of
+	 * being drawn.
+	 **/
+	void setDrawList(DrawList *list);
+	void setDrawList();
+	DrawList *getDrawList() const;
+
+	/**
+	 * When enabled, drawing a 2D view of a single layer of an array texture
+	 * draws that layer of the array texture instead, so draws of different
+	 * views into the same array texture don't break the current batch.
+	 **/
+	void setArrayTextureBatching(bool enable);
+	bool isArrayTextureBatching() const;
+
 	/**
 	 * Scissor defines a box such that everything outside that box is discarded
 	 * and not drawn. Scissoring is automatically enabled.
@@ -853,6 +900,26 @@ class Graphics : public Module
 	 **/
 	Stats getStats() const;
 
+	/**
+	 * Named, nestable scopes which are timed on the CPU and, when the backend
+	 * supports timestamp queries, on the GPU. GPU results are collected a few
+	 * frames later without waiting on the GPU.
+	 **/
+	void pushProfileScope(const std::string &name);
+	void popProfileScope();
+
+	/**
+	 * Returns the most recent frame whose profile scopes have been fully
+	 * collected, or null if there isn't one.
+	 **/
+	const ProfileFrame *getLatestProfileFrame() const;
+
+	/**
+	 * Returns the collected profile frames as Chrome trace event JSON.
+	 **/
+	std::string getProfileTrace() const;
+	void clearProfileFrames();
+
 	size_t getStackDepth() const;
 	void push(StackType type = STACK_TRANSFORM);
 	void pop();
@@ -959,6 +1026,13 @@ class Graphics : public Module
 		SamplerState defaultSamplerState = SamplerState();
 	};
 
+	struct BatchedIndexRange
+	{
+		TriangleIndexMode mode;
+		int vertexStart;
+		int vertexCount;
+	};
+
 	struct BatchedDrawState
 	{
 		StreamBuffer *vb[2];
@@ -970,6 +1044,11 @@ class Graphics : public Module
 		Shader::StandardShader standardShaderType = Shader::STANDARD_DEFAULT;
 		int vertexCount = 0;
 		int indexCount = 0;
+		IndexDataType indexType = INDEX_UINT16;
+
+		// Index ranges written so far while the batch uses 16 bit indices,
+		// used to regenerate them if the batch has to be widened to 32 bits.
+		std::vector<BatchedIndexRange> indexRanges;
 
 		StreamBuffer::MapInfo vbMap[2];
 		StreamBuffer::MapInfo indexBufferMap = StreamBuffer::MapInfo();
@@ -1022,16 +1101,36 @@ class Graphics : public Module
 	virtual void setRenderTargetsInternal(const RenderTargets &rts, int pixelw, int pixelh, bool hasSRGBtexture) = 0;
 
 	virtual void initCapabilities() = 0;
-	virtual void getAPIStats(int &shaderswitches) const = 0;
+	virtual void getAPIStats(int &shaderswitches, int &pipelinecachehits, int &pipelinecachemisses, int &pipelinecacheunknown) const = 0;
 
 	void createQuadIndexBuffer();
 	void createFanIndexBuffer();
 
+	void checkDrawListInactive(const char *funcname) const;
+
 	void updateTemporaryResources();
 	void clearTemporaryResources();
 
 	void updatePendingReadbacks();
 
+	/**
+	 * Writes a GPU timestamp query at the current point in the current
+	 * frame's commands. Returns the query's index within the frame, or -1 if
+	 * timestamp queries aren't supported.
+	 **/
+	virtual int writeTimestampQuery() { return -1; }
+
+	/**
+	 * Called once no more timestamp queries will be written for the frame.
+	 * Backends call resolveProfileFrame when the query results are ready.
+	 **/
+	virtual void endTimestampQueries(uint64 /*frame*/) {}
+
+	// Must be called by backends when presenting, before submitting the frame.
+	// Scopes which are still open are closed at that point.
+	void endProfileFrame();
+	void resolveProfileFrame(uint64 frame, const std::vector<double> &timestamps);
+
 	void releaseDefaultResources();
 
 	void validateStencilState(const StencilState &s) const;
@@ -1064,6 +1163,9 @@ class Graphics : public Module
 
 	BatchedDrawState batchedDrawState;
 
+	DrawList *drawList;
+	bool arrayTextureBatching;
+
 	std::vector<Matrix4> transformStack;
 	Matrix4 deviceProjectionMatrix;
 
@@ -1078,6 +1180,14 @@ class Graphics : public Module
 	int renderTargetSwitchCount;
 	int drawCalls;
 	int drawCallsBatched;
+	int batchedDrawsUint16Indices;
+	int batchedDrawsUint32Indices;
+
+	std::vector<ProfileScope> profileScopes;
+	std::vector<size_t> profileScopeStack;
+	std::deque<ProfileFrame> pendingProfileFrames;
+	std::deque<ProfileFrame> completedProfileFrames;
+	uint64 profileFrameIndex;
 
 	Buffer *quadIndexBuffer;
 	Buffer *fanIndexBuffer;
@@ -1087,6 +1197,9 @@ class Graphics : public Module
 	Deprecations deprecations;
 
 	static const size_t MAX_USER_STACK_DEPTH = 128;
+	static const size_t MAX_PROFILE_SCOPE_DEPTH = 64;
+	static const size_t MAX_PENDING_PROFILE_FRAMES = 8;
+	static const size_t MAX_COMPLETED_PROFILE_FRAMES = 600;
 	static const int MAX_TEMPORARY_RESOURCE_UNUSED_FRAMES = 16;
 
 private:
@@ -30,6 +30,16 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
+
+#if defined(LOVE_SIMD_SSE)
+#include <xmmintrin.h>
+#define LOVE_PARTICLES_SIMD_SSE
+#elif defined(LOVE_SIMD_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+// vdivq_f32 and vsqrtq_f32 are only available on 64 bit ARM.
+#include <arm_neon.h>
+#define LOVE_PARTICLES_SIMD_NEON
+#endif
 
 namespace love
 {
@@ -53,11 +63,12 @@ float calculate_variation(float inner, float outer, float var)
 
 love::Type ParticleSystem::type("ParticleSystem", &Drawable::type);
 
-ParticleSystem::ParticleSystem(Texture *texture, uint32 size)
+ParticleSystem::ParticleSystem(Texture *texture, uint32 size, SimulationMode mode)
 	: pMem(nullptr)
-	, pFree(nullptr)
-	, pHead(nullptr)
-	, pTail(nullptr)
+	, pQuadIndices(nullptr)
+	, arrayStride(0)
+	, particles()
+	, drawReversed(false)
 	, texture(texture)
 	, active(true)
 	, insertMode(INSERT_MODE_TOP)
@@ -93,8 +104,13 @@ ParticleSystem::ParticleSystem(Texture *texture, uint32 size)
 	, offset(float(texture->getWidth())*0.5f, float(texture->getHeight())*0.5f)
 	, defaultOffset(true)
 	, relativeRotation(false)
-	, vertexAttributes(CommonFormat::XYf_STf_RGBAub, 0)
-	, buffer(nullptr)
+	, simulationMode(mode)
+	, gpuQuadsModified(true)
+	, gpuSpawnSlot(0)
+	, gpuUsedSlots(0)
+	, gpuPendingEmits(0)
+	, gpuSeed(0)
+	, gpuTime(0.0f)
 {
 	if (size == 0 || size > MAX_PARTICLES)
 		throw love::Exception("Invalid ParticleSystem size.");
@@ -102,17 +118,41 @@ ParticleSystem::ParticleSystem(Texture *texture, uint32 size)
 	if (texture->getTextureType() != TEXTURE_2D)
 		throw love::Exception("Only 2D textures can be used with ParticleSystems.");
 
+	if (mode == SIMULATION_GPU)
+	{
+		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+		const Graphics::Capabilities &caps = gfx->getCapabilities();
+
+		if (!caps.features[Graphics::FEATURE_GLSL4] || !caps.features[Graphics::FEATURE_INDIRECT_DRAW])
+			throw love::Exception("GPU-simulated ParticleSystems are not supported on this system.");
+	}
+
 	sizes.push_back(1.0f);
 	colors.push_back(Colorf(1.0f, 1.0f, 1.0f, 1.0f));
 
-	setBufferSize(size);
+	if (simulationMode == SIMULATION_GPU)
+		gpuSystemCount++;
+
+	try
+	{
+		setBufferSize(size);
+	}
+	catch (std::exception &)
+	{
+		// The destructor won't run, and the shared shader may have just been
+		// created.
+		if (simulationMode == SIMULATION_GPU)
+			releaseGPUSystem();
+		throw;
+	}
 }
 
 ParticleSystem::ParticleSystem(const ParticleSystem &p)
 	: pMem(nullptr)
-	, pFree(nullptr)
-	, pHead(nullptr)
-	, pTail(nullptr)
+	, pQuadIndices(nullptr)
+	, arrayStride(0)
+	, particles()
+	, drawReversed(false)
 	, texture(p.texture)
 	, active(p.active)
 	, insertMode(p.insertMode)
@@ -154,15 +194,35 @@ ParticleSystem::ParticleSystem(const ParticleSystem &p)
 	, colors(p.colors)
 	, quads(p.quads)
 	, relativeRotation(p.relativeRotation)
-	, vertexAttributes(p.vertexAttributes)
-	, buffer(nullptr)
+	, simulationMode(p.simulationMode)
+	, gpuQuadsModified(true)
+	, gpuSpawnSlot(0)
+	, gpuUsedSlots(0)
+	, gpuPendingEmits(0)
+	, gpuSeed(0)
+	, gpuTime(0.0f)
 {
-	setBufferSize(maxParticles);
+	if (simulationMode == SIMULATION_GPU)
+		gpuSystemCount++;
+
+	try
+	{
+		setBufferSize(maxParticles);
+	}
+	catch (std::exception &)
+	{
+		if (simulationMode == SIMULATION_GPU)
+			releaseGPUSystem();
+		throw;
+	}
 }
 
 ParticleSystem::~ParticleSystem()
 {
 	deleteBuffers();
+
+	if (simulationMode == SIMULATION_GPU)
+		releaseGPUSystem();
 }
 
 ParticleSystem *ParticleSystem::clone()
@@ -183,17 +243,41 @@ void ParticleSystem::resetOffset()
 
 void ParticleSystem::createBuffers(size_t size)
 {
+	if (simulationMode == SIMULATION_GPU)
+	{
+		createGPUBuffers(size);
+		return;
+	}
+
 	try
 	{
-		pFree = pMem = new Particle[size];
-		maxParticles = (uint32) size;
+		// Round up so every array starts on a 16 byte boundary relative to
+		// the start of the allocation.
+		size_t stride = (size + 3) & ~((size_t) 3);
 
-		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+		pMem = new float[stride * NUM_FLOAT_ARRAYS];
+		pQuadIndices = new int[stride];
+		arrayStride = stride;
+		maxParticles = (uint32) size;
 
-		size_t bytes = sizeof(Vertex) * size * 4;
-		Buffer::Settings settings(BUFFERUSAGEFLAG_VERTEX, BUFFERDATAUSAGE_STREAM);
-		auto decl = Buffer::getCommonFormatDeclaration(CommonFormat::XYf_STf_RGBAub);
-		buffer = gfx->newBuffer(settings, decl, nullptr, bytes, 0);
+		float **arrays[NUM_FLOAT_ARRAYS] = {
+			&particles.lifetime, &particles.life,
+			&particles.positionX, &particles.positionY,
+			&particles.originX, &particles.originY,
+			&particles.velocityX, &particles.velocityY,
+			&particles.linearAccelerationX, &particles.linearAccelerationY,
+			&particles.radialAcceleration, &particles.tangentialAcceleration,
+			&particles.linearDamping,
+			&particles.size, &particles.sizeOffset, &particles.sizeIntervalSize,
+			&particles.rotation, &particles.angle,
+			&particles.spinStart, &particles.spinEnd,
+			&particles.colorR, &particles.colorG, &particles.colorB, &particles.colorA,
+		};
+
+		for (int i = 0; i < NUM_FLOAT_ARRAYS; i++)
+			*arrays[i] = pMem + stride * i;
+
+		particles.quadIndex = pQuadIndices;
 	}
 	catch (std::bad_alloc &)
 	{
@@ -205,11 +289,19 @@ void ParticleSystem::createBuffers(size_t size)
 void ParticleSystem::deleteBuffers()
 {
 	delete[] pMem;
-	if (buffer)
-		buffer->release();
+	delete[] pQuadIndices;
 
 	pMem = nullptr;
-	buffer = nullptr;
+	pQuadIndices = nullptr;
+	arrayStride = 0;
+	particles = ParticleArrays();
+
+	gpuParticleBuffer.set(nullptr);
+	gpuVertexBuffer.set(nullptr);
+	gpuIndexBuffer.set(nullptr);
+	gpuDrawArgsBuffer.set(nullptr);
+	gpuQuadBuffer.set(nullptr);
+
 	maxParticles = 0;
 	activeParticles = 0;
 }
@@ -233,28 +325,28 @@ void ParticleSystem::addParticle(float t)
 	if (isFull())
 		return;
 
-	// Gets a free particle and updates the allocation pointer.
-	Particle *p = pFree++;
-	initParticle(p, t);
-
-	switch (insertMode)
+	if (insertMode != INSERT_MODE_RANDOM && drawReversed != (insertMode == INSERT_MODE_BOTTOM))
 	{
-	default:
-	case INSERT_MODE_TOP:
-		insertTop(p);
-		break;
-	case INSERT_MODE_BOTTOM:
-		insertBottom(p);
-		break;
-	case INSERT_MODE_RANDOM:
-		insertRandom(p);
-		break;
+		// New particles are always appended to the arrays. The bottom insert
+		// mode draws them in reverse, so flip any existing particles when
+		// switching between top and bottom to keep their current order.
+		reverseParticles();
+		drawReversed = !drawReversed;
 	}
 
-	activeParticles++;
+	uint32 index = activeParticles++;
+	initParticle(index, t);
+
+	if (insertMode == INSERT_MODE_RANDOM)
+	{
+		// Nonuniform, but 64-bit is so large nobody will notice. Hopefully.
+		uint32 pos = (uint32) (rng.rand() % (uint64) activeParticles);
+		if (pos != index)
+			swapParticles(pos, index);
+	}
 }
 
-void ParticleSystem::initParticle(Particle *p, float t)
+void ParticleSystem::initParticle(uint32 index, float t)
 {
 	float min,max;
 
@@ -263,13 +355,11 @@ void ParticleSystem::initParticle(Particle *p, float t)
 
 	min = particleLifeMin;
 	max = particleLifeMax;
-	if (min == max)
-		p->life = min;
-	else
-		p->life = (float) rng.random(min, max);
-	p->lifetime = p->life;
+	float plife = min;
+	if (min != max)
+		plife = (float) rng.random(min, max);
 
-	p->position = pos;
+	love::Vector2 ppos = pos;
 
 	min = direction - spread/2.0f;
 	max = direction + spread/2.0f;
@@ -285,15 +375,15 @@ void ParticleSystem::initParticle(Particle *p, float t)
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
 		rand_x = (float) rng.random(-emissionArea.x, emissionArea.x);
 		rand_y = (float) rng.random(-emissionArea.y, emissionArea.y);
-		p->position.x += c * rand_x - s * rand_y;
-		p->position.y += s * rand_x + c * rand_y;
+		ppos.x += c * rand_x - s * rand_y;
+		ppos.y += s * rand_x + c * rand_y;
 		break;
 	case DISTRIBUTION_NORMAL:
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
 		rand_x = (float) rng.randomNormal(emissionArea.x);
 		rand_y = (float) rng.randomNormal(emissionArea.y);
-		p->position.x += c * rand_x - s * rand_y;
-		p->position.y += s * rand_x + c * rand_y;
+		ppos.x += c * rand_x - s * rand_y;
+		ppos.y += s * rand_x + c * rand_y;
 		break;
 	case DISTRIBUTION_ELLIPSE:
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
@@ -301,16 +391,16 @@ void ParticleSystem::initParticle(Particle *p, float t)
 		rand_y = (float) rng.random(-1, 1);
 		min = emissionArea.x * (rand_x * sqrt(1 - 0.5f*pow(rand_y, 2)));
 		max = emissionArea.y * (rand_y * sqrt(1 - 0.5f*pow(rand_x, 2)));
-		p->position.x += c * min - s * max;
-		p->position.y += s * min + c * max;
+		ppos.x += c * min - s * max;
+		ppos.y += s * min + c * max;
 		break;
 	case DISTRIBUTION_BORDER_ELLIPSE:
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
 		rand_x = (float) rng.random(0, LOVE_M_PI * 2);
 		min = cosf(rand_x) * emissionArea.x;
 		max = sinf(rand_x) * emissionArea.y;
-		p->position.x += c * min - s * max;
-		p->position.y += s * min + c * max;
+		ppos.x += c * min - s * max;
+		ppos.y += s * min + c * max;
 		break;
 	case DISTRIBUTION_BORDER_RECTANGLE:
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
@@ -319,26 +409,26 @@ void ParticleSystem::initParticle(Particle *p, float t)
 		if (rand_x < -rand_y)
 		{
 			min = rand_x + rand_y + emissionArea.x;
-			p->position.x += c * min - s * -emissionArea.y;
-			p->position.y += s * min + c * -emissionArea.y;
+			ppos.x += c * min - s * -emissionArea.y;
+			ppos.y += s * min + c * -emissionArea.y;
 		}
 		else if (rand_x < 0)
 		{
 			max = rand_x + emissionArea.y;
-			p->position.x += c * -emissionArea.x - s * max;
-			p->position.y += s * -emissionArea.x + c * max;
+			ppos.x += c * -emissionArea.x - s * max;
+			ppos.y += s * -emissionArea.x + c * max;
 		}
 		else if (rand_x < rand_y)
 		{
 			max = rand_x - emissionArea.y;
-			p->position.x += c * emissionArea.x - s * max;
-			p->position.y += s * emissionArea.x + c * max;
+			ppos.x += c * emissionArea.x - s * max;
+			ppos.y += s * emissionArea.x + c * max;
 		}
 		else
 		{
 			min = rand_x - rand_y - emissionArea.x;
-			p->position.x += c * min - s * emissionArea.y;
-			p->position.y += s * min + c * emissionArea.y;
+			ppos.x += c * min - s * emissionArea.y;
+			ppos.y += s * min + c * emissionArea.y;
 		}
 		break;
 	case DISTRIBUTION_NONE:
@@ -348,154 +438,138 @@ void ParticleSystem::initParticle(Particle *p, float t)
 
 	// Determine if the origin of each particle is the center of the area
 	if (directionRelativeToEmissionCenter)
-		dir += atan2(p->position.y - pos.y, p->position.x - pos.x);
-
-	p->origin = pos;
+		dir += atan2(ppos.y - pos.y, ppos.x - pos.x);
 
 	min = speedMin;
 	max = speedMax;
 	float speed = (float) rng.random(min, max);
 
-	p->velocity = love::Vector2(cosf(dir), sinf(dir)) * speed;
+	love::Vector2 velocity = love::Vector2(cosf(dir), sinf(dir)) * speed;
+
+	ParticleArrays &p = particles;
+
+	p.life[index] = plife;
+	p.lifetime[index] = plife;
+
+	p.positionX[index] = ppos.x;
+	p.positionY[index] = ppos.y;
 
-	p->linearAcceleration.x = (float) rng.random(linearAccelerationMin.x, linearAccelerationMax.x);
-	p->linearAcceleration.y = (float) rng.random(linearAccelerationMin.y, linearAccelerationMax.y);
+	p.originX[index] = pos.x;
+	p.originY[index] = pos.y;
+
+	p.velocityX[index] = velocity.x;
+	p.velocityY[index] = velocity.y;
+
+	p.linearAccelerationX[index] = (float) rng.random(linearAccelerationMin.x, linearAccelerationMax.x);
+	p.linearAccelerationY[index] = (float) rng.random(linearAccelerationMin.y, linearAccelerationMax.y);
 
 	min = radialAccelerationMin;
 	max = radialAccelerationMax;
-	p->radialAcceleration = (float) rng.random(min, max);
+	p.radialAcceleration[index] = (float) rng.random(min, max);
 
 	min = tangentialAccelerationMin;
 	max = tangentialAccelerationMax;
-	p->tangentialAcceleration = (float) rng.random(min, max);
+	p.tangentialAcceleration[index] = (float) rng.random(min, max);
 
 	min = linearDampingMin;
 	max = linearDampingMax;
-	p->linearDamping = (float) rng.random(min, max);
+	p.linearDamping[index] = (float) rng.random(min, max);
 
-	p->sizeOffset       = (float) rng.random(sizeVariation); // time offset for size change
-	p->sizeIntervalSize = (1.0f - (float) rng.random(sizeVariation)) - p->sizeOffset;
-	p->size = sizes[(size_t)(p->sizeOffset - .5f) * (sizes.size() - 1)];
+	float sizeOffset = (float) rng.random(sizeVariation); // time offset for size change
+	p.sizeOffset[index] = sizeOffset;
+	p.sizeIntervalSize[index] = (1.0f - (float) rng.random(sizeVariation)) - sizeOffset;
+	p.size[index] = sizes[(size_t)(sizeOffset - .5f) * (sizes.size() - 1)];
 
 	min = rotationMin;
 	max = rotationMax;
-	p->spinStart = calculate_variation(spinStart, spinEnd, spinVariation);
-	p->spinEnd = calculate_variation(spinEnd, spinStart, spinVariation);
-	p->rotation = (float) rng.random(min, max);
+	p.spinStart[index] = calculate_variation(spinStart, spinEnd, spinVariation);
+	p.spinEnd[index] = calculate_variation(spinEnd, spinStart, spinVariation);
 
-	p->angle = p->rotation;
+	float rotation = (float) rng.random(min, max);
+	p.rotation[index] = rotation;
+	p.angle[index] = rotation;
 	if (relativeRotation)
-		p->angle += atan2f(p->velocity.y, p->velocity.x);
+		p.angle[index] += atan2f(velocity.y, velocity.x);
 
-	p->color = colors[0];
+	p.colorR[index] = colors[0].r;
+	p.colorG[index] = colors[0].g;
+	p.colorB[index] = colors[0].b;
+	p.colorA[index] = colors[0].a;
 
-	p->quadIndex = 0;
+	p.quadIndex[index] = 0;
 }
 
-void ParticleSystem::insertTop(Particle *p)
+void ParticleSystem::copyParticle(uint32 dst, uint32 src)
 {
-	if (pHead == nullptr)
-	{
-		pHead = p;
-		p->prev = nullptr;
-	}
-	else
-	{
-		pTail->next = p;
-		p->prev = pTail;
-	}
-	p->next = nullptr;
-	pTail = p;
-}
+	size_t stride = arrayStride;
 
-void ParticleSystem::insertBottom(Particle *p)
-{
-	if (pTail == nullptr)
-	{
-		pTail = p;
-		p->next = nullptr;
-	}
-	else
-	{
-		pHead->prev = p;
-		p->next = pHead;
-	}
-	p->prev = nullptr;
-	pHead = p;
+	for (int i = 0; i < NUM_FLOAT_ARRAYS; i++)
+		pMem[stride * i + dst] = pMem[stride * i + src];
+
+	pQuadIndices[dst] = pQuadIndices[src];
 }
 
-void ParticleSystem::insertRandom(Particle *p)
+void ParticleSystem::swapParticles(uint32 a, uint32 b)
 {
-	// Nonuniform, but 64-bit is so large nobody will notice. Hopefully.
-	uint64 pos = rng.rand() % ((int64) activeParticles + 1);
+	size_t stride = arrayStride;
 
-	// Special case where the particle gets inserted before the head.
-	if (pos == activeParticles)
-	{
-		Particle *pA = pHead;
-		if (pA)
-			pA->prev = p;
-		p->prev = nullptr;
-		p->next = pA;
-		pHead = p;
-		return;
-	}
+	for (int i = 0; i < NUM_FLOAT_ARRAYS; i++)
+		std::swap(pMem[stride * i + a], pMem[stride * i + b]);
 
-	// Inserts the particle after the randomly selected particle.
-	Particle *pA = pMem + pos;
-	Particle *pB = pA->next;
-	pA->next = p;
-	if (pB)
-		pB->prev = p;
-	else
-		pTail = p;
-	p->prev = pA;
-	p->next = pB;
+	std::swap(pQuadIndices[a], pQuadIndices[b]);
 }
 
-ParticleSystem::Particle *ParticleSystem::removeParticle(Particle *p)
+void ParticleSystem::reverseParticles()
 {
-	// The linked list is updated in this function and old pointers may be
-	// invalidated. The returned pointer will inform the caller of the new
-	// pointer to the next particle.
-	Particle *pNext = nullptr;
+	for (uint32 i = 0; i < activeParticles / 2; i++)
+		swapParticles(i, activeParticles - 1 - i);
+}
 
-	// Removes the particle from the linked list.
-	if (p->prev)
-		p->prev->next = p->next;
-	else
-		pHead = p->next;
+void ParticleSystem::removeDeadParticles(float dt)
+{
+	float *life = particles.life;
 
-	if (p->next)
+	if (insertMode == INSERT_MODE_RANDOM)
 	{
-		p->next->prev = p->prev;
-		pNext = p->next;
+		// Order doesn't matter, so the last particle can be moved into the
+		// free slot.
+		for (uint32 i = 0; i < activeParticles;)
+		{
+			life[i] -= dt;
+
+			if (life[i] <= 0)
+			{
+				activeParticles--;
+				if (i != activeParticles)
+				{
+					copyParticle(i, activeParticles);
+					// The moved particle hasn't had its life decreased yet.
+					life[i] += dt;
+				}
+			}
+			else
+				i++;
+		}
 	}
 	else
-		pTail = p->prev;
-
-	// The (in memory) last particle can now be moved into the free slot.
-	// It will skip the moving if it happens to be the removed particle.
-	pFree--;
-	if (p != pFree)
 	{
-		*p = *pFree;
-		if (pNext == pFree)
-			pNext = p;
+		// Compact the arrays while keeping the particles in order.
+		uint32 alive = 0;
 
-		if (p->prev)
-			p->prev->next = p;
-		else
-			pHead = p;
+		for (uint32 i = 0; i < activeParticles; i++)
+		{
+			life[i] -= dt;
 
-		if (p->next)
-			p->next->prev = p;
-		else
-			pTail = p;
-	}
+			if (life[i] > 0)
+			{
+				if (alive != i)
+					copyParticle(alive, i);
+				alive++;
+			}
+		}
 
-	activeParticles--;
-	return pNext;
+		activeParticles = alive;
+	}
 }
 
 void ParticleSystem::setTexture(Texture *tex)
@@ -504,6 +578,7 @@ void ParticleSystem::setTexture(Texture *tex)
 		throw love::Exception("Only 2D textures can be used with ParticleSystems.");
 
 	texture.set(tex);
+	gpuQuadsModified = true;
 
 	if (defaultOffset)
 		resetOffset();
@@ -524,6 +599,11 @@ ParticleSystem::InsertMode ParticleSystem::getInsertMode() const
 	return insertMode;
 }
 
+ParticleSystem::SimulationMode ParticleSystem::getSimulationMode() const
+{
+	return simulationMode;
+}
+
 void ParticleSystem::setEmissionRate(float rate)
 {
 	if (rate < 0.0f)
@@ -807,6 +887,7 @@ void ParticleSystem::setQuads(const std::vector<Quad *> &newQuads)
 		quadlist.push_back(q);
 
 	quads = quadlist;
+	gpuQuadsModified = true;
 
 	if (defaultOffset)
 		resetOffset();
@@ -815,6 +896,7 @@ void ParticleSystem::setQuads(const std::vector<Quad *> &newQuads)
 void ParticleSystem::setQuads()
 {
 	quads.clear();
+	gpuQuadsModified = true;
 }
 
 std::vector<Quad *> ParticleSystem::getQuads() const
@@ -862,13 +944,22 @@ void ParticleSystem::pause()
 
 void ParticleSystem::reset()
 {
-	if (pMem == nullptr)
+	if (simulationMode == SIMULATION_GPU && gpuParticleBuffer.get() != nullptr)
+	{
+		const uint32 drawargs[] = {0, 1, 0, 0, 0};
+		gpuParticleBuffer->clear(0, gpuParticleBuffer->getSize());
+		gpuDrawArgsBuffer->fill(0, sizeof(drawargs), drawargs);
+
+		gpuSpawnSlot = 0;
+		gpuUsedSlots = 0;
+		gpuPendingEmits = 0;
+		gpuSpawnBatches.clear();
+	}
+	else if (pMem == nullptr)
 		return;
 
-	pFree = pMem;
-	pHead = nullptr;
-	pTail = nullptr;
 	activeParticles = 0;
+	drawReversed = false;
 	life = lifetime;
 	emitCounter = 0;
 }
@@ -878,6 +969,13 @@ void ParticleSystem::emit(uint32 num)
 	if (!active)
 		return;
 
+	if (simulationMode == SIMULATION_GPU)
+	{
+		// Spawned by the compute shader during the next update.
+		gpuPendingEmits = std::min(gpuPendingEmits + num, maxParticles);
+		return;
+	}
+
 	num = std::min(num, maxParticles - activeParticles);
 
 	while (num--)
@@ -909,99 +1007,247 @@ bool ParticleSystem::isFull() const
 	return activeParticles == maxParticles;
 }
 
-void ParticleSystem::update(float dt)
+void ParticleSystem::updateParticles(uint32 start, uint32 end, float dt)
 {
-	if (pMem == nullptr || dt == 0.0f)
-		return;
+	ParticleArrays &p = particles;
 
-	// Traverse all particles and update.
-	Particle *p = pHead;
-
-	while (p)
+	for (uint32 i = start; i < end; i++)
 	{
-		// Decrease lifespan.
-		p->life -= dt;
+		// Get vector from particle center to particle.
+		love::Vector2 radial(p.positionX[i] - p.originX[i], p.positionY[i] - p.originY[i]);
+		radial.normalize();
 
-		if (p->life <= 0)
-			p = removeParticle(p);
-		else
-		{
-			// Temp variables.
-			love::Vector2 radial, tangential;
-			love::Vector2 ppos = p->position;
+		// Calculate tangential acceleration.
+		love::Vector2 tangential(-radial.y, radial.x);
 
-			// Get vector from particle center to particle.
-			radial = ppos - p->origin;
-			radial.normalize();
-			tangential = radial;
+		radial *= p.radialAcceleration[i];
+		tangential *= p.tangentialAcceleration[i];
 
-			// Resize radial acceleration.
-			radial *= p->radialAcceleration;
+		// Update velocity.
+		float vx = p.velocityX[i] + (radial.x + tangential.x + p.linearAccelerationX[i]) * dt;
+		float vy = p.velocityY[i] + (radial.y + tangential.y + p.linearAccelerationY[i]) * dt;
 
-			// Calculate tangential acceleration.
-			{
-				float a = tangential.x;
-				tangential.x = -tangential.y;
-				tangential.y = a;
-			}
+		// Apply damping.
+		float damping = 1.0f / (1.0f + p.linearDamping[i] * dt);
+		vx *= damping;
+		vy *= damping;
+
+		p.velocityX[i] = vx;
+		p.velocityY[i] = vy;
+
+		// Modify position.
+		p.positionX[i] += vx * dt;
+		p.positionY[i] += vy * dt;
+
+		const float t = 1.0f - p.life[i] / p.lifetime[i];
 
-			// Resize tangential.
-			tangential *= p->tangentialAcceleration;
+		// Rotate.
+		p.rotation[i] += (p.spinStart[i] * (1.0f - t) + p.spinEnd[i] * t) * dt;
+		p.angle[i] = p.rotation[i];
+	}
+}
+
+void ParticleSystem::updateParticlesSIMD(float dt)
+{
+	uint32 count = activeParticles;
+	uint32 simdcount = 0;
 
-			// Update velocity.
-			p->velocity += (radial + tangential + p->linearAcceleration) * dt;
+#if defined(LOVE_PARTICLES_SIMD_SSE)
 
-			// Apply damping.
-			p->velocity *= 1.0f / (1.0f + p->linearDamping * dt);
+	ParticleArrays &p = particles;
+	simdcount = count & ~3u;
 
-			// Modify position.
-			ppos += p->velocity * dt;
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 vdt = _mm_set1_ps(dt);
 
-			p->position = ppos;
+	// We can't guarantee 16 byte alignment of the allocation, so unaligned
+	// loads and stores are used.
+	for (uint32 i = 0; i < simdcount; i += 4)
+	{
+		__m128 px = _mm_loadu_ps(&p.positionX[i]);
+		__m128 py = _mm_loadu_ps(&p.positionY[i]);
+
+		// Normalized vector from the particle's origin to the particle.
+		__m128 rx = _mm_sub_ps(px, _mm_loadu_ps(&p.originX[i]));
+		__m128 ry = _mm_sub_ps(py, _mm_loadu_ps(&p.originY[i]));
+		__m128 len2 = _mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry));
+		__m128 invlen = _mm_and_ps(_mm_div_ps(one, _mm_sqrt_ps(len2)), _mm_cmpgt_ps(len2, zero));
+		rx = _mm_mul_ps(rx, invlen);
+		ry = _mm_mul_ps(ry, invlen);
+
+		__m128 ra = _mm_loadu_ps(&p.radialAcceleration[i]);
+		__m128 ta = _mm_loadu_ps(&p.tangentialAcceleration[i]);
+
+		// Radial, tangential and linear acceleration.
+		__m128 ax = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(rx, ra), _mm_mul_ps(ry, ta)), _mm_loadu_ps(&p.linearAccelerationX[i]));
+		__m128 ay = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ry, ra), _mm_mul_ps(rx, ta)), _mm_loadu_ps(&p.linearAccelerationY[i]));
+
+		__m128 vx = _mm_add_ps(_mm_loadu_ps(&p.velocityX[i]), _mm_mul_ps(ax, vdt));
+		__m128 vy = _mm_add_ps(_mm_loadu_ps(&p.velocityY[i]), _mm_mul_ps(ay, vdt));
+
+		// Damping.
+		__m128 damping = _mm_div_ps(one, _mm_add_ps(one, _mm_mul_ps(_mm_loadu_ps(&p.linearDamping[i]), vdt)));
+		vx = _mm_mul_ps(vx, damping);
+		vy = _mm_mul_ps(vy, damping);
+
+		_mm_storeu_ps(&p.velocityX[i], vx);
+		_mm_storeu_ps(&p.velocityY[i], vy);
+		_mm_storeu_ps(&p.positionX[i], _mm_add_ps(px, _mm_mul_ps(vx, vdt)));
+		_mm_storeu_ps(&p.positionY[i], _mm_add_ps(py, _mm_mul_ps(vy, vdt)));
+
+		// Spin.
+		__m128 t = _mm_sub_ps(one, _mm_div_ps(_mm_loadu_ps(&p.life[i]), _mm_loadu_ps(&p.lifetime[i])));
+		__m128 spin = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&p.spinStart[i]), _mm_sub_ps(one, t)), _mm_mul_ps(_mm_loadu_ps(&p.spinEnd[i]), t));
+		__m128 rotation = _mm_add_ps(_mm_loadu_ps(&p.rotation[i]), _mm_mul_ps(spin, vdt));
+
+		_mm_storeu_ps(&p.rotation[i], rotation);
+		_mm_storeu_ps(&p.angle[i], rotation);
+	}
 
-			const float t = 1.0f - p->life / p->lifetime;
+#elif defined(LOVE_PARTICLES_SIMD_NEON)
 
-			// Rotate.
-			p->rotation += (p->spinStart * (1.0f - t) + p->spinEnd * t) * dt;
+	ParticleArrays &p = particles;
+	simdcount = count & ~3u;
 
-			p->angle = p->rotation;
+	const float32x4_t zero = vdupq_n_f32(0.0f);
+	const float32x4_t one = vdupq_n_f32(1.0f);
 
-			if (relativeRotation)
-				p->angle += atan2f(p->velocity.y, p->velocity.x);
+	for (uint32 i = 0; i < simdcount; i += 4)
+	{
+		float32x4_t px = vld1q_f32(&p.positionX[i]);
+		float32x4_t py = vld1q_f32(&p.positionY[i]);
+
+		// Normalized vector from the particle's origin to the particle.
+		float32x4_t rx = vsubq_f32(px, vld1q_f32(&p.originX[i]));
+		float32x4_t ry = vsubq_f32(py, vld1q_f32(&p.originY[i]));
+		float32x4_t len2 = vmlaq_f32(vmulq_f32(rx, rx), ry, ry);
+		float32x4_t invlen = vdivq_f32(one, vsqrtq_f32(len2));
+		invlen = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(invlen), vcgtq_f32(len2, zero)));
+		rx = vmulq_f32(rx, invlen);
+		ry = vmulq_f32(ry, invlen);
+
+		float32x4_t ra = vld1q_f32(&p.radialAcceleration[i]);
+		float32x4_t ta = vld1q_f32(&p.tangentialAcceleration[i]);
+
+		// Radial, tangential and linear acceleration.
+		float32x4_t ax = vaddq_f32(vmlsq_f32(vmulq_f32(rx, ra), ry, ta), vld1q_f32(&p.linearAccelerationX[i]));
+		float32x4_t ay = vaddq_f32(vmlaq_f32(vmulq_f32(ry, ra), rx, ta), vld1q_f32(&p.linearAccelerationY[i]));
+
+		float32x4_t vx = vmlaq_n_f32(vld1q_f32(&p.velocityX[i]), ax, dt);
+		float32x4_t vy = vmlaq_n_f32(vld1q_f32(&p.velocityY[i]), ay, dt);
+
+		// Damping.
+		float32x4_t damping = vdivq_f32(one, vmlaq_n_f32(one, vld1q_f32(&p.linearDamping[i]), dt));
+		vx = vmulq_f32(vx, damping);
+		vy = vmulq_f32(vy, damping);
+
+		vst1q_f32(&p.velocityX[i], vx);
+		vst1q_f32(&p.velocityY[i], vy);
+		vst1q_f32(&p.positionX[i], vmlaq_n_f32(px, vx, dt));
+		vst1q_f32(&p.positionY[i], vmlaq_n_f32(py, vy, dt));
+
+		// Spin.
+		float32x4_t t = vsubq_f32(one, vdivq_f32(vld1q_f32(&p.life[i]), vld1q_f32(&p.lifetime[i])));
+		float32x4_t spin = vmlaq_f32(vmulq_f32(vld1q_f32(&p.spinStart[i]), vsubq_f32(one, t)), vld1q_f32(&p.spinEnd[i]), t);
+		float32x4_t rotation = vmlaq_n_f32(vld1q_f32(&p.rotation[i]), spin, dt);
+
+		vst1q_f32(&p.rotation[i], rotation);
+		vst1q_f32(&p.angle[i], rotation);
+	}
+
+#endif
+
+	// Remaining particles (or all of them, without SIMD support.)
+	updateParticles(simdcount, count, dt);
+}
+
+void ParticleSystem::update(float dt)
+{
+	if (simulationMode == SIMULATION_GPU)
+	{
+		if (dt != 0.0f)
+			updateGPU(dt);
+		return;
+	}
 
-			// Change size according to given intervals:
-			// i = 0       1       2      3          n-1
-			//     |-------|-------|------|--- ... ---|
-			// t = 0    1/(n-1)        3/(n-1)        1
-			//
-			// `s' is the interpolation variable scaled to the current
-			// interval width, e.g. if n = 5 and t = 0.3, then the current
-			// indices are 1,2 and s = 0.3 - 0.25 = 0.05
-			float s = p->sizeOffset + t * p->sizeIntervalSize; // size variation
+	if (pMem == nullptr || dt == 0.0f)
+		return;
+
+	// Decrease lifespans and remove dead particles.
+	removeDeadParticles(dt);
+
+	// Update movement and rotation of the remaining particles.
+	updateParticlesSIMD(dt);
+
+	ParticleArrays &p = particles;
+	uint32 count = activeParticles;
+
+	if (relativeRotation)
+	{
+		for (uint32 i = 0; i < count; i++)
+			p.angle[i] += atan2f(p.velocityY[i], p.velocityX[i]);
+	}
+
+	// Change size according to given intervals:
+	// i = 0       1       2      3          n-1
+	//     |-------|-------|------|--- ... ---|
+	// t = 0    1/(n-1)        3/(n-1)        1
+	//
+	// `s' is the interpolation variable scaled to the current
+	// interval width, e.g. if n = 5 and t = 0.3, then the current
+	// indices are 1,2 and s = 0.3 - 0.25 = 0.05
+	if (sizes.size() == 1)
+		std::fill(p.size, p.size + count, sizes[0]);
+	else
+	{
+		for (uint32 j = 0; j < count; j++)
+		{
+			const float t = 1.0f - p.life[j] / p.lifetime[j];
+			float s = p.sizeOffset[j] + t * p.sizeIntervalSize[j]; // size variation
 			s *= (float)(sizes.size() - 1); // 0 <= s < sizes.size()
 			size_t i = (size_t)s;
 			size_t k = (i == sizes.size() - 1) ? i : i + 1; // boundary check (prevents failing on t = 1.0f)
 			s -= (float)i; // transpose s to be in interval [0:1]: i <= s < i + 1 ~> 0 <= s < 1
-			p->size = sizes[i] * (1.0f - s) + sizes[k] * s;
-
-			// Update color according to given intervals (as above)
-			s = t * (float)(colors.size() - 1);
-			i = (size_t)s;
-			k = (i == colors.size() - 1) ? i : i + 1;
-			s -= (float)i;                            // 0 <= s <= 1
-			p->color = colors[i] * (1.0f - s) + colors[k] * s;
-
-			// Update the quad index.
-			k = quads.size();
-			if (k > 0)
-			{
-				s = t * (float) k; // [0:numquads-1] (clamped below)
-				i = (s > 0.0f) ? (size_t) s : 0;
-				p->quadIndex = (int) ((i < k) ? i : k - 1);
-			}
+			p.size[j] = sizes[i] * (1.0f - s) + sizes[k] * s;
+		}
+	}
+
+	// Update color according to given intervals (as above)
+	if (colors.size() == 1)
+	{
+		std::fill(p.colorR, p.colorR + count, colors[0].r);
+		std::fill(p.colorG, p.colorG + count, colors[0].g);
+		std::fill(p.colorB, p.colorB + count, colors[0].b);
+		std::fill(p.colorA, p.colorA + count, colors[0].a);
+	}
+	else
+	{
+		for (uint32 j = 0; j < count; j++)
+		{
+			const float t = 1.0f - p.life[j] / p.lifetime[j];
+			float s = t * (float)(colors.size() - 1);
+			size_t i = (size_t)s;
+			size_t k = (i == colors.size() - 1) ? i : i + 1;
+			s -= (float)i; // 0 <= s <= 1
+			Colorf c = colors[i] * (1.0f - s) + colors[k] * s;
+			p.colorR[j] = c.r;
+			p.colorG[j] = c.g;
+			p.colorB[j] = c.b;
+			p.colorA[j] = c.a;
+		}
+	}
 
-			// Next particle.
-			p = p->next;
+	// Update the quad index.
+	size_t numquads = quads.size();
+	if (numquads > 0)
+	{
+		for (uint32 j = 0; j < count; j++)
+		{
+			const float t = 1.0f - p.life[j] / p.lifetime[j];
+			float s = t * (float) numquads; // [0:numquads-1] (clamped below)
+			size_t i = (s > 0.0f) ? (size_t) s : 0;
+			p.quadIndex[j] = (int) ((i < numquads) ? i : numquads - 1);
 		}
 	}
 
@@ -1027,67 +1273,615 @@ void ParticleSystem::update(float dt)
 
 void ParticleSystem::draw(Graphics *gfx, const Matrix4 &m)
 {
+	if (simulationMode == SIMULATION_GPU)
+	{
+		drawGPU(gfx, m);
+		return;
+	}
+
 	uint32 pCount = getCount();
 
-	if (pCount == 0 || texture.get() == nullptr || pMem == nullptr || buffer == nullptr)
+	if (pCount == 0 || texture.get() == nullptr || pMem == nullptr)
 		return;
 
-	gfx->flushBatchedDraws();
+	const Matrix4 &tm = gfx->getTransform();
+	bool is2D = tm.isAffine2DTransform();
 
-	if (Shader::isDefaultActive())
-		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+	Matrix4 t(tm, m);
 
-	if (Shader::current)
-		Shader::current->validateDrawState(PRIMITIVE_TRIANGLES, texture);
+	Graphics::BatchedDrawCommand cmd;
+	cmd.formats[0] = getSinglePositionFormat(is2D);
+	cmd.formats[1] = CommonFormat::STf_RGBAub;
+	cmd.indexMode = TRIANGLEINDEX_QUADS;
+	cmd.texture = texture;
 
 	const Vector2 *positions = texture->getQuad()->getVertexPositions();
 	const Vector2 *texcoords = texture->getQuad()->getVertexTexCoords();
 
-	Vertex *pVerts = (Vertex *) buffer->map(Buffer::MAP_WRITE_INVALIDATE, 0, buffer->getSize());
-	Particle *p = pHead;
-
 	bool useQuads = !quads.empty();
 
-	Matrix3 t;
+	const ParticleArrays &p = particles;
+	Colorf gc = gfx->getColor();
+
+	Matrix3 pt;
+	Vector2 localpositions[4];
+
+	// Batched draws switch to 32 bit indices when needed, so the whole system
+	// goes into a single draw. Vertices are written straight into the batched
+	// stream buffers.
+	cmd.vertexCount = (int) pCount * 4;
 
-	// set the vertex data for each particle (transformation, texcoords, color)
-	while (p)
+	Graphics::BatchedVertexData data = gfx->requestBatchedDraw(cmd);
+	STf_RGBAub *vertexdata = (STf_RGBAub *) data.stream[1];
+
+	for (uint32 j = 0; j < pCount; j++)
 	{
+		uint32 i = drawReversed ? pCount - 1 - j : j;
+
 		if (useQuads)
 		{
-			positions = quads[p->quadIndex]->getVertexPositions();
-			texcoords = quads[p->quadIndex]->getVertexTexCoords();
+			positions = quads[p.quadIndex[i]]->getVertexPositions();
+			texcoords = quads[p.quadIndex[i]]->getVertexTexCoords();
 		}
 
 		// particle vertices are image vertices transformed by particle info
-		t.setTransformation(p->position.x, p->position.y, p->angle, p->size, p->size, offset.x, offset.y, 0.0f, 0.0f);
-		t.transformXY(pVerts, positions, 4);
+		float size = p.size[i];
+		pt.setTransformation(p.positionX[i], p.positionY[i], p.angle[i], size, size, offset.x, offset.y, 0.0f, 0.0f);
+		pt.transformXY(localpositions, positions, 4);
+
+		if (is2D)
+			t.transformXY((Vector2 *) data.stream[0] + j * 4, localpositions, 4);
+		else
+			t.transformXY0((Vector3 *) data.stream[0] + j * 4, localpositions, 4);
 
 		// Particle colors are stored as floats (0-1) but vertex colors are
 		// unsigned bytes (0-255).
-		Color32 c = toColor32(p->color);
+		Colorf pc(p.colorR[i] * gc.r, p.colorG[i] * gc.g, p.colorB[i] * gc.b, p.colorA[i] * gc.a);
+		Color32 c = toColor32(pc);
 
 		// set the texture coordinate and color data for particle vertices
 		for (int v = 0; v < 4; v++)
 		{
-			pVerts[v].s = texcoords[v].x;
-			pVerts[v].t = texcoords[v].y;
-			pVerts[v].color = c;
+			vertexdata[v].s = texcoords[v].x;
+			vertexdata[v].t = texcoords[v].y;
+			vertexdata[v].color = c;
+		}
+
+		vertexdata += 4;
+	}
+}
+
+// Particle data and vertices are generated by this compute shader and drawn
+// with an indirect draw, so GPU-simulated particles never need a readback.
+// New particles are spawned into a ring of slots. Surviving particles append
+// their vertices to a compacted vertex buffer, and bump the draw's index
+// count with an atomic add.
+static const char gpuParticleShaderCode[] = R"(
+layout(local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+
+struct Particle
+{
+	vec4 positionVelocity; // xy: position, zw: velocity
+	vec4 originLife;       // xy: origin, z: remaining life, w: lifetime
+	vec4 acceleration;     // xy: linear, z: radial, w: tangential
+	vec4 sizeRotation;     // x: linear damping, y: size offset, z: size interval, w: rotation
+	vec4 spin;             // x: spin start, y: spin end
+};
+
+struct ParticleVertex
+{
+	vec2 position;
+	vec2 texcoord;
+	vec4 color;
+};
+
+layout(std430) buffer ParticleBuffer { Particle particles[]; };
+layout(std430) writeonly buffer VertexBuffer { ParticleVertex vertices[]; };
+layout(std430) buffer DrawArgsBuffer { uint drawArgs[]; };
+layout(std430) readonly buffer QuadBuffer { vec4 quadVertices[]; };
+
+uniform ivec4 SpawnParams; // x: first spawn slot, y: spawn count, z: interpolated spawn count, w: buffer size
+uniform ivec4 SimParams; // x: used slots, y: random seed, z: area distribution, w: flags
+uniform ivec4 Counts; // x: sizes, y: colors, z: quads
+uniform vec4 EmitterPosition; // xy: previous position, zw: current position
+uniform vec4 EmissionArea; // xy: area, z: area angle, w: dt
+uniform vec4 DirectionSpeed; // x: direction, y: spread, z: min speed, w: max speed
+uniform vec4 LifeDamping; // xy: particle lifetime, zw: linear damping
+uniform vec4 LinearAcceleration; // xy: min, zw: max
+uniform vec4 RadialTangential; // xy: radial acceleration, zw: tangential acceleration
+uniform vec4 RotationSpin; // xy: rotation, z: spin start, w: spin end
+uniform vec4 VariationOffset; // x: size variation, y: spin variation, zw: offset
+uniform float Sizes[8];
+uniform vec4 Colors[8];
+
+#define FLAG_RELATIVE_ROTATION 1
+#define FLAG_DIRECTION_RELATIVE_TO_CENTER 2
+
+#define PI 3.14159265358979
+
+uint rngState;
+
+uint hash(uint x)
+{
+	x ^= x >> 16;
+	x *= 0x7feb352du;
+	x ^= x >> 15;
+	x *= 0x846ca68bu;
+	x ^= x >> 16;
+	return x;
+}
+
+float random()
+{
+	rngState = hash(rngState);
+	return float(rngState >> 8) * (1.0 / 16777216.0);
+}
+
+float random(float minval, float maxval)
+{
+	return minval + (maxval - minval) * random();
+}
+
+float randomNormal(float stddev)
+{
+	float r = sqrt(-2.0 * log(max(random(), 1e-7)));
+	return r * cos(2.0 * PI * random()) * stddev;
+}
+
+float calculateVariation(float inner, float outer, float var)
+{
+	float low = inner - (outer / 2.0) * var;
+	float high = inner + (outer / 2.0) * var;
+	float r = random();
+	return low * (1.0 - r) + high * r;
+}
+
+float safeAtan(vec2 v)
+{
+	return (v.x == 0.0 && v.y == 0.0) ? 0.0 : atan(v.y, v.x);
+}
+
+Particle initParticle(float t)
+{
+	vec2 pos = mix(EmitterPosition.xy, EmitterPosition.zw, t);
+	vec2 ppos = pos;
+
+	float life = random(LifeDamping.x, LifeDamping.y);
+	float dir = random(DirectionSpeed.x - DirectionSpeed.y / 2.0, DirectionSpeed.x + DirectionSpeed.y / 2.0);
+
+	vec2 area = EmissionArea.xy;
+	float c = cos(EmissionArea.z);
+	float s = sin(EmissionArea.z);
+	vec2 offset = vec2(0.0);
+
+	switch (SimParams.z)
+	{
+	case 1: // uniform
+		offset = vec2(random(-area.x, area.x), random(-area.y, area.y));
+		break;
+	case 2: // normal
+		offset = vec2(randomNormal(area.x), randomNormal(area.y));
+		break;
+	case 3: // ellipse
+	{
+		float rx = random(-1.0, 1.0);
+		float ry = random(-1.0, 1.0);
+		offset = area * vec2(rx * sqrt(1.0 - 0.5 * ry * ry), ry * sqrt(1.0 - 0.5 * rx * rx));
+		break;
+	}
+	case 4: // borderellipse
+	{
+		float r = random(0.0, PI * 2.0);
+		offset = vec2(cos(r), sin(r)) * area;
+		break;
+	}
+	case 5: // borderrectangle
+	{
+		float r = random((area.x + area.y) * -2.0, (area.x + area.y) * 2.0);
+		float h = area.y * 2.0;
+		if (r < -h)
+			offset = vec2(r + h + area.x, -area.y);
+		else if (r < 0.0)
+			offset = vec2(-area.x, r + area.y);
+		else if (r < h)
+			offset = vec2(area.x, r - area.y);
+		else
+			offset = vec2(r - h - area.x, area.y);
+		break;
+	}
+	default:
+		break;
+	}
+
+	ppos += vec2(c * offset.x - s * offset.y, s * offset.x + c * offset.y);
+
+	if ((SimParams.w & FLAG_DIRECTION_RELATIVE_TO_CENTER) != 0)
+		dir += safeAtan(ppos - pos);
+
+	float speed = random(DirectionSpeed.z, DirectionSpeed.w);
+	vec2 velocity = vec2(cos(dir), sin(dir)) * speed;
+
+	vec2 linearacc = vec2(random(LinearAcceleration.x, LinearAcceleration.z), random(LinearAcceleration.y, LinearAcceleration.w));
+	float radialacc = random(RadialTangential.x, RadialTangential.y);
+	float tangentialacc = random(RadialTangential.z, RadialTangential.w);
+	float damping = random(LifeDamping.z, LifeDamping.w);
+
+	float sizeoffset = random(0.0, VariationOffset.x);
+	float sizeinterval = (1.0 - random(0.0, VariationOffset.x)) - sizeoffset;
+
+	float spinstart = calculateVariation(RotationSpin.z, RotationSpin.w, VariationOffset.y);
+	float spinend = calculateVariation(RotationSpin.w, RotationSpin.z, VariationOffset.y);
+	float rotation = random(RotationSpin.x, RotationSpin.y);
+
+	Particle p;
+	p.positionVelocity = vec4(ppos, velocity);
+	p.originLife = vec4(pos, life, life);
+	p.acceleration = vec4(linearacc, radialacc, tangentialacc);
+	p.sizeRotation = vec4(damping, sizeoffset, sizeinterval, rotation);
+	p.spin = vec4(spinstart, spinend, 0.0, 0.0);
+	return p;
+}
+
+Particle updateParticle(Particle p, float dt)
+{
+	vec2 pos = p.positionVelocity.xy;
+	vec2 velocity = p.positionVelocity.zw;
+
+	vec2 radial = pos - p.originLife.xy;
+	float len = length(radial);
+	if (len > 0.0)
+		radial /= len;
+
+	vec2 tangential = vec2(-radial.y, radial.x);
+
+	velocity += (radial * p.acceleration.z + tangential * p.acceleration.w + p.acceleration.xy) * dt;
+	velocity *= 1.0 / (1.0 + p.sizeRotation.x * dt);
+
+	pos += velocity * dt;
+
+	float t = 1.0 - p.originLife.z / p.originLife.w;
+	p.sizeRotation.w += (p.spin.x * (1.0 - t) + p.spin.y * t) * dt;
+
+	p.positionVelocity = vec4(pos, velocity);
+	return p;
+}
+
+void writeVertices(Particle p, uint slot)
+{
+	float t = 1.0 - p.originLife.z / p.originLife.w;
+
+	float s = (p.sizeRotation.y + t * p.sizeRotation.z) * float(Counts.x - 1);
+	int i = clamp(int(s), 0, Counts.x - 1);
+	int k = min(i + 1, Counts.x - 1);
+	float size = mix(Sizes[i], Sizes[k], s - float(i));
+
+	s = t * float(Counts.y - 1);
+	i = clamp(int(s), 0, Counts.y - 1);
+	k = min(i + 1, Counts.y - 1);
+	vec4 color = mix(Colors[i], Colors[k], s - float(i));
+
+	int quad = clamp(int(t * float(Counts.z)), 0, Counts.z - 1);
+
+	float angle = p.sizeRotation.w;
+	if ((SimParams.w & FLAG_RELATIVE_ROTATION) != 0)
+		angle += safeAtan(p.positionVelocity.zw);
+
+	float c = cos(angle);
+	float sn = sin(angle);
+
+	for (uint v = 0u; v < 4u; v++)
+	{
+		vec4 q = quadVertices[uint(quad) * 4u + v];
+		vec2 local = (q.xy - VariationOffset.zw) * size;
+
+		ParticleVertex vert;
+		vert.position = vec2(c * local.x - sn * local.y, sn * local.x + c * local.y) + p.positionVelocity.xy;
+		vert.texcoord = q.zw;
+		vert.color = color;
+		vertices[slot * 4u + v] = vert;
+	}
+}
+
+void computemain()
+{
+	uint index = love_GlobalThreadID.x;
+	if (index >= uint(SimParams.x))
+		return;
+
+	uint buffersize = uint(SpawnParams.w);
+	uint spawnindex = (index + buffersize - uint(SpawnParams.x)) % buffersize;
+
+	rngState = hash(index ^ hash(uint(SimParams.y)));
+
+	Particle p;
+
+	if (spawnindex < uint(SpawnParams.y))
+	{
+		// Interpolate new particles between the previous and current emitter
+		// positions, like the CPU path does.
+		float t = 1.0;
+		if (spawnindex < uint(SpawnParams.z))
+			t = float(spawnindex + 1u) / float(SpawnParams.z);
+		p = initParticle(t);
+	}
+	else
+	{
+		p = particles[index];
+
+		if (p.originLife.z <= 0.0)
+			return;
+
+		float dt = EmissionArea.w;
+		p.originLife.z -= dt;
+
+		if (p.originLife.z <= 0.0)
+		{
+			particles[index].originLife.z = 0.0;
+			return;
+		}
+
+		p = updateParticle(p, dt);
+	}
+
+	particles[index] = p;
+
+	uint slot = atomicAdd(drawArgs[0], 6u) / 6u;
+	writeVertices(p, slot);
+}
+)";
+
+Shader *ParticleSystem::gpuUpdateShader = nullptr;
+int ParticleSystem::gpuSystemCount = 0;
+
+void ParticleSystem::releaseGPUSystem()
+{
+	if (--gpuSystemCount == 0 && gpuUpdateShader != nullptr)
+	{
+		gpuUpdateShader->release();
+		gpuUpdateShader = nullptr;
+	}
+}
+
+static void sendGPUUniform(Shader *shader, const char *name, const void *data, int count)
+{
+	const Shader::UniformInfo *info = shader->getUniformInfo(name);
+	if (info == nullptr)
+		return;
+
+	count = std::min(count, info->count);
+	memcpy(info->data, data, sizeof(float) * info->components * count);
+	shader->updateUniform(info, count);
+}
+
+static void sendGPUBuffer(Shader *shader, const char *name, Buffer *buffer)
+{
+	const Shader::UniformInfo *info = shader->getUniformInfo(name);
+	if (info != nullptr)
+		shader->sendBuffers(info, &buffer, 1);
+}
+
+void ParticleSystem::createGPUBuffers(size_t size)
+{
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+
+	int threadgroups = (int) ((size + 63) / 64);
+	if (threadgroups > gfx->getCapabilities().limits[Graphics::LIMIT_THREADGROUPS_X])
+		throw love::Exception("GPU-simulated ParticleSystem buffer size is too large for this system.");
+
+	if (gpuUpdateShader == nullptr)
+	{
+		Shader::CompileOptions options;
+		options.debugName = "ParticleSystem GPU simulation";
+		gpuUpdateShader = gfx->newComputeShader(gpuParticleShaderCode, options);
+	}
+
+	Buffer::Settings particlesettings(BUFFERUSAGEFLAG_SHADER_STORAGE, BUFFERDATAUSAGE_STATIC);
+	particlesettings.zeroInitialize = true;
+	particlesettings.debugName = "ParticleSystem particles";
+
+	std::vector<Buffer::DataDeclaration> particleformat = {
+		{"positionVelocity", DATAFORMAT_FLOAT_VEC4},
+		{"originLife", DATAFORMAT_FLOAT_VEC4},
+		{"acceleration", DATAFORMAT_FLOAT_VEC4},
+		{"sizeRotation", DATAFORMAT_FLOAT_VEC4},
+		{"spin", DATAFORMAT_FLOAT_VEC4},
+	};
+
+	Buffer *b = gfx->newBuffer(particlesettings, particleformat, nullptr, 0, size);
+	gpuParticleBuffer.set(b, Acquire::NORETAIN);
+
+	Buffer::Settings vertexsettings(BUFFERUSAGEFLAG_VERTEX | BUFFERUSAGEFLAG_SHADER_STORAGE, BUFFERDATAUSAGE_STATIC);
+	vertexsettings.debugName = "ParticleSystem vertices";
+
+	std::vector<Buffer::DataDeclaration> vertexformat = {
+		{graphics::getConstant(ATTRIB_POS), DATAFORMAT_FLOAT_VEC2},
+		{graphics::getConstant(ATTRIB_TEXCOORD), DATAFORMAT_FLOAT_VEC2},
+		{graphics::getConstant(ATTRIB_COLOR), DATAFORMAT_FLOAT_VEC4},
+	};
+
+	b = gfx->newBuffer(vertexsettings, vertexformat, nullptr, 0, size * 4);
+	gpuVertexBuffer.set(b, Acquire::NORETAIN);
+
+	std::vector<uint32> indices(size * 6);
+	fillIndices(TRIANGLEINDEX_QUADS, (uint32) 0, (uint32) size * 4, indices.data());
+
+	Buffer::Settings indexsettings(BUFFERUSAGEFLAG_INDEX, BUFFERDATAUSAGE_STATIC);
+	b = gfx->newBuffer(indexsettings, DATAFORMAT_UINT32, indices.data(), indices.size() * sizeof(uint32), 0);
+	gpuIndexBuffer.set(b, Acquire::NORETAIN);
+
+	// Indexed draw arguments: index count, instance count, first index, base
+	// vertex, base instance.
+	const uint32 drawargs[] = {0, 1, 0, 0, 0};
+
+	Buffer::Settings argssettings(BUFFERUSAGEFLAG_INDIRECT_ARGUMENTS | BUFFERUSAGEFLAG_SHADER_STORAGE, BUFFERDATAUSAGE_DYNAMIC);
+	b = gfx->newBuffer(argssettings, DATAFORMAT_UINT32, drawargs, sizeof(drawargs), 0);
+	gpuDrawArgsBuffer.set(b, Acquire::NORETAIN);
+
+	maxParticles = (uint32) size;
+	gpuQuadsModified = true;
+}
+
+void ParticleSystem::updateGPUQuads()
+{
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+
+	std::vector<Quad *> quadlist = getQuads();
+	if (quadlist.empty())
+		quadlist.push_back(texture->getQuad());
+
+	// Position and texture coordinate of each quad vertex.
+	std::vector<Vector4> data;
+	data.reserve(quadlist.size() * 4);
+
+	for (Quad *q : quadlist)
+	{
+		const Vector2 *positions = q->getVertexPositions();
+		const Vector2 *texcoords = q->getVertexTexCoords();
+
+		for (int v = 0; v < 4; v++)
+			data.emplace_back(positions[v].x, positions[v].y, texcoords[v].x, texcoords[v].y);
+	}
+
+	Buffer::Settings settings(BUFFERUSAGEFLAG_SHADER_STORAGE, BUFFERDATAUSAGE_STATIC);
+	Buffer *b = gfx->newBuffer(settings, DATAFORMAT_FLOAT_VEC4, data.data(), data.size() * sizeof(Vector4), 0);
+	gpuQuadBuffer.set(b, Acquire::NORETAIN);
+
+	gpuQuadsModified = false;
+}
+
+void ParticleSystem::updateGPU(float dt)
+{
+	if (gpuParticleBuffer.get() == nullptr || gpuUpdateShader == nullptr)
+		return;
+
+	gpuTime += dt;
+
+	// Forget about particles which are known to be dead by now.
+	while (!gpuSpawnBatches.empty() && gpuSpawnBatches.front().deathTime <= gpuTime)
+	{
+		activeParticles -= gpuSpawnBatches.front().count;
+		gpuSpawnBatches.pop_front();
+	}
+
+	uint32 interpolated = 0;
+
+	if (active)
+	{
+		float rate = 1.0f / emissionRate; // the amount of time between each particle emit
+		emitCounter += dt;
+		while (emitCounter > rate)
+		{
+			interpolated++;
+			emitCounter -= rate;
 		}
 
-		pVerts += 4;
-		p = p->next;
+		life -= dt;
+		if (lifetime != -1 && life < 0)
+			stop();
 	}
 
-	buffer->unmap(0, pCount * sizeof(Vertex) * 4);
+	// Only spawn into slots whose previous particles are guaranteed to be
+	// dead, since we can't check the GPU's data.
+	uint32 available = maxParticles - activeParticles;
+	uint32 emitted = std::min(gpuPendingEmits, available);
+	interpolated = std::min(interpolated, available - emitted);
+	uint32 spawncount = interpolated + emitted;
+	gpuPendingEmits = 0;
+
+	if (spawncount > 0)
+	{
+		float maxlife = std::max(particleLifeMin, particleLifeMax);
+		gpuSpawnBatches.push_back({gpuTime + maxlife, spawncount});
+		activeParticles += spawncount;
+		gpuUsedSlots = std::min(maxParticles, gpuUsedSlots + spawncount);
+	}
+
+	if (gpuQuadsModified)
+		updateGPUQuads();
+
+	Shader *shader = gpuUpdateShader;
+
+	int spawnparams[4] = {(int) gpuSpawnSlot, (int) spawncount, (int) interpolated, (int) maxParticles};
+	int flags = (relativeRotation ? 1 : 0) | (directionRelativeToEmissionCenter ? 2 : 0);
+	int simparams[4] = {(int) gpuUsedSlots, (int) gpuSeed++, (int) emissionAreaDistribution, flags};
+	int counts[4] = {(int) sizes.size(), (int) colors.size(), (int) std::max<size_t>(quads.size(), 1), 0};
+
+	float emitterposition[4] = {prevPosition.x, prevPosition.y, position.x, position.y};
+	float emissionarea[4] = {emissionArea.x, emissionArea.y, emissionAreaAngle, dt};
+	float directionspeed[4] = {direction, spread, speedMin, speedMax};
+	float lifedamping[4] = {particleLifeMin, particleLifeMax, linearDampingMin, linearDampingMax};
+	float linearacceleration[4] = {linearAccelerationMin.x, linearAccelerationMin.y, linearAccelerationMax.x, linearAccelerationMax.y};
+	float radialtangential[4] = {radialAccelerationMin, radialAccelerationMax, tangentialAccelerationMin, tangentialAccelerationMax};
+	float rotationspin[4] = {rotationMin, rotationMax, spinStart, spinEnd};
+	float variationoffset[4] = {sizeVariation, spinVariation, offset.x, offset.y};
+
+	sendGPUUniform(shader, "SpawnParams", spawnparams, 1);
+	sendGPUUniform(shader, "SimParams", simparams, 1);
+	sendGPUUniform(shader, "Counts", counts, 1);
+	sendGPUUniform(shader, "EmitterPosition", emitterposition, 1);
+	sendGPUUniform(shader, "EmissionArea", emissionarea, 1);
+	sendGPUUniform(shader, "DirectionSpeed", directionspeed, 1);
+	sendGPUUniform(shader, "LifeDamping", lifedamping, 1);
+	sendGPUUniform(shader, "LinearAcceleration", linearacceleration, 1);
+	sendGPUUniform(shader, "RadialTangential", radialtangential, 1);
+	sendGPUUniform(shader, "RotationSpin", rotationspin, 1);
+	sendGPUUniform(shader, "VariationOffset", variationoffset, 1);
+	sendGPUUniform(shader, "Sizes", sizes.data(), (int) sizes.size());
+	sendGPUUniform(shader, "Colors", colors.data(), (int) colors.size());
+
+	sendGPUBuffer(shader, "ParticleBuffer", gpuParticleBuffer);
+	sendGPUBuffer(shader, "VertexBuffer", gpuVertexBuffer);
+	sendGPUBuffer(shader, "DrawArgsBuffer", gpuDrawArgsBuffer);
+	sendGPUBuffer(shader, "QuadBuffer", gpuQuadBuffer);
+
+	// The shader counts the surviving particles' indices from scratch.
+	const uint32 drawargs[] = {0, 1, 0, 0, 0};
+	gpuDrawArgsBuffer->fill(0, sizeof(drawargs), drawargs);
+
+	if (gpuUsedSlots > 0)
+	{
+		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+		gfx->dispatchThreadgroups(shader, (int) ((gpuUsedSlots + 63) / 64), 1, 1);
+	}
+
+	gpuSpawnSlot = (gpuSpawnSlot + spawncount) % maxParticles;
+	prevPosition = position;
+}
+
+void ParticleSystem::drawGPU(Graphics *gfx, const Matrix4 &m)
+{
+	if (gpuUsedSlots == 0 || texture.get() == nullptr || gpuVertexBuffer.get() == nullptr)
+		return;
+
+	if (gfx->getDrawList() != nullptr)
+		throw love::Exception("GPU-simulated ParticleSystems cannot be drawn while a DrawList is active.");
+
+	gfx->flushBatchedDraws();
+
+	if (Shader::isDefaultActive())
+		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+
+	if (Shader::current)
+		Shader::current->validateDrawState(PRIMITIVE_TRIANGLES, texture);
 
 	Graphics::TempTransform transform(gfx, m);
 
-	BufferBindings vertexbuffers;
-	vertexbuffers.set(0, buffer, 0);
+	VertexAttributes attributes;
+	attributes.set(ATTRIB_POS, DATAFORMAT_FLOAT_VEC2, 0, 0);
+	attributes.set(ATTRIB_TEXCOORD, DATAFORMAT_FLOAT_VEC2, sizeof(float) * 2, 0);
+	attributes.set(ATTRIB_COLOR, DATAFORMAT_FLOAT_VEC4, sizeof(float) * 4, 0);
+	attributes.setBufferLayout(0, (uint16) gpuVertexBuffer->getArrayStride());
+
+	BufferBindings buffers;
+	buffers.set(0, gpuVertexBuffer, 0);
+
+	Graphics::DrawIndexedCommand cmd(&attributes, &buffers, gpuIndexBuffer);
+	cmd.primitiveType = PRIMITIVE_TRIANGLES;
+	cmd.indexType = INDEX_UINT32;
+	cmd.indirectBuffer = gpuDrawArgsBuffer;
+	cmd.texture = gfx->getTextureOrDefaultForActiveShader(texture);
 
-	Texture *tex = gfx->getTextureOrDefaultForActiveShader(texture);
-	gfx->drawQuads(0, pCount, vertexAttributes, vertexbuffers, tex);
+	gfx->draw(cmd);
 }
 
 bool ParticleSystem::getConstant(const char *in, AreaSpreadDistribution &out)
@@ -1120,6 +1914,21 @@ std::vector<std::string> ParticleSystem::getConstants(InsertMode)
 	return insertModes.getNames();
 }
 
+bool ParticleSystem::getConstant(const char *in, SimulationMode &out)
+{
+	return simulationModes.find(in, out);
+}
+
+bool ParticleSystem::getConstant(SimulationMode in, const char *&out)
+{
+	return simulationModes.find(in, out);
+}
+
+std::vector<std::string> ParticleSystem::getConstants(SimulationMode)
+{
+	return simulationModes.getNames();
+}
+
 StringMap<ParticleSystem::AreaSpreadDistribution, ParticleSystem::DISTRIBUTION_MAX_ENUM>::Entry ParticleSystem::distributionsEntries[] =
 {
 	{ "none",    DISTRIBUTION_NONE },
@@ -1141,5 +1950,13 @@ StringMap<ParticleSystem::InsertMode, ParticleSystem::INSERT_MODE_MAX_ENUM>::Ent
 
 StringMap<ParticleSystem::InsertMode, ParticleSystem::INSERT_MODE_MAX_ENUM> ParticleSystem::insertModes(ParticleSystem::insertModesEntries, sizeof(ParticleSystem::insertModesEntries));
 
+StringMap<ParticleSystem::SimulationMode, ParticleSystem::SIMULATION_MAX_ENUM>::Entry ParticleSystem::simulationModesEntries[] =
+{
+	{ "cpu", SIMULATION_CPU },
+	{ "gpu", SIMULATION_GPU },
+};
+
+StringMap<ParticleSystem::SimulationMode, ParticleSystem::SIMULATION_MAX_ENUM> ParticleSystem::simulationModes(ParticleSystem::simulationModesEntries, sizeof(ParticleSystem::simulationModesEntries));
+
 } // graphics
 } // love
@@ -30,9 +30,11 @@
 #include "Quad.h"
 #include "Texture.h"
 #include "Buffer.h"
+#include "Shader.h"
 
 // STL
 #include <vector>
+#include <deque>
 
 namespace love
 {
@@ -76,6 +78,17 @@ class ParticleSystem : public Drawable
 		INSERT_MODE_MAX_ENUM
 	};
 
+	/**
+	 * Where particles are simulated: on the CPU, or on the GPU with a compute
+	 * shader.
+	 */
+	enum SimulationMode
+	{
+		SIMULATION_CPU,
+		SIMULATION_GPU,
+		SIMULATION_MAX_ENUM
+	};
+
 	/**
 	 * Maximum numbers of particles in a ParticleSystem.
 	 * This limit comes from the fact that a quad requires four vertices and the
@@ -86,7 +99,7 @@ class ParticleSystem : public Drawable
 	/**
 	 * Creates a particle system with the specified buffer size and texture.
 	 **/
-	ParticleSystem(Texture *texture, uint32 buffer);
+	ParticleSystem(Texture *texture, uint32 buffer, SimulationMode mode = SIMULATION_CPU);
 	ParticleSystem(const ParticleSystem &p);
 
 	/**
@@ -135,6 +148,11 @@ class ParticleSystem : public Drawable
 	 */
 	InsertMode getInsertMode() const;
 
+	/**
+	 * Returns whether particles are simulated on the CPU or the GPU.
+	 **/
+	SimulationMode getSimulationMode() const;
+
 	/**
 	 * Sets the emission rate.
 	 * @param rate The amount of particles per second.
@@ -453,6 +471,8 @@ class ParticleSystem : public Drawable
 
 	/**
 	 * Returns the amount of particles that are currently active in the system.
+	 * GPU-simulated systems never read back from the GPU, so this is an upper
+	 * bound based on the maximum particle lifetime.
 	 **/
 	uint32 getCount() const;
 
@@ -521,68 +541,103 @@ class ParticleSystem : public Drawable
 	static bool getConstant(InsertMode in, const char *&out);
 	static std::vector<std::string> getConstants(InsertMode);
 
+	static bool getConstant(const char *in, SimulationMode &out);
+	static bool getConstant(SimulationMode in, const char *&out);
+	static std::vector<std::string> getConstants(SimulationMode);
+
 private:
 
-	// Represents a single particle.
-	struct Particle
+	// Particles spawned on the GPU in a single update. They're all known to be
+	// dead once deathTime has passed.
+	struct GPUSpawnBatch
 	{
-		Particle *prev;
-		Particle *next;
+		float deathTime;
+		uint32 count;
+	};
 
-		float lifetime;
-		float life;
+	// Particle data is stored as a structure of arrays (one contiguous array
+	// per attribute) rather than as an array of structs, so update() can
+	// process several particles at once with SIMD instructions.
+	struct ParticleArrays
+	{
+		float *lifetime;
+		float *life;
 
-		love::Vector2 position;
+		float *positionX;
+		float *positionY;
 
 		// Particles gravitate towards this point.
-		love::Vector2 origin;
+		float *originX;
+		float *originY;
 
-		love::Vector2 velocity;
-		love::Vector2 linearAcceleration;
-		float radialAcceleration;
-		float tangentialAcceleration;
+		float *velocityX;
+		float *velocityY;
+		float *linearAccelerationX;
+		float *linearAccelerationY;
+		float *radialAcceleration;
+		float *tangentialAcceleration;
 
-		float linearDamping;
+		float *linearDamping;
 
-		float size;
-		float sizeOffset;
-		float sizeIntervalSize;
+		float *size;
+		float *sizeOffset;
+		float *sizeIntervalSize;
 
-		float rotation; // Amount of rotation applied to the final angle.
-		float angle;
-		float spinStart;
-		float spinEnd;
+		float *rotation; // Amount of rotation applied to the final angle.
+		float *angle;
+		float *spinStart;
+		float *spinEnd;
 
-		Colorf color;
+		float *colorR;
+		float *colorG;
+		float *colorB;
+		float *colorA;
 
-		int quadIndex;
+		int *quadIndex;
 	};
 
+	// The number of float arrays in ParticleArrays.
+	static const int NUM_FLOAT_ARRAYS = 24;
+
 	void resetOffset();
 
 	void createBuffers(size_t size);
 	void deleteBuffers();
 
 	void addParticle(float t);
-	Particle *removeParticle(Particle *p);
 
 	// Called by addParticle.
-	void initParticle(Particle *p, float t);
-	void insertTop(Particle *p);
-	void insertBottom(Particle *p);
-	void insertRandom(Particle *p);
+	void initParticle(uint32 index, float t);
+
+	void copyParticle(uint32 dst, uint32 src);
+	void swapParticles(uint32 a, uint32 b);
+	void reverseParticles();
+
+	// Removes dead particles. The order of the remaining particles is kept
+	// unless the insert mode is random.
+	void removeDeadParticles(float dt);
+
+	void updateParticles(uint32 start, uint32 end, float dt);
+	void updateParticlesSIMD(float dt);
+
+	void createGPUBuffers(size_t size);
+	static void releaseGPUSystem();
+	void updateGPUQuads();
+	void updateGPU(float dt);
+	void drawGPU(Graphics *gfx, const Matrix4 &m);
 
 	// Pointer to the beginning of the allocated memory.
-	Particle *pMem;
+	float *pMem;
+	int *pQuadIndices;
 
-	// Pointer to a free particle.
-	Particle *pFree;
+	// The number of elements allocated for each array in pMem.
+	size_t arrayStride;
 
-	// Pointer to the start of the linked list.
-	Particle *pHead;
+	ParticleArrays particles;
 
-	// Pointer to the end of the linked list.
-	Particle *pTail;
+	// Particles are stored in the order they're drawn, unless this is true
+	// (used by the bottom insert mode so new particles can be appended.)
+	bool drawReversed;
 
 	// The texture to be drawn.
 	StrongRef<Texture> texture;
@@ -673,14 +728,34 @@ class ParticleSystem : public Drawable
 
 	bool relativeRotation;
 
-	const VertexAttributes vertexAttributes;
-	Buffer *buffer;
+	SimulationMode simulationMode;
+
+	// GPU simulation state.
+	StrongRef<Buffer> gpuParticleBuffer;
+	StrongRef<Buffer> gpuVertexBuffer;
+	StrongRef<Buffer> gpuIndexBuffer;
+	StrongRef<Buffer> gpuDrawArgsBuffer;
+	StrongRef<Buffer> gpuQuadBuffer;
+	bool gpuQuadsModified;
+	uint32 gpuSpawnSlot;
+	uint32 gpuUsedSlots;
+	uint32 gpuPendingEmits;
+	uint32 gpuSeed;
+	float gpuTime;
+	std::deque<GPUSpawnBatch> gpuSpawnBatches;
+
+	// Shared by all GPU-simulated ParticleSystems.
+	static Shader *gpuUpdateShader;
+	static int gpuSystemCount;
 
 	static StringMap<AreaSpreadDistribution, DISTRIBUTION_MAX_ENUM>::Entry distributionsEntries[];
 	static StringMap<AreaSpreadDistribution, DISTRIBUTION_MAX_ENUM> distributions;
 
 	static StringMap<InsertMode, INSERT_MODE_MAX_ENUM>::Entry insertModesEntries[];
 	static StringMap<InsertMode, INSERT_MODE_MAX_ENUM> insertModes;
+
+	static StringMap<SimulationMode, SIMULATION_MAX_ENUM>::Entry simulationModesEntries[];
+	static StringMap<SimulationMode, SIMULATION_MAX_ENUM> simulationModes;
 };
 
 } // graphics
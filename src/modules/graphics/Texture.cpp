@@ -477,6 +477,15 @@ void Texture::draw(Graphics *gfx, Quad *q, const Matrix4 &localTransform)
 		return;
 	}
 
+	// Layer views are drawn through their array texture, so that consecutive
+	// draws using different layers of it can be batched together. Custom
+	// shaders expect a 2D texture, so this only applies to default shaders.
+	if (gfx->isArrayTextureBatching() && isArrayLayerView() && Shader::isDefaultActive())
+	{
+		rootView.texture->drawLayer(gfx, rootView.startLayer, q, localTransform);
+		return;
+	}
+
 	if (!readable)
 		throw love::Exception("Textures with non-readable formats cannot be drawn.");
 
@@ -568,6 +577,21 @@ void Texture::drawLayer(Graphics *gfx, int layer, Quad *q, const Matrix4 &m)
 	}
 }
 
+bool Texture::isArrayLayerView() const
+{
+	const Texture *root = rootView.texture;
+
+	if (root == this || texType != TEXTURE_2D || root->getTextureType() != TEXTURE_2D_ARRAY)
+		return false;
+
+	// Sampling the array texture must give the same results as sampling the
+	// view would.
+	return rootView.startMipmap == 0
+		&& mipmapCount == root->getMipmapCount()
+		&& format == root->getPixelFormat()
+		&& samplerState.toKey() == root->getSamplerState().toKey();
+}
+
 void Texture::uploadImageData(love::image::ImageDataBase *d, int level, int slice, int x, int y)
 {
 	Rect rect = {x, y, d->getWidth(), d->getHeight()};
@@ -343,6 +343,8 @@ class Texture : public Drawable, public Resource
 	virtual void uploadByteData(const void *data, size_t size, int level, int slice, const Rect &r) = 0;
 
 	bool supportsGenerateMipmaps(const char *&outReason) const;
+
+	bool isArrayLayerView() const;
 	virtual void generateMipmapsInternal() = 0;
 
 	SamplerState validateSamplerState(SamplerState s) const;
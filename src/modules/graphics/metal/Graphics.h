@@ -202,7 +202,7 @@ class Graphics final : public love::graphics::Graphics
 
 	void setRenderTargetsInternal(const RenderTargets &rts, int pixelw, int pixelh, bool hasSRGBcanvas) override;
 	void initCapabilities() override;
-	void getAPIStats(int &shaderswitches) const override;
+	void getAPIStats(int &shaderswitches, int &pipelinecachehits, int &pipelinecachemisses, int &pipelinecacheunknown) const override;
 
 	void processCompletedCommandBuffers();
 
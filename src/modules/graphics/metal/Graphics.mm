@@ -356,7 +356,7 @@ Graphics::Graphics()
 		// resize to fit if needed, later.
 		batchedDrawState.vb[0] = CreateStreamBuffer(device, BUFFERUSAGE_VERTEX, 1024 * 1024 * 1);
 		batchedDrawState.vb[1] = CreateStreamBuffer(device, BUFFERUSAGE_VERTEX, 256  * 1024 * 1);
-		batchedDrawState.indexBuffer = CreateStreamBuffer(device, BUFFERUSAGE_INDEX, sizeof(uint16) * LOVE_UINT16_MAX);
+		batchedDrawState.indexBuffer = CreateStreamBuffer(device, BUFFERUSAGE_INDEX, sizeof(uint32) * LOVE_UINT16_MAX);
 	}
 
 	createQuadIndexBuffer();
@@ -1636,6 +1636,8 @@ void Graphics::present(void *screenshotCallbackData)
 	if (isRenderTargetActive())
 		throw love::Exception("present cannot be called while a render target is active.");
 
+	endProfileFrame();
+
 	deprecations.draw(this);
 
 	// endPass calls useRenderEncoder, which makes sure activeDrawable is set
@@ -1746,6 +1748,8 @@ void Graphics::present(void *screenshotCallbackData)
 	shaderSwitches = 0;
 	renderTargetSwitchCount = 0;
 	drawCallsBatched = 0;
+	batchedDrawsUint16Indices = 0;
+	batchedDrawsUint32Indices = 0;
 
 	updatePendingReadbacks();
 	updateTemporaryResources();
@@ -2288,9 +2292,12 @@ void Graphics::initCapabilities()
 		capabilities.textureTypes[i] = true;
 }
 
-void Graphics::getAPIStats(int &shaderswitches) const
+void Graphics::getAPIStats(int &shaderswitches, int &pipelinecachehits, int &pipelinecachemisses, int &pipelinecacheunknown) const
 {
 	shaderswitches = shaderSwitches;
+	pipelinecachehits = 0;
+	pipelinecachemisses = 0;
+	pipelinecacheunknown = 0;
 }
 
 } // metal
@@ -360,7 +360,7 @@ bool Graphics::setMode(void */*context*/, int width, int height, int pixelwidth,
 		// resize to fit if needed, later.
 		batchedDrawState.vb[0] = CreateStreamBuffer(BUFFERUSAGE_VERTEX, 1024 * 1024 * 1);
 		batchedDrawState.vb[1] = CreateStreamBuffer(BUFFERUSAGE_VERTEX, 256  * 1024 * 1);
-		batchedDrawState.indexBuffer = CreateStreamBuffer(BUFFERUSAGE_INDEX, sizeof(uint16) * LOVE_UINT16_MAX);
+		batchedDrawState.indexBuffer = CreateStreamBuffer(BUFFERUSAGE_INDEX, sizeof(uint32) * LOVE_UINT16_MAX);
 	}
 
 	// Reload all volatile objects.
@@ -410,6 +410,7 @@ void Graphics::unSetMode()
 	Volatile::unloadAll();
 
 	clearTemporaryResources();
+	clearTimestampQueries();
 
 	for (const auto &pair : framebufferObjects)
 		gl.deleteFramebuffer(pair.second);
@@ -1162,6 +1163,8 @@ void Graphics::present(void *screenshotCallbackData)
 	if (isRenderTargetActive())
 		throw love::Exception("present cannot be called while a render target is active.");
 
+	endProfileFrame();
+
 	deprecations.draw(this);
 
 	flushBatchedDraws();
@@ -1285,7 +1288,10 @@ void Graphics::present(void *screenshotCallbackData)
 	gl.stats.shaderSwitches = 0;
 	renderTargetSwitchCount = 0;
 	drawCallsBatched = 0;
+	batchedDrawsUint16Indices = 0;
+	batchedDrawsUint32Indices = 0;
 
+	updateTimestampQueries();
 	updatePendingReadbacks();
 	updateTemporaryResources();
 }
@@ -1560,9 +1566,145 @@ Graphics::RendererInfo Graphics::getRendererInfo() const
 	return info;
 }
 
-void Graphics::getAPIStats(int &shaderswitches) const
+void Graphics::getAPIStats(int &shaderswitches, int &pipelinecachehits, int &pipelinecachemisses, int &pipelinecacheunknown) const
 {
 	shaderswitches = gl.stats.shaderSwitches;
+
+	// OpenGL has no explicit pipeline objects.
+	pipelinecachehits = 0;
+	pipelinecachemisses = 0;
+	pipelinecacheunknown = 0;
+}
+
+// Each profile scope uses two queries.
+static const size_t MAX_TIMESTAMP_QUERIES_PER_FRAME = 256;
+
+static bool isTimestampQueryCore()
+{
+	return GLAD_VERSION_3_3 || GLAD_ARB_timer_query;
+}
+
+int Graphics::writeTimestampQuery()
+{
+	bool core = isTimestampQueryCore();
+
+	if (!core && !GLAD_EXT_disjoint_timer_query)
+		return -1;
+
+	if (timestampQueries.size() >= MAX_TIMESTAMP_QUERIES_PER_FRAME)
+		return -1;
+
+	GLuint query = 0;
+
+	if (!freeTimestampQueries.empty())
+	{
+		query = freeTimestampQueries.back();
+		freeTimestampQueries.pop_back();
+	}
+	else if (core)
+		glGenQueries(1, &query);
+	else
+		glGenQueriesEXT(1, &query);
+
+	if (core)
+		glQueryCounter(query, GL_TIMESTAMP);
+	else
+		glQueryCounterEXT(query, GL_TIMESTAMP_EXT);
+
+	timestampQueries.push_back(query);
+	return (int) timestampQueries.size() - 1;
+}
+
+void Graphics::endTimestampQueries(uint64 frame)
+{
+	if (timestampQueries.empty())
+		return;
+
+	TimestampQueryFrame pending;
+	pending.frame = frame;
+	std::swap(pending.queries, timestampQueries);
+
+	pendingTimestampQueries.push_back(std::move(pending));
+}
+
+void Graphics::updateTimestampQueries()
+{
+	if (pendingTimestampQueries.empty())
+		return;
+
+	bool core = isTimestampQueryCore();
+
+	// Results from before a disjoint operation (e.g. a GPU frequency change)
+	// are unreliable, so they're dropped.
+	GLint disjoint = 0;
+	if (!core)
+		glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+
+	size_t resolvedcount = 0;
+	std::vector<double> timestamps;
+
+	for (TimestampQueryFrame &pending : pendingTimestampQueries)
+	{
+		// Queries complete in order, so once the frame's last query has a
+		// result all of them do. Stop at the first frame that isn't done yet
+		// rather than waiting on it.
+		GLint available = 0;
+		if (core)
+			glGetQueryObjectiv(pending.queries.back(), GL_QUERY_RESULT_AVAILABLE, &available);
+		else
+			glGetQueryObjectivEXT(pending.queries.back(), GL_QUERY_RESULT_AVAILABLE_EXT, &available);
+
+		if (!available)
+			break;
+
+		timestamps.clear();
+
+		if (!disjoint)
+		{
+			for (GLuint query : pending.queries)
+			{
+				GLuint64 nanoseconds = 0;
+				if (core)
+					glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+				else
+					glGetQueryObjectui64vEXT(query, GL_QUERY_RESULT_EXT, &nanoseconds);
+
+				timestamps.push_back((double) nanoseconds / 1000000000.0);
+			}
+		}
+
+		resolveProfileFrame(pending.frame, timestamps);
+
+		freeTimestampQueries.insert(freeTimestampQueries.end(), pending.queries.begin(), pending.queries.end());
+		resolvedcount++;
+	}
+
+	pendingTimestampQueries.erase(pendingTimestampQueries.begin(), pendingTimestampQueries.begin() + resolvedcount);
+}
+
+void Graphics::clearTimestampQueries()
+{
+	bool core = isTimestampQueryCore();
+
+	for (TimestampQueryFrame &pending : pendingTimestampQueries)
+	{
+		resolveProfileFrame(pending.frame, {});
+		freeTimestampQueries.insert(freeTimestampQueries.end(), pending.queries.begin(), pending.queries.end());
+	}
+
+	freeTimestampQueries.insert(freeTimestampQueries.end(), timestampQueries.begin(), timestampQueries.end());
+
+	if (!freeTimestampQueries.empty())
+	{
+		if (core)
+			glDeleteQueries((GLsizei) freeTimestampQueries.size(), freeTimestampQueries.data());
+		else
+			glDeleteQueriesEXT((GLsizei) freeTimestampQueries.size(), freeTimestampQueries.data());
+	}
+
+	pendingTimestampQueries.clear();
+	timestampQueries.clear();
+	freeTimestampQueries.clear();
 }
 
 void Graphics::initCapabilities()
@@ -143,7 +143,12 @@ class Graphics final : public love::graphics::Graphics
 
 	void setRenderTargetsInternal(const RenderTargets &rts, int pixelw, int pixelh, bool hasSRGBtexture) override;
 	void initCapabilities() override;
-	void getAPIStats(int &shaderswitches) const override;
+	void getAPIStats(int &shaderswitches, int &pipelinecachehits, int &pipelinecachemisses, int &pipelinecacheunknown) const override;
+
+	int writeTimestampQuery() override;
+	void endTimestampQueries(uint64 frame) override;
+	void updateTimestampQueries();
+	void clearTimestampQueries();
 
 	void endPass(bool presenting);
 	GLuint bindCachedFBO(const RenderTargets &targets);
@@ -169,6 +174,16 @@ class Graphics final : public love::graphics::Graphics
 	char *bufferMapMemory;
 	size_t bufferMapMemorySize;
 
+	struct TimestampQueryFrame
+	{
+		uint64 frame;
+		std::vector<GLuint> queries;
+	};
+
+	std::vector<GLuint> timestampQueries;
+	std::vector<GLuint> freeTimestampQueries;
+	std::vector<TimestampQueryFrame> pendingTimestampQueries;
+
 	// [non-readable, readable]
 	uint32 pixelFormatUsage[PIXELFORMAT_MAX_ENUM][2];
 
@@ -83,11 +83,17 @@ bool Buffer::loadVolatile()
 	if (result != VK_SUCCESS)
 		throw love::Exception("failed to create buffer");
 
-	if (zeroInitialize)
-		vkCmdFillBuffer(vgfx->getCommandBufferForDataTransfer(), buffer, 0, VK_WHOLE_SIZE, 0);
+	{
+		// Nothing can reference the buffer before it's created, so its initial
+		// contents don't need to be ordered with the frame's draws.
+		InitialUploadScope initialUploadScope(initialUpload);
+
+		if (zeroInitialize)
+			vkCmdFillBuffer(getCommandBufferForUpload(), buffer, 0, VK_WHOLE_SIZE, 0);
 
-	if (initialData)
-		fill(0, size, initialData);
+		if (initialData)
+			fill(0, size, initialData);
+	}
 
 	if (usageFlags & BUFFERUSAGEFLAG_TEXEL)
 	{
@@ -235,7 +241,7 @@ bool Buffer::fill(size_t offset, size_t size, const void *data)
 	bufferCopy.dstOffset = offset;
 	bufferCopy.size = size;
 
-	vkCmdCopyBuffer(vgfx->getCommandBufferForDataTransfer(), fillBuffer, buffer, 1, &bufferCopy);
+	vkCmdCopyBuffer(getCommandBufferForUpload(), fillBuffer, buffer, 1, &bufferCopy);
 
 	vgfx->queueCleanUp([allocator = allocator, fillBuffer = fillBuffer, fillAllocation = fillAllocation]() {
 		vmaDestroyBuffer(allocator, fillBuffer, fillAllocation);
@@ -266,6 +272,14 @@ void Buffer::unmap(size_t usedoffset, size_t usedsize)
 	}
 }
 
+VkCommandBuffer Buffer::getCommandBufferForUpload()
+{
+	if (initialUpload)
+		return vgfx->getCommandBufferForInitialDataTransfer();
+	else
+		return vgfx->getCommandBufferForDataTransfer();
+}
+
 void Buffer::clearInternal(size_t offset, size_t size)
 {
 	vkCmdFillBuffer(vgfx->getCommandBufferForDataTransfer(), buffer, offset, size, 0);
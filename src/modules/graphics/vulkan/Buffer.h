@@ -58,6 +58,7 @@ class Buffer final
 private:
 
 	void clearInternal(size_t offset, size_t size) override;
+	VkCommandBuffer getCommandBufferForUpload();
 
 	bool zeroInitialize;
 	const void *initialData;
@@ -73,6 +74,7 @@ class Buffer final
 	BufferUsageFlags usageFlags;
 	Range mappedRange;
 	bool coherent;
+	bool initialUpload = false;
 };
 
 } // vulkan
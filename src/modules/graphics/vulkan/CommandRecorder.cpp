@@ -0,0 +1,260 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "CommandRecorder.h"
+#include "common/Exception.h"
+
+#include <algorithm>
+
+namespace love
+{
+namespace graphics
+{
+namespace vulkan
+{
+
+CommandRecorder::Worker::Worker(CommandRecorder *recorder, int index)
+	: recorder(recorder)
+	, index(index)
+{
+	threadName = "VulkanCommandRecorder";
+}
+
+void CommandRecorder::Worker::threadFunction()
+{
+	recorder->workerLoop(index);
+}
+
+CommandRecorder::CommandRecorder(VkDevice device, uint32 queueFamilyIndex, size_t framesInFlight, int threadCount)
+	: device(device)
+	, currentFrame(0)
+	, pendingPasses(0)
+	, stopping(false)
+{
+	threadCount = std::min(std::max(threadCount, 1), MAX_THREADS);
+
+	VkCommandPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	poolInfo.queueFamilyIndex = queueFamilyIndex;
+	poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+	threadPools.resize(threadCount + 1);
+
+	for (ThreadPools &t : threadPools)
+	{
+		t.pools.resize(framesInFlight, VK_NULL_HANDLE);
+		t.commandBuffers.resize(framesInFlight);
+		t.usedCommandBuffers.resize(framesInFlight, 0);
+
+		for (VkCommandPool &pool : t.pools)
+		{
+			if (vkCreateCommandPool(device, &poolInfo, nullptr, &pool) != VK_SUCCESS)
+			{
+				for (ThreadPools &other : threadPools)
+				{
+					for (VkCommandPool otherpool : other.pools)
+					{
+						if (otherpool != VK_NULL_HANDLE)
+							vkDestroyCommandPool(device, otherpool, nullptr);
+					}
+				}
+				throw love::Exception("failed to create command pool");
+			}
+		}
+	}
+
+	for (int i = 1; i <= threadCount; i++)
+	{
+		Worker *worker = new Worker(this, i);
+		worker->start();
+		workers.push_back(worker);
+	}
+}
+
+CommandRecorder::~CommandRecorder()
+{
+	{
+		love::thread::Lock lock(mutex);
+		stopping = true;
+		workCond->broadcast();
+	}
+
+	for (Worker *worker : workers)
+	{
+		worker->wait();
+		delete worker;
+	}
+
+	// Destroying a pool frees its command buffers.
+	for (ThreadPools &t : threadPools)
+	{
+		for (VkCommandPool pool : t.pools)
+			vkDestroyCommandPool(device, pool, nullptr);
+	}
+}
+
+int CommandRecorder::getThreadCount() const
+{
+	return (int) workers.size();
+}
+
+void CommandRecorder::beginFrame(size_t frame)
+{
+	currentFrame = frame;
+
+	for (ThreadPools &t : threadPools)
+	{
+		vkResetCommandPool(device, t.pools[frame], 0);
+		t.usedCommandBuffers[frame] = 0;
+	}
+}
+
+void CommandRecorder::record(Pass *pass)
+{
+	love::thread::Lock lock(mutex);
+	queue.push_back(pass);
+	pendingPasses++;
+	workCond->signal();
+}
+
+void CommandRecorder::wait()
+{
+	// Help out instead of sleeping.
+	while (true)
+	{
+		Pass *pass = nullptr;
+
+		{
+			love::thread::Lock lock(mutex);
+			if (queue.empty())
+				break;
+			pass = queue.front();
+			queue.pop_front();
+		}
+
+		finishPass(0, pass);
+	}
+
+	love::thread::Lock lock(mutex);
+	while (pendingPasses > 0)
+		doneCond->wait(mutex);
+
+	if (!error.empty())
+	{
+		std::string err = error;
+		error.clear();
+		throw love::Exception("%s", err.c_str());
+	}
+}
+
+void CommandRecorder::workerLoop(int index)
+{
+	while (true)
+	{
+		Pass *pass = nullptr;
+
+		{
+			love::thread::Lock lock(mutex);
+			while (!stopping && queue.empty())
+				workCond->wait(mutex);
+
+			if (stopping)
+				return;
+
+			pass = queue.front();
+			queue.pop_front();
+		}
+
+		finishPass(index, pass);
+	}
+}
+
+void CommandRecorder::finishPass(int index, Pass *pass)
+{
+	try
+	{
+		recordPass(index, pass);
+	}
+	catch (std::exception &e)
+	{
+		love::thread::Lock lock(mutex);
+		if (error.empty())
+			error = e.what();
+	}
+
+	love::thread::Lock lock(mutex);
+	if (--pendingPasses == 0)
+		doneCond->broadcast();
+}
+
+void CommandRecorder::recordPass(int index, Pass *pass)
+{
+	VkCommandBuffer commandBuffer = getCommandBuffer(index);
+
+	VkCommandBufferInheritanceInfo inheritanceInfo{};
+	inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+	inheritanceInfo.renderPass = pass->renderPass;
+	inheritanceInfo.subpass = 0;
+	inheritanceInfo.framebuffer = pass->framebuffer;
+
+	VkCommandBufferBeginInfo beginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+	beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+	if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+		throw love::Exception("failed to begin recording secondary command buffer");
+
+	for (const Command &command : pass->commands)
+		command(commandBuffer);
+
+	if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+		throw love::Exception("failed to record secondary command buffer");
+
+	pass->commandBuffer = commandBuffer;
+}
+
+VkCommandBuffer CommandRecorder::getCommandBuffer(int index)
+{
+	ThreadPools &t = threadPools[index];
+	std::vector<VkCommandBuffer> &commandBuffers = t.commandBuffers[currentFrame];
+	size_t &used = t.usedCommandBuffers[currentFrame];
+
+	if (used == commandBuffers.size())
+	{
+		VkCommandBufferAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.commandPool = t.pools[currentFrame];
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+		allocInfo.commandBufferCount = 1;
+
+		VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+		if (vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer) != VK_SUCCESS)
+			throw love::Exception("failed to allocate secondary command buffer");
+
+		commandBuffers.push_back(commandBuffer);
+	}
+
+	return commandBuffers[used++];
+}
+
+} // vulkan
+} // graphics
+} // love
@@ -0,0 +1,130 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+#include "common/int.h"
+#include "thread/threads.h"
+
+#include "VulkanWrapper.h"
+
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+namespace vulkan
+{
+
+/**
+ * Records render passes into secondary command buffers on worker threads.
+ * Graphics captures the commands of a pass while it's active and queues the
+ * pass once it ends, so recording overlaps with the rest of the frame. The
+ * calling thread joins in when it waits for the queue to drain.
+ **/
+class CommandRecorder
+{
+public:
+
+	typedef std::function<void(VkCommandBuffer)> Command;
+
+	struct Pass
+	{
+		VkRenderPass renderPass = VK_NULL_HANDLE;
+		VkFramebuffer framebuffer = VK_NULL_HANDLE;
+
+		// Run on a worker thread, so they must not refer to state which can
+		// change after they're captured.
+		std::vector<Command> commands;
+
+		// Set once the pass has been recorded.
+		VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+	};
+
+	static const int MAX_THREADS = 16;
+
+	CommandRecorder(VkDevice device, uint32 queueFamilyIndex, size_t framesInFlight, int threadCount);
+	~CommandRecorder();
+
+	int getThreadCount() const;
+
+	// Resets the command buffers of the given frame. No passes may be queued,
+	// and the frame's previous submission must have finished.
+	void beginFrame(size_t frame);
+
+	// The pass must stay alive until wait() returns.
+	void record(Pass *pass);
+
+	// Returns once every queued pass has been recorded.
+	void wait();
+
+private:
+
+	// Command pools can't be used from several threads at once, so each
+	// thread has its own for every frame in flight.
+	struct ThreadPools
+	{
+		std::vector<VkCommandPool> pools;
+		std::vector<std::vector<VkCommandBuffer>> commandBuffers;
+		std::vector<size_t> usedCommandBuffers;
+	};
+
+	class Worker : public love::thread::Threadable
+	{
+	public:
+		Worker(CommandRecorder *recorder, int index);
+		void threadFunction() override;
+	private:
+		CommandRecorder *recorder;
+		int index;
+	};
+
+	void workerLoop(int index);
+	void finishPass(int index, Pass *pass);
+	void recordPass(int index, Pass *pass);
+	VkCommandBuffer getCommandBuffer(int index);
+
+	VkDevice device;
+	size_t currentFrame;
+
+	// Index 0 belongs to the thread calling wait().
+	std::vector<ThreadPools> threadPools;
+	std::vector<Worker *> workers;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef workCond;
+	love::thread::ConditionalRef doneCond;
+
+	std::deque<Pass *> queue;
+	int pendingPasses;
+	bool stopping;
+
+	// Exceptions can't leave the worker threads.
+	std::string error;
+
+}; // CommandRecorder
+
+} // vulkan
+} // graphics
+} // love
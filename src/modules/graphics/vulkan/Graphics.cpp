@@ -23,6 +23,7 @@
 #include "common/version.h"
 #include "common/memory.h"
 #include "window/Window.h"
+#include "filesystem/Filesystem.h"
 #include "Buffer.h"
 #include "Graphics.h"
 #include "GraphicsReadback.h"
@@ -34,6 +35,7 @@
 
 #include <algorithm>
 #include <vector>
+#include <cstdlib>
 #include <cstring>
 #include <set>
 #include <sstream>
@@ -62,6 +64,11 @@ static const std::vector<const char*> deviceExtensions = {
 
 constexpr uint32_t USAGES_POLL_INTERVAL = 5000;
 
+constexpr const char *PIPELINE_CACHE_FILENAME = "vulkan_pipelinecache.bin";
+
+// Each profile scope uses two queries.
+constexpr uint32_t MAX_TIMESTAMP_QUERIES_PER_FRAME = 256;
+
 constexpr int DEFAULT_VERTEX_BUFFER_BINDING = 0;
 constexpr int VERTEX_BUFFER_BINDING_START = 1;
 
@@ -265,10 +272,12 @@ void Graphics::clear(const std::vector<OptionalColorD> &colors, OptionalInt sten
 		rect.rect.extent.width = static_cast<uint32_t>(renderPassState.width);
 		rect.rect.extent.height = static_cast<uint32_t>(renderPassState.height);
 
-		vkCmdClearAttachments(
-			commandBuffers[currentFrame],
-			static_cast<uint32_t>(attachments.size()), attachments.data(),
-			1, &rect);
+		recordCommand([attachments = std::move(attachments), rect](VkCommandBuffer commandBuffer) {
+			vkCmdClearAttachments(
+				commandBuffer,
+				static_cast<uint32_t>(attachments.size()), attachments.data(),
+				1, &rect);
+		});
 	}
 	else
 	{
@@ -349,7 +358,7 @@ void Graphics::submitGpuCommands(SubmitMode submitMode, void *screenshotCallback
 			if (fakeBackbuffer == nullptr)
 			{
 				Vulkan::cmdTransitionImageLayout(
-					commandBuffers.at(currentFrame),
+					activeCommandBuffer,
 					backbufferImage,
 					swapChainPixelFormat,
 					VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
@@ -380,7 +389,7 @@ void Graphics::submitGpuCommands(SubmitMode submitMode, void *screenshotCallback
 				throw love::Exception("failed to create screenshot readback buffer");
 
 			Vulkan::cmdTransitionImageLayout(
-				commandBuffers.at(currentFrame),
+				activeCommandBuffer,
 				backbufferImage,
 				swapChainPixelFormat,
 				VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
@@ -396,14 +405,14 @@ void Graphics::submitGpuCommands(SubmitMode submitMode, void *screenshotCallback
 			};
 
 			vkCmdCopyImageToBuffer(
-				commandBuffers.at(currentFrame),
+				activeCommandBuffer,
 				backbufferImage,
 				VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
 				screenshotBuffer,
 				1, &region);
 
 			Vulkan::cmdTransitionImageLayout(
-				commandBuffers.at(currentFrame),
+				activeCommandBuffer,
 				backbufferImage,
 				swapChainPixelFormat,
 				VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
@@ -413,6 +422,16 @@ void Graphics::submitGpuCommands(SubmitMode submitMode, void *screenshotCallback
 
 	endRecordingGraphicsCommands();
 
+	std::vector<VkCommandBuffer> submitCommandbuffers;
+
+	if (initialDataTransferActive)
+	{
+		endRecordingInitialDataTransferCommands();
+		submitCommandbuffers.push_back(initialDataTransferCommandBuffers.at(currentFrame));
+	}
+
+	submitCommandbuffers.insert(submitCommandbuffers.end(), frameCommandBuffers.begin(), frameCommandBuffers.end());
+
 	if (!imagesInFlight.empty())
 	{
 		if (imagesInFlight[imageIndex] != VK_NULL_HANDLE)
@@ -420,8 +439,6 @@ void Graphics::submitGpuCommands(SubmitMode submitMode, void *screenshotCallback
 		imagesInFlight[imageIndex] = inFlightFences[currentFrame];
 	}
 
-	std::array<VkCommandBuffer, 1> submitCommandbuffers = { commandBuffers.at(currentFrame) };
-
 	VkSubmitInfo submitInfo{};
 	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
@@ -540,6 +557,8 @@ void Graphics::present(void *screenshotCallbackdata)
 	if (isRenderTargetActive())
 		throw love::Exception("present cannot be called while a render target is active.");
 
+	endProfileFrame();
+
 	if (!renderPassState.active && renderPassState.windowClearRequested)
 		startRenderPass();
 
@@ -589,6 +608,8 @@ void Graphics::present(void *screenshotCallbackdata)
 	drawCalls = 0;
 	renderTargetSwitchCount = 0;
 	drawCallsBatched = 0;
+	batchedDrawsUint16Indices = 0;
+	batchedDrawsUint32Indices = 0;
 
 	updatePendingReadbacks();
 	updateTemporaryResources();
@@ -658,6 +679,7 @@ bool Graphics::setMode(void *context, int width, int height, int pixelwidth, int
 		createCommandPool();
 		createCommandBuffers();
 		createSyncObjects();
+		createTimestampQueryPools();
 	}
 
 	if (localUniformBuffer == nullptr)
@@ -673,7 +695,7 @@ bool Graphics::setMode(void *context, int width, int height, int pixelwidth, int
 			// resize to fit if needed, later.
 			batchedDrawState.vb[0] = new StreamBuffer(this, BUFFERUSAGE_VERTEX, 1024 * 1024 * 1);
 			batchedDrawState.vb[1] = new StreamBuffer(this, BUFFERUSAGE_VERTEX, 256 * 1024 * 1);
-			batchedDrawState.indexBuffer = new StreamBuffer(this, BUFFERUSAGE_INDEX, sizeof(uint16) * LOVE_UINT16_MAX);
+			batchedDrawState.indexBuffer = new StreamBuffer(this, BUFFERUSAGE_INDEX, sizeof(uint32) * LOVE_UINT16_MAX);
 		}
 
 		if (defaultVertexBuffer == nullptr)
@@ -709,9 +731,7 @@ bool Graphics::setMode(void *context, int width, int height, int pixelwidth, int
 			Buffer::Settings settings(BUFFERUSAGEFLAG_VERTEX, BUFFERDATAUSAGE_STATIC);
 			defaultVertexBuffer.set(newBuffer(settings, format, &data, sizeof(DefaultData), 1), Acquire::NORETAIN);
 
-			VkBuffer buffer = (VkBuffer)defaultVertexBuffer->getHandle();
-			VkDeviceSize offset = 0;
-			vkCmdBindVertexBuffers(commandBuffers.at(currentFrame), DEFAULT_VERTEX_BUFFER_BINDING, 1, &buffer, &offset);
+			bindDefaultVertexBuffer();
 		}
 
 		createDefaultShaders();
@@ -726,10 +746,13 @@ bool Graphics::setMode(void *context, int width, int height, int pixelwidth, int
 	restoreState(states.back());
 
 	Vulkan::resetShaderSwitches();
+	Vulkan::resetPipelineCacheStats();
 
 	created = true;
 	drawCalls = 0;
 	drawCallsBatched = 0;
+	batchedDrawsUint16Indices = 0;
+	batchedDrawsUint32Indices = 0;
 
 	return true;
 }
@@ -775,14 +798,18 @@ void Graphics::initCapabilities()
 	capabilities.textureTypes[TEXTURE_CUBE] = true;
 }
 
-void Graphics::getAPIStats(int &shaderswitches) const
+void Graphics::getAPIStats(int &shaderswitches, int &pipelinecachehits, int &pipelinecachemisses, int &pipelinecacheunknown) const
 {
 	shaderswitches = static_cast<int>(Vulkan::getNumShaderSwitches());
+	pipelinecachehits = static_cast<int>(Vulkan::getNumPipelineCacheHits());
+	pipelinecachemisses = static_cast<int>(Vulkan::getNumPipelineCacheMisses());
+	pipelinecacheunknown = static_cast<int>(Vulkan::getNumPipelineCacheUnknown());
 }
 
 void Graphics::unSetMode()
 {
 	submitGpuCommands(SUBMIT_NOPRESENT);
+	savePipelineCache();
 
 	created = false;
 
@@ -818,9 +845,12 @@ void Graphics::setFrontFaceWinding(Winding winding)
 	states.back().winding = winding;
 
 	if (optionalDeviceExtensions.extendedDynamicState)
-		vkCmdSetFrontFaceEXT(
-			commandBuffers.at(currentFrame),
-			Vulkan::getFrontFace(winding));
+	{
+		VkFrontFace frontFace = Vulkan::getFrontFace(winding);
+		recordCommand([frontFace](VkCommandBuffer commandBuffer) {
+			vkCmdSetFrontFaceEXT(commandBuffer, frontFace);
+		});
+	}
 }
 
 void Graphics::setColorMask(ColorChannelMask mask)
@@ -871,21 +901,20 @@ void Graphics::draw(const DrawCommand &cmd)
 
 	if (cmd.indirectBuffer != nullptr)
 	{
-		vkCmdDrawIndirect(
-			commandBuffers.at(currentFrame),
-			(VkBuffer) cmd.indirectBuffer->getHandle(),
-			cmd.indirectBufferOffset,
-			1,
-			0);
+		VkBuffer indirectBuffer = (VkBuffer) cmd.indirectBuffer->getHandle();
+		VkDeviceSize indirectOffset = cmd.indirectBufferOffset;
+		recordCommand([indirectBuffer, indirectOffset](VkCommandBuffer commandBuffer) {
+			vkCmdDrawIndirect(commandBuffer, indirectBuffer, indirectOffset, 1, 0);
+		});
 	}
 	else
 	{
-		vkCmdDraw(
-			commandBuffers.at(currentFrame),
-			(uint32) cmd.vertexCount,
-			(uint32) cmd.instanceCount,
-			(uint32) cmd.vertexStart,
-			0);
+		uint32 vertexCount = (uint32) cmd.vertexCount;
+		uint32 instanceCount = (uint32) cmd.instanceCount;
+		uint32 vertexStart = (uint32) cmd.vertexStart;
+		recordCommand([vertexCount, instanceCount, vertexStart](VkCommandBuffer commandBuffer) {
+			vkCmdDraw(commandBuffer, vertexCount, instanceCount, vertexStart, 0);
+		});
 	}
 
 	drawCalls++;
@@ -895,30 +924,28 @@ void Graphics::draw(const DrawIndexedCommand &cmd)
 {
 	prepareDraw(*cmd.attributes, *cmd.buffers, cmd.texture, cmd.primitiveType, cmd.cullMode);
 
-	vkCmdBindIndexBuffer(
-		commandBuffers.at(currentFrame),
-		(VkBuffer) cmd.indexBuffer->getHandle(),
-		(VkDeviceSize) cmd.indexBufferOffset,
-		Vulkan::getVulkanIndexBufferType(cmd.indexType));
+	VkBuffer indexBuffer = (VkBuffer) cmd.indexBuffer->getHandle();
+	VkDeviceSize indexOffset = (VkDeviceSize) cmd.indexBufferOffset;
+	VkIndexType indexType = Vulkan::getVulkanIndexBufferType(cmd.indexType);
+	recordCommand([indexBuffer, indexOffset, indexType](VkCommandBuffer commandBuffer) {
+		vkCmdBindIndexBuffer(commandBuffer, indexBuffer, indexOffset, indexType);
+	});
 
 	if (cmd.indirectBuffer != nullptr)
 	{
-		vkCmdDrawIndexedIndirect(
-			commandBuffers.at(currentFrame),
-			(VkBuffer) cmd.indirectBuffer->getHandle(),
-			cmd.indirectBufferOffset,
-			1,
-			0);
+		VkBuffer indirectBuffer = (VkBuffer) cmd.indirectBuffer->getHandle();
+		VkDeviceSize indirectOffset = cmd.indirectBufferOffset;
+		recordCommand([indirectBuffer, indirectOffset](VkCommandBuffer commandBuffer) {
+			vkCmdDrawIndexedIndirect(commandBuffer, indirectBuffer, indirectOffset, 1, 0);
+		});
 	}
 	else
 	{
-		vkCmdDrawIndexed(
-			commandBuffers.at(currentFrame),
-			(uint32) cmd.indexCount,
-			(uint32) cmd.instanceCount,
-			0,
-			0,
-			0);
+		uint32 indexCount = (uint32) cmd.indexCount;
+		uint32 instanceCount = (uint32) cmd.instanceCount;
+		recordCommand([indexCount, instanceCount](VkCommandBuffer commandBuffer) {
+			vkCmdDrawIndexed(commandBuffer, indexCount, instanceCount, 0, 0, 0);
+		});
 	}
 
 	drawCalls++;
@@ -931,11 +958,11 @@ void Graphics::drawQuads(int start, int count, const VertexAttributes &attribute
 
 	prepareDraw(attributes, buffers, texture, PRIMITIVE_TRIANGLES, CULL_NONE);
 
-	vkCmdBindIndexBuffer(
-		commandBuffers.at(currentFrame),
-		(VkBuffer)quadIndexBuffer->getHandle(),
-		0,
-		Vulkan::getVulkanIndexBufferType(INDEX_UINT16));
+	VkBuffer indexBuffer = (VkBuffer)quadIndexBuffer->getHandle();
+	VkIndexType indexType = Vulkan::getVulkanIndexBufferType(INDEX_UINT16);
+	recordCommand([indexBuffer, indexType](VkCommandBuffer commandBuffer) {
+		vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, indexType);
+	});
 
 	int baseVertex = start * 4;
 
@@ -943,13 +970,10 @@ void Graphics::drawQuads(int start, int count, const VertexAttributes &attribute
 	{
 		int quadcount = std::min(MAX_QUADS_PER_DRAW, count - quadindex);
 
-		vkCmdDrawIndexed(
-			commandBuffers.at(currentFrame),
-			static_cast<uint32_t>(quadcount * 6),
-			1,
-			0,
-			baseVertex,
-			0);
+		uint32 indexCount = static_cast<uint32_t>(quadcount * 6);
+		recordCommand([indexCount, baseVertex](VkCommandBuffer commandBuffer) {
+			vkCmdDrawIndexed(commandBuffer, indexCount, 1, 0, baseVertex, 0);
+		});
 		baseVertex += quadcount * 4;
 
 		drawCalls++;
@@ -990,7 +1014,9 @@ void Graphics::applyScissor()
 		scissor.extent.height = (uint32)(rect.h * dpiScale);
 	}
 
-	vkCmdSetScissor(commandBuffers.at(currentFrame), 0, 1, &scissor);
+	recordCommand([scissor](VkCommandBuffer commandBuffer) {
+		vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+	});
 }
 
 void Graphics::setScissor(const Rect &rect)
@@ -1020,19 +1046,9 @@ void Graphics::setStencilState(const StencilState &s)
 
 	flushBatchedDraws();
 
-	vkCmdSetStencilWriteMask(commandBuffers.at(currentFrame), VK_STENCIL_FRONT_AND_BACK, s.writeMask);
-	
-	vkCmdSetStencilCompareMask(commandBuffers.at(currentFrame), VK_STENCIL_FRONT_AND_BACK, s.readMask);
-	vkCmdSetStencilReference(commandBuffers.at(currentFrame), VK_STENCIL_FRONT_AND_BACK, s.value);
-
-	if (optionalDeviceExtensions.extendedDynamicState)
-		vkCmdSetStencilOpEXT(
-			commandBuffers.at(currentFrame),
-			VK_STENCIL_FRONT_AND_BACK,
-			VK_STENCIL_OP_KEEP, Vulkan::getStencilOp(s.action),
-			VK_STENCIL_OP_KEEP, Vulkan::getCompareOp(getReversedCompareMode(s.compare)));
-
 	states.back().stencil = s;
+
+	cmdSetStencilState();
 }
 
 void Graphics::setDepthMode(CompareMode compare, bool write)
@@ -1041,17 +1057,10 @@ void Graphics::setDepthMode(CompareMode compare, bool write)
 
 	flushBatchedDraws();
 
-	if (optionalDeviceExtensions.extendedDynamicState)
-	{
-		vkCmdSetDepthCompareOpEXT(
-			commandBuffers.at(currentFrame), Vulkan::getCompareOp(compare));
-
-		vkCmdSetDepthWriteEnableEXT(
-			commandBuffers.at(currentFrame), Vulkan::getBool(write));
-	}
-
 	states.back().depthTest = compare;
 	states.back().depthWrite = write;
+
+	cmdSetDepthState();
 }
 
 void Graphics::setWireframe(bool enable)
@@ -1185,12 +1194,12 @@ bool Graphics::dispatch(love::graphics::Shader *shader, int x, int y, int z)
 	if (renderPassState.active)
 		endRenderPass();
 
-	vkCmdBindPipeline(commandBuffers.at(currentFrame), VK_PIPELINE_BIND_POINT_COMPUTE, computeShader->getComputePipeline());
+	vkCmdBindPipeline(activeCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, computeShader->getComputePipeline());
 
-	computeShader->cmdPushDescriptorSets(commandBuffers.at(currentFrame), VK_PIPELINE_BIND_POINT_COMPUTE);
+	computeShader->cmdPushDescriptorSets(activeCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE);
 
 	// TODO: does this need any layout transitions?
-	vkCmdDispatch(commandBuffers.at(currentFrame), (uint32) x, (uint32) y, (uint32) z);
+	vkCmdDispatch(activeCommandBuffer, (uint32) x, (uint32) y, (uint32) z);
 
 	return true;
 }
@@ -1202,12 +1211,12 @@ bool Graphics::dispatch(love::graphics::Shader *shader, love::graphics::Buffer *
 	if (renderPassState.active)
 		endRenderPass();
 
-	vkCmdBindPipeline(commandBuffers.at(currentFrame), VK_PIPELINE_BIND_POINT_COMPUTE, computeShader->getComputePipeline());
+	vkCmdBindPipeline(activeCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, computeShader->getComputePipeline());
 
-	computeShader->cmdPushDescriptorSets(commandBuffers.at(currentFrame), VK_PIPELINE_BIND_POINT_COMPUTE);
+	computeShader->cmdPushDescriptorSets(activeCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE);
 
 	// TODO: does this need any layout transitions?
-	vkCmdDispatchIndirect(commandBuffers.at(currentFrame), (VkBuffer) indirectargs->getHandle(), argsoffset);
+	vkCmdDispatchIndirect(activeCommandBuffer, (VkBuffer) indirectargs->getHandle(), argsoffset);
 
 	return true;
 }
@@ -1228,27 +1237,61 @@ void Graphics::setRenderTargetsInternal(const RenderTargets &rts, int pixelw, in
 
 void Graphics::initDynamicState()
 {
-	vkCmdSetStencilWriteMask(commandBuffers.at(currentFrame), VK_STENCIL_FRONT_AND_BACK, states.back().stencil.writeMask);
-	vkCmdSetStencilCompareMask(commandBuffers.at(currentFrame), VK_STENCIL_FRONT_AND_BACK, states.back().stencil.readMask);
-	vkCmdSetStencilReference(commandBuffers.at(currentFrame), VK_STENCIL_FRONT_AND_BACK, states.back().stencil.value);
+	cmdSetStencilState();
+	cmdSetDepthState();
 
 	if (optionalDeviceExtensions.extendedDynamicState)
 	{
-		 vkCmdSetStencilOpEXT(
-			commandBuffers.at(currentFrame),
-			VK_STENCIL_FRONT_AND_BACK,
-			VK_STENCIL_OP_KEEP, Vulkan::getStencilOp(states.back().stencil.action),
-			VK_STENCIL_OP_KEEP, Vulkan::getCompareOp(getReversedCompareMode(states.back().stencil.compare)));
+		VkFrontFace frontFace = Vulkan::getFrontFace(states.back().winding);
+		recordCommand([frontFace](VkCommandBuffer commandBuffer) {
+			vkCmdSetFrontFaceEXT(commandBuffer, frontFace);
+		});
+	}
+}
 
-		vkCmdSetDepthCompareOpEXT(
-			commandBuffers.at(currentFrame), Vulkan::getCompareOp(states.back().depthTest));
+void Graphics::cmdSetStencilState()
+{
+	const StencilState &s = states.back().stencil;
 
-		vkCmdSetDepthWriteEnableEXT(
-			commandBuffers.at(currentFrame), Vulkan::getBool(states.back().depthWrite));
+	bool extendedDynamicState = optionalDeviceExtensions.extendedDynamicState;
+	VkStencilOp stencilOp = Vulkan::getStencilOp(s.action);
+	VkCompareOp compareOp = Vulkan::getCompareOp(getReversedCompareMode(s.compare));
 
-		vkCmdSetFrontFaceEXT(
-			commandBuffers.at(currentFrame), Vulkan::getFrontFace(states.back().winding));
-	}
+	recordCommand([s, extendedDynamicState, stencilOp, compareOp](VkCommandBuffer commandBuffer) {
+		vkCmdSetStencilWriteMask(commandBuffer, VK_STENCIL_FRONT_AND_BACK, s.writeMask);
+		vkCmdSetStencilCompareMask(commandBuffer, VK_STENCIL_FRONT_AND_BACK, s.readMask);
+		vkCmdSetStencilReference(commandBuffer, VK_STENCIL_FRONT_AND_BACK, s.value);
+
+		if (extendedDynamicState)
+			vkCmdSetStencilOpEXT(
+				commandBuffer,
+				VK_STENCIL_FRONT_AND_BACK,
+				VK_STENCIL_OP_KEEP, stencilOp,
+				VK_STENCIL_OP_KEEP, compareOp);
+	});
+}
+
+void Graphics::cmdSetDepthState()
+{
+	if (!optionalDeviceExtensions.extendedDynamicState)
+		return;
+
+	VkCompareOp compareOp = Vulkan::getCompareOp(states.back().depthTest);
+	VkBool32 write = Vulkan::getBool(states.back().depthWrite);
+
+	recordCommand([compareOp, write](VkCommandBuffer commandBuffer) {
+		vkCmdSetDepthCompareOpEXT(commandBuffer, compareOp);
+		vkCmdSetDepthWriteEnableEXT(commandBuffer, write);
+	});
+}
+
+void Graphics::bindDefaultVertexBuffer()
+{
+	VkBuffer buffer = (VkBuffer)defaultVertexBuffer->getHandle();
+	recordCommand([buffer](VkCommandBuffer commandBuffer) {
+		VkDeviceSize offset = 0;
+		vkCmdBindVertexBuffers(commandBuffer, DEFAULT_VERTEX_BUFFER_BINDING, 1, &buffer, &offset);
+	});
 }
 
 void Graphics::beginFrame()
@@ -1294,10 +1337,16 @@ void Graphics::beginFrame()
 
 	startRecordingGraphicsCommands();
 
+	if (!timestampQueryPools.empty())
+	{
+		vkCmdResetQueryPool(activeCommandBuffer, timestampQueryPools.at(currentFrame), 0, MAX_TIMESTAMP_QUERIES_PER_FRAME);
+		timestampQueryCount = 0;
+	}
+
 	if (!swapChainImages.empty())
 	{
 		Vulkan::cmdTransitionImageLayout(
-			commandBuffers.at(currentFrame),
+			activeCommandBuffer,
 			swapChainImages[imageIndex],
 			swapChainPixelFormat,
 			VK_IMAGE_LAYOUT_UNDEFINED,
@@ -1308,7 +1357,7 @@ void Graphics::beginFrame()
 	{
 		if (depthImage)
 			Vulkan::cmdTransitionImageLayout(
-				commandBuffers.at(currentFrame),
+				activeCommandBuffer,
 				depthImage,
 				depthStencilPixelFormat,
 				VK_IMAGE_LAYOUT_UNDEFINED,
@@ -1316,7 +1365,7 @@ void Graphics::beginFrame()
 
 		if (colorImage)
 			Vulkan::cmdTransitionImageLayout(
-				commandBuffers.at(currentFrame),
+				activeCommandBuffer,
 				colorImage,
 				swapChainPixelFormat,
 				VK_IMAGE_LAYOUT_UNDEFINED,
@@ -1326,6 +1375,7 @@ void Graphics::beginFrame()
 	}
 
 	Vulkan::resetShaderSwitches();
+	Vulkan::resetPipelineCacheStats();
 
 	for (const auto &shader : usedShadersInFrame)
 		shader->newFrame();
@@ -1344,6 +1394,14 @@ void Graphics::startRecordingGraphicsCommands()
 	if (vkBeginCommandBuffer(commandBuffers.at(currentFrame), &beginInfo) != VK_SUCCESS)
 		throw love::Exception("failed to begin recording command buffer");
 
+	activeCommandBuffer = commandBuffers.at(currentFrame);
+	frameCommandBuffers.clear();
+	usedExtraCommandBuffers = 0;
+	recordedRenderPasses.clear();
+
+	if (commandRecorder)
+		commandRecorder->beginFrame(currentFrame);
+
 	initDynamicState();
 
 	// This must be done after vkBeginCommandBuffer (since newTexture needs an
@@ -1363,11 +1421,7 @@ void Graphics::startRecordingGraphicsCommands()
 	setDefaultRenderPass();
 
 	if (defaultVertexBuffer)
-	{
-		VkBuffer buffer = (VkBuffer)defaultVertexBuffer->getHandle();
-		VkDeviceSize offset = 0;
-		vkCmdBindVertexBuffers(commandBuffers.at(currentFrame), DEFAULT_VERTEX_BUFFER_BINDING, 1, &buffer, &offset);
-	}
+		bindDefaultVertexBuffer();
 }
 
 void Graphics::endRecordingGraphicsCommands()
@@ -1375,16 +1429,120 @@ void Graphics::endRecordingGraphicsCommands()
 	if (renderPassState.active)
 		endRenderPass();
 
-	if (vkEndCommandBuffer(commandBuffers.at(currentFrame)) != VK_SUCCESS)
+	if (vkEndCommandBuffer(activeCommandBuffer) != VK_SUCCESS)
+		throw love::Exception("failed to record command buffer");
+
+	frameCommandBuffers.push_back(activeCommandBuffer);
+	activeCommandBuffer = VK_NULL_HANDLE;
+
+	if (commandRecorder)
+	{
+		commandRecorder->wait();
+
+		for (const auto &renderPass : recordedRenderPasses)
+			recordRenderPassCommandBuffer(*renderPass);
+	}
+}
+
+VkCommandBuffer Graphics::beginExtraCommandBuffer()
+{
+	auto &commandBuffers = extraCommandBuffers.at(currentFrame);
+
+	if (usedExtraCommandBuffers == commandBuffers.size())
+	{
+		VkCommandBufferAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.commandPool = commandPool;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandBufferCount = 1;
+
+		VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+		if (vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer) != VK_SUCCESS)
+			throw love::Exception("failed to allocate command buffer");
+
+		commandBuffers.push_back(commandBuffer);
+	}
+
+	VkCommandBuffer commandBuffer = commandBuffers[usedExtraCommandBuffers++];
+
+	VkCommandBufferBeginInfo beginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+	if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+		throw love::Exception("failed to begin recording command buffer");
+
+	return commandBuffer;
+}
+
+void Graphics::recordRenderPassCommandBuffer(RecordedRenderPass &renderPass)
+{
+	VkCommandBuffer commandBuffer = renderPass.commandBuffer;
+
+	for (const auto &[image, format, imageLayout, renderLayout, rootmip, rootlayer] : renderPass.transitionImages)
+		Vulkan::cmdTransitionImageLayout(commandBuffer, image, format, imageLayout, renderLayout, rootmip, 1, rootlayer, 1);
+
+	vkCmdBeginRenderPass(commandBuffer, &renderPass.beginInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+	vkCmdExecuteCommands(commandBuffer, 1, &renderPass.pass.commandBuffer);
+	vkCmdEndRenderPass(commandBuffer);
+
+	for (const auto &[image, format, imageLayout, renderLayout, rootmip, rootlayer] : renderPass.transitionImages)
+		Vulkan::cmdTransitionImageLayout(commandBuffer, image, format, renderLayout, imageLayout, rootmip, 1, rootlayer, 1);
+
+	if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
 		throw love::Exception("failed to record command buffer");
 }
 
+void Graphics::endRecordingInitialDataTransferCommands()
+{
+	VkCommandBuffer commandBuffer = initialDataTransferCommandBuffers.at(currentFrame);
+
+	// Make the uploads visible to everything recorded in the main command
+	// buffer, which is submitted right after this one.
+	VkMemoryBarrier barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+	vkCmdPipelineBarrier(
+		commandBuffer,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+		0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+	if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+		throw love::Exception("failed to record data transfer command buffer");
+
+	initialDataTransferActive = false;
+}
+
 VkCommandBuffer Graphics::getCommandBufferForDataTransfer()
 {
 	if (renderPassState.active)
 		endRenderPass();
 
-	return commandBuffers.at(currentFrame);
+	return activeCommandBuffer;
+}
+
+VkCommandBuffer Graphics::getCommandBufferForInitialDataTransfer()
+{
+	// Only valid for resources which nothing has referenced yet: everything
+	// recorded here executes before all of the frame's other commands.
+	VkCommandBuffer commandBuffer = initialDataTransferCommandBuffers.at(currentFrame);
+
+	if (!initialDataTransferActive)
+	{
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+		if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+			throw love::Exception("failed to begin recording data transfer command buffer");
+
+		initialDataTransferActive = true;
+	}
+
+	return commandBuffer;
 }
 
 void Graphics::queueCleanUp(std::function<void()> cleanUp)
@@ -1499,6 +1657,7 @@ void Graphics::pickPhysicalDevice()
 	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
 	minUniformBufferOffsetAlignment = properties.limits.minUniformBufferOffsetAlignment;
 	deviceApiVersion = properties.apiVersion;
+	timestampPeriod = properties.limits.timestampComputeAndGraphics ? properties.limits.timestampPeriod : 0.0f;
 
 	depthStencilFormat = findDepthFormat();
 	switch (depthStencilFormat)
@@ -1632,6 +1791,8 @@ static void findOptionalDeviceExtensions(VkPhysicalDevice physicalDevice, Option
 			optionalDeviceExtensions.shaderFloatControls = true;
 		if (strcmp(extension.extensionName, VK_KHR_SPIRV_1_4_EXTENSION_NAME) == 0)
 			optionalDeviceExtensions.spirv14 = true;
+		if (strcmp(extension.extensionName, VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME) == 0)
+			optionalDeviceExtensions.pipelineCreationFeedback = true;
 	}
 }
 
@@ -1670,6 +1831,9 @@ void Graphics::createLogicalDevice()
 		optionalDeviceExtensions.spirv14 = false;
 	if (optionalDeviceExtensions.spirv14 && deviceApiVersion < VK_API_VERSION_1_1)
 		optionalDeviceExtensions.spirv14 = false;
+	// Promoted to core in Vulkan 1.3.
+	if (deviceApiVersion >= VK_API_VERSION_1_3)
+		optionalDeviceExtensions.pipelineCreationFeedback = true;
 
 	VkPhysicalDeviceFeatures deviceFeatures{};
 	deviceFeatures.samplerAnisotropy = VK_TRUE;
@@ -1694,6 +1858,8 @@ void Graphics::createLogicalDevice()
 		enabledExtensions.push_back(VK_KHR_SHADER_FLOAT_CONTROLS_EXTENSION_NAME);
 	if (optionalDeviceExtensions.spirv14)
 		enabledExtensions.push_back(VK_KHR_SPIRV_1_4_EXTENSION_NAME);
+	if (optionalDeviceExtensions.pipelineCreationFeedback && deviceApiVersion < VK_API_VERSION_1_3)
+		enabledExtensions.push_back(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
 	if (deviceApiVersion >= VK_API_VERSION_1_1)
 		enabledExtensions.push_back(VK_KHR_BIND_MEMORY_2_EXTENSION_NAME);
 
@@ -1723,13 +1889,120 @@ void Graphics::createLogicalDevice()
 	vkGetDeviceQueue(device, indices.presentFamily.value, 0, &presentQueue);
 }
 
+static PipelineCacheFileHeader getPipelineCacheFileHeader(VkPhysicalDevice physicalDevice)
+{
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+	PipelineCacheFileHeader header{};
+	header.magic = PipelineCacheFileHeader::MAGIC;
+	header.version = PipelineCacheFileHeader::VERSION;
+	header.vendorID = properties.vendorID;
+	header.deviceID = properties.deviceID;
+	header.driverVersion = properties.driverVersion;
+	memcpy(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+
+	return header;
+}
+
+static bool isPipelineCacheFileHeaderCompatible(const PipelineCacheFileHeader &a, const PipelineCacheFileHeader &b)
+{
+	return a.magic == b.magic
+		&& a.version == b.version
+		&& a.vendorID == b.vendorID
+		&& a.deviceID == b.deviceID
+		&& a.driverVersion == b.driverVersion
+		&& memcmp(a.pipelineCacheUUID, b.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
 void Graphics::createPipelineCache()
 {
 	VkPipelineCacheCreateInfo cacheInfo{};
 	cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
 
+	// Try to seed the cache with the data serialized by a previous session.
+	// Anything that doesn't match the current device and driver is ignored,
+	// since the driver would have to throw it away anyway.
+	StrongRef<love::filesystem::FileData> cacheFile;
+	auto fs = Module::getInstance<love::filesystem::Filesystem>(M_FILESYSTEM);
+
+	if (fs != nullptr)
+	{
+		try
+		{
+			if (fs->exists(PIPELINE_CACHE_FILENAME))
+				cacheFile.set(fs->read(PIPELINE_CACHE_FILENAME), Acquire::NORETAIN);
+		}
+		catch (love::Exception &)
+		{
+			cacheFile.set(nullptr);
+		}
+	}
+
+	if (cacheFile.get() != nullptr && cacheFile->getSize() > sizeof(PipelineCacheFileHeader))
+	{
+		PipelineCacheFileHeader header;
+		memcpy(&header, cacheFile->getData(), sizeof(PipelineCacheFileHeader));
+
+		const uint8 *data = (const uint8 *) cacheFile->getData() + sizeof(PipelineCacheFileHeader);
+		size_t size = cacheFile->getSize() - sizeof(PipelineCacheFileHeader);
+
+		if (isPipelineCacheFileHeaderCompatible(header, getPipelineCacheFileHeader(physicalDevice))
+			&& header.dataSize == size
+			&& header.dataHash == XXH32(data, size, 0))
+		{
+			cacheInfo.initialDataSize = size;
+			cacheInfo.pInitialData = data;
+		}
+	}
+
 	if (vkCreatePipelineCache(device, &cacheInfo, nullptr, &pipelineCache) != VK_SUCCESS)
-		throw love::Exception("could not create pipeline cache");
+	{
+		// The driver might still reject data that passed our checks.
+		cacheInfo.initialDataSize = 0;
+		cacheInfo.pInitialData = nullptr;
+
+		if (vkCreatePipelineCache(device, &cacheInfo, nullptr, &pipelineCache) != VK_SUCCESS)
+			throw love::Exception("could not create pipeline cache");
+	}
+
+	pipelineCacheModified = false;
+}
+
+void Graphics::savePipelineCache()
+{
+	if (pipelineCache == VK_NULL_HANDLE || !pipelineCacheModified)
+		return;
+
+	auto fs = Module::getInstance<love::filesystem::Filesystem>(M_FILESYSTEM);
+	if (fs == nullptr)
+		return;
+
+	size_t size = 0;
+	if (vkGetPipelineCacheData(device, pipelineCache, &size, nullptr) != VK_SUCCESS || size == 0)
+		return;
+
+	std::vector<uint8> filedata(sizeof(PipelineCacheFileHeader) + size);
+	uint8 *data = filedata.data() + sizeof(PipelineCacheFileHeader);
+
+	if (vkGetPipelineCacheData(device, pipelineCache, &size, data) != VK_SUCCESS)
+		return;
+
+	PipelineCacheFileHeader header = getPipelineCacheFileHeader(physicalDevice);
+	header.dataSize = (uint32) size;
+	header.dataHash = XXH32(data, size, 0);
+	memcpy(filedata.data(), &header, sizeof(PipelineCacheFileHeader));
+
+	try
+	{
+		fs->write(PIPELINE_CACHE_FILENAME, filedata.data(), sizeof(PipelineCacheFileHeader) + size);
+		pipelineCacheModified = false;
+	}
+	catch (love::Exception &)
+	{
+		// The cache is only an optimization, so a missing or read-only save
+		// directory isn't an error.
+	}
 }
 
 void Graphics::initVMA()
@@ -2333,7 +2606,12 @@ void Graphics::prepareDraw(const VertexAttributes &attributes, const BufferBindi
 	configuration.primitiveType = primitiveType;
 
 	if (optionalDeviceExtensions.extendedDynamicState)
-		vkCmdSetCullModeEXT(commandBuffers.at(currentFrame), Vulkan::getCullMode(cullmode));
+	{
+		VkCullModeFlags vkcullmode = Vulkan::getCullMode(cullmode);
+		recordCommand([vkcullmode](VkCommandBuffer commandBuffer) {
+			vkCmdSetCullModeEXT(commandBuffer, vkcullmode);
+		});
+	}
 	else
 	{
 		configuration.dynamicState.winding = states.back().winding;
@@ -2347,15 +2625,21 @@ void Graphics::prepareDraw(const VertexAttributes &attributes, const BufferBindi
 	VkPipeline pipeline = s->getCachedGraphicsPipeline(this, configuration);
 	if (pipeline != renderPassState.pipeline)
 	{
-		vkCmdBindPipeline(commandBuffers.at(currentFrame), VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+		recordCommand([pipeline](VkCommandBuffer commandBuffer) {
+			vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+		});
 		renderPassState.pipeline = pipeline;
 	}
 
 	s->setMainTex(texture);
-	s->cmdPushDescriptorSets(commandBuffers.at(currentFrame), VK_PIPELINE_BIND_POINT_GRAPHICS);
 
-	VkBuffer vkbuffers[BufferBindings::MAX];
-	VkDeviceSize vkoffsets[BufferBindings::MAX];
+	Shader::DescriptorSetBinding descriptorSets = s->updateDescriptorSets();
+	recordCommand([descriptorSets](VkCommandBuffer commandBuffer) {
+		Shader::cmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, descriptorSets);
+	});
+
+	std::array<VkBuffer, BufferBindings::MAX> vkbuffers;
+	std::array<VkDeviceSize, BufferBindings::MAX> vkoffsets;
 	uint32 buffercount = 0;
 
 	uint32 allbits = buffers.useBits;
@@ -2377,7 +2661,11 @@ void Graphics::prepareDraw(const VertexAttributes &attributes, const BufferBindi
 	}
 
 	if (buffercount > 0)
-		vkCmdBindVertexBuffers(commandBuffers.at(currentFrame), VERTEX_BUFFER_BINDING_START, buffercount, vkbuffers, vkoffsets);
+	{
+		recordCommand([buffercount, vkbuffers, vkoffsets](VkCommandBuffer commandBuffer) {
+			vkCmdBindVertexBuffers(commandBuffer, VERTEX_BUFFER_BINDING_START, buffercount, vkbuffers.data(), vkoffsets.data());
+		});
+	}
 }
 
 void Graphics::setDefaultRenderPass()
@@ -2536,6 +2824,49 @@ void Graphics::startRenderPass()
 	if (renderPassState.isWindow && renderPassState.windowClearRequested)
 		renderPassState.windowClearRequested = false;
 
+	renderPassState.beginInfo.renderPass = getRenderPass(renderPassState.renderPassConfiguration);
+
+	renderPassState.framebufferConfiguration.staticData.renderPass = renderPassState.beginInfo.renderPass;
+	renderPassState.beginInfo.framebuffer = getFramebuffer(renderPassState.framebufferConfiguration);
+
+	if (commandRecorder)
+	{
+		// The pass gets a primary command buffer of its own, which is
+		// finished once a worker has recorded the pass's contents.
+		if (vkEndCommandBuffer(activeCommandBuffer) != VK_SUCCESS)
+			throw love::Exception("failed to record command buffer");
+
+		frameCommandBuffers.push_back(activeCommandBuffer);
+		activeCommandBuffer = VK_NULL_HANDLE;
+
+		auto renderPass = std::make_unique<RecordedRenderPass>();
+		renderPass->pass.renderPass = renderPassState.beginInfo.renderPass;
+		renderPass->pass.framebuffer = renderPassState.beginInfo.framebuffer;
+		renderPass->commandBuffer = beginExtraCommandBuffer();
+		renderPass->beginInfo = renderPassState.beginInfo;
+		renderPass->clearColors = renderPassState.clearColors;
+		renderPass->beginInfo.pClearValues = renderPass->clearColors.data();
+		renderPass->transitionImages = renderPassState.transitionImages;
+
+		frameCommandBuffers.push_back(renderPass->commandBuffer);
+
+		recordedRenderPass = renderPass.get();
+		recordedRenderPasses.push_back(std::move(renderPass));
+
+		// Secondary command buffers don't inherit any state.
+		renderPassState.pipeline = VK_NULL_HANDLE;
+		initDynamicState();
+		if (defaultVertexBuffer)
+			bindDefaultVertexBuffer();
+	}
+	else
+	{
+		for (const auto &[image, format, imageLayout, renderLayout, rootmip, rootlayer] : renderPassState.transitionImages)
+			Vulkan::cmdTransitionImageLayout(activeCommandBuffer, image, format, imageLayout, renderLayout, rootmip, 1, rootlayer, 1);
+
+		vkCmdBeginRenderPass(activeCommandBuffer, &renderPassState.beginInfo, VK_SUBPASS_CONTENTS_INLINE);
+	}
+
 	VkViewport viewport{};
 	viewport.x = 0.0f;
 	viewport.y = 0.0f;
@@ -2544,17 +2875,9 @@ void Graphics::startRenderPass()
 	viewport.minDepth = 0.0f;
 	viewport.maxDepth = 1.0f;
 
-	vkCmdSetViewport(commandBuffers.at(currentFrame), 0, 1, &viewport);
-
-	renderPassState.beginInfo.renderPass = getRenderPass(renderPassState.renderPassConfiguration);
-
-	renderPassState.framebufferConfiguration.staticData.renderPass = renderPassState.beginInfo.renderPass;
-	renderPassState.beginInfo.framebuffer = getFramebuffer(renderPassState.framebufferConfiguration);
-
-	for (const auto &[image, format, imageLayout, renderLayout, rootmip, rootlayer] : renderPassState.transitionImages)
-		Vulkan::cmdTransitionImageLayout(commandBuffers.at(currentFrame), image, format, imageLayout, renderLayout, rootmip, 1, rootlayer, 1);
-
-	vkCmdBeginRenderPass(commandBuffers.at(currentFrame), &renderPassState.beginInfo, VK_SUBPASS_CONTENTS_INLINE);
+	recordCommand([viewport](VkCommandBuffer commandBuffer) {
+		vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+	});
 
 	applyScissor();
 }
@@ -2563,10 +2886,20 @@ void Graphics::endRenderPass()
 {
 	renderPassState.active = false;
 
-	vkCmdEndRenderPass(commandBuffers.at(currentFrame));
+	if (recordedRenderPass != nullptr)
+	{
+		commandRecorder->record(&recordedRenderPass->pass);
+		recordedRenderPass = nullptr;
+
+		activeCommandBuffer = beginExtraCommandBuffer();
+	}
+	else
+	{
+		vkCmdEndRenderPass(activeCommandBuffer);
 
-	for (const auto &[image, format, imageLayout, renderLayout, rootmip, rootlayer] : renderPassState.transitionImages)
-		Vulkan::cmdTransitionImageLayout(commandBuffers.at(currentFrame), image, format, renderLayout, imageLayout, rootmip, 1, rootlayer, 1);
+		for (const auto &[image, format, imageLayout, renderLayout, rootmip, rootlayer] : renderPassState.transitionImages)
+			Vulkan::cmdTransitionImageLayout(activeCommandBuffer, image, format, renderLayout, imageLayout, rootmip, 1, rootlayer, 1);
+	}
 
 	for (auto &colorAttachment : renderPassState.renderPassConfiguration.colorAttachments)
 		colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
@@ -2823,9 +3156,35 @@ VkPipeline Graphics::createGraphicsPipeline(Shader *shader, const GraphicsPipeli
 	pipelineInfo.basePipelineIndex = -1;
 	pipelineInfo.renderPass = configuration.renderPass;
 
+	// Lets us tell whether the pipeline was served by the pipeline cache
+	// (possibly loaded from disk) or had to be compiled from scratch.
+	VkPipelineCreationFeedback pipelineFeedback{};
+	VkPipelineCreationFeedbackCreateInfo feedbackInfo{};
+	feedbackInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO;
+	feedbackInfo.pPipelineCreationFeedback = &pipelineFeedback;
+
+	if (optionalDeviceExtensions.pipelineCreationFeedback)
+		pipelineInfo.pNext = &feedbackInfo;
+
 	VkPipeline graphicsPipeline;
 	if (vkCreateGraphicsPipelines(device, pipelineCache, 1, &pipelineInfo, nullptr, &graphicsPipeline) != VK_SUCCESS)
 		throw love::Exception("failed to create graphics pipeline");
+
+	// Without valid feedback (extension missing, or the driver chose not to
+	// fill it in) we can't tell whether the cache was used.
+	if ((pipelineFeedback.flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT) == 0)
+	{
+		Vulkan::pipelineCacheUnknown();
+		pipelineCacheModified = true;
+	}
+	else if (pipelineFeedback.flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT)
+		Vulkan::pipelineCacheHit();
+	else
+	{
+		Vulkan::pipelineCacheMiss();
+		pipelineCacheModified = true;
+	}
+
 	return graphicsPipeline;
 }
 
@@ -3030,6 +3389,13 @@ void Graphics::createCommandPool()
 
 	if (vkCreateCommandPool(device, &poolInfo, nullptr, &commandPool) != VK_SUCCESS)
 		throw love::Exception("failed to create command pool");
+
+	// Recording render passes on worker threads is opt-in for now.
+	const char *threadsenv = getenv("LOVE_GRAPHICS_VULKAN_RECORDING_THREADS");
+	int recordingThreads = threadsenv != nullptr ? atoi(threadsenv) : 0;
+
+	if (recordingThreads > 0)
+		commandRecorder.reset(new CommandRecorder(device, queueFamilyIndices.graphicsFamily.value, MAX_FRAMES_IN_FLIGHT, recordingThreads));
 }
 
 void Graphics::createCommandBuffers()
@@ -3044,6 +3410,14 @@ void Graphics::createCommandBuffers()
 
 	if (vkAllocateCommandBuffers(device, &allocInfo, commandBuffers.data()) != VK_SUCCESS)
 		throw love::Exception("failed to allocate command buffers");
+
+	initialDataTransferCommandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+
+	if (vkAllocateCommandBuffers(device, &allocInfo, initialDataTransferCommandBuffers.data()) != VK_SUCCESS)
+		throw love::Exception("failed to allocate data transfer command buffers");
+
+	// Allocated as needed when render passes are recorded on worker threads.
+	extraCommandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
 }
 
 void Graphics::createSyncObjects()
@@ -3067,6 +3441,72 @@ void Graphics::createSyncObjects()
 			throw love::Exception("failed to create synchronization objects for a frame!");
 }
 
+void Graphics::createTimestampQueryPools()
+{
+	if (timestampPeriod <= 0.0f)
+		return;
+
+	timestampQueryPools.resize(MAX_FRAMES_IN_FLIGHT, VK_NULL_HANDLE);
+
+	VkQueryPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+	poolInfo.queryCount = MAX_TIMESTAMP_QUERIES_PER_FRAME;
+
+	for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+	{
+		if (vkCreateQueryPool(device, &poolInfo, nullptr, &timestampQueryPools.at(i)) != VK_SUCCESS)
+			throw love::Exception("failed to create timestamp query pool");
+	}
+}
+
+int Graphics::writeTimestampQuery()
+{
+	if (timestampQueryPools.empty() || timestampQueryCount >= MAX_TIMESTAMP_QUERIES_PER_FRAME)
+		return -1;
+
+	VkQueryPool queryPool = timestampQueryPools.at(currentFrame);
+	uint32 query = timestampQueryCount;
+	recordCommand([queryPool, query](VkCommandBuffer commandBuffer) {
+		vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, query);
+	});
+
+	return (int) timestampQueryCount++;
+}
+
+void Graphics::endTimestampQueries(uint64 frame)
+{
+	if (timestampQueryCount == 0)
+		return;
+
+	VkQueryPool pool = timestampQueryPools.at(currentFrame);
+	uint32 count = timestampQueryCount;
+	double period = timestampPeriod;
+
+	// Readback callbacks run once the frame's fence has been signaled, so the
+	// results are available without waiting.
+	readbackCallbacks.at(currentFrame).push_back([this, pool, count, period, frame]() {
+		std::vector<uint64> ticks(count);
+		std::vector<double> timestamps;
+
+		VkResult result = vkGetQueryPoolResults(
+			device, pool, 0, count,
+			sizeof(uint64) * count, ticks.data(), sizeof(uint64),
+			VK_QUERY_RESULT_64_BIT);
+
+		if (result == VK_SUCCESS)
+		{
+			timestamps.reserve(count);
+			for (uint64 t : ticks)
+				timestamps.push_back((double) t * period / 1000000000.0);
+		}
+
+		resolveProfileFrame(frame, timestamps);
+	});
+
+	timestampQueryCount = 0;
+}
+
 void Graphics::cleanup()
 {
 	for (auto &cleanUpFns : cleanUpFunctions)
@@ -3082,7 +3522,21 @@ void Graphics::cleanup()
 		vkDestroyFence(device, inFlightFences[i], nullptr);
 	}
 
+	for (VkQueryPool pool : timestampQueryPools)
+		vkDestroyQueryPool(device, pool, nullptr);
+	timestampQueryPools.clear();
+
 	vkFreeCommandBuffers(device, commandPool, MAX_FRAMES_IN_FLIGHT, commandBuffers.data());
+	vkFreeCommandBuffers(device, commandPool, MAX_FRAMES_IN_FLIGHT, initialDataTransferCommandBuffers.data());
+
+	for (const auto &frameExtraCommandBuffers : extraCommandBuffers)
+	{
+		if (!frameExtraCommandBuffers.empty())
+			vkFreeCommandBuffers(device, commandPool, (uint32) frameExtraCommandBuffers.size(), frameExtraCommandBuffers.data());
+	}
+	extraCommandBuffers.clear();
+
+	commandRecorder.reset();
 
 	for (auto const &p : samplers)
 		vkDestroySampler(device, p.second, nullptr);
@@ -3097,6 +3551,7 @@ void Graphics::cleanup()
 	framebuffers.clear();
 
 	vkDestroyCommandPool(device, commandPool, nullptr);
+	savePipelineCache();
 	vkDestroyPipelineCache(device, pipelineCache, nullptr);
 	vkDestroyDevice(device, nullptr);
 }
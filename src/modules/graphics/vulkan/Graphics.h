@@ -27,6 +27,7 @@
 #include "ShaderStage.h"
 #include "Shader.h"
 #include "Texture.h"
+#include "CommandRecorder.h"
 
 // libraries
 #include "VulkanWrapper.h"
@@ -168,6 +169,25 @@ struct OptionalDeviceExtensions
 
 	// VK_KHR_spirv_1_4
 	bool spirv14 = false;
+
+	// VK_EXT_pipeline_creation_feedback
+	bool pipelineCreationFeedback = false;
+};
+
+// Prepended to the serialized VkPipelineCache data in the save directory.
+struct PipelineCacheFileHeader
+{
+	static const uint32_t MAGIC = 0x4350564C; // "LVPC"
+	static const uint32_t VERSION = 1;
+
+	uint32_t magic;
+	uint32_t version;
+	uint32_t vendorID;
+	uint32_t deviceID;
+	uint32_t driverVersion;
+	uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+	uint32_t dataSize;
+	uint32_t dataHash;
 };
 
 struct QueueFamilyIndices
@@ -209,6 +229,37 @@ struct RenderpassState
 	OptionalInt mainWindowClearStencilValue;
 };
 
+// A render pass recorded into a secondary command buffer by CommandRecorder.
+// Its primary command buffer is recorded once the secondary one is done.
+struct RecordedRenderPass
+{
+	CommandRecorder::Pass pass;
+	VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+	VkRenderPassBeginInfo beginInfo{};
+	std::vector<VkClearValue> clearColors;
+	std::vector<std::tuple<VkImage, PixelFormat, VkImageLayout, VkImageLayout, int, int>> transitionImages;
+};
+
+/**
+ * Marks uploads made while it's alive as going into a newly created resource,
+ * and unmarks them again even if the upload throws.
+ **/
+struct InitialUploadScope
+{
+	InitialUploadScope(bool &initialUpload)
+		: initialUpload(initialUpload)
+	{
+		initialUpload = true;
+	}
+
+	~InitialUploadScope()
+	{
+		initialUpload = false;
+	}
+
+	bool &initialUpload;
+};
+
 enum SubmitMode
 {
 	SUBMIT_PRESENT,
@@ -262,6 +313,7 @@ class Graphics final : public love::graphics::Graphics
 	VkDevice getDevice() const;
 	VmaAllocator getVmaAllocator() const;
 	VkCommandBuffer getCommandBufferForDataTransfer();
+	VkCommandBuffer getCommandBufferForInitialDataTransfer();
 	void queueCleanUp(std::function<void()> cleanUp);
 	void addReadbackCallback(std::function<void()> callback);
 	void submitGpuCommands(SubmitMode, void *screenshotCallbackData = nullptr);
@@ -286,7 +338,9 @@ class Graphics final : public love::graphics::Graphics
 	bool dispatch(love::graphics::Shader *shader, int x, int y, int z) override;
 	bool dispatch(love::graphics::Shader *shader, love::graphics::Buffer *indirectargs, size_t argsoffset) override;
 	void initCapabilities() override;
-	void getAPIStats(int &shaderswitches) const override;
+	void getAPIStats(int &shaderswitches, int &pipelinecachehits, int &pipelinecachemisses, int &pipelinecacheunknown) const override;
+	int writeTimestampQuery() override;
+	void endTimestampQueries(uint64 frame) override;
 	void setRenderTargetsInternal(const RenderTargets &rts, int pixelw, int pixelh, bool hasSRGBtexture) override;
 
 private:
@@ -296,6 +350,7 @@ class Graphics final : public love::graphics::Graphics
 	QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device);
 	void createLogicalDevice();
 	void createPipelineCache();
+	void savePipelineCache();
 	void initVMA();
 	void createSurface();
 	bool checkDeviceExtensionSupport(VkPhysicalDevice device);
@@ -318,13 +373,17 @@ class Graphics final : public love::graphics::Graphics
 	void createCommandPool();
 	void createCommandBuffers();
 	void createSyncObjects();
+	void createTimestampQueryPools();
 	void cleanup();
 	void cleanupSwapChain();
 	void recreateSwapChain();
 	void initDynamicState();
+	void cmdSetStencilState();
+	void cmdSetDepthState();
 	void beginFrame();
 	void startRecordingGraphicsCommands();
 	void endRecordingGraphicsCommands();
+	void endRecordingInitialDataTransferCommands();
 	void createVulkanVertexFormat(
 		Shader *shader,
 		const VertexAttributes &attributes, 
@@ -338,6 +397,22 @@ class Graphics final : public love::graphics::Graphics
 	void setDefaultRenderPass();
 	void startRenderPass();
 	void endRenderPass();
+	void recordRenderPassCommandBuffer(RecordedRenderPass &renderPass);
+	VkCommandBuffer beginExtraCommandBuffer();
+	void bindDefaultVertexBuffer();
+
+	// Records into the active render pass's secondary command buffer when
+	// render passes are recorded on worker threads, or straight into the
+	// active command buffer otherwise. The command may run after the call
+	// returns, so it must capture everything it uses by value.
+	template <typename T>
+	void recordCommand(T &&command)
+	{
+		if (recordedRenderPass != nullptr)
+			recordedRenderPass->pass.commands.emplace_back(std::forward<T>(command));
+		else
+			command(activeCommandBuffer);
+	}
 	void applyScissor();
 	VkSampler createSampler(const SamplerState &sampler);
 	void cleanupUnusedObjects();
@@ -370,17 +445,38 @@ class Graphics final : public love::graphics::Graphics
 	VkImageView depthImageView = VK_NULL_HANDLE;
 	VmaAllocation depthImageAllocation = VK_NULL_HANDLE;
 	VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+	bool pipelineCacheModified = false;
 	std::unordered_map<RenderPassConfiguration, VkRenderPass, RenderPassConfigurationHasher> renderPasses;
 	std::unordered_map<FramebufferConfiguration, VkFramebuffer, FramebufferConfigurationHasher> framebuffers;
 	std::unordered_map<VkFramebuffer, bool> framebufferUsages;
 	std::unordered_map<uint64, VkSampler> samplers;
 	VkCommandPool commandPool = VK_NULL_HANDLE;
 	std::vector<VkCommandBuffer> commandBuffers;
+	// The primary command buffer currently being recorded into. This is
+	// commandBuffers[currentFrame] unless render passes are recorded on worker
+	// threads, in which case the frame is split into one command buffer per
+	// render pass and one for the commands between each of them.
+	VkCommandBuffer activeCommandBuffer = VK_NULL_HANDLE;
+	std::vector<std::vector<VkCommandBuffer>> extraCommandBuffers;
+	size_t usedExtraCommandBuffers = 0;
+	std::vector<VkCommandBuffer> frameCommandBuffers;
+	std::unique_ptr<CommandRecorder> commandRecorder;
+	std::vector<std::unique_ptr<RecordedRenderPass>> recordedRenderPasses;
+	RecordedRenderPass *recordedRenderPass = nullptr;
+	// Uploads into newly created resources, submitted ahead of commandBuffers
+	// so they don't have to interrupt the active render pass.
+	std::vector<VkCommandBuffer> initialDataTransferCommandBuffers;
+	bool initialDataTransferActive = false;
 	Shader *computeShader = nullptr;
 	std::vector<VkSemaphore> imageAvailableSemaphores;
 	std::vector<VkSemaphore> renderFinishedSemaphores;
 	std::vector<VkFence> inFlightFences;
 	std::vector<VkFence> imagesInFlight;
+	// One pool per frame in flight, reset at the start of that frame.
+	std::vector<VkQueryPool> timestampQueryPools;
+	uint32 timestampQueryCount = 0;
+	// Nanoseconds per timestamp tick, or 0 if timestamps aren't supported.
+	float timestampPeriod = 0.0f;
 	int vsync = 1;
 	VkDeviceSize minUniformBufferOffsetAlignment = 0;
 	bool imageRequested = false;
@@ -250,6 +250,16 @@ void Shader::newFrame()
 }
 
 void Shader::cmdPushDescriptorSets(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint)
+{
+	cmdBindDescriptorSets(commandBuffer, bindPoint, updateDescriptorSets());
+}
+
+void Shader::cmdBindDescriptorSets(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint, const DescriptorSetBinding &binding)
+{
+	vkCmdBindDescriptorSets(commandBuffer, bindPoint, binding.pipelineLayout, 0, 1, &binding.descriptorSet, binding.dynamicOffsetCount, &binding.dynamicOffset);
+}
+
+Shader::DescriptorSetBinding Shader::updateDescriptorSets()
 {
 	bool useLocalUniformOffset = false;
 	uint32 localUniformOffset = 0;
@@ -315,7 +325,12 @@ void Shader::cmdPushDescriptorSets(VkCommandBuffer commandBuffer, VkPipelineBind
 		resourceDescriptorsDirty = false;
 	}
 
-	vkCmdBindDescriptorSets(commandBuffer, bindPoint, pipelineLayout, 0, 1, &currentDescriptorSet, useLocalUniformOffset ? 1 : 0, &localUniformOffset);
+	DescriptorSetBinding binding{};
+	binding.pipelineLayout = pipelineLayout;
+	binding.descriptorSet = currentDescriptorSet;
+	binding.dynamicOffsetCount = useLocalUniformOffset ? 1 : 0;
+	binding.dynamicOffset = localUniformOffset;
+	return binding;
 }
 
 Shader::~Shader()
@@ -99,6 +99,16 @@ class Shader final
 		DataBaseType baseType;
 	};
 
+	// Everything vkCmdBindDescriptorSets needs, so the bind can be recorded
+	// after the shader's state has moved on.
+	struct DescriptorSetBinding
+	{
+		VkPipelineLayout pipelineLayout;
+		VkDescriptorSet descriptorSet;
+		uint32 dynamicOffsetCount;
+		uint32 dynamicOffset;
+	};
+
 	Shader(StrongRef<love::graphics::ShaderStage> stages[], const CompileOptions &options);
 	virtual ~Shader();
 
@@ -114,6 +124,8 @@ class Shader final
 	void newFrame();
 
 	void cmdPushDescriptorSets(VkCommandBuffer, VkPipelineBindPoint);
+	DescriptorSetBinding updateDescriptorSets();
+	static void cmdBindDescriptorSets(VkCommandBuffer, VkPipelineBindPoint, const DescriptorSetBinding &binding);
 
 	void attach() override;
 
@@ -149,7 +149,11 @@ bool Texture::loadVolatile()
 		if (vmaCreateImage(allocator, &imageInfo, &imageAllocationCreateInfo, &textureImage, &textureImageAllocation, nullptr) != VK_SUCCESS)
 			throw love::Exception("failed to create image");
 
-		auto commandBuffer = vgfx->getCommandBufferForDataTransfer();
+		// Nothing can reference the image before it's created, so its
+		// initial contents don't need to be ordered with the frame's draws.
+		InitialUploadScope initialUploadScope(initialUpload);
+
+		auto commandBuffer = getCommandBufferForUpload();
 
 		if (computeWrite)
 			imageLayout = VK_IMAGE_LAYOUT_GENERAL;
@@ -376,9 +380,17 @@ void Texture::createTextureImageView()
 		throw love::Exception("could not create texture image view");
 }
 
+VkCommandBuffer Texture::getCommandBufferForUpload()
+{
+	if (initialUpload)
+		return vgfx->getCommandBufferForInitialDataTransfer();
+	else
+		return vgfx->getCommandBufferForDataTransfer();
+}
+
 void Texture::clear()
 {
-	auto commandBuffer = vgfx->getCommandBufferForDataTransfer();
+	auto commandBuffer = getCommandBufferForUpload();
 
 	VkImageSubresourceRange range{};
 	range.aspectMask = imageAspect;
@@ -581,7 +593,7 @@ void Texture::uploadByteData(const void *data, size_t size, int level, int slice
 	if (getTextureType() == TEXTURE_VOLUME)
 		region.imageOffset.z = slice;
 
-	auto commandBuffer = vgfx->getCommandBufferForDataTransfer();
+	auto commandBuffer = getCommandBufferForUpload();
 
 	if (imageLayout != VK_IMAGE_LAYOUT_GENERAL)
 	{
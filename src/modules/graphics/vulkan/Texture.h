@@ -73,6 +73,7 @@ class Texture final
 private:
 	void createTextureImageView();
 	void clear();
+	VkCommandBuffer getCommandBufferForUpload();
 
 	Graphics *vgfx = nullptr;
 	VkDevice device = VK_NULL_HANDLE;
@@ -87,6 +88,7 @@ class Texture final
 	Slices slices;
 	int layerCount = 0;
 	VkSampleCountFlagBits msaaSamples = VK_SAMPLE_COUNT_1_BIT;
+	bool initialUpload = false;
 };
 
 } // vulkan
@@ -31,6 +31,9 @@ namespace vulkan
 {
 
 static uint32_t numShaderSwitches;
+static uint32_t numPipelineCacheHits;
+static uint32_t numPipelineCacheMisses;
+static uint32_t numPipelineCacheUnknown;
 
 void Vulkan::shaderSwitch()
 {
@@ -47,6 +50,43 @@ void Vulkan::resetShaderSwitches()
 	numShaderSwitches = 0;
 }
 
+void Vulkan::pipelineCacheHit()
+{
+	numPipelineCacheHits++;
+}
+
+void Vulkan::pipelineCacheMiss()
+{
+	numPipelineCacheMisses++;
+}
+
+void Vulkan::pipelineCacheUnknown()
+{
+	numPipelineCacheUnknown++;
+}
+
+uint32_t Vulkan::getNumPipelineCacheHits()
+{
+	return numPipelineCacheHits;
+}
+
+uint32_t Vulkan::getNumPipelineCacheMisses()
+{
+	return numPipelineCacheMisses;
+}
+
+uint32_t Vulkan::getNumPipelineCacheUnknown()
+{
+	return numPipelineCacheUnknown;
+}
+
+void Vulkan::resetPipelineCacheStats()
+{
+	numPipelineCacheHits = 0;
+	numPipelineCacheMisses = 0;
+	numPipelineCacheUnknown = 0;
+}
+
 VkFormat Vulkan::getVulkanVertexFormat(DataFormat format)
 {
 	switch (format)
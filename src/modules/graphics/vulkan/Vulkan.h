@@ -58,6 +58,14 @@ class Vulkan
 	static uint32_t getNumShaderSwitches();
 	static void resetShaderSwitches();
 
+	static void pipelineCacheHit();
+	static void pipelineCacheMiss();
+	static void pipelineCacheUnknown();
+	static uint32_t getNumPipelineCacheHits();
+	static uint32_t getNumPipelineCacheMisses();
+	static uint32_t getNumPipelineCacheUnknown();
+	static void resetPipelineCacheStats();
+
 	static VkFormat getVulkanVertexFormat(DataFormat format);
 	static TextureFormat getTextureFormat(PixelFormat format);
 	static std::string getVendorName(uint32_t vendorId);
@@ -432,6 +432,41 @@ int w_getCanvas(lua_State *L)
 	}
 }
 
+int w_setDrawList(lua_State *L)
+{
+	if (lua_isnoneornil(L, 1))
+		instance()->setDrawList();
+	else
+	{
+		DrawList *list = luax_checkdrawlist(L, 1);
+		instance()->setDrawList(list);
+	}
+
+	return 0;
+}
+
+int w_getDrawList(lua_State *L)
+{
+	DrawList *list = instance()->getDrawList();
+	if (list != nullptr)
+		luax_pushtype(L, list);
+	else
+		lua_pushnil(L);
+	return 1;
+}
+
+int w_setArrayTextureBatching(lua_State *L)
+{
+	instance()->setArrayTextureBatching(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isArrayTextureBatching(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isArrayTextureBatching());
+	return 1;
+}
+
 static void screenshotFunctionCallback(const Graphics::ScreenshotInfo *info, love::image::ImageData *i, void *gd)
 {
 	if (info == nullptr)
@@ -1452,6 +1487,18 @@ int w_newSpriteBatch(lua_State *L)
 	return 1;
 }
 
+int w_newDrawList(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	DrawList *t = nullptr;
+	luax_catchexcept(L, [&](){ t = instance()->newDrawList(); });
+
+	luax_pushtype(L, t);
+	t->release();
+	return 1;
+}
+
 int w_newParticleSystem(lua_State *L)
 {
 	luax_checkgraphicscreated(L);
@@ -1462,8 +1509,16 @@ int w_newParticleSystem(lua_State *L)
 	if (size < 1.0 || size > ParticleSystem::MAX_PARTICLES)
 		return luaL_error(L, "Invalid ParticleSystem size");
 
+	ParticleSystem::SimulationMode mode = ParticleSystem::SIMULATION_CPU;
+	if (!lua_isnoneornil(L, 3))
+	{
+		const char *str = luaL_checkstring(L, 3);
+		if (!ParticleSystem::getConstant(str, mode))
+			return luax_enumerror(L, "particle simulation mode", ParticleSystem::getConstants(mode), str);
+	}
+
 	luax_catchexcept(L,
-		[&](){ t = instance()->newParticleSystem(texture, int(size)); }
+		[&](){ t = instance()->newParticleSystem(texture, int(size), mode); }
 	);
 
 	luax_pushtype(L, t);
@@ -3100,6 +3155,72 @@ int w_getSystemLimits(lua_State *L)
 	return 1;
 }
 
+int w_pushProfileScope(lua_State *L)
+{
+	std::string name = luax_checkstring(L, 1);
+	luax_catchexcept(L, [&]() { instance()->pushProfileScope(name); });
+	return 0;
+}
+
+int w_popProfileScope(lua_State *L)
+{
+	luax_catchexcept(L, [&]() { instance()->popProfileScope(); });
+	return 0;
+}
+
+int w_getProfileScopes(lua_State *L)
+{
+	const Graphics::ProfileFrame *frame = instance()->getLatestProfileFrame();
+
+	if (frame == nullptr)
+	{
+		lua_newtable(L);
+		lua_pushnil(L);
+		return 2;
+	}
+
+	lua_createtable(L, (int) frame->scopes.size(), 0);
+
+	for (size_t i = 0; i < frame->scopes.size(); i++)
+	{
+		const Graphics::ProfileScope &scope = frame->scopes[i];
+
+		lua_createtable(L, 0, 4);
+
+		luax_pushstring(L, scope.name);
+		lua_setfield(L, -2, "name");
+
+		lua_pushinteger(L, scope.depth + 1);
+		lua_setfield(L, -2, "depth");
+
+		lua_pushnumber(L, scope.cpuEnd - scope.cpuStart);
+		lua_setfield(L, -2, "cputime");
+
+		if (scope.gpuStart >= 0.0 && scope.gpuEnd >= 0.0)
+		{
+			lua_pushnumber(L, scope.gpuEnd - scope.gpuStart);
+			lua_setfield(L, -2, "gputime");
+		}
+
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+
+	lua_pushnumber(L, (lua_Number) frame->index);
+	return 2;
+}
+
+int w_getProfileTrace(lua_State *L)
+{
+	bool clear = luax_optboolean(L, 1, false);
+
+	luax_pushstring(L, instance()->getProfileTrace());
+
+	if (clear)
+		instance()->clearProfileFrames();
+
+	return 1;
+}
+
 int w_getStats(lua_State *L)
 {
 	Graphics::Stats stats = instance()->getStats();
@@ -3107,7 +3228,7 @@ int w_getStats(lua_State *L)
 	if (lua_istable(L, 1))
 		lua_pushvalue(L, 1);
 	else
-		lua_createtable(L, 0, 7);
+		lua_createtable(L, 0, 13);
 
 	lua_pushinteger(L, stats.drawCalls);
 	lua_setfield(L, -2, "drawcalls");
@@ -3115,12 +3236,27 @@ int w_getStats(lua_State *L)
 	lua_pushinteger(L, stats.drawCallsBatched);
 	lua_setfield(L, -2, "drawcallsbatched");
 
+	lua_pushinteger(L, stats.batchedDrawsUint16Indices);
+	lua_setfield(L, -2, "batcheddrawsuint16indices");
+
+	lua_pushinteger(L, stats.batchedDrawsUint32Indices);
+	lua_setfield(L, -2, "batcheddrawsuint32indices");
+
 	lua_pushinteger(L, stats.renderTargetSwitches);
 	lua_setfield(L, -2, "canvasswitches");
 
 	lua_pushinteger(L, stats.shaderSwitches);
 	lua_setfield(L, -2, "shaderswitches");
 
+	lua_pushinteger(L, stats.pipelineCacheHits);
+	lua_setfield(L, -2, "pipelinecachehits");
+
+	lua_pushinteger(L, stats.pipelineCacheMisses);
+	lua_setfield(L, -2, "pipelinecachemisses");
+
+	lua_pushinteger(L, stats.pipelineCacheUnknown);
+	lua_setfield(L, -2, "pipelinecacheunknown");
+
 	lua_pushinteger(L, stats.textures);
 	lua_setfield(L, -2, "textures");
 
@@ -3959,6 +4095,7 @@ static const luaL_Reg functions[] =
 	{ "newImageFont", w_newImageFont },
 	{ "newSpriteBatch", w_newSpriteBatch },
 	{ "newParticleSystem", w_newParticleSystem },
+	{ "newDrawList", w_newDrawList },
 	{ "newShader", w_newShader },
 	{ "newComputeShader", w_newComputeShader },
 	{ "newBuffer", w_newBuffer },
@@ -3975,6 +4112,10 @@ static const luaL_Reg functions[] =
 
 	{ "setCanvas", w_setCanvas },
 	{ "getCanvas", w_getCanvas },
+	{ "setDrawList", w_setDrawList },
+	{ "getDrawList", w_getDrawList },
+	{ "setArrayTextureBatching", w_setArrayTextureBatching },
+	{ "isArrayTextureBatching", w_isArrayTextureBatching },
 
 	{ "setColor", w_setColor },
 	{ "getColor", w_getColor },
@@ -4021,6 +4162,10 @@ static const luaL_Reg functions[] =
 	{ "getSystemLimits", w_getSystemLimits },
 	{ "getTextureTypes", w_getTextureTypes },
 	{ "getStats", w_getStats },
+	{ "pushProfileScope", w_pushProfileScope },
+	{ "popProfileScope", w_popProfileScope },
+	{ "getProfileScopes", w_getProfileScopes },
+	{ "getProfileTrace", w_getProfileTrace },
 
 	{ "captureScreenshot", w_captureScreenshot },
 
@@ -4115,6 +4260,7 @@ static const lua_CFunction types[] =
 	luaopen_graphicsbuffer,
 	luaopen_graphicsreadback,
 	luaopen_spritebatch,
+	luaopen_drawlist,
 	luaopen_particlesystem,
 	luaopen_shader,
 	luaopen_mesh,
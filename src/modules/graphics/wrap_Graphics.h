@@ -26,6 +26,7 @@
 #include "wrap_Texture.h"
 #include "wrap_Quad.h"
 #include "wrap_SpriteBatch.h"
+#include "wrap_DrawList.h"
 #include "wrap_ParticleSystem.h"
 #include "wrap_Shader.h"
 #include "wrap_Mesh.h"
@@ -106,6 +106,16 @@ int w_ParticleSystem_getInsertMode(lua_State *L)
 	return 1;
 }
 
+int w_ParticleSystem_getSimulationMode(lua_State *L)
+{
+	ParticleSystem *t = luax_checkparticlesystem(L, 1);
+	const char *str;
+	if (!ParticleSystem::getConstant(t->getSimulationMode(), str))
+		return luaL_error(L, "Unknown simulation mode");
+	lua_pushstring(L, str);
+	return 1;
+}
+
 int w_ParticleSystem_setEmissionRate(lua_State *L)
 {
 	ParticleSystem *t = luax_checkparticlesystem(L, 1);
@@ -712,6 +722,7 @@ static const luaL_Reg w_ParticleSystem_functions[] =
 	{ "getBufferSize", w_ParticleSystem_getBufferSize },
 	{ "setInsertMode", w_ParticleSystem_setInsertMode },
 	{ "getInsertMode", w_ParticleSystem_getInsertMode },
+	{ "getSimulationMode", w_ParticleSystem_getSimulationMode },
 	{ "setEmissionRate", w_ParticleSystem_setEmissionRate },
 	{ "getEmissionRate", w_ParticleSystem_getEmissionRate },
 	{ "setEmitterLifetime", w_ParticleSystem_setEmitterLifetime },
@@ -58,7 +58,11 @@ ImageData::ImageData(int width, int height, PixelFormat format, void *data, bool
 		throw love::Exception("ImageData does not support the %s pixel format.", getPixelFormatName(format));
 
 	if (own)
+	{
 		this->data = (unsigned char *) data;
+		pixelSetFunction = getPixelSetFunction(format);
+		pixelGetFunction = getPixelGetFunction(format);
+	}
 	else
 		create(width, height, format, data);
 }
@@ -82,6 +86,28 @@ love::image::ImageData *ImageData::clone() const
 	return new ImageData(*this);
 }
 
+ImageData *ImageData::transfer()
+{
+	Lock lock(getMutex());
+
+	if (transferred)
+		throw love::Exception("ImageData has already been transferred.");
+
+	ImageData *d = new ImageData(width, height, format, data, true);
+
+	// The new ImageData has to free the pixels the same way this one would.
+	d->decodeHandler = decodeHandler;
+	d->setLinear(isLinear());
+
+	data = nullptr;
+	decodeHandler = nullptr;
+	width = 0;
+	height = 0;
+	transferred = true;
+
+	return d;
+}
+
 void ImageData::create(int width, int height, PixelFormat format, void *data)
 {
 	size_t datasize = getPixelFormatSliceSize(format, width, height);
@@ -114,6 +114,7 @@ class ImageData : public ImageDataBase
 	ImageData *clone() const override;
 	void *getData() const override;
 	size_t getSize() const override;
+	ImageData *transfer() override;
 
 	size_t getPixelSize() const;
 
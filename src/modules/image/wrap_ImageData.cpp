@@ -53,6 +53,15 @@ int w_ImageData_clone(lua_State *L)
 	return 1;
 }
 
+int w_ImageData_transfer(lua_State *L)
+{
+	ImageData *t = luax_checkimagedata(L, 1), *d = nullptr;
+	luax_catchexcept(L, [&](){ d = t->transfer(); });
+	luax_pushtype(L, d);
+	d->release();
+	return 1;
+}
+
 int w_ImageData_getFormat(lua_State *L)
 {
 	ImageData *t = luax_checkimagedata(L, 1);
@@ -287,6 +296,7 @@ static FFI_ImageData ffifuncs =
 static const luaL_Reg w_ImageData_functions[] =
 {
 	{ "clone", w_ImageData_clone },
+	{ "transfer", w_ImageData_transfer },
 	{ "getFormat", w_ImageData_getFormat },
 	{ "setLinear", w_ImageData_setLinear },
 	{ "isLinear", w_ImageData_isLinear },
@@ -327,6 +327,7 @@ local _getHeight = ImageData.getHeight
 local _getDimensions = ImageData.getDimensions
 local _getFormat = ImageData.getFormat
 local _release = ImageData.release
+local _transfer = ImageData.transfer
 
 -- Table which holds ImageData objects as keys, and information about the objects
 -- as values. Uses weak keys so the ImageData objects can still be GC'd properly.
@@ -455,5 +456,11 @@ function ImageData:release()
 	return _release(self)
 end
 
+function ImageData:transfer()
+	-- The cached pointer belongs to the new ImageData after this.
+	objectcache[self] = nil
+	return _transfer(self)
+end
+
 -- DO NOT REMOVE THE NEXT LINE. It is used to load this file as a C++ string.
 --)luastring"--"
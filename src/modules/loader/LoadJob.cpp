@@ -0,0 +1,213 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "LoadJob.h"
+#include "common/Module.h"
+#include "common/Exception.h"
+#include "data/DataStream.h"
+#include "filesystem/Filesystem.h"
+#include "font/Font.h"
+#include "image/Image.h"
+#include "sound/Sound.h"
+
+namespace love
+{
+namespace loader
+{
+
+love::Type LoadJob::type("LoadJob", &Object::type);
+
+LoadJob::LoadJob(Kind kind, const std::string &filename, int priority)
+	: kind(kind)
+	, filename(filename)
+	, fontSize(12)
+	, priority(priority)
+	, sequence(0)
+	, status(STATUS_QUEUED)
+	, resultType(nullptr)
+	, callback(nullptr)
+	, settings(nullptr)
+{
+}
+
+LoadJob::LoadJob(Kind kind, love::Data *data, int priority)
+	: kind(kind)
+	, data(data)
+	, fontSize(12)
+	, priority(priority)
+	, sequence(0)
+	, status(STATUS_QUEUED)
+	, resultType(nullptr)
+	, callback(nullptr)
+	, settings(nullptr)
+{
+}
+
+LoadJob::~LoadJob()
+{
+	delete callback;
+	delete settings;
+}
+
+template <typename T>
+static T *getModule(Module::ModuleType type, const char *name)
+{
+	T *module = Module::getInstance<T>(type);
+	if (module == nullptr)
+		throw love::Exception("love.%s must be loaded to load this asset.", name);
+	return module;
+}
+
+void LoadJob::load()
+{
+	Status expected = STATUS_QUEUED;
+	if (!status.compare_exchange_strong(expected, STATUS_LOADING))
+		return;
+
+	bool failed = false;
+
+	try
+	{
+		if (data.get() == nullptr)
+		{
+			auto fs = getModule<filesystem::Filesystem>(Module::M_FILESYSTEM, "filesystem");
+			data.set(fs->read(filename.c_str()), Acquire::NORETAIN);
+		}
+
+		switch (kind)
+		{
+		case KIND_IMAGEDATA:
+		case KIND_COMPRESSEDIMAGEDATA:
+		case KIND_IMAGE:
+		{
+			auto module = getModule<image::Image>(Module::M_IMAGE, "image");
+			bool compressed = kind == KIND_COMPRESSEDIMAGEDATA || (kind == KIND_IMAGE && module->isCompressed(data));
+
+			if (compressed)
+			{
+				result.set(module->newCompressedData(data), Acquire::NORETAIN);
+				resultType = &image::CompressedImageData::type;
+			}
+			else
+			{
+				result.set(module->newImageData(data), Acquire::NORETAIN);
+				resultType = &image::ImageData::type;
+			}
+			break;
+		}
+		case KIND_SOUNDDATA:
+		{
+			auto module = getModule<sound::Sound>(Module::M_SOUND, "sound");
+			StrongRef<Stream> stream(new data::DataStream(data), Acquire::NORETAIN);
+			StrongRef<sound::Decoder> decoder(module->newDecoder(stream, sound::Decoder::DEFAULT_BUFFER_SIZE), Acquire::NORETAIN);
+			result.set(module->newSoundData(decoder), Acquire::NORETAIN);
+			resultType = &sound::SoundData::type;
+			break;
+		}
+		case KIND_RASTERIZER:
+		case KIND_FONT:
+		{
+			auto module = getModule<font::Font>(Module::M_FONT, "font");
+			font::TrueTypeRasterizer::Settings rsettings;
+			result.set(module->newTrueTypeRasterizer(data, fontSize, rsettings), Acquire::NORETAIN);
+			resultType = &font::Rasterizer::type;
+			break;
+		}
+		default:
+			throw love::Exception("Unknown asset type.");
+		}
+	}
+	catch (love::Exception &e)
+	{
+		error = e.what();
+		failed = true;
+	}
+
+	// The encoded file isn't needed anymore.
+	data.set(nullptr);
+
+	// Don't overwrite a cancellation which happened while we were decoding.
+	expected = STATUS_LOADING;
+	status.compare_exchange_strong(expected, failed ? STATUS_FAILED : STATUS_READY);
+}
+
+bool LoadJob::cancel()
+{
+	Status s = status;
+	while (s == STATUS_QUEUED || s == STATUS_LOADING || s == STATUS_READY)
+	{
+		if (status.compare_exchange_weak(s, STATUS_CANCELLED))
+			return true;
+	}
+	return false;
+}
+
+void LoadJob::setResult(love::Object *object, love::Type *type)
+{
+	result.set(object);
+	resultType = type;
+	status = STATUS_DONE;
+}
+
+void LoadJob::setFailed(const std::string &err)
+{
+	result.set(nullptr);
+	resultType = nullptr;
+	error = err;
+	status = STATUS_FAILED;
+}
+
+void LoadJob::setCallback(Reference *ref)
+{
+	delete callback;
+	callback = ref;
+}
+
+void LoadJob::setSettings(Reference *ref)
+{
+	delete settings;
+	settings = ref;
+}
+
+STRINGMAP_CLASS_BEGIN(LoadJob, LoadJob::Kind, LoadJob::KIND_MAX_ENUM, kind)
+{
+	{ "imagedata",           LoadJob::KIND_IMAGEDATA           },
+	{ "compressedimagedata", LoadJob::KIND_COMPRESSEDIMAGEDATA },
+	{ "sounddata",           LoadJob::KIND_SOUNDDATA           },
+	{ "rasterizer",          LoadJob::KIND_RASTERIZER          },
+	{ "image",               LoadJob::KIND_IMAGE               },
+	{ "font",                LoadJob::KIND_FONT                },
+}
+STRINGMAP_CLASS_END(LoadJob, LoadJob::Kind, LoadJob::KIND_MAX_ENUM, kind)
+
+STRINGMAP_CLASS_BEGIN(LoadJob, LoadJob::Status, LoadJob::STATUS_MAX_ENUM, status)
+{
+	{ "queued",    LoadJob::STATUS_QUEUED    },
+	{ "loading",   LoadJob::STATUS_LOADING   },
+	{ "ready",     LoadJob::STATUS_READY     },
+	{ "done",      LoadJob::STATUS_DONE      },
+	{ "failed",    LoadJob::STATUS_FAILED    },
+	{ "cancelled", LoadJob::STATUS_CANCELLED },
+}
+STRINGMAP_CLASS_END(LoadJob, LoadJob::Status, LoadJob::STATUS_MAX_ENUM, status)
+
+} // loader
+} // love
@@ -0,0 +1,154 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_LOADER_LOADJOB_H
+#define LOVE_LOADER_LOADJOB_H
+
+// LOVE
+#include "common/Object.h"
+#include "common/Data.h"
+#include "common/Reference.h"
+#include "common/StringMap.h"
+#include "common/int.h"
+
+// STL
+#include <atomic>
+#include <string>
+
+namespace love
+{
+namespace loader
+{
+
+/**
+ * A single asset to be loaded by the Loader. The decoding step runs on a
+ * worker thread, anything which needs the graphics context is finished on the
+ * main thread by Loader::update.
+ **/
+class LoadJob : public love::Object
+{
+public:
+
+	static love::Type type;
+
+	enum Kind
+	{
+		KIND_IMAGEDATA,
+		KIND_COMPRESSEDIMAGEDATA,
+		KIND_SOUNDDATA,
+		KIND_RASTERIZER,
+		KIND_IMAGE,
+		KIND_FONT,
+		KIND_MAX_ENUM
+	};
+
+	enum Status
+	{
+		STATUS_QUEUED,
+		STATUS_LOADING,
+		STATUS_READY,
+		STATUS_DONE,
+		STATUS_FAILED,
+		STATUS_CANCELLED,
+		STATUS_MAX_ENUM
+	};
+
+	/**
+	 * Creates a job which reads the file with the given name from
+	 * love.filesystem when it runs.
+	 **/
+	LoadJob(Kind kind, const std::string &filename, int priority);
+
+	/**
+	 * Creates a job which decodes already loaded data.
+	 **/
+	LoadJob(Kind kind, love::Data *data, int priority);
+
+	virtual ~LoadJob();
+
+	Kind getKind() const { return kind; }
+	Status getStatus() const { return status; }
+	int getPriority() const { return priority; }
+	const std::string &getError() const { return error; }
+
+	/**
+	 * Whether the main thread still has work to do once the job is decoded.
+	 **/
+	bool needsFinish() const { return kind == KIND_IMAGE || kind == KIND_FONT; }
+
+	/**
+	 * The font size used by rasterizer and font jobs.
+	 **/
+	void setFontSize(int size) { fontSize = size; }
+
+	/**
+	 * Runs the decoding step. Called from a worker thread.
+	 **/
+	void load();
+
+	/**
+	 * Marks the job as cancelled. Returns false if it has already finished.
+	 **/
+	bool cancel();
+
+	// The following may only be used from the main thread.
+
+	love::Object *getResult() const { return result.get(); }
+	love::Type *getResultType() const { return resultType; }
+	void setResult(love::Object *object, love::Type *type);
+	void setFailed(const std::string &err);
+
+	void setCallback(Reference *ref);
+	Reference *getCallback() const { return callback; }
+
+	void setSettings(Reference *ref);
+	Reference *getSettings() const { return settings; }
+
+	STRINGMAP_CLASS_DECLARE(Kind);
+	STRINGMAP_CLASS_DECLARE(Status);
+
+private:
+
+	friend class Loader;
+
+	Kind kind;
+	std::string filename;
+	StrongRef<love::Data> data;
+	int fontSize;
+
+	// Guarded by the Loader's mutex while the job is queued.
+	int priority;
+	uint64 sequence;
+
+	std::atomic<Status> status;
+
+	StrongRef<love::Object> result;
+	love::Type *resultType;
+	std::string error;
+
+	Reference *callback;
+	Reference *settings;
+
+}; // LoadJob
+
+} // loader
+} // love
+
+#endif // LOVE_LOADER_LOADJOB_H
@@ -0,0 +1,222 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "Loader.h"
+
+// STL
+#include <algorithm>
+
+namespace love
+{
+namespace loader
+{
+
+Loader::Worker::Worker(Loader *loader)
+	: loader(loader)
+{
+	threadName = "AssetLoader";
+}
+
+void Loader::Worker::threadFunction()
+{
+	while (LoadJob *job = loader->waitForJob())
+	{
+		job->load();
+		loader->finishJob(job);
+	}
+}
+
+bool Loader::JobCompare::operator () (const LoadJob *a, const LoadJob *b) const
+{
+	// std::push_heap puts the largest element first, so the "largest" job is
+	// the one with the highest priority which was queued first.
+	if (a->priority != b->priority)
+		return a->priority < b->priority;
+	return a->sequence > b->sequence;
+}
+
+Loader::Loader()
+	: love::Module(M_LOADER, "love.loader")
+	, nextSequence(0)
+	, finish(false)
+	, frameBudget(0.004)
+{
+	int count = love::thread::getWorkerThreadCount(MAX_WORKERS);
+
+	for (int i = 0; i < count; i++)
+	{
+		Worker *worker = new Worker(this);
+		worker->start();
+		workers.push_back(worker);
+	}
+}
+
+Loader::~Loader()
+{
+	{
+		thread::Lock lock(mutex);
+		finish = true;
+		cond->broadcast();
+	}
+
+	for (Worker *worker : workers)
+	{
+		worker->wait();
+		delete worker;
+	}
+
+	for (LoadJob *job : queue)
+		job->release();
+
+	for (LoadJob *job : ready)
+		job->release();
+}
+
+void Loader::submit(LoadJob *job)
+{
+	thread::Lock lock(mutex);
+
+	job->retain();
+	job->sequence = nextSequence++;
+
+	queue.push_back(job);
+	std::push_heap(queue.begin(), queue.end(), JobCompare());
+
+	cond->signal();
+}
+
+void Loader::cancel(LoadJob *job)
+{
+	if (!job->cancel())
+		return;
+
+	thread::Lock lock(mutex);
+
+	auto it = std::find(queue.begin(), queue.end(), job);
+	if (it != queue.end())
+	{
+		queue.erase(it);
+		std::make_heap(queue.begin(), queue.end(), JobCompare());
+		job->release();
+	}
+}
+
+void Loader::cancelAll()
+{
+	std::vector<LoadJob *> jobs;
+
+	{
+		thread::Lock lock(mutex);
+		jobs.swap(queue);
+	}
+
+	for (LoadJob *job : jobs)
+	{
+		job->cancel();
+		job->release();
+	}
+
+	// Jobs which are decoding or decoded are dropped by popReady.
+	thread::Lock lock(mutex);
+
+	for (LoadJob *job : running)
+		job->cancel();
+
+	for (LoadJob *job : ready)
+		job->cancel();
+}
+
+void Loader::setPriority(LoadJob *job, int priority)
+{
+	thread::Lock lock(mutex);
+
+	job->priority = priority;
+
+	if (std::find(queue.begin(), queue.end(), job) != queue.end())
+		std::make_heap(queue.begin(), queue.end(), JobCompare());
+}
+
+LoadJob *Loader::popReady()
+{
+	while (true)
+	{
+		LoadJob *job = nullptr;
+
+		{
+			thread::Lock lock(mutex);
+			if (ready.empty())
+				return nullptr;
+
+			job = ready.front();
+			ready.pop_front();
+		}
+
+		if (job->getStatus() != LoadJob::STATUS_CANCELLED)
+			return job;
+
+		job->release();
+	}
+}
+
+int Loader::getPendingCount()
+{
+	thread::Lock lock(mutex);
+	return (int) (queue.size() + running.size() + ready.size());
+}
+
+void Loader::setFrameBudget(double seconds)
+{
+	frameBudget = std::max(seconds, 0.0);
+}
+
+double Loader::getFrameBudget() const
+{
+	return frameBudget;
+}
+
+LoadJob *Loader::waitForJob()
+{
+	thread::Lock lock(mutex);
+
+	while (!finish && queue.empty())
+		cond->wait(mutex);
+
+	if (finish)
+		return nullptr;
+
+	std::pop_heap(queue.begin(), queue.end(), JobCompare());
+	LoadJob *job = queue.back();
+	queue.pop_back();
+
+	running.push_back(job);
+	return job;
+}
+
+void Loader::finishJob(LoadJob *job)
+{
+	// The main thread releases the job, since it can hold Lua references.
+	thread::Lock lock(mutex);
+	running.erase(std::find(running.begin(), running.end(), job));
+	ready.push_back(job);
+}
+
+} // loader
+} // love
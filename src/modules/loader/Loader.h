@@ -0,0 +1,122 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_LOADER_LOADER_H
+#define LOVE_LOADER_LOADER_H
+
+// LOVE
+#include "common/Module.h"
+#include "thread/threads.h"
+#include "LoadJob.h"
+
+// STL
+#include <deque>
+#include <vector>
+
+namespace love
+{
+namespace loader
+{
+
+/**
+ * Decodes assets on a pool of worker threads. Queued jobs run in priority
+ * order, and jobs with the same priority run in the order they were queued.
+ * Decoded jobs wait in a list until the main thread finishes them with
+ * popReady.
+ **/
+class Loader : public love::Module
+{
+public:
+
+	static const int MAX_WORKERS = 4;
+
+	Loader();
+	virtual ~Loader();
+
+	/**
+	 * Queues a job. The Loader holds a reference to it until it's returned
+	 * from popReady or cancelled.
+	 **/
+	void submit(LoadJob *job);
+
+	/**
+	 * Cancels a job, and drops it from the queue if it hasn't started yet.
+	 **/
+	void cancel(LoadJob *job);
+	void cancelAll();
+
+	/**
+	 * Changes the priority of a job. Has no effect once it has started.
+	 **/
+	void setPriority(LoadJob *job, int priority);
+
+	/**
+	 * Returns the oldest job which finished decoding, or null. The caller
+	 * takes over the Loader's reference.
+	 **/
+	LoadJob *popReady();
+
+	/**
+	 * The number of jobs which haven't been returned by popReady yet.
+	 **/
+	int getPendingCount();
+
+	void setFrameBudget(double seconds);
+	double getFrameBudget() const;
+
+private:
+
+	class Worker : public love::thread::Threadable
+	{
+	public:
+		Worker(Loader *loader);
+		void threadFunction() override;
+	private:
+		Loader *loader;
+	};
+
+	struct JobCompare
+	{
+		bool operator () (const LoadJob *a, const LoadJob *b) const;
+	};
+
+	LoadJob *waitForJob();
+	void finishJob(LoadJob *job);
+
+	std::vector<Worker *> workers;
+
+	thread::MutexRef mutex;
+	thread::ConditionalRef cond;
+
+	// Heap ordered by JobCompare.
+	std::vector<LoadJob *> queue;
+	std::vector<LoadJob *> running;
+	std::deque<LoadJob *> ready;
+	uint64 nextSequence;
+	bool finish;
+
+	double frameBudget;
+
+}; // Loader
+
+} // loader
+} // love
+
+#endif // LOVE_LOADER_LOADER_H
@@ -0,0 +1,146 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_LoadJob.h"
+#include "Loader.h"
+
+namespace love
+{
+namespace loader
+{
+
+#define instance() (Module::getInstance<Loader>(Module::M_LOADER))
+
+LoadJob *luax_checkloadjob(lua_State *L, int idx)
+{
+	return luax_checktype<LoadJob>(L, idx);
+}
+
+int w_LoadJob_getKind(lua_State *L)
+{
+	LoadJob *job = luax_checkloadjob(L, 1);
+	const char *str = nullptr;
+	if (!LoadJob::getConstant(job->getKind(), str))
+		return luaL_error(L, "Unknown asset type.");
+	lua_pushstring(L, str);
+	return 1;
+}
+
+int w_LoadJob_getStatus(lua_State *L)
+{
+	LoadJob *job = luax_checkloadjob(L, 1);
+	const char *str = nullptr;
+	if (!LoadJob::getConstant(job->getStatus(), str))
+		return luaL_error(L, "Unknown load status.");
+	lua_pushstring(L, str);
+	return 1;
+}
+
+int w_LoadJob_isFinished(lua_State *L)
+{
+	LoadJob::Status status = luax_checkloadjob(L, 1)->getStatus();
+	luax_pushboolean(L, status == LoadJob::STATUS_DONE || status == LoadJob::STATUS_FAILED || status == LoadJob::STATUS_CANCELLED);
+	return 1;
+}
+
+int w_LoadJob_getResult(lua_State *L)
+{
+	LoadJob *job = luax_checkloadjob(L, 1);
+	if (job->getStatus() == LoadJob::STATUS_DONE && job->getResult() != nullptr)
+		luax_pushtype(L, *job->getResultType(), job->getResult());
+	else
+		lua_pushnil(L);
+	return 1;
+}
+
+int w_LoadJob_getError(lua_State *L)
+{
+	LoadJob *job = luax_checkloadjob(L, 1);
+	if (job->getStatus() == LoadJob::STATUS_FAILED)
+		luax_pushstring(L, job->getError());
+	else
+		lua_pushnil(L);
+	return 1;
+}
+
+int w_LoadJob_cancel(lua_State *L)
+{
+	LoadJob *job = luax_checkloadjob(L, 1);
+	instance()->cancel(job);
+	return 0;
+}
+
+int w_LoadJob_setPriority(lua_State *L)
+{
+	LoadJob *job = luax_checkloadjob(L, 1);
+	int priority = (int) luaL_checkinteger(L, 2);
+	instance()->setPriority(job, priority);
+	return 0;
+}
+
+int w_LoadJob_getPriority(lua_State *L)
+{
+	LoadJob *job = luax_checkloadjob(L, 1);
+	lua_pushinteger(L, job->getPriority());
+	return 1;
+}
+
+int w_LoadJob_setCallback(lua_State *L)
+{
+	LoadJob *job = luax_checkloadjob(L, 1);
+	if (!lua_isnoneornil(L, 2))
+		luaL_checktype(L, 2, LUA_TFUNCTION);
+	lua_settop(L, 2);
+	job->setCallback(luax_refif(L, LUA_TFUNCTION));
+	return 0;
+}
+
+int w_LoadJob_getCallback(lua_State *L)
+{
+	LoadJob *job = luax_checkloadjob(L, 1);
+	if (job->getCallback() != nullptr)
+		job->getCallback()->push(L);
+	else
+		lua_pushnil(L);
+	return 1;
+}
+
+static const luaL_Reg w_LoadJob_functions[] =
+{
+	{ "getKind", w_LoadJob_getKind },
+	{ "getStatus", w_LoadJob_getStatus },
+	{ "isFinished", w_LoadJob_isFinished },
+	{ "getResult", w_LoadJob_getResult },
+	{ "getError", w_LoadJob_getError },
+	{ "cancel", w_LoadJob_cancel },
+	{ "setPriority", w_LoadJob_setPriority },
+	{ "getPriority", w_LoadJob_getPriority },
+	{ "setCallback", w_LoadJob_setCallback },
+	{ "getCallback", w_LoadJob_getCallback },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_loadjob(lua_State *L)
+{
+	return luax_register_type(L, &LoadJob::type, w_LoadJob_functions, nullptr);
+}
+
+} // loader
+} // love
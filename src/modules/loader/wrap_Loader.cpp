@@ -0,0 +1,241 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "wrap_Loader.h"
+#include "wrap_LoadJob.h"
+#include "Loader.h"
+#include "filesystem/File.h"
+#include "timer/Timer.h"
+
+namespace love
+{
+namespace loader
+{
+
+#define instance() (Module::getInstance<Loader>(Module::M_LOADER))
+
+static LoadJob *newLoadJob(lua_State *L, LoadJob::Kind kind, int priorityidx)
+{
+	int priority = (int) luaL_optinteger(L, priorityidx, 0);
+	LoadJob *job = nullptr;
+
+	// Files are read on the worker thread, so only their name is needed here.
+	if (lua_type(L, 1) == LUA_TSTRING)
+		job = new LoadJob(kind, luax_checkstring(L, 1), priority);
+	else if (luax_istype(L, 1, love::filesystem::File::type))
+		job = new LoadJob(kind, luax_checktype<love::filesystem::File>(L, 1)->getFilename(), priority);
+	else
+		job = new LoadJob(kind, luax_checktype<love::Data>(L, 1), priority);
+
+	return job;
+}
+
+static int submitLoadJob(lua_State *L, LoadJob *job)
+{
+	instance()->submit(job);
+	luax_pushtype(L, job);
+	job->release();
+	return 1;
+}
+
+int w_newImageData(lua_State *L)
+{
+	return submitLoadJob(L, newLoadJob(L, LoadJob::KIND_IMAGEDATA, 2));
+}
+
+int w_newCompressedImageData(lua_State *L)
+{
+	return submitLoadJob(L, newLoadJob(L, LoadJob::KIND_COMPRESSEDIMAGEDATA, 2));
+}
+
+int w_newSoundData(lua_State *L)
+{
+	return submitLoadJob(L, newLoadJob(L, LoadJob::KIND_SOUNDDATA, 2));
+}
+
+int w_newRasterizer(lua_State *L)
+{
+	int size = (int) luaL_optinteger(L, 2, 12);
+	LoadJob *job = newLoadJob(L, LoadJob::KIND_RASTERIZER, 3);
+	job->setFontSize(size);
+	return submitLoadJob(L, job);
+}
+
+int w_newImage(lua_State *L)
+{
+	Reference *settings = nullptr;
+	if (!lua_isnoneornil(L, 2))
+	{
+		luaL_checktype(L, 2, LUA_TTABLE);
+		lua_pushvalue(L, 2);
+		settings = luax_refif(L, LUA_TTABLE);
+	}
+
+	LoadJob *job = newLoadJob(L, LoadJob::KIND_IMAGE, 3);
+	job->setSettings(settings);
+	return submitLoadJob(L, job);
+}
+
+int w_newFont(lua_State *L)
+{
+	int size = (int) luaL_optinteger(L, 2, 12);
+	LoadJob *job = newLoadJob(L, LoadJob::KIND_FONT, 3);
+	job->setFontSize(size);
+	return submitLoadJob(L, job);
+}
+
+/**
+ * Creates the love.graphics object for a decoded image or font job.
+ **/
+static void finishGraphicsJob(lua_State *L, LoadJob *job)
+{
+	int top = lua_gettop(L);
+
+	luax_pushtype(L, *job->getResultType(), job->getResult());
+	int idxs[] = {lua_gettop(L), 0};
+	int n = 1;
+
+	if (job->getSettings() != nullptr)
+	{
+		job->getSettings()->push(L);
+		idxs[n++] = lua_gettop(L);
+	}
+
+	const char *function = job->getKind() == LoadJob::KIND_FONT ? "newFont" : "newImage";
+
+	if (luax_pconvobj(L, idxs, n, "graphics", function) == 0)
+		job->setResult(luax_checktype<love::Object>(L, idxs[0]), luax_type(L, idxs[0]));
+	else
+		job->setFailed(luax_tostring(L, -1));
+
+	lua_settop(L, top);
+}
+
+int w_update(lua_State *L)
+{
+	Loader *loader = instance();
+	double budget = luaL_optnumber(L, 1, loader->getFrameBudget());
+	double start = love::timer::Timer::getTime();
+	int count = 0;
+
+	while (LoadJob *job = loader->popReady())
+	{
+		// The stack keeps the job alive if a callback errors.
+		luax_pushtype(L, job);
+		job->release();
+		int jobidx = lua_gettop(L);
+
+		if (job->getStatus() == LoadJob::STATUS_READY)
+		{
+			if (job->needsFinish())
+				finishGraphicsJob(L, job);
+			else
+				job->setResult(job->getResult(), job->getResultType());
+		}
+
+		if (job->getCallback() != nullptr)
+		{
+			job->getCallback()->push(L);
+			lua_pushvalue(L, jobidx);
+			lua_call(L, 1, 0);
+		}
+
+		lua_settop(L, jobidx - 1);
+		count++;
+
+		// GPU uploads can take a while, spread them out over several frames.
+		if (love::timer::Timer::getTime() - start >= budget)
+			break;
+	}
+
+	lua_pushinteger(L, count);
+	return 1;
+}
+
+int w_cancelAll(lua_State *)
+{
+	instance()->cancelAll();
+	return 0;
+}
+
+int w_getPendingCount(lua_State *L)
+{
+	lua_pushinteger(L, instance()->getPendingCount());
+	return 1;
+}
+
+int w_setFrameBudget(lua_State *L)
+{
+	instance()->setFrameBudget(luaL_checknumber(L, 1));
+	return 0;
+}
+
+int w_getFrameBudget(lua_State *L)
+{
+	lua_pushnumber(L, instance()->getFrameBudget());
+	return 1;
+}
+
+// List of functions to wrap.
+static const luaL_Reg functions[] =
+{
+	{ "newImageData", w_newImageData },
+	{ "newCompressedImageData", w_newCompressedImageData },
+	{ "newSoundData", w_newSoundData },
+	{ "newRasterizer", w_newRasterizer },
+	{ "newImage", w_newImage },
+	{ "newFont", w_newFont },
+	{ "update", w_update },
+	{ "cancelAll", w_cancelAll },
+	{ "getPendingCount", w_getPendingCount },
+	{ "setFrameBudget", w_setFrameBudget },
+	{ "getFrameBudget", w_getFrameBudget },
+	{ 0, 0 }
+};
+
+static const lua_CFunction types[] =
+{
+	luaopen_loadjob,
+	0
+};
+
+extern "C" int luaopen_love_loader(lua_State *L)
+{
+	Loader *instance = instance();
+	if (instance == nullptr)
+	{
+		luax_catchexcept(L, [&](){ instance = new Loader(); });
+	}
+	else
+		instance->retain();
+
+	WrappedModule w;
+	w.module = instance;
+	w.name = "loader";
+	w.type = &Module::type;
+	w.functions = functions;
+	w.types = types;
+
+	return luax_register_module(L, w);
+}
+
+} // loader
+} // love
@@ -196,6 +196,7 @@ function love.init()
 			thread = true,
 			window = true,
 			video = true,
+			loader = true,
 		},
 		audio = {
 			mixwithsystem = true, -- Only relevant for Android / iOS.
@@ -321,6 +322,7 @@ function love.init()
 		"graphics",
 		"math",
 		"physics",
+		"loader",
 	} do
 		if c.modules[v] then
 			require("love." .. v)
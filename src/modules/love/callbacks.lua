@@ -170,6 +170,9 @@ function love.run()
 		-- Update dt, as we'll be passing it to update
 		local dt = love.timer and love.timer.step() or 0
 
+		-- Finish assets loaded in the background, within the frame budget.
+		if love.loader then love.loader.update() end
+
 		-- Call update and draw
 		if love.update then love.update(dt) end -- will pass 0 if love.timer is disabled
 
@@ -134,6 +134,9 @@ extern "C"
 #if defined(LOVE_ENABLE_KEYBOARD)
 	extern int luaopen_love_keyboard(lua_State*);
 #endif
+#if defined(LOVE_ENABLE_LOADER)
+	extern int luaopen_love_loader(lua_State*);
+#endif
 #if defined(LOVE_ENABLE_MATH)
 	extern int luaopen_love_math(lua_State*);
 #endif
@@ -206,6 +209,9 @@ static const luaL_Reg modules[] = {
 #if defined(LOVE_ENABLE_KEYBOARD)
 	{ "love.keyboard", luaopen_love_keyboard },
 #endif
+#if defined(LOVE_ENABLE_LOADER)
+	{ "love.loader", luaopen_love_loader },
+#endif
 #if defined(LOVE_ENABLE_MATH)
 	{ "love.math", luaopen_love_math },
 #endif
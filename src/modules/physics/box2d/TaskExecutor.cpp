@@ -0,0 +1,175 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "TaskExecutor.h"
+#include "common/Exception.h"
+
+// STD
+#include <algorithm>
+
+namespace love
+{
+namespace physics
+{
+namespace box2d
+{
+
+TaskExecutor::Worker::Worker(TaskExecutor *executor)
+	: executor(executor)
+{
+	threadName = "PhysicsWorker";
+}
+
+void TaskExecutor::Worker::threadFunction()
+{
+	executor->workerLoop();
+}
+
+TaskExecutor::TaskExecutor(int threadCount)
+	: generation(0)
+	, stopping(false)
+	, task(nullptr)
+	, context(nullptr)
+	, count(0)
+	, rangeSize(1)
+	, nextIndex(0)
+	, busyWorkers(0)
+{
+	threadCount = std::min(std::max(threadCount, 1), MAX_THREADS);
+
+	for (int i = 1; i < threadCount; i++)
+	{
+		Worker *worker = new Worker(this);
+		worker->start();
+		workers.push_back(worker);
+	}
+}
+
+TaskExecutor::~TaskExecutor()
+{
+	{
+		love::thread::Lock lock(mutex);
+		stopping = true;
+		startCond->broadcast();
+	}
+
+	for (Worker *worker : workers)
+	{
+		worker->wait();
+		delete worker;
+	}
+}
+
+int32 TaskExecutor::GetWorkerCount() const
+{
+	return (int32) workers.size() + 1;
+}
+
+void TaskExecutor::ParallelFor(int32 count, int32 minRange, b2ParallelTask *task, void *context)
+{
+	if (count <= 0)
+		return;
+
+	minRange = std::max(minRange, 1);
+
+	if (workers.empty() || count <= minRange)
+	{
+		task(0, count, context);
+		return;
+	}
+
+	// Several ranges per thread, so uneven ranges even out.
+	int32 ranges = GetWorkerCount() * 4;
+	int32 size = std::max((count + ranges - 1) / ranges, minRange);
+
+	{
+		love::thread::Lock lock(mutex);
+		this->task = task;
+		this->context = context;
+		this->count = count;
+		rangeSize = size;
+		nextIndex = 0;
+		busyWorkers = (int) workers.size();
+		error.clear();
+		generation++;
+		startCond->broadcast();
+	}
+
+	runRanges();
+
+	love::thread::Lock lock(mutex);
+	while (busyWorkers > 0)
+		doneCond->wait(mutex);
+
+	if (!error.empty())
+		throw love::Exception("%s", error.c_str());
+}
+
+void TaskExecutor::workerLoop()
+{
+	uint64 seen = 0;
+
+	while (true)
+	{
+		{
+			love::thread::Lock lock(mutex);
+			while (!stopping && generation == seen)
+				startCond->wait(mutex);
+
+			if (stopping)
+				return;
+
+			seen = generation;
+		}
+
+		runRanges();
+
+		love::thread::Lock lock(mutex);
+		if (--busyWorkers == 0)
+			doneCond->signal();
+	}
+}
+
+void TaskExecutor::runRanges()
+{
+	while (true)
+	{
+		int32 begin = nextIndex.fetch_add(rangeSize);
+		if (begin >= count)
+			break;
+
+		int32 end = std::min(begin + rangeSize, count);
+
+		try
+		{
+			task(begin, end, context);
+		}
+		catch (std::exception &e)
+		{
+			love::thread::Lock lock(mutex);
+			if (error.empty())
+				error = e.what();
+		}
+	}
+}
+
+} // box2d
+} // physics
+} // love
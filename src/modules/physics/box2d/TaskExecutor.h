@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_PHYSICS_BOX2D_TASK_EXECUTOR_H
+#define LOVE_PHYSICS_BOX2D_TASK_EXECUTOR_H
+
+// LOVE
+#include "common/int.h"
+#include "thread/threads.h"
+
+// Box2D
+#include <box2d/Box2D.h>
+
+// STD
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace love
+{
+namespace physics
+{
+namespace box2d
+{
+
+/**
+ * Runs Box2D's parallel loops on a set of worker threads. The thread calling
+ * ParallelFor also takes part, so there are threadCount - 1 workers.
+ **/
+class TaskExecutor : public b2TaskExecutor
+{
+public:
+
+	static const int MAX_THREADS = 16;
+
+	TaskExecutor(int threadCount);
+	virtual ~TaskExecutor();
+
+	// Implements b2TaskExecutor.
+	int32 GetWorkerCount() const override;
+	void ParallelFor(int32 count, int32 minRange, b2ParallelTask *task, void *context) override;
+
+private:
+
+	class Worker : public love::thread::Threadable
+	{
+	public:
+		Worker(TaskExecutor *executor);
+		void threadFunction() override;
+	private:
+		TaskExecutor *executor;
+	};
+
+	void workerLoop();
+	void runRanges();
+
+	std::vector<Worker *> workers;
+
+	love::thread::MutexRef mutex;
+	love::thread::ConditionalRef startCond;
+	love::thread::ConditionalRef doneCond;
+
+	// Incremented for every ParallelFor, so workers know there's new work.
+	uint64 generation;
+	bool stopping;
+
+	// The current loop. Only changed while no worker is running it.
+	b2ParallelTask *task;
+	void *context;
+	int32 count;
+	int32 rangeSize;
+	std::atomic<int32> nextIndex;
+	int busyWorkers;
+
+	// Box2D assertions throw, and exceptions can't leave the worker threads.
+	std::string error;
+
+}; // TaskExecutor
+
+} // box2d
+} // physics
+} // love
+
+#endif // LOVE_PHYSICS_BOX2D_TASK_EXECUTOR_H
@@ -23,12 +23,16 @@
 #include "Shape.h"
 #include "Contact.h"
 #include "Physics.h"
+#include "TaskExecutor.h"
 #include "common/Reference.h"
 
 // Needed for World::getJoints. It should be moved to wrapper code...
 #include "wrap_Joint.h"
 #include "wrap_Shape.h"
 
+// STD
+#include <algorithm>
+
 namespace love
 {
 namespace physics
@@ -271,6 +275,8 @@ World::World()
 	, end(this)
 	, presolve(this)
 	, postsolve(this)
+	, contactEventsBuffered(false)
+	, executor(nullptr)
 {
 	world = new b2World(b2Vec2(0,0));
 	world->SetAllowSleeping(true);
@@ -289,6 +295,8 @@ World::World(b2Vec2 gravity, bool sleep)
 	, end(this)
 	, presolve(this)
 	, postsolve(this)
+	, contactEventsBuffered(false)
+	, executor(nullptr)
 {
 	world = new b2World(Physics::scaleDown(gravity));
 	world->SetAllowSleeping(sleep);
@@ -312,6 +320,8 @@ void World::update(float dt)
 
 void World::update(float dt, int velocityIterations, int positionIterations)
 {
+	clearContactEvents();
+
 	world->Step(dt, velocityIterations, positionIterations);
 
 	// Destroy all objects marked during the time step.
@@ -343,12 +353,18 @@ void World::update(float dt, int velocityIterations, int positionIterations)
 
 void World::BeginContact(b2Contact *contact)
 {
-	begin.process(contact);
+	if (contactEventsBuffered)
+		recordContactEvent(CONTACT_EVENT_BEGIN, contact, nullptr);
+	else
+		begin.process(contact);
 }
 
 void World::EndContact(b2Contact *contact)
 {
-	end.process(contact);
+	if (contactEventsBuffered)
+		recordContactEvent(CONTACT_EVENT_END, contact, nullptr);
+	else
+		end.process(contact);
 
 	// Letting the Contact know that the b2Contact will be destroyed any second.
 	Contact *c = (Contact *)findObject(contact);
@@ -364,7 +380,61 @@ void World::PreSolve(b2Contact *contact, const b2Manifold *oldManifold)
 
 void World::PostSolve(b2Contact *contact, const b2ContactImpulse *impulse)
 {
-	postsolve.process(contact, impulse);
+	if (contactEventsBuffered)
+		recordContactEvent(CONTACT_EVENT_POSTSOLVE, contact, impulse);
+	else
+		postsolve.process(contact, impulse);
+}
+
+void World::recordContactEvent(ContactEventType type, b2Contact *contact, const b2ContactImpulse *impulse)
+{
+	Shape *a = (Shape *)(contact->GetFixtureA()->GetUserData().pointer);
+	Shape *b = (Shape *)(contact->GetFixtureB()->GetUserData().pointer);
+	if (!a || !b)
+		throw love::Exception("A Shape has escaped Memoizer!");
+
+	ContactEvent e = {};
+	e.type = type;
+	e.pointCount = contact->GetManifold()->pointCount;
+
+	// Keep the Shapes alive until the events are cleared, even if they're
+	// destroyed after the step.
+	e.a = a;
+	e.b = b;
+	a->retain();
+	b->retain();
+
+	if (e.pointCount > 0)
+	{
+		b2WorldManifold manifold;
+		contact->GetWorldManifold(&manifold);
+		e.normal = manifold.normal;
+		for (int i = 0; i < e.pointCount; i++)
+			e.points[i] = Physics::scaleUp(manifold.points[i]);
+	}
+
+	if (impulse)
+	{
+		for (int i = 0; i < impulse->count; i++)
+		{
+			e.normalImpulses[i] = Physics::scaleUp(impulse->normalImpulses[i]);
+			e.tangentImpulses[i] = Physics::scaleUp(impulse->tangentImpulses[i]);
+		}
+	}
+
+	contactEvents.push_back(e);
+}
+
+void World::clearContactEvents()
+{
+	for (const ContactEvent &e : contactEvents)
+	{
+		e.a->release();
+		e.b->release();
+	}
+
+	// clear() keeps the capacity, so steady-state updates don't allocate.
+	contactEvents.clear();
 }
 
 bool World::ShouldCollide(b2Fixture *fixtureA, b2Fixture *fixtureB)
@@ -462,6 +532,58 @@ void World::setCallbacksL(lua_State *L)
 	begin.L = end.L = presolve.L = postsolve.L = filter.L = L;
 }
 
+void World::setContactEventsBuffered(bool buffered)
+{
+	contactEventsBuffered = buffered;
+	if (!buffered)
+		clearContactEvents();
+}
+
+bool World::areContactEventsBuffered() const
+{
+	return contactEventsBuffered;
+}
+
+const std::vector<World::ContactEvent> &World::getContactEvents() const
+{
+	return contactEvents;
+}
+
+void World::setThreadCount(int count)
+{
+	if (count < 1)
+		throw love::Exception("Thread count must be at least 1.");
+
+	if (world->IsLocked())
+		throw love::Exception("The thread count cannot be changed during a World update.");
+
+	count = std::min(count, (int) TaskExecutor::MAX_THREADS);
+
+	if (count == getThreadCount())
+		return;
+
+	TaskExecutor *newexecutor = count > 1 ? new TaskExecutor(count) : nullptr;
+
+	world->SetTaskExecutor(newexecutor);
+	delete executor;
+	executor = newexecutor;
+}
+
+int World::getThreadCount() const
+{
+	return executor != nullptr ? executor->GetWorkerCount() : 1;
+}
+
+void World::setBroadPhaseLayout(BroadPhaseLayout layout)
+{
+	world->SetBroadPhaseLayout(layout == BROADPHASE_LAYOUT_WIDE ? b2_wideTreeLayout : b2_binaryTreeLayout);
+}
+
+World::BroadPhaseLayout World::getBroadPhaseLayout() const
+{
+	return world->GetBroadPhaseLayout() == b2_wideTreeLayout ? BROADPHASE_LAYOUT_WIDE : BROADPHASE_LAYOUT_BINARY;
+}
+
 int World::setContactFilter(lua_State *L)
 {
 	if (!lua_isnoneornil(L, 1))
@@ -550,6 +672,41 @@ int World::getBodies(lua_State *L) const
 	return 1;
 }
 
+static void writeBodyState(const b2Body *b, float *dst)
+{
+	b2Vec2 position = Physics::scaleUp(b->GetPosition());
+	b2Vec2 velocity = Physics::scaleUp(b->GetLinearVelocity());
+
+	dst[0] = position.x;
+	dst[1] = position.y;
+	dst[2] = b->GetAngle();
+	dst[3] = velocity.x;
+	dst[4] = velocity.y;
+	dst[5] = b->GetAngularVelocity();
+}
+
+int World::getBodyStates(float *dst) const
+{
+	int count = 0;
+
+	for (const b2Body *b = world->GetBodyList(); b != nullptr; b = b->GetNext())
+	{
+		if (b == groundBody)
+			continue;
+
+		writeBodyState(b, dst + count * BODY_STATE_COMPONENTS);
+		count++;
+	}
+
+	return count;
+}
+
+void World::getBodyStates(const std::vector<Body *> &bodies, float *dst) const
+{
+	for (size_t i = 0; i < bodies.size(); i++)
+		writeBodyState(bodies[i]->body, dst + i * BODY_STATE_COMPONENTS);
+}
+
 int World::getJoints(lua_State *L) const
 {
 	lua_newtable(L);
@@ -668,6 +825,174 @@ int World::rayCastAny(lua_State *L)
 	return 0;
 }
 
+namespace
+{
+
+// Minimum number of rays or boxes per task of a batch.
+const int32 BATCH_MIN_RANGE = 64;
+
+struct RayCastBatch
+{
+	b2World *world;
+	const float *rays;
+	uint16 categoryMask;
+	bool any;
+	World::RayCastHit *hits;
+};
+
+void rayCastBatchRange(int32 begin, int32 end, void *context)
+{
+	RayCastBatch *batch = (RayCastBatch *) context;
+
+	for (int32 i = begin; i < end; i++)
+	{
+		const float *ray = batch->rays + i * 4;
+		b2Vec2 v1 = Physics::scaleDown(b2Vec2(ray[0], ray[1]));
+		b2Vec2 v2 = Physics::scaleDown(b2Vec2(ray[2], ray[3]));
+
+		World::RayCastHit &hit = batch->hits[i];
+		hit.shape = nullptr;
+		hit.point = b2Vec2(0.0f, 0.0f);
+		hit.normal = b2Vec2(0.0f, 0.0f);
+		hit.fraction = 1.0f;
+
+		// Box2D asserts on zero length rays.
+		if (v1 == v2)
+			continue;
+
+		World::RayCastOneCallback raycast(batch->categoryMask, batch->any);
+		batch->world->RayCast(&raycast, v1, v2);
+
+		if (raycast.hitFixture)
+		{
+			hit.shape = (Shape *)(raycast.hitFixture->GetUserData().pointer);
+			if (hit.shape == nullptr)
+				throw love::Exception("A Shape has escaped Memoizer!");
+			hit.point = Physics::scaleUp(raycast.hitPoint);
+			hit.normal = raycast.hitNormal;
+			hit.fraction = raycast.hitFraction;
+		}
+	}
+}
+
+class CollectShapesCallback : public b2QueryCallback
+{
+public:
+
+	CollectShapesCallback(uint16 categoryMask, std::vector<Shape *> &shapes)
+		: categoryMask(categoryMask)
+		, shapes(shapes)
+	{}
+
+	bool ReportFixture(b2Fixture *f) override
+	{
+		if (categoryMask != 0xFFFF && (categoryMask & f->GetFilterData().categoryBits) == 0)
+			return true;
+
+		Shape *shape = (Shape *)(f->GetUserData().pointer);
+		if (!shape)
+			throw love::Exception("A Shape has escaped Memoizer!");
+		shapes.push_back(shape);
+		return true;
+	}
+
+private:
+
+	uint16 categoryMask;
+	std::vector<Shape *> &shapes;
+};
+
+// The shapes found by one task, which are put in box order afterwards.
+struct QueryAreaChunk
+{
+	int32 begin;
+	std::vector<Shape *> shapes;
+};
+
+struct QueryAreaBatch
+{
+	b2World *world;
+	const float *boxes;
+	uint16 categoryMask;
+	int *counts;
+
+	love::thread::MutexRef mutex;
+	std::vector<QueryAreaChunk> chunks;
+};
+
+void queryAreaBatchRange(int32 begin, int32 end, void *context)
+{
+	QueryAreaBatch *batch = (QueryAreaBatch *) context;
+
+	QueryAreaChunk chunk;
+	chunk.begin = begin;
+	CollectShapesCallback query(batch->categoryMask, chunk.shapes);
+
+	for (int32 i = begin; i < end; i++)
+	{
+		const float *box = batch->boxes + i * 4;
+		b2AABB aabb;
+		aabb.lowerBound = Physics::scaleDown(b2Vec2(box[0], box[1]));
+		aabb.upperBound = Physics::scaleDown(b2Vec2(box[2], box[3]));
+
+		size_t first = chunk.shapes.size();
+		batch->world->QueryAABB(&query, aabb);
+		batch->counts[i] = (int) (chunk.shapes.size() - first);
+	}
+
+	love::thread::Lock lock(batch->mutex);
+	batch->chunks.push_back(std::move(chunk));
+}
+
+} // anonymous namespace
+
+void World::rayCastBatch(const float *rays, int count, uint16 categoryMask, bool any, RayCastHit *hits)
+{
+	RayCastBatch batch;
+	batch.world = world;
+	batch.rays = rays;
+	batch.categoryMask = categoryMask;
+	batch.any = any;
+	batch.hits = hits;
+
+	if (executor != nullptr)
+	{
+		// Queries rebuild the wide tree lazily, which can't happen on
+		// several threads.
+		world->GetContactManager().m_broadPhase.UpdateWideTree();
+		executor->ParallelFor(count, BATCH_MIN_RANGE, rayCastBatchRange, &batch);
+	}
+	else
+		rayCastBatchRange(0, count, &batch);
+}
+
+void World::queryAreaBatch(const float *boxes, int count, uint16 categoryMask, std::vector<Shape *> &shapes, std::vector<int> &counts)
+{
+	counts.resize(count);
+
+	QueryAreaBatch batch;
+	batch.world = world;
+	batch.boxes = boxes;
+	batch.categoryMask = categoryMask;
+	batch.counts = counts.data();
+
+	if (executor != nullptr)
+	{
+		world->GetContactManager().m_broadPhase.UpdateWideTree();
+		executor->ParallelFor(count, BATCH_MIN_RANGE, queryAreaBatchRange, &batch);
+	}
+	else if (count > 0)
+		queryAreaBatchRange(0, count, &batch);
+
+	std::sort(batch.chunks.begin(), batch.chunks.end(), [](const QueryAreaChunk &a, const QueryAreaChunk &b)
+	{
+		return a.begin < b.begin;
+	});
+
+	for (const QueryAreaChunk &chunk : batch.chunks)
+		shapes.insert(shapes.end(), chunk.shapes.begin(), chunk.shapes.end());
+}
+
 int World::rayCastClosest(lua_State *L)
 {
 	float x1 = (float)luaL_checknumber(L, 1);
@@ -735,8 +1060,13 @@ void World::destroy()
 	world->DestroyBody(groundBody);
 	unregisterObject(world);
 
+	clearContactEvents();
+
 	delete world;
 	world = nullptr;
+
+	delete executor;
+	executor = nullptr;
 }
 
 void World::registerObject(void *b2object, love::Object *object)
@@ -758,6 +1088,21 @@ love::Object *World::findObject(void *b2object) const
 		return nullptr;
 }
 
+STRINGMAP_CLASS_BEGIN(World, World::BroadPhaseLayout, World::BROADPHASE_LAYOUT_MAX_ENUM, broadPhaseLayout)
+{
+	{ "binary", World::BROADPHASE_LAYOUT_BINARY },
+	{ "wide",   World::BROADPHASE_LAYOUT_WIDE   },
+}
+STRINGMAP_CLASS_END(World, World::BroadPhaseLayout, World::BROADPHASE_LAYOUT_MAX_ENUM, broadPhaseLayout)
+
+STRINGMAP_CLASS_BEGIN(World, World::ContactEventType, World::CONTACT_EVENT_MAX_ENUM, contactEventType)
+{
+	{ "begin",     World::CONTACT_EVENT_BEGIN     },
+	{ "end",       World::CONTACT_EVENT_END       },
+	{ "postsolve", World::CONTACT_EVENT_POSTSOLVE },
+}
+STRINGMAP_CLASS_END(World, World::ContactEventType, World::CONTACT_EVENT_MAX_ENUM, contactEventType)
+
 } // box2d
 } // physics
 } // love
@@ -25,6 +25,7 @@
 #include "common/Object.h"
 #include "common/runtime.h"
 #include "common/Reference.h"
+#include "common/StringMap.h"
 
 // STD
 #include <vector>
@@ -44,6 +45,7 @@ class Contact;
 class Body;
 class Shape;
 class Joint;
+class TaskExecutor;
 
 /**
  * The World is the "God" container class,
@@ -69,6 +71,42 @@ class World : public Object, public b2ContactListener, public b2ContactFilter, p
 
 	static love::Type type;
 
+	// Number of floats written per body by getBodyStates: x, y, angle,
+	// linear velocity x and y, and angular velocity.
+	static const int BODY_STATE_COMPONENTS = 6;
+
+	enum BroadPhaseLayout
+	{
+		BROADPHASE_LAYOUT_BINARY,
+		BROADPHASE_LAYOUT_WIDE,
+		BROADPHASE_LAYOUT_MAX_ENUM
+	};
+
+	enum ContactEventType
+	{
+		CONTACT_EVENT_BEGIN,
+		CONTACT_EVENT_END,
+		CONTACT_EVENT_POSTSOLVE,
+		CONTACT_EVENT_MAX_ENUM
+	};
+
+	/**
+	 * A contact event recorded during update() when contact events are
+	 * buffered. Positions are scaled up, impulses are only set for postsolve
+	 * events.
+	 **/
+	struct ContactEvent
+	{
+		ContactEventType type;
+		Shape *a;
+		Shape *b;
+		b2Vec2 normal;
+		b2Vec2 points[b2_maxManifoldPoints];
+		float normalImpulses[b2_maxManifoldPoints];
+		float tangentImpulses[b2_maxManifoldPoints];
+		int pointCount;
+	};
+
 	class ContactCallback
 	{
 	public:
@@ -146,6 +184,18 @@ class World : public Object, public b2ContactListener, public b2ContactFilter, p
 		bool any;
 	};
 
+	/**
+	 * The result of one ray of rayCastBatch. The point is scaled up, shape is
+	 * null if the ray didn't hit anything.
+	 **/
+	struct RayCastHit
+	{
+		Shape *shape;
+		b2Vec2 point;
+		b2Vec2 normal;
+		float fraction;
+	};
+
 	/**
 	 * Creates a new world.
 	 **/
@@ -209,6 +259,39 @@ class World : public Object, public b2ContactListener, public b2ContactFilter, p
 	 **/
 	void setCallbacksL(lua_State *L);
 
+	/**
+	 * Sets whether begin, end and postsolve contact events are recorded into
+	 * a list which can be read after update(), instead of calling the
+	 * callbacks set with setCallbacks. The presolve callback is still called,
+	 * since it's used to modify contacts before they're solved.
+	 **/
+	void setContactEventsBuffered(bool buffered);
+	bool areContactEventsBuffered() const;
+
+	/**
+	 * Gets the contact events recorded during the last update().
+	 **/
+	const std::vector<ContactEvent> &getContactEvents() const;
+
+	/**
+	 * Sets the number of threads used to update contacts and solve islands
+	 * during update(). Contact callbacks are still called on the thread
+	 * calling update(), but with more than one thread every island is solved
+	 * before any postSolve callback runs. Changes a postSolve callback makes
+	 * to other bodies therefore don't affect islands solved later in the same
+	 * update, like they do with a single thread.
+	 **/
+	void setThreadCount(int count);
+	int getThreadCount() const;
+
+	/**
+	 * Sets the tree layout used to find new contacts and for queries and ray
+	 * casts. The wide layout is faster with many shapes, the binary layout
+	 * avoids rebuilding the wide tree when only a few shapes move.
+	 **/
+	void setBroadPhaseLayout(BroadPhaseLayout layout);
+	BroadPhaseLayout getBroadPhaseLayout() const;
+
 	/**
 	 * Sets the ContactFilter callback.
 	 **/
@@ -289,6 +372,20 @@ class World : public Object, public b2ContactListener, public b2ContactFilter, p
 	 **/
 	int getJoints(lua_State *L) const;
 
+	/**
+	 * Writes the state of every Body in the World, in the same order as
+	 * getBodies, as BODY_STATE_COMPONENTS floats per Body.
+	 * @param dst Array of at least getBodyCount() * BODY_STATE_COMPONENTS floats.
+	 * @return The number of Bodies written.
+	 **/
+	int getBodyStates(float *dst) const;
+
+	/**
+	 * Writes the state of the given Bodies, as BODY_STATE_COMPONENTS floats
+	 * per Body.
+	 **/
+	void getBodyStates(const std::vector<Body *> &bodies, float *dst) const;
+
 	/**
 	 * Get an array of all the Contacts in the World.
 	 * @return An array of Contacts.
@@ -319,11 +416,29 @@ class World : public Object, public b2ContactListener, public b2ContactFilter, p
 	int rayCastAny(lua_State *L);
 	int rayCastClosest(lua_State *L);
 
+	/**
+	 * Casts a batch of rays, given as x1, y1, x2, y2 per ray, and gets the
+	 * closest hit of each, or any hit if any is true. Rays with a length of
+	 * zero don't hit anything. Uses the World's threads if it has several.
+	 **/
+	void rayCastBatch(const float *rays, int count, uint16 categoryMask, bool any, RayCastHit *hits);
+
+	/**
+	 * Finds the shapes overlapping each of a batch of boxes, given as lx, ly,
+	 * ux, uy per box. The shapes of all boxes are appended to shapes in box
+	 * order, and counts gets the number of shapes of each box. Uses the
+	 * World's threads if it has several.
+	 **/
+	void queryAreaBatch(const float *boxes, int count, uint16 categoryMask, std::vector<Shape *> &shapes, std::vector<int> &counts);
+
 	/**
 	 * Destroy this world.
 	 **/
 	void destroy();
 
+	STRINGMAP_CLASS_DECLARE(BroadPhaseLayout);
+	STRINGMAP_CLASS_DECLARE(ContactEventType);
+
 	void registerObject(void *b2object, love::Object *object);
 	void unregisterObject(void *b2object);
 	love::Object *findObject(void *b2object) const;
@@ -348,6 +463,17 @@ class World : public Object, public b2ContactListener, public b2ContactFilter, p
 
 	std::unordered_map<void *, love::Object *> box2dObjectMap;
 
+	void recordContactEvent(ContactEventType type, b2Contact *contact, const b2ContactImpulse *impulse);
+	void clearContactEvents();
+
+	// Contact events of the last update, when buffered. The storage is
+	// reused between updates.
+	bool contactEventsBuffered;
+	std::vector<ContactEvent> contactEvents;
+
+	// Only used when more than one thread is set.
+	TaskExecutor *executor;
+
 }; // World
 
 } // box2d
@@ -19,6 +19,19 @@
  **/
 
 #include "wrap_World.h"
+#include "wrap_Body.h"
+#include "wrap_Shape.h"
+#include "common/config.h"
+#include "common/Data.h"
+
+#ifdef LOVE_ENABLE_GRAPHICS
+#include "graphics/Buffer.h"
+#endif
+
+// STD
+#include <vector>
+#include <string.h>
+#include <stdint.h>
 
 namespace love
 {
@@ -69,6 +82,134 @@ int w_World_getCallbacks(lua_State *L)
 	return t->getCallbacks(L);
 }
 
+int w_World_setContactEventsBuffered(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	t->setContactEventsBuffered(luax_checkboolean(L, 2));
+	return 0;
+}
+
+int w_World_areContactEventsBuffered(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	luax_pushboolean(L, t->areContactEventsBuffered());
+	return 1;
+}
+
+static int w_World_contactEventsIterator(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	int i = (int) luaL_checkinteger(L, 2);
+
+	const std::vector<World::ContactEvent> &events = t->getContactEvents();
+	if (i < 0 || i >= (int) events.size())
+		return 0;
+
+	const World::ContactEvent &e = events[i];
+
+	const char *type = nullptr;
+	if (!World::getConstant(e.type, type))
+		return luaL_error(L, "Unknown contact event type.");
+
+	lua_pushinteger(L, i + 1);
+	lua_pushstring(L, type);
+	luax_pushshape(L, e.a);
+	luax_pushshape(L, e.b);
+
+	if (e.pointCount > 0)
+	{
+		lua_pushnumber(L, e.normal.x);
+		lua_pushnumber(L, e.normal.y);
+	}
+	else
+	{
+		lua_pushnil(L);
+		lua_pushnil(L);
+	}
+
+	for (int p = 0; p < b2_maxManifoldPoints; p++)
+	{
+		if (p < e.pointCount)
+		{
+			lua_pushnumber(L, e.points[p].x);
+			lua_pushnumber(L, e.points[p].y);
+		}
+		else
+		{
+			lua_pushnil(L);
+			lua_pushnil(L);
+		}
+	}
+
+	for (int p = 0; p < b2_maxManifoldPoints; p++)
+	{
+		if (e.type == World::CONTACT_EVENT_POSTSOLVE && p < e.pointCount)
+		{
+			lua_pushnumber(L, e.normalImpulses[p]);
+			lua_pushnumber(L, e.tangentImpulses[p]);
+		}
+		else
+		{
+			lua_pushnil(L);
+			lua_pushnil(L);
+		}
+	}
+
+	return 6 + b2_maxManifoldPoints * 4;
+}
+
+int w_World_getContactEvents(lua_State *L)
+{
+	luax_checkworld(L, 1);
+	lua_pushcfunction(L, w_World_contactEventsIterator);
+	lua_pushvalue(L, 1);
+	lua_pushinteger(L, 0);
+	return 3;
+}
+
+int w_World_getContactEventCount(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	lua_pushinteger(L, (lua_Integer) t->getContactEvents().size());
+	return 1;
+}
+
+int w_World_setThreadCount(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	int count = (int) luaL_checkinteger(L, 2);
+	luax_catchexcept(L, [&](){ t->setThreadCount(count); });
+	return 0;
+}
+
+int w_World_getThreadCount(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	lua_pushinteger(L, t->getThreadCount());
+	return 1;
+}
+
+int w_World_setBroadPhaseLayout(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	const char *str = luaL_checkstring(L, 2);
+	World::BroadPhaseLayout layout;
+	if (!World::getConstant(str, layout))
+		return luax_enumerror(L, "broad phase layout", World::getConstants(layout), str);
+	t->setBroadPhaseLayout(layout);
+	return 0;
+}
+
+int w_World_getBroadPhaseLayout(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	const char *str = nullptr;
+	if (!World::getConstant(t->getBroadPhaseLayout(), str))
+		return luaL_error(L, "Unknown broad phase layout.");
+	lua_pushstring(L, str);
+	return 1;
+}
+
 int w_World_setContactFilter(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -160,6 +301,83 @@ int w_World_getBodies(lua_State *L)
 	return ret;
 }
 
+int w_World_getBodyStates(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+
+	bool allbodies = lua_isnoneornil(L, 3);
+	std::vector<Body *> bodies;
+
+	if (!allbodies)
+	{
+		luaL_checktype(L, 3, LUA_TTABLE);
+		int n = (int) luax_objlen(L, 3);
+		bodies.reserve(n);
+
+		for (int i = 1; i <= n; i++)
+		{
+			lua_rawgeti(L, 3, i);
+			Body *b = luax_checkbody(L, -1);
+			if (b->getWorld() != t)
+				return luaL_error(L, "Body at index %d does not belong to this World.", i);
+			bodies.push_back(b);
+			lua_pop(L, 1);
+		}
+	}
+
+	lua_Integer offset = luaL_optinteger(L, 4, 0);
+	if (offset < 0 || offset % sizeof(float) != 0)
+		return luaL_error(L, "Byte offset must be a non-negative multiple of %d.", (int) sizeof(float));
+
+	int count = allbodies ? t->getBodyCount() : (int) bodies.size();
+	size_t size = (size_t) count * World::BODY_STATE_COMPONENTS * sizeof(float);
+
+	auto writestates = [&](float *dst)
+	{
+		if (allbodies)
+			t->getBodyStates(dst);
+		else
+			t->getBodyStates(bodies, dst);
+	};
+
+#ifdef LOVE_ENABLE_GRAPHICS
+	if (luax_istype(L, 2, graphics::Buffer::type))
+	{
+		graphics::Buffer *buffer = luax_checktype<graphics::Buffer>(L, 2);
+		if ((size_t) offset + size > buffer->getSize())
+			return luaL_error(L, "Buffer is too small to hold the states of %d bodies (%d bytes needed).", count, (int) ((size_t) offset + size));
+
+		if (count > 0)
+		{
+			std::vector<float> states((size_t) count * World::BODY_STATE_COMPONENTS);
+			writestates(states.data());
+			luax_catchexcept(L, [&]() { buffer->fill((size_t) offset, size, states.data()); });
+		}
+	}
+	else
+#endif // LOVE_ENABLE_GRAPHICS
+	{
+		Data *data = luax_checktype<Data>(L, 2);
+		if ((size_t) offset + size > data->getSize())
+			return luaL_error(L, "Data is too small to hold the states of %d bodies (%d bytes needed).", count, (int) ((size_t) offset + size));
+
+		uint8 *dst = (uint8 *) data->getData() + offset;
+
+		// Data views can start at any byte, floats can't be written there.
+		if (count > 0 && ((uintptr_t) dst) % alignof(float) == 0)
+			writestates((float *) dst);
+		else if (count > 0)
+		{
+			std::vector<float> states((size_t) count * World::BODY_STATE_COMPONENTS);
+			writestates(states.data());
+			memcpy(dst, states.data(), size);
+		}
+	}
+
+	lua_pushinteger(L, count);
+	return 1;
+}
+
 int w_World_getJoints(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -227,6 +445,139 @@ int w_World_rayCastClosest(lua_State *L)
 	return ret;
 }
 
+// Gets a batch of rays or boxes with 4 numbers each, from a flat table or a
+// Data containing floats. Returns the number of rays or boxes.
+static int checkBatchInput(lua_State *L, int idx, const char *name, std::vector<float> &storage, const float *&values)
+{
+	if (lua_istable(L, idx))
+	{
+		int n = (int) luax_objlen(L, idx);
+		if (n % 4 != 0)
+			return luaL_error(L, "The number of %s values must be a multiple of 4.", name);
+
+		storage.resize(n);
+		for (int i = 0; i < n; i++)
+		{
+			lua_rawgeti(L, idx, i + 1);
+			storage[i] = (float) luaL_checknumber(L, -1);
+			lua_pop(L, 1);
+		}
+
+		values = storage.data();
+		return n / 4;
+	}
+
+	Data *data = luax_checktype<Data>(L, idx);
+	if (data->getSize() % (4 * sizeof(float)) != 0)
+		return luaL_error(L, "The size of %s Data must be a multiple of %d bytes.", name, (int) (4 * sizeof(float)));
+
+	int count = (int) (data->getSize() / (4 * sizeof(float)));
+
+	// Data views can start at any byte, so only read floats from it in place
+	// when it's suitably aligned.
+	if (((uintptr_t) data->getData()) % alignof(float) == 0)
+		values = (const float *) data->getData();
+	else
+	{
+		storage.resize((size_t) count * 4);
+		memcpy(storage.data(), data->getData(), data->getSize());
+		values = storage.data();
+	}
+
+	return count;
+}
+
+// Pushes the table at idx if there is one, or a new table. Entries past
+// length are removed from a reused table.
+static void pushBatchResults(lua_State *L, int idx, int length)
+{
+	if (lua_istable(L, idx))
+	{
+		lua_pushvalue(L, idx);
+		int oldlength = (int) luax_objlen(L, -1);
+		for (int i = oldlength; i > length; i--)
+		{
+			lua_pushnil(L);
+			lua_rawseti(L, -2, i);
+		}
+	}
+	else
+		lua_createtable(L, length, 0);
+}
+
+int w_World_rayCastBatch(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+
+	std::vector<float> storage;
+	const float *rays = nullptr;
+	int count = checkBatchInput(L, 2, "ray", storage, rays);
+
+	bool any = luax_optboolean(L, 3, false);
+	uint16 categoryMask = (uint16) luaL_optinteger(L, 4, 0xFFFF);
+
+	std::vector<World::RayCastHit> hits(count);
+	luax_catchexcept(L, [&]() { t->rayCastBatch(rays, count, categoryMask, any, hits.data()); });
+
+	pushBatchResults(L, 5, count * 6);
+
+	for (int i = 0; i < count; i++)
+	{
+		const World::RayCastHit &hit = hits[i];
+		int base = i * 6;
+
+		if (hit.shape != nullptr)
+			luax_pushshape(L, hit.shape);
+		else
+			lua_pushboolean(L, 0);
+		lua_rawseti(L, -2, base + 1);
+
+		lua_pushnumber(L, hit.point.x);
+		lua_rawseti(L, -2, base + 2);
+		lua_pushnumber(L, hit.point.y);
+		lua_rawseti(L, -2, base + 3);
+		lua_pushnumber(L, hit.normal.x);
+		lua_rawseti(L, -2, base + 4);
+		lua_pushnumber(L, hit.normal.y);
+		lua_rawseti(L, -2, base + 5);
+		lua_pushnumber(L, hit.fraction);
+		lua_rawseti(L, -2, base + 6);
+	}
+
+	return 1;
+}
+
+int w_World_queryAreaBatch(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+
+	std::vector<float> storage;
+	const float *boxes = nullptr;
+	int count = checkBatchInput(L, 2, "box", storage, boxes);
+
+	uint16 categoryMask = (uint16) luaL_optinteger(L, 3, 0xFFFF);
+
+	std::vector<Shape *> shapes;
+	std::vector<int> counts;
+	luax_catchexcept(L, [&]() { t->queryAreaBatch(boxes, count, categoryMask, shapes, counts); });
+
+	pushBatchResults(L, 4, (int) shapes.size());
+	for (int i = 0; i < (int) shapes.size(); i++)
+	{
+		luax_pushshape(L, shapes[i]);
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	pushBatchResults(L, 5, count);
+	for (int i = 0; i < count; i++)
+	{
+		lua_pushinteger(L, counts[i]);
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 2;
+}
+
 int w_World_destroy(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -246,6 +597,14 @@ static const luaL_Reg w_World_functions[] =
 	{ "update", w_World_update },
 	{ "setCallbacks", w_World_setCallbacks },
 	{ "getCallbacks", w_World_getCallbacks },
+	{ "setContactEventsBuffered", w_World_setContactEventsBuffered },
+	{ "areContactEventsBuffered", w_World_areContactEventsBuffered },
+	{ "getContactEvents", w_World_getContactEvents },
+	{ "getContactEventCount", w_World_getContactEventCount },
+	{ "setThreadCount", w_World_setThreadCount },
+	{ "getThreadCount", w_World_getThreadCount },
+	{ "setBroadPhaseLayout", w_World_setBroadPhaseLayout },
+	{ "getBroadPhaseLayout", w_World_getBroadPhaseLayout },
 	{ "setContactFilter", w_World_setContactFilter },
 	{ "getContactFilter", w_World_getContactFilter },
 	{ "setGravity", w_World_setGravity },
@@ -258,6 +617,7 @@ static const luaL_Reg w_World_functions[] =
 	{ "getJointCount", w_World_getJointCount },
 	{ "getContactCount", w_World_getContactCount },
 	{ "getBodies", w_World_getBodies },
+	{ "getBodyStates", w_World_getBodyStates },
 	{ "getJoints", w_World_getJoints },
 	{ "getContacts", w_World_getContacts },
 	{ "queryShapesInArea", w_World_queryShapesInArea },
@@ -265,6 +625,8 @@ static const luaL_Reg w_World_functions[] =
 	{ "rayCast", w_World_rayCast },
 	{ "rayCastAny", w_World_rayCastAny },
 	{ "rayCastClosest", w_World_rayCastClosest },
+	{ "rayCastBatch", w_World_rayCastBatch },
+	{ "queryAreaBatch", w_World_queryAreaBatch },
 	{ "destroy", w_World_destroy },
 	{ "isDestroyed", w_World_isDestroyed },
 
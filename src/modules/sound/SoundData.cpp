@@ -19,21 +19,330 @@
  **/
 
 #include "SoundData.h"
+#include "common/config.h"
+#include "common/math.h"
 
 // C
 #include <cstdlib>
 #include <cstring>
+#include <cmath>
 
 // C++
 #include <limits>
 #include <iostream>
 #include <vector>
+#include <algorithm>
+
+#if defined(LOVE_SIMD_SSE) && (defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define LOVE_SOUNDDATA_SIMD_SSE2
+#elif defined(LOVE_SIMD_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+// vdivq_f32 and vaddvq_f32 are only available on 64 bit ARM.
+#include <arm_neon.h>
+#define LOVE_SOUNDDATA_SIMD_NEON
+#endif
 
 namespace love
 {
 namespace sound
 {
 
+// Bulk versions of getSample. Results are identical to it.
+static void samplesToFloat(const void *src, int bitDepth, float *dst, size_t count)
+{
+	size_t i = 0;
+
+	if (bitDepth == 16)
+	{
+		const int16 *s = (const int16 *) src;
+
+#if defined(LOVE_SOUNDDATA_SIMD_SSE2)
+		const __m128 scale = _mm_set1_ps((float) LOVE_INT16_MAX);
+		for (; i + 8 <= count; i += 8)
+		{
+			__m128i v = _mm_loadu_si128((const __m128i *) (s + i));
+			__m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+			__m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+			_mm_storeu_ps(dst + i, _mm_div_ps(_mm_cvtepi32_ps(lo), scale));
+			_mm_storeu_ps(dst + i + 4, _mm_div_ps(_mm_cvtepi32_ps(hi), scale));
+		}
+#elif defined(LOVE_SOUNDDATA_SIMD_NEON)
+		const float32x4_t scale = vdupq_n_f32((float) LOVE_INT16_MAX);
+		for (; i + 8 <= count; i += 8)
+		{
+			int16x8_t v = vld1q_s16(s + i);
+			vst1q_f32(dst + i, vdivq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale));
+			vst1q_f32(dst + i + 4, vdivq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale));
+		}
+#endif
+
+		for (; i < count; i++)
+			dst[i] = (float) s[i] / (float) LOVE_INT16_MAX;
+	}
+	else
+	{
+		const uint8 *s = (const uint8 *) src;
+
+#if defined(LOVE_SOUNDDATA_SIMD_SSE2)
+		const __m128 scale = _mm_set1_ps(127.0f);
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i bias = _mm_set1_epi32(128);
+		for (; i + 8 <= count; i += 8)
+		{
+			__m128i v = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (s + i)), zero);
+			__m128i lo = _mm_sub_epi32(_mm_unpacklo_epi16(v, zero), bias);
+			__m128i hi = _mm_sub_epi32(_mm_unpackhi_epi16(v, zero), bias);
+			_mm_storeu_ps(dst + i, _mm_div_ps(_mm_cvtepi32_ps(lo), scale));
+			_mm_storeu_ps(dst + i + 4, _mm_div_ps(_mm_cvtepi32_ps(hi), scale));
+		}
+#elif defined(LOVE_SOUNDDATA_SIMD_NEON)
+		const float32x4_t scale = vdupq_n_f32(127.0f);
+		const int16x8_t bias = vdupq_n_s16(128);
+		for (; i + 8 <= count; i += 8)
+		{
+			int16x8_t v = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(s + i))), bias);
+			vst1q_f32(dst + i, vdivq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale));
+			vst1q_f32(dst + i + 4, vdivq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale));
+		}
+#endif
+
+		for (; i < count; i++)
+			dst[i] = ((float) s[i] - 128.0f) / 127.0f;
+	}
+}
+
+// Bulk versions of setSample, which also clamp to [-1, 1].
+static void samplesFromFloat(const float *src, void *dst, int bitDepth, size_t count)
+{
+	size_t i = 0;
+
+	if (bitDepth == 16)
+	{
+		int16 *d = (int16 *) dst;
+
+#if defined(LOVE_SOUNDDATA_SIMD_SSE2)
+		const __m128 scale = _mm_set1_ps((float) LOVE_INT16_MAX);
+		const __m128 minval = _mm_set1_ps(-1.0f);
+		const __m128 maxval = _mm_set1_ps(1.0f);
+		for (; i + 8 <= count; i += 8)
+		{
+			__m128 a = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), minval), maxval);
+			__m128 b = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4), minval), maxval);
+			__m128i ia = _mm_cvttps_epi32(_mm_mul_ps(a, scale));
+			__m128i ib = _mm_cvttps_epi32(_mm_mul_ps(b, scale));
+			_mm_storeu_si128((__m128i *) (d + i), _mm_packs_epi32(ia, ib));
+		}
+#elif defined(LOVE_SOUNDDATA_SIMD_NEON)
+		const float32x4_t minval = vdupq_n_f32(-1.0f);
+		const float32x4_t maxval = vdupq_n_f32(1.0f);
+		for (; i + 8 <= count; i += 8)
+		{
+			float32x4_t a = vminq_f32(vmaxq_f32(vld1q_f32(src + i), minval), maxval);
+			float32x4_t b = vminq_f32(vmaxq_f32(vld1q_f32(src + i + 4), minval), maxval);
+			int32x4_t ia = vcvtq_s32_f32(vmulq_n_f32(a, (float) LOVE_INT16_MAX));
+			int32x4_t ib = vcvtq_s32_f32(vmulq_n_f32(b, (float) LOVE_INT16_MAX));
+			vst1q_s16(d + i, vcombine_s16(vqmovn_s32(ia), vqmovn_s32(ib)));
+		}
+#endif
+
+		for (; i < count; i++)
+		{
+			float sample = std::min(std::max(src[i], -1.0f), 1.0f);
+			d[i] = (int16) (sample * (float) LOVE_INT16_MAX);
+		}
+	}
+	else
+	{
+		uint8 *d = (uint8 *) dst;
+
+#if defined(LOVE_SOUNDDATA_SIMD_SSE2)
+		const __m128 scale = _mm_set1_ps(127.0f);
+		const __m128 bias = _mm_set1_ps(128.0f);
+		const __m128 minval = _mm_set1_ps(-1.0f);
+		const __m128 maxval = _mm_set1_ps(1.0f);
+		for (; i + 8 <= count; i += 8)
+		{
+			__m128 a = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), minval), maxval);
+			__m128 b = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4), minval), maxval);
+			__m128i ia = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(a, scale), bias));
+			__m128i ib = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(b, scale), bias));
+			__m128i packed = _mm_packs_epi32(ia, ib);
+			_mm_storel_epi64((__m128i *) (d + i), _mm_packus_epi16(packed, packed));
+		}
+#elif defined(LOVE_SOUNDDATA_SIMD_NEON)
+		const float32x4_t minval = vdupq_n_f32(-1.0f);
+		const float32x4_t maxval = vdupq_n_f32(1.0f);
+		const float32x4_t bias = vdupq_n_f32(128.0f);
+		for (; i + 8 <= count; i += 8)
+		{
+			float32x4_t a = vminq_f32(vmaxq_f32(vld1q_f32(src + i), minval), maxval);
+			float32x4_t b = vminq_f32(vmaxq_f32(vld1q_f32(src + i + 4), minval), maxval);
+			int32x4_t ia = vcvtq_s32_f32(vaddq_f32(vmulq_n_f32(a, 127.0f), bias));
+			int32x4_t ib = vcvtq_s32_f32(vaddq_f32(vmulq_n_f32(b, 127.0f), bias));
+			vst1_u8(d + i, vqmovun_s16(vcombine_s16(vqmovn_s32(ia), vqmovn_s32(ib))));
+		}
+#endif
+
+		for (; i < count; i++)
+		{
+			float sample = std::min(std::max(src[i], -1.0f), 1.0f);
+			d[i] = (uint8) ((sample * 127.0f) + 128.0f);
+		}
+	}
+}
+
+static void deinterleave(const float *src, int channels, size_t frames, float *const *dst)
+{
+	size_t i = 0;
+
+	if (channels == 2)
+	{
+#if defined(LOVE_SOUNDDATA_SIMD_SSE2)
+		for (; i + 4 <= frames; i += 4)
+		{
+			__m128 a = _mm_loadu_ps(src + i * 2);
+			__m128 b = _mm_loadu_ps(src + i * 2 + 4);
+			_mm_storeu_ps(dst[0] + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+			_mm_storeu_ps(dst[1] + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+		}
+#elif defined(LOVE_SOUNDDATA_SIMD_NEON)
+		for (; i + 4 <= frames; i += 4)
+		{
+			float32x4x2_t v = vld2q_f32(src + i * 2);
+			vst1q_f32(dst[0] + i, v.val[0]);
+			vst1q_f32(dst[1] + i, v.val[1]);
+		}
+#endif
+	}
+
+	for (; i < frames; i++)
+	{
+		for (int c = 0; c < channels; c++)
+			dst[c][i] = src[i * channels + c];
+	}
+}
+
+static void interleave(const float *const *src, int channels, size_t frames, float *dst)
+{
+	size_t i = 0;
+
+	if (channels == 2)
+	{
+#if defined(LOVE_SOUNDDATA_SIMD_SSE2)
+		for (; i + 4 <= frames; i += 4)
+		{
+			__m128 l = _mm_loadu_ps(src[0] + i);
+			__m128 r = _mm_loadu_ps(src[1] + i);
+			_mm_storeu_ps(dst + i * 2, _mm_unpacklo_ps(l, r));
+			_mm_storeu_ps(dst + i * 2 + 4, _mm_unpackhi_ps(l, r));
+		}
+#elif defined(LOVE_SOUNDDATA_SIMD_NEON)
+		for (; i + 4 <= frames; i += 4)
+		{
+			float32x4x2_t v;
+			v.val[0] = vld1q_f32(src[0] + i);
+			v.val[1] = vld1q_f32(src[1] + i);
+			vst2q_f32(dst + i * 2, v);
+		}
+#endif
+	}
+
+	for (; i < frames; i++)
+	{
+		for (int c = 0; c < channels; c++)
+			dst[i * channels + c] = src[c][i];
+	}
+}
+
+static void remapChannels(const float *src, int srcChannels, float *dst, int dstChannels, size_t frames)
+{
+	if (srcChannels == 1)
+	{
+		// Mono goes to every channel.
+		std::vector<const float *> planes(dstChannels, src);
+		interleave(planes.data(), dstChannels, frames, dst);
+	}
+	else if (dstChannels == 1)
+	{
+		// Every channel is averaged into mono.
+		float scale = 1.0f / srcChannels;
+		for (size_t i = 0; i < frames; i++)
+		{
+			float sum = 0.0f;
+			for (int c = 0; c < srcChannels; c++)
+				sum += src[i * srcChannels + c];
+			dst[i] = sum * scale;
+		}
+	}
+	else
+	{
+		for (size_t i = 0; i < frames; i++)
+		{
+			for (int c = 0; c < dstChannels; c++)
+				dst[i * dstChannels + c] = c < srcChannels ? src[i * srcChannels + c] : 0.0f;
+		}
+	}
+}
+
+// Windowed sinc resampling filter, with precomputed kernels for a number of
+// fractional positions between input samples.
+static const int RESAMPLE_TAPS = 32;
+static const int RESAMPLE_PHASES = 256;
+
+static std::vector<float> getResampleKernels(int fromRate, int toRate)
+{
+	// When downsampling, frequencies the new rate can't represent are
+	// filtered out.
+	double cutoff = std::min(1.0, (double) toRate / (double) fromRate);
+	const int half = RESAMPLE_TAPS / 2;
+
+	std::vector<float> kernels((RESAMPLE_PHASES + 1) * RESAMPLE_TAPS);
+
+	for (int p = 0; p <= RESAMPLE_PHASES; p++)
+	{
+		double frac = (double) p / (double) RESAMPLE_PHASES;
+		float *k = &kernels[p * RESAMPLE_TAPS];
+		double sum = 0.0;
+
+		for (int t = 0; t < RESAMPLE_TAPS; t++)
+		{
+			double x = t - half + 1 - frac;
+			double sinc = x == 0.0 ? 1.0 : std::sin(LOVE_M_PI * cutoff * x) / (LOVE_M_PI * cutoff * x);
+			double window = 0.42 + 0.5 * std::cos(LOVE_M_PI * x / half) + 0.08 * std::cos(2.0 * LOVE_M_PI * x / half);
+			k[t] = (float) (sinc * window);
+			sum += k[t];
+		}
+
+		// Unity gain at DC.
+		for (int t = 0; t < RESAMPLE_TAPS; t++)
+			k[t] = (float) (k[t] / sum);
+	}
+
+	return kernels;
+}
+
+static inline float applyKernel(const float *kernel, const float *src)
+{
+#if defined(LOVE_SOUNDDATA_SIMD_SSE2)
+	__m128 sum = _mm_setzero_ps();
+	for (int t = 0; t < RESAMPLE_TAPS; t += 4)
+		sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(kernel + t), _mm_loadu_ps(src + t)));
+	sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+	sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+	return _mm_cvtss_f32(sum);
+#elif defined(LOVE_SOUNDDATA_SIMD_NEON)
+	float32x4_t sum = vdupq_n_f32(0.0f);
+	for (int t = 0; t < RESAMPLE_TAPS; t += 4)
+		sum = vmlaq_f32(sum, vld1q_f32(kernel + t), vld1q_f32(src + t));
+	return vaddvq_f32(sum);
+#else
+	float sum = 0.0f;
+	for (int t = 0; t < RESAMPLE_TAPS; t++)
+		sum += kernel[t] * src[t];
+	return sum;
+#endif
+}
+
 love::Type SoundData::type("SoundData", &Data::type);
 
 SoundData::SoundData(Decoder *decoder)
@@ -274,9 +583,10 @@ void SoundData::copyFrom(const SoundData *src, int srcStart, int count, int dstS
 
 	if (bitDepth != src->bitDepth)
 	{
-		// Bit depth mismatch, use get/setSample at loop
-		for (int i = 0; i < count * channels; i++)
-			setSample(dstStart * channels + i, src->getSample(srcStart * channels + i));
+		// Bit depth mismatch, convert through floats.
+		std::vector<float> samples((size_t) count * channels);
+		samplesToFloat(src->data + srcStart * srcBytesPerSample, src->bitDepth, samples.data(), samples.size());
+		samplesFromFloat(samples.data(), data + dstStart * bytesPerSample, bitDepth, samples.size());
 	}
 	else if (this->data == src->data)
 		// May overlap, use memmove
@@ -300,5 +610,87 @@ SoundData *SoundData::slice(int start, int length) const
 	return new SoundData(data + start * channels * bitDepth/8, length, sampleRate, bitDepth, channels);
 }
 
+SoundData *SoundData::resample(int newSampleRate) const
+{
+	if (newSampleRate <= 0)
+		throw love::Exception("Invalid sample rate: %d", newSampleRate);
+
+	if (newSampleRate == sampleRate)
+		return clone();
+
+	int frames = getSampleCount();
+	int64 newFrames = ((int64) frames * newSampleRate + sampleRate - 1) / sampleRate;
+	if (newFrames > std::numeric_limits<int>::max() / channels)
+		throw love::Exception("Data is too big!");
+
+	newFrames = std::max<int64>(newFrames, 1);
+
+	const int half = RESAMPLE_TAPS / 2;
+
+	std::vector<float> interleaved((size_t) frames * channels);
+	samplesToFloat(data, bitDepth, interleaved.data(), interleaved.size());
+
+	// Each channel is padded with silence, so the filter never reads outside
+	// of it.
+	size_t paddedFrames = (size_t) frames + RESAMPLE_TAPS + 1;
+	std::vector<float> input(paddedFrames * channels, 0.0f);
+	std::vector<float *> inputPlanes(channels);
+	for (int c = 0; c < channels; c++)
+		inputPlanes[c] = &input[c * paddedFrames + half];
+
+	deinterleave(interleaved.data(), channels, frames, inputPlanes.data());
+
+	std::vector<float> output((size_t) newFrames * channels);
+	std::vector<float *> outputPlanes(channels);
+	for (int c = 0; c < channels; c++)
+		outputPlanes[c] = &output[c * newFrames];
+
+	std::vector<float> kernels = getResampleKernels(sampleRate, newSampleRate);
+
+	for (int64 i = 0; i < newFrames; i++)
+	{
+		// Position in the input, as a whole sample and a fraction of one.
+		int64 position = i * sampleRate;
+		int64 whole = position / newSampleRate;
+		int64 phase = ((position % newSampleRate) * RESAMPLE_PHASES + newSampleRate / 2) / newSampleRate;
+
+		const float *kernel = &kernels[phase * RESAMPLE_TAPS];
+		for (int c = 0; c < channels; c++)
+			outputPlanes[c][i] = applyKernel(kernel, inputPlanes[c] + whole - half + 1);
+	}
+
+	interleaved.resize(output.size());
+	interleave(outputPlanes.data(), channels, (size_t) newFrames, interleaved.data());
+
+	SoundData *resampled = new SoundData((int) newFrames, newSampleRate, bitDepth, channels);
+	samplesFromFloat(interleaved.data(), resampled->data, bitDepth, interleaved.size());
+	return resampled;
+}
+
+SoundData *SoundData::convert(int newBitDepth, int newChannels) const
+{
+	if (newBitDepth != 8 && newBitDepth != 16)
+		throw love::Exception("Invalid bit depth: %d", newBitDepth);
+
+	if (newChannels <= 0)
+		throw love::Exception("Invalid channel count: %d", newChannels);
+
+	int frames = getSampleCount();
+
+	std::vector<float> samples((size_t) frames * channels);
+	samplesToFloat(data, bitDepth, samples.data(), samples.size());
+
+	if (newChannels != channels)
+	{
+		std::vector<float> remapped((size_t) frames * newChannels);
+		remapChannels(samples.data(), channels, remapped.data(), newChannels, frames);
+		samples.swap(remapped);
+	}
+
+	SoundData *converted = new SoundData(frames, sampleRate, newBitDepth, newChannels);
+	samplesFromFloat(samples.data(), converted->data, newBitDepth, samples.size());
+	return converted;
+}
+
 } // sound
 } // love
@@ -64,6 +64,20 @@ class SoundData : public love::Data
 	void copyFrom(const SoundData *src, int srcStart, int count, int dstStart);
 	SoundData *slice(int start, int length = -1) const;
 
+	/**
+	 * Creates a new SoundData with the same audio at a different sample rate,
+	 * using a windowed sinc filter.
+	 **/
+	SoundData *resample(int sampleRate) const;
+
+	/**
+	 * Creates a new SoundData with the same audio in a different bit depth
+	 * and/or channel count. Mono is copied to every channel, and every
+	 * channel is averaged into mono. Other channel count changes keep the
+	 * channels both layouts share and silence the rest.
+	 **/
+	SoundData *convert(int bitDepth, int channels) const;
+
 private:
 
 	void load(int samples, int sampleRate, int bitDepth, int channels, const void *newData = 0);
@@ -134,7 +134,13 @@ drmp3_bool32 MP3Decoder::onSeek(void *pUserData, int offset, drmp3_seek_origin o
 }
 
 MP3Decoder::MP3Decoder(Stream *stream, int bufferSize)
+: MP3Decoder(stream, bufferSize, nullptr)
+{
+}
+
+MP3Decoder::MP3Decoder(Stream *stream, int bufferSize, SeekTable *table)
 : Decoder(stream, bufferSize)
+, seekTable(table)
 {
 	// Check for possible ID3 tag and skip it if necessary.
 	offset = findFirstValidHeader(stream);
@@ -147,26 +153,32 @@ MP3Decoder::MP3Decoder(Stream *stream, int bufferSize)
 
 	sampleRate = mp3.sampleRate;
 
-	// calculate duration
-	drmp3_uint64 pcmCount, mp3FrameCount;
-	if (!drmp3_get_mp3_and_pcm_frame_count(&mp3, &mp3FrameCount, &pcmCount))
+	if (seekTable.get() == nullptr)
 	{
-		drmp3_uninit(&mp3);
-		throw love::Exception("Could not calculate mp3 duration.");
-	}
-	duration = ((double) pcmCount) / ((double) mp3.sampleRate);
+		seekTable.set(new SeekTable(), Acquire::NORETAIN);
 
-	// create seek table
-	drmp3_uint32 mp3FrameInt = (drmp3_uint32) mp3FrameCount;
-	seekTable.resize((size_t) mp3FrameCount, {0ULL, 0ULL, 0, 0});
-	if (!drmp3_calculate_seek_points(&mp3, &mp3FrameInt, seekTable.data()))
-	{
-		drmp3_uninit(&mp3);
-		throw love::Exception("Could not calculate mp3 seek table");
+		// calculate duration
+		drmp3_uint64 pcmCount, mp3FrameCount;
+		if (!drmp3_get_mp3_and_pcm_frame_count(&mp3, &mp3FrameCount, &pcmCount))
+		{
+			drmp3_uninit(&mp3);
+			throw love::Exception("Could not calculate mp3 duration.");
+		}
+		seekTable->duration = ((double) pcmCount) / ((double) mp3.sampleRate);
+
+		// create seek table
+		drmp3_uint32 mp3FrameInt = (drmp3_uint32) mp3FrameCount;
+		seekTable->points.resize((size_t) mp3FrameCount, {0ULL, 0ULL, 0, 0});
+		if (!drmp3_calculate_seek_points(&mp3, &mp3FrameInt, seekTable->points.data()))
+		{
+			drmp3_uninit(&mp3);
+			throw love::Exception("Could not calculate mp3 seek table");
+		}
+		seekTable->points.resize(mp3FrameInt);
 	}
 
 	// bind seek table
-	if (!drmp3_bind_seek_table(&mp3, mp3FrameInt, seekTable.data()))
+	if (!drmp3_bind_seek_table(&mp3, (drmp3_uint32) seekTable->points.size(), seekTable->points.data()))
 	{
 		drmp3_uninit(&mp3);
 		throw love::Exception("Could not bind mp3 seek table");
@@ -181,7 +193,7 @@ MP3Decoder::~MP3Decoder()
 love::sound::Decoder *MP3Decoder::clone()
 {
 	StrongRef<Stream> s(stream->clone(), Acquire::NORETAIN);
-	return new MP3Decoder(s, bufferSize);
+	return new MP3Decoder(s, bufferSize, seekTable);
 }
 
 int MP3Decoder::decode()
@@ -229,7 +241,7 @@ int MP3Decoder::getBitDepth() const
 
 double MP3Decoder::getDuration()
 {
-	return duration;
+	return seekTable->duration;
 }
 
 } // lullaby
@@ -54,17 +54,27 @@ class MP3Decoder: public love::sound::Decoder
 	double getDuration() override;
 
 private:
+
+	// Building the seek table scans the whole file, so it's done once and
+	// shared with clones of the decoder.
+	class SeekTable : public Object
+	{
+	public:
+		std::vector<drmp3_seek_point> points;
+		double duration = 0.0;
+	};
+
+	MP3Decoder(Stream *stream, int bufsize, SeekTable *seekTable);
+
 	static size_t onRead(void *pUserData, void *pBufferOut, size_t bytesToRead);
 	static drmp3_bool32 onSeek(void *pUserData, int offset, drmp3_seek_origin origin);
 
 	// MP3 handle
 	drmp3 mp3;
 	// Used for fast seeking
-	std::vector<drmp3_seek_point> seekTable;
+	StrongRef<SeekTable> seekTable;
 	// Position of first MP3 frame found
 	int64 offset;
-
-	double duration;
 }; // MP3Decoder
 
 } // lullaby
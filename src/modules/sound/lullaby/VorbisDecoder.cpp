@@ -21,6 +21,7 @@
 #include "VorbisDecoder.h"
 
 #include <string.h>
+#include <algorithm>
 #include "common/config.h"
 #include "common/Exception.h"
 
@@ -76,8 +77,14 @@ static long vorbisTell(void *datasource)
  **/
 
 VorbisDecoder::VorbisDecoder(Stream *stream, int bufferSize)
+	: VorbisDecoder(stream, bufferSize, nullptr)
+{
+}
+
+VorbisDecoder::VorbisDecoder(Stream *stream, int bufferSize, SeekIndex *seekIndex)
 	: Decoder(stream, bufferSize)
 	, duration(-2.0)
+	, seekIndex(seekIndex)
 {
 	ov_callbacks callbacks = {};
 	callbacks.close_func = vorbisClose;
@@ -90,6 +97,15 @@ VorbisDecoder::VorbisDecoder(Stream *stream, int bufferSize)
 		throw love::Exception("Could not read Ogg bitstream");
 
 	vorbisInfo = ov_info(&handle, -1);
+
+	// Chained files have several sets of granule positions, which the index
+	// doesn't handle. Those use libvorbisfile's own seeking.
+	if (seekIndex.get() == nullptr && ov_seekable(&handle) && ov_streams(&handle) == 1)
+	{
+		seekIndex.set(new SeekIndex(), Acquire::NORETAIN);
+		if (!buildSeekIndex())
+			seekIndex.set(nullptr);
+	}
 }
 
 VorbisDecoder::~VorbisDecoder()
@@ -100,7 +116,7 @@ VorbisDecoder::~VorbisDecoder()
 love::sound::Decoder *VorbisDecoder::clone()
 {
 	StrongRef<Stream> s(stream->clone(), Acquire::NORETAIN);
-	return new VorbisDecoder(s, bufferSize);
+	return new VorbisDecoder(s, bufferSize, seekIndex);
 }
 
 int VorbisDecoder::decode()
@@ -133,6 +149,119 @@ int VorbisDecoder::decode()
 	return size;
 }
 
+bool VorbisDecoder::buildSeekIndex()
+{
+	long serial = ov_serialnumber(&handle, 0);
+	int64 position = stream->tell();
+	int64 offset = 0;
+
+	if (!stream->seek(0, Stream::SEEKORIGIN_BEGIN))
+		return false;
+
+	bool success = true;
+
+	// Only the page headers are read, page bodies are skipped over.
+	while (true)
+	{
+		uint8 header[27];
+		uint8 segments[255];
+
+		int64 read = stream->read(header, sizeof(header));
+		if (read == 0)
+			break;
+
+		if (read < (int64) sizeof(header) || memcmp(header, "OggS", 4) != 0)
+		{
+			success = false;
+			break;
+		}
+
+		int segmentCount = header[26];
+		if (stream->read(segments, segmentCount) < segmentCount)
+		{
+			success = false;
+			break;
+		}
+
+		int64 bodySize = 0;
+		for (int i = 0; i < segmentCount; i++)
+			bodySize += segments[i];
+
+		ogg_int64_t granule = 0;
+		for (int i = 7; i >= 0; i--)
+			granule = (granule << 8) | header[6 + i];
+
+		long pageSerial = (long) ((uint32) header[14] | ((uint32) header[15] << 8) | ((uint32) header[16] << 16) | ((uint32) header[17] << 24));
+
+		// Pages where no packet ends have a granule position of -1.
+		if (pageSerial == serial && granule >= 0)
+			seekIndex->pages.push_back({granule, offset});
+
+		offset += sizeof(header) + segmentCount + bodySize;
+
+		if (!stream->seek(bodySize, Stream::SEEKORIGIN_CURRENT))
+		{
+			success = false;
+			break;
+		}
+	}
+
+	// libvorbisfile expects the stream to be where it left it.
+	if (!stream->seek(position, Stream::SEEKORIGIN_BEGIN))
+		throw love::Exception("Could not read Ogg bitstream");
+
+	return success && !seekIndex->pages.empty();
+}
+
+bool VorbisDecoder::seekIndexed(ogg_int64_t sample)
+{
+	const auto &pages = seekIndex->pages;
+
+	// Granule positions in the file are offset by the first sample's.
+	ogg_int64_t granule = sample + handle.pcmlengths[0];
+
+	// The first page which ends at or after the target. Decoding starts one
+	// page before the one preceding it, so the overlapping packet at the page
+	// boundary is complete.
+	auto it = std::lower_bound(pages.begin(), pages.end(), granule, [](const SeekIndex::Page &p, ogg_int64_t g)
+	{
+		return p.granule < g;
+	});
+
+	ptrdiff_t index = (it - pages.begin()) - 2;
+	int64 offset = index >= 0 ? pages[index].offset : 0;
+
+	if (ov_raw_seek(&handle, offset) != 0)
+		return false;
+
+	ogg_int64_t position = ov_pcm_tell(&handle);
+	if (position < 0 || position > sample)
+		return ov_pcm_seek(&handle, sample) == 0;
+
+#ifdef LOVE_BIG_ENDIAN
+	int endian = 1;
+#else
+	int endian = 0;
+#endif
+
+	// Decode and throw away samples up to the target.
+	int frameSize = vorbisInfo->channels * 2;
+	while (position < sample)
+	{
+		int size = (int) std::min<int64>((sample - position) * frameSize, bufferSize);
+		long result = ov_read(&handle, (char *) buffer, size, endian, 2, 1, 0);
+
+		if (result == OV_HOLE)
+			continue;
+		else if (result <= 0)
+			return false;
+
+		position += result / frameSize;
+	}
+
+	return true;
+}
+
 bool VorbisDecoder::seek(double s)
 {
 	int result = 0;
@@ -141,6 +270,8 @@ bool VorbisDecoder::seek(double s)
 	// a bug in libvorbis <= 1.3.4 when seeking to PCM 0 in multiplexed streams.
 	if (s <= 0.000001)
 		result = ov_raw_seek(&handle, 0);
+	else if (seekIndex.get() != nullptr)
+		result = seekIndexed((ogg_int64_t) (s * vorbisInfo->rate)) ? 0 : -1;
 	else
 		result = ov_time_seek(&handle, s);
 
@@ -26,6 +26,9 @@
 #include "common/int.h"
 #include "sound/Decoder.h"
 
+// STD
+#include <vector>
+
 // vorbis
 #define OV_EXCLUDE_STATIC_CALLBACKS
 #include <vorbis/codec.h>
@@ -57,10 +60,32 @@ class VorbisDecoder : public Decoder
 
 private:
 
+	// Byte offsets of the Ogg pages in the file, by the granule position
+	// (sample) each page ends on. Built once per file and shared with clones
+	// of the decoder, so seeks don't need to bisect the file.
+	class SeekIndex : public Object
+	{
+	public:
+		struct Page
+		{
+			ogg_int64_t granule;
+			int64 offset;
+		};
+
+		std::vector<Page> pages;
+	};
+
+	VorbisDecoder(Stream *stream, int bufferSize, SeekIndex *seekIndex);
+
+	bool buildSeekIndex();
+	bool seekIndexed(ogg_int64_t sample);
+
 	OggVorbis_File handle;
 	vorbis_info *vorbisInfo;
 	double duration;
 
+	StrongRef<SeekIndex> seekIndex;
+
 }; // VorbisDecoder
 
 } // lullaby
@@ -146,6 +146,29 @@ int w_SoundData_slice(lua_State *L)
 	return 1;
 }
 
+int w_SoundData_resample(lua_State *L)
+{
+	SoundData *t = luax_checksounddata(L, 1), *c = nullptr;
+	int sampleRate = (int) luaL_checkinteger(L, 2);
+
+	luax_catchexcept(L, [&](){ c = t->resample(sampleRate); });
+	luax_pushtype(L, c);
+	c->release();
+	return 1;
+}
+
+int w_SoundData_convert(lua_State *L)
+{
+	SoundData *t = luax_checksounddata(L, 1), *c = nullptr;
+	int bitDepth = (int) luaL_optinteger(L, 2, t->getBitDepth());
+	int channels = (int) luaL_optinteger(L, 3, t->getChannelCount());
+
+	luax_catchexcept(L, [&](){ c = t->convert(bitDepth, channels); });
+	luax_pushtype(L, c);
+	c->release();
+	return 1;
+}
+
 static const luaL_Reg w_SoundData_functions[] =
 {
 	{ "clone", w_SoundData_clone },
@@ -158,6 +181,8 @@ static const luaL_Reg w_SoundData_functions[] =
 	{ "getSample", w_SoundData_getSample },
 	{ "copyFrom", w_SoundData_copyFrom },
 	{ "slice", w_SoundData_slice },
+	{ "resample", w_SoundData_resample },
+	{ "convert", w_SoundData_convert },
 
 	{ 0, 0 }
 };
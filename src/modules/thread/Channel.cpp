@@ -19,6 +19,7 @@
  **/
 
 #include "Channel.h"
+#include "common/Exception.h"
 
 #include <timer/Timer.h>
 
@@ -30,17 +31,172 @@ namespace thread
 love::Type Channel::type("Channel", &Object::type);
 
 Channel::Channel()
-	: sent(0)
+	: cells(nullptr)
+	, cellMask(0)
+	, enqueuePos(0)
+	, dequeuePos(0)
+	, waiters(0)
+	, sent(0)
 	, received(0)
 {
 }
 
+Channel::Channel(int capacity)
+	: Channel()
+{
+	if (capacity <= 0)
+		throw love::Exception("Channel capacity must be greater than 0.");
+
+	uint64 size = 1;
+	while (size < (uint64) capacity)
+		size <<= 1;
+
+	cells = new Cell[size];
+	cellMask = size - 1;
+
+	for (uint64 i = 0; i < size; i++)
+		cells[i].sequence.store(i, std::memory_order_relaxed);
+}
+
 Channel::~Channel()
 {
+	delete[] cells;
+}
+
+// The lock-free ring buffer is a bounded multi-producer/multi-consumer queue.
+// Each cell's sequence number says whether it's ready to be written to or
+// read from at a given position, so producers and consumers only contend on
+// the position they claim.
+
+bool Channel::tryPushLockFree(const Variant &var, uint64 &id)
+{
+	Cell *cell = nullptr;
+	uint64 pos = enqueuePos.load(std::memory_order_relaxed);
+
+	while (true)
+	{
+		cell = &cells[pos & cellMask];
+		uint64 seq = cell->sequence.load(std::memory_order_acquire);
+		int64 diff = (int64) seq - (int64) pos;
+
+		if (diff == 0)
+		{
+			if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+			return false; // Full.
+		else
+			pos = enqueuePos.load(std::memory_order_relaxed);
+	}
+
+	cell->value = var;
+	cell->sequence.store(pos + 1, std::memory_order_release);
+
+	id = pos + 1;
+	return true;
+}
+
+bool Channel::tryPopLockFree(Variant *var)
+{
+	Cell *cell = nullptr;
+	uint64 pos = dequeuePos.load(std::memory_order_relaxed);
+
+	while (true)
+	{
+		cell = &cells[pos & cellMask];
+		uint64 seq = cell->sequence.load(std::memory_order_acquire);
+		int64 diff = (int64) seq - (int64) (pos + 1);
+
+		if (diff == 0)
+		{
+			if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+			return false; // Empty.
+		else
+			pos = dequeuePos.load(std::memory_order_relaxed);
+	}
+
+	*var = cell->value;
+	cell->value = Variant();
+	cell->sequence.store(pos + cellMask + 1, std::memory_order_release);
+
+	received++;
+	return true;
+}
+
+template <typename T>
+bool Channel::waitLockFree(const T &condition, double timeout)
+{
+	if (condition())
+		return true;
+
+	Lock l(mutex);
+
+	// Pairs with the fence in notifyLockFree: either the condition below sees
+	// the other thread's change, or that thread sees this one waiting.
+	waiters++;
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	bool result = false;
+
+	while (true)
+	{
+		if (condition())
+		{
+			result = true;
+			break;
+		}
+
+		if (timeout < 0)
+		{
+			cond->wait(mutex);
+			continue;
+		}
+
+		double start = love::timer::Timer::getTime();
+		cond->wait(mutex, timeout*1000);
+		double stop = love::timer::Timer::getTime();
+
+		timeout -= (stop-start);
+
+		if (timeout < 0)
+		{
+			result = condition();
+			break;
+		}
+	}
+
+	waiters--;
+	return result;
+}
+
+void Channel::notifyLockFree()
+{
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	if (waiters.load(std::memory_order_relaxed) > 0)
+	{
+		Lock l(mutex);
+		cond->broadcast();
+	}
+}
+
+uint64 Channel::pushLockFree(const Variant &var)
+{
+	uint64 id = 0;
+	waitLockFree([&]() { return tryPushLockFree(var, id); }, -1.0);
+	notifyLockFree();
+	return id;
 }
 
 uint64 Channel::push(const Variant &var)
 {
+	if (isLockFree())
+		return pushLockFree(var);
+
 	Lock l(mutex);
 
 	queue.push(var);
@@ -49,8 +205,45 @@ uint64 Channel::push(const Variant &var)
 	return ++sent;
 }
 
+uint64 Channel::pushMany(const std::vector<Variant> &vars)
+{
+	if (isLockFree())
+	{
+		uint64 id = 0;
+		for (const Variant &var : vars)
+		{
+			if (tryPushLockFree(var, id))
+				continue;
+
+			// Wake consumers of what has been pushed so far before blocking
+			// on a full channel.
+			notifyLockFree();
+			waitLockFree([&]() { return tryPushLockFree(var, id); }, -1.0);
+		}
+
+		notifyLockFree();
+		return id;
+	}
+
+	Lock l(mutex);
+
+	for (const Variant &var : vars)
+		queue.push(var);
+
+	sent += vars.size();
+	cond->broadcast();
+
+	return sent;
+}
+
 bool Channel::supply(const Variant &var)
 {
+	if (isLockFree())
+	{
+		uint64 id = pushLockFree(var);
+		return waitLockFree([&]() { return received >= id; }, -1.0);
+	}
+
 	Lock l(mutex);
 	uint64 id = push(var);
 
@@ -62,6 +255,12 @@ bool Channel::supply(const Variant &var)
 
 bool Channel::supply(const Variant &var, double timeout)
 {
+	if (isLockFree())
+	{
+		uint64 id = pushLockFree(var);
+		return waitLockFree([&]() { return received >= id; }, std::max(timeout, 0.0));
+	}
+
 	Lock l(mutex);
 	uint64 id = push(var);
 
@@ -82,6 +281,15 @@ bool Channel::supply(const Variant &var, double timeout)
 
 bool Channel::pop(Variant *var)
 {
+	if (isLockFree())
+	{
+		if (!tryPopLockFree(var))
+			return false;
+
+		notifyLockFree();
+		return true;
+	}
+
 	Lock l(mutex);
 
 	if (queue.empty())
@@ -96,8 +304,52 @@ bool Channel::pop(Variant *var)
 	return true;
 }
 
+int Channel::popMany(std::vector<Variant> &vars, int max)
+{
+	int count = 0;
+
+	if (isLockFree())
+	{
+		Variant var;
+		while (count < max && tryPopLockFree(&var))
+		{
+			vars.push_back(var);
+			count++;
+		}
+
+		if (count > 0)
+			notifyLockFree();
+
+		return count;
+	}
+
+	Lock l(mutex);
+
+	while (count < max && !queue.empty())
+	{
+		vars.push_back(queue.front());
+		queue.pop();
+		count++;
+	}
+
+	if (count > 0)
+	{
+		received += count;
+		cond->broadcast();
+	}
+
+	return count;
+}
+
 bool Channel::demand(Variant *var)
 {
+	if (isLockFree())
+	{
+		waitLockFree([&]() { return tryPopLockFree(var); }, -1.0);
+		notifyLockFree();
+		return true;
+	}
+
 	Lock l(mutex);
 
 	while (!pop(var))
@@ -108,6 +360,15 @@ bool Channel::demand(Variant *var)
 
 bool Channel::demand(Variant *var, double timeout)
 {
+	if (isLockFree())
+	{
+		if (!waitLockFree([&]() { return tryPopLockFree(var); }, std::max(timeout, 0.0)))
+			return false;
+
+		notifyLockFree();
+		return true;
+	}
+
 	Lock l(mutex);
 
 	while (timeout >= 0)
@@ -127,6 +388,10 @@ bool Channel::demand(Variant *var, double timeout)
 
 bool Channel::peek(Variant *var)
 {
+	// Another thread could pop the value while it's being copied.
+	if (isLockFree())
+		throw love::Exception("peek cannot be used with lock-free Channels.");
+
 	Lock l(mutex);
 
 	if (queue.empty())
@@ -138,18 +403,47 @@ bool Channel::peek(Variant *var)
 
 int Channel::getCount() const
 {
+	if (isLockFree())
+	{
+		uint64 dequeued = dequeuePos.load(std::memory_order_relaxed);
+		uint64 enqueued = enqueuePos.load(std::memory_order_relaxed);
+		return enqueued > dequeued ? (int) (enqueued - dequeued) : 0;
+	}
+
 	Lock l(mutex);
 	return (int) queue.size();
 }
 
+int Channel::getCapacity() const
+{
+	return isLockFree() ? (int) (cellMask + 1) : 0;
+}
+
 bool Channel::hasRead(uint64 id) const
 {
+	if (isLockFree())
+		return received >= id;
+
 	Lock l(mutex);
 	return received >= id;
 }
 
 void Channel::clear()
 {
+	if (isLockFree())
+	{
+		// Popping everything also finishes all the supply waits.
+		Variant var;
+		bool popped = false;
+		while (tryPopLockFree(&var))
+			popped = true;
+
+		if (popped)
+			notifyLockFree();
+
+		return;
+	}
+
 	Lock l(mutex);
 
 	// We're already empty.
@@ -160,7 +454,7 @@ void Channel::clear()
 		queue.pop();
 
 	// Finish all the supply waits
-	received = sent;
+	received = sent.load();
 	cond->broadcast();
 }
 
@@ -23,6 +23,8 @@
 
 // STL
 #include <queue>
+#include <vector>
+#include <atomic>
 
 // LOVE
 #include "common/Variant.h"
@@ -41,12 +43,22 @@ class Channel : public love::Object
 	static love::Type type;
 
 	Channel();
+
+	/**
+	 * Creates a Channel backed by a lock-free ring buffer which holds at most
+	 * 'capacity' values, rounded up to a power of two. Pushing to a full
+	 * lock-free Channel waits until there is room for the value.
+	 **/
+	Channel(int capacity);
+
 	~Channel();
 
 	uint64 push(const Variant &var);
+	uint64 pushMany(const std::vector<Variant> &vars);
 	bool supply(const Variant &var); // blocking push
 	bool supply(const Variant &var, double timeout);
 	bool pop(Variant *var);
+	int popMany(std::vector<Variant> &vars, int max);
 	bool demand(Variant *var); // blocking pop
 	bool demand(Variant *var, double timeout); // blocking pop
 	bool peek(Variant *var);
@@ -54,17 +66,41 @@ class Channel : public love::Object
 	bool hasRead(uint64 id) const;
 	void clear();
 
+	bool isLockFree() const { return cells != nullptr; }
+	int getCapacity() const;
+
 	void lockMutex();
 	void unlockMutex();
 
 private:
 
+	struct Cell
+	{
+		std::atomic<uint64> sequence;
+		Variant value;
+	};
+
+	bool tryPushLockFree(const Variant &var, uint64 &id);
+	bool tryPopLockFree(Variant *var);
+	uint64 pushLockFree(const Variant &var);
+	template <typename T>
+	bool waitLockFree(const T &condition, double timeout);
+	void notifyLockFree();
+
 	MutexRef mutex;
 	ConditionalRef cond;
 	std::queue<Variant> queue;
 
-	uint64 sent;
-	uint64 received;
+	// Only used by lock-free Channels. The mutex and condition variable are
+	// then only used to sleep while the Channel is empty or full.
+	Cell *cells;
+	uint64 cellMask;
+	alignas(64) std::atomic<uint64> enqueuePos;
+	alignas(64) std::atomic<uint64> dequeuePos;
+	std::atomic<int> waiters;
+
+	std::atomic<uint64> sent;
+	std::atomic<uint64> received;
 
 }; // Channel
 
@@ -40,6 +40,11 @@ Channel *ThreadModule::newChannel()
 	return new Channel();
 }
 
+Channel *ThreadModule::newChannel(int capacity)
+{
+	return new Channel(capacity);
+}
+
 Channel *ThreadModule::getChannel(const std::string &name)
 {
 	Lock lock(namedChannelMutex);
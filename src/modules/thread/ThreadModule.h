@@ -47,6 +47,7 @@ class ThreadModule : public love::Module
 	virtual ~ThreadModule() {}
 	virtual LuaThread *newThread(const std::string &name, love::Data *data);
 	virtual Channel *newChannel();
+	virtual Channel *newChannel(int capacity);
 	virtual Channel *getChannel(const std::string &name);
 
 private:
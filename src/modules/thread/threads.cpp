@@ -20,6 +20,10 @@
 
 #include "threads.h"
 
+// STD
+#include <algorithm>
+#include <thread>
+
 #if defined(LOVE_LINUX)
 #include <signal.h>
 #endif
@@ -157,6 +161,13 @@ Conditional *ConditionalRef::operator->() const
 	return conditional;
 }
 
+int getWorkerThreadCount(int max)
+{
+	// Leave a core for the main thread, but always have at least one worker.
+	int cores = (int) std::thread::hardware_concurrency();
+	return std::min(std::max(cores - 1, 1), max);
+}
+
 #if defined(LOVE_LINUX)
 static sigset_t oldset;
 
@@ -129,6 +129,12 @@ Mutex *newMutex();
 Conditional *newConditional();
 Thread *newThread(Threadable *t);
 
+/**
+ * Gets how many worker threads a pool of background workers should use:
+ * one less than the number of CPU cores, between 1 and max.
+ **/
+int getWorkerThreadCount(int max);
+
 #if defined(LOVE_LINUX)
 void disableSignals();
 void reenableSignals();
@@ -43,6 +43,30 @@ int w_Channel_push(lua_State *L)
 	return 1;
 }
 
+int w_Channel_pushMany(lua_State *L)
+{
+	Channel *c = luax_checkchannel(L, 1);
+	luaL_checktype(L, 2, LUA_TTABLE);
+
+	int count = (int) luax_objlen(L, 2);
+	std::vector<Variant> vars;
+	vars.reserve(count);
+
+	for (int i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, 2, i);
+		luax_catchexcept(L, [&]() { vars.push_back(luax_checkvariant(L, -1)); });
+		if (vars.back().getType() == Variant::UNKNOWN)
+			return luaL_error(L, "Invalid value at index %d: boolean, number, string, love type, or table expected.", i);
+		lua_pop(L, 1);
+	}
+
+	uint64 id = 0;
+	luax_catchexcept(L, [&]() { id = c->pushMany(vars); });
+	lua_pushnumber(L, (lua_Number) id);
+	return 1;
+}
+
 int w_Channel_supply(lua_State *L)
 {
 	Channel *c = luax_checkchannel(L, 1);
@@ -72,6 +96,24 @@ int w_Channel_pop(lua_State *L)
 	return 1;
 }
 
+int w_Channel_popMany(lua_State *L)
+{
+	Channel *c = luax_checkchannel(L, 1);
+	int max = (int) luaL_optinteger(L, 2, LOVE_INT32_MAX);
+
+	std::vector<Variant> vars;
+	c->popMany(vars, max);
+
+	lua_createtable(L, (int) vars.size(), 0);
+	for (int i = 0; i < (int) vars.size(); i++)
+	{
+		luax_pushvariant(L, vars[i]);
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 1;
+}
+
 int w_Channel_demand(lua_State *L)
 {
 	Channel *c = luax_checkchannel(L, 1);
@@ -94,7 +136,9 @@ int w_Channel_peek(lua_State *L)
 {
 	Channel *c = luax_checkchannel(L, 1);
 	Variant var;
-	if (c->peek(&var))
+	bool result = false;
+	luax_catchexcept(L, [&]() { result = c->peek(&var); });
+	if (result)
 		luax_pushvariant(L, var);
 	else
 		lua_pushnil(L);
@@ -108,6 +152,20 @@ int w_Channel_getCount(lua_State *L)
 	return 1;
 }
 
+int w_Channel_getCapacity(lua_State *L)
+{
+	Channel *c = luax_checkchannel(L, 1);
+	lua_pushinteger(L, c->getCapacity());
+	return 1;
+}
+
+int w_Channel_isLockFree(lua_State *L)
+{
+	Channel *c = luax_checkchannel(L, 1);
+	luax_pushboolean(L, c->isLockFree());
+	return 1;
+}
+
 int w_Channel_hasRead(lua_State *L)
 {
 	Channel *c = luax_checkchannel(L, 1);
@@ -128,6 +186,9 @@ int w_Channel_performAtomic(lua_State *L)
 	Channel *c = luax_checkchannel(L, 1);
 	luaL_checktype(L, 2, LUA_TFUNCTION);
 
+	if (c->isLockFree())
+		return luaL_error(L, "performAtomic cannot be used with lock-free Channels.");
+
 	// Pass this channel as an argument to the function.
 	lua_pushvalue(L, 1);
 	lua_insert(L, 3);
@@ -153,11 +214,15 @@ int w_Channel_performAtomic(lua_State *L)
 static const luaL_Reg w_Channel_functions[] =
 {
 	{ "push", w_Channel_push },
+	{ "pushMany", w_Channel_pushMany },
 	{ "supply", w_Channel_supply },
 	{ "pop", w_Channel_pop },
+	{ "popMany", w_Channel_popMany },
 	{ "demand", w_Channel_demand },
 	{ "peek", w_Channel_peek },
 	{ "getCount", w_Channel_getCount },
+	{ "getCapacity", w_Channel_getCapacity },
+	{ "isLockFree", w_Channel_isLockFree },
 	{ "hasRead", w_Channel_hasRead },
 	{ "clear", w_Channel_clear },
 	{ "performAtomic", w_Channel_performAtomic },
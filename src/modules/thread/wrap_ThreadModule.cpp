@@ -83,7 +83,16 @@ int w_newThread(lua_State *L)
 
 int w_newChannel(lua_State *L)
 {
-	Channel *c = instance()->newChannel();
+	Channel *c = nullptr;
+
+	if (lua_isnoneornil(L, 1))
+		c = instance()->newChannel();
+	else
+	{
+		int capacity = (int) luaL_checkinteger(L, 1);
+		luax_catchexcept(L, [&]() { c = instance()->newChannel(capacity); });
+	}
+
 	luax_pushtype(L, c);
 	c->release();
 	return 1;
@@ -64,6 +64,15 @@ bool VideoStream::isPlaying() const
 	return frameSync->isPlaying();
 }
 
+void VideoStream::setDecodeAhead(int /*frames*/)
+{
+}
+
+int VideoStream::getDecodeAhead() const
+{
+	return 0;
+}
+
 VideoStream::Frame::Frame()
 	: yplane(nullptr)
 	, cbplane(nullptr)
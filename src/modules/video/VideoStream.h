@@ -72,6 +72,12 @@ class VideoStream : public love::Object
 	virtual double tell() const;
 	virtual bool isPlaying() const;
 
+	/**
+	 * Sets how many frames may be decoded ahead of playback.
+	 **/
+	virtual void setDecodeAhead(int frames);
+	virtual int getDecodeAhead() const;
+
 	class FrameSync;
 	class DeltaSync;
 
@@ -20,6 +20,7 @@
 
 // STL
 #include <iostream>
+#include <algorithm>
 
 // LOVE
 #include "TheoraVideoStream.h"
@@ -37,7 +38,11 @@ TheoraVideoStream::TheoraVideoStream(love::filesystem::File *file)
 	: demuxer(file)
 	, headerParsed(false)
 	, decoder(nullptr)
-	, frameReady(false)
+	, frontBuffer(nullptr)
+	, decodeAhead(DEFAULT_DECODE_AHEAD)
+	, queuedFrames(0)
+	, frameDuration(0)
+	, lastPosition(0)
 	, lastFrame(0)
 	, nextFrame(0)
 {
@@ -46,17 +51,12 @@ TheoraVideoStream::TheoraVideoStream(love::filesystem::File *file)
 
 	th_info_init(&videoInfo);
 
-	frontBuffer = new Frame();
-	backBuffer = new Frame();
-
 	try
 	{
 		parseHeader();
 	}
 	catch (love::Exception &ex)
 	{
-		delete backBuffer;
-		delete frontBuffer;
 		th_info_clear(&videoInfo);
 		throw ex;
 	}
@@ -72,7 +72,12 @@ TheoraVideoStream::~TheoraVideoStream()
 	th_info_clear(&videoInfo);
 
 	delete frontBuffer;
-	delete backBuffer;
+
+	for (const QueuedFrame &f : frameQueue)
+		delete f.frame;
+
+	for (Frame *f : freeFrames)
+		delete f;
 }
 
 int TheoraVideoStream::getWidth() const
@@ -114,7 +119,18 @@ size_t TheoraVideoStream::getSize() const
 
 bool TheoraVideoStream::isPlaying() const
 {
-	return frameSync->isPlaying() && !demuxer.isEos();
+	// Frames decoded ahead still need to be shown after the end of the file.
+	return frameSync->isPlaying() && !(demuxer.isEos() && queuedFrames == 0);
+}
+
+void TheoraVideoStream::setDecodeAhead(int frames)
+{
+	decodeAhead = std::min(std::max(frames, 1), MAX_DECODE_AHEAD);
+}
+
+int TheoraVideoStream::getDecodeAhead() const
+{
+	return decodeAhead;
 }
 
 template<typename T>
@@ -162,33 +178,40 @@ void TheoraVideoStream::parseHeader()
 	decoder = th_decode_alloc(&videoInfo, setupInfo);
 	th_setup_free(setupInfo);
 
-	Frame *buffers[2] = {backBuffer, frontBuffer};
-
 	yPlaneXOffset = cPlaneXOffset = videoInfo.pic_x;
 	yPlaneYOffset = cPlaneYOffset = videoInfo.pic_y;
 
 	scaleFormat(videoInfo.pixel_fmt, cPlaneXOffset, cPlaneYOffset);
 
-	for (int i = 0; i < 2; i++)
-	{
-		buffers[i]->cw = buffers[i]->yw = videoInfo.pic_width;
-		buffers[i]->ch = buffers[i]->yh = videoInfo.pic_height;
-
-		scaleFormat(videoInfo.pixel_fmt, buffers[i]->cw, buffers[i]->ch);
-
-		buffers[i]->yplane = new unsigned char[buffers[i]->yw * buffers[i]->yh];
-		buffers[i]->cbplane = new unsigned char[buffers[i]->cw * buffers[i]->ch];
-		buffers[i]->crplane = new unsigned char[buffers[i]->cw * buffers[i]->ch];
+	if (videoInfo.fps_numerator > 0)
+		frameDuration = (double) videoInfo.fps_denominator / (double) videoInfo.fps_numerator;
 
-		memset(buffers[i]->yplane, 16, buffers[i]->yw * buffers[i]->yh);
-		memset(buffers[i]->cbplane, 128, buffers[i]->cw * buffers[i]->ch);
-		memset(buffers[i]->crplane, 128, buffers[i]->cw * buffers[i]->ch);
-	}
+	frontBuffer = newFrame();
 
 	headerParsed = true;
 	th_decode_packetin(decoder, &packet, nullptr);
 }
 
+VideoStream::Frame *TheoraVideoStream::newFrame() const
+{
+	Frame *frame = new Frame();
+
+	frame->cw = frame->yw = videoInfo.pic_width;
+	frame->ch = frame->yh = videoInfo.pic_height;
+
+	scaleFormat(videoInfo.pixel_fmt, frame->cw, frame->ch);
+
+	frame->yplane = new unsigned char[frame->yw * frame->yh];
+	frame->cbplane = new unsigned char[frame->cw * frame->ch];
+	frame->crplane = new unsigned char[frame->cw * frame->ch];
+
+	memset(frame->yplane, 16, frame->yw * frame->yh);
+	memset(frame->cbplane, 128, frame->cw * frame->ch);
+	memset(frame->crplane, 128, frame->cw * frame->ch);
+
+	return frame;
+}
+
 void TheoraVideoStream::seekDecoder(double target)
 {
 	bool success = demuxer.seek(packet, target, [this](int64 granulepos) {
@@ -203,87 +226,133 @@ void TheoraVideoStream::seekDecoder(double target)
 	th_decode_ctl(decoder, TH_DECCTL_SET_GRANPOS, &packet.granulepos, sizeof(packet.granulepos));
 }
 
+void TheoraVideoStream::flushFrames()
+{
+	love::thread::Lock l(bufferMutex);
+
+	for (const QueuedFrame &f : frameQueue)
+		freeFrames.push_back(f.frame);
+
+	frameQueue.clear();
+	queuedFrames = 0;
+}
+
+bool TheoraVideoStream::decodeFrame(Frame *target)
+{
+	// Copy out the frame currently in the decoder, before the next packet
+	// replaces it.
+	if (target != nullptr)
+	{
+		th_ycbcr_buffer bufferinfo;
+		th_decode_ycbcr_out(decoder, bufferinfo);
+
+		for (int y = 0; y < target->yh; ++y)
+		{
+			memcpy(target->yplane+target->yw*y,
+					bufferinfo[0].data+
+						bufferinfo[0].stride*(y+yPlaneYOffset)+yPlaneXOffset,
+					target->yw);
+		}
+
+		for (int y = 0; y < target->ch; ++y)
+		{
+			memcpy(target->cbplane+target->cw*y,
+					bufferinfo[1].data+
+						bufferinfo[1].stride*(y+cPlaneYOffset)+cPlaneXOffset,
+					target->cw);
+		}
+
+		for (int y = 0; y < target->ch; ++y)
+		{
+			memcpy(target->crplane+target->cw*y,
+					bufferinfo[2].data+
+						bufferinfo[2].stride*(y+cPlaneYOffset)+cPlaneXOffset,
+					target->cw);
+		}
+	}
+
+	ogg_int64_t decoderPosition;
+	do
+	{
+		if (demuxer.readPacket(packet))
+			return false;
+
+		if (packet.granulepos > 0)
+			th_decode_ctl(decoder, TH_DECCTL_SET_GRANPOS, &packet.granulepos, sizeof(packet.granulepos));
+	} while (th_decode_packetin(decoder, &packet, &decoderPosition) != 0);
+
+	lastFrame = nextFrame;
+	nextFrame = th_granule_time(decoder, decoderPosition);
+	return true;
+}
+
 void TheoraVideoStream::threadedFillBackBuffer(double dt)
 {
+	StrongRef<FrameSync> sync;
+	{
+		love::thread::Lock l(bufferMutex);
+		sync = frameSync;
+	}
+
 	// Synchronize
-	frameSync->update(dt);
-	double position = frameSync->getPosition();
+	sync->update(dt);
+	double position = sync->getPosition();
 
 	// Seeking backwards
-	if (position < lastFrame)
+	if (position < lastPosition)
+	{
+		flushFrames();
 		seekDecoder(position);
+	}
 
-	th_ycbcr_buffer bufferinfo;
-	bool hasFrame = false;
+	lastPosition = position;
 
-	// Until we are at the end of the stream, or we are displaying the right frame
+	// Skip frames which would be replaced before they could be shown. If we
+	// can't catch up, seek.
 	unsigned int framesBehind = 0;
 	bool failedSeek = false;
-	while (!demuxer.isEos() && position >= nextFrame)
+	while (!demuxer.isEos() && nextFrame + frameDuration <= position)
 	{
-		// If we can't catch up, seek
 		if (framesBehind++ > 5 && !failedSeek)
 		{
+			flushFrames();
 			seekDecoder(position);
 			framesBehind = 0;
 			failedSeek = true;
+			continue;
 		}
 
-		th_decode_ycbcr_out(decoder, bufferinfo);
-		hasFrame = true;
-
-		ogg_int64_t decoderPosition;
-		do
-		{
-			if (demuxer.readPacket(packet))
-				return;
-
-			if (packet.granulepos > 0)
-				th_decode_ctl(decoder, TH_DECCTL_SET_GRANPOS, &packet.granulepos, sizeof(packet.granulepos));
-		} while (th_decode_packetin(decoder, &packet, &decoderPosition) != 0);
-
-		lastFrame = nextFrame;
-		nextFrame = th_granule_time(decoder, decoderPosition);
+		if (!decodeFrame(nullptr))
+			return;
 	}
 
-	// Only swap once, even if we read many frames to get here
-	if (hasFrame)
+	// Decode ahead of playback, until the queue is full.
+	while (!demuxer.isEos() && queuedFrames < decodeAhead)
 	{
-		// Don't swap whilst we're writing to the backbuffer
+		Frame *frame = nullptr;
 		{
 			love::thread::Lock l(bufferMutex);
-			frameReady = false;
+			if (!freeFrames.empty())
+			{
+				frame = freeFrames.back();
+				freeFrames.pop_back();
+			}
 		}
 
-		for (int y = 0; y < backBuffer->yh; ++y)
-		{
-			memcpy(backBuffer->yplane+backBuffer->yw*y,
-					bufferinfo[0].data+
-						bufferinfo[0].stride*(y+yPlaneYOffset)+yPlaneXOffset,
-					backBuffer->yw);
-		}
+		if (frame == nullptr)
+			frame = newFrame();
 
-		for (int y = 0; y < backBuffer->ch; ++y)
-		{
-			memcpy(backBuffer->cbplane+backBuffer->cw*y,
-					bufferinfo[1].data+
-						bufferinfo[1].stride*(y+cPlaneYOffset)+cPlaneXOffset,
-					backBuffer->cw);
-		}
+		double time = nextFrame;
+		bool more = decodeFrame(frame);
 
-		for (int y = 0; y < backBuffer->ch; ++y)
-		{
-			memcpy(backBuffer->crplane+backBuffer->cw*y,
-					bufferinfo[2].data+
-						bufferinfo[2].stride*(y+cPlaneYOffset)+cPlaneXOffset,
-					backBuffer->cw);
-		}
-
-		// Re-enable swapping
 		{
 			love::thread::Lock l(bufferMutex);
-			frameReady = true;
+			frameQueue.push_back({frame, time});
+			queuedFrames = (int) frameQueue.size();
 		}
+
+		if (!more)
+			break;
 	}
 }
 
@@ -294,22 +363,25 @@ void TheoraVideoStream::fillBackBuffer()
 
 bool TheoraVideoStream::swapBuffers()
 {
-	if (demuxer.isEos())
-		return false;
+	love::thread::Lock l(bufferMutex);
 
 	if (!frameSync->isPlaying())
 		return false;
 
-	love::thread::Lock l(bufferMutex);
-	if (!frameReady)
-		return false;
-	frameReady = false;
+	double position = frameSync->getPosition();
 
-	Frame *temp = frontBuffer;
-	frontBuffer = backBuffer;
-	backBuffer = temp;
+	// Show the newest frame which is due. Older due frames are dropped.
+	bool swapped = false;
+	while (!frameQueue.empty() && frameQueue.front().time <= position)
+	{
+		freeFrames.push_back(frontBuffer);
+		frontBuffer = frameQueue.front().frame;
+		frameQueue.pop_front();
+		swapped = true;
+	}
 
-	return true;
+	queuedFrames = (int) frameQueue.size();
+	return swapped;
 }
 
 } // theora
@@ -29,6 +29,11 @@
 #include "thread/threads.h"
 #include "OggDemuxer.h"
 
+// STL
+#include <atomic>
+#include <deque>
+#include <vector>
+
 // OGG/Theora
 #include <ogg/ogg.h>
 #include <theora/codec.h>
@@ -59,9 +64,22 @@ class TheoraVideoStream : public love::video::VideoStream
 
 	bool isPlaying() const;
 
+	void setDecodeAhead(int frames);
+	int getDecodeAhead() const;
+
 	void threadedFillBackBuffer(double dt);
 
+	static const int DEFAULT_DECODE_AHEAD = 4;
+	static const int MAX_DECODE_AHEAD = 32;
+
 private:
+
+	struct QueuedFrame
+	{
+		Frame *frame;
+		double time;
+	};
+
 	OggDemuxer demuxer;
 
 	bool headerParsed;
@@ -71,21 +89,37 @@ class TheoraVideoStream : public love::video::VideoStream
 	th_info videoInfo;
 	th_dec_ctx *decoder;
 
+	// The frame being displayed. Only touched by the main thread after
+	// construction.
 	Frame *frontBuffer;
-	Frame *backBuffer;
+
+	// Decoded frames waiting for their time, oldest first.
+	std::deque<QueuedFrame> frameQueue;
+
+	// Frames which can be decoded into.
+	std::vector<Frame *> freeFrames;
+
 	unsigned int yPlaneXOffset;
 	unsigned int cPlaneXOffset;
 	unsigned int yPlaneYOffset;
 	unsigned int cPlaneYOffset;
 
+	// Guards frameQueue, freeFrames and frameSync.
 	love::thread::MutexRef bufferMutex;
-	bool frameReady;
 
+	std::atomic<int> decodeAhead;
+	std::atomic<int> queuedFrames;
+
+	double frameDuration;
+	double lastPosition;
 	double lastFrame;
 	double nextFrame;
 
 	void parseHeader();
+	Frame *newFrame() const;
 	void seekDecoder(double target);
+	void flushFrames();
+	bool decodeFrame(Frame *target);
 }; // TheoraVideoStream
 
 } // theora
@@ -36,19 +36,40 @@ namespace theora
 Video::Video()
 	: love::video::Video("love.video.theora")
 {
-	workerThread = new Worker();
-	workerThread->start();
+	int count = love::thread::getWorkerThreadCount(MAX_WORKERS);
+
+	for (int i = 0; i < count; i++)
+	{
+		Worker *worker = new Worker();
+		worker->start();
+		workers.push_back(worker);
+	}
 }
 
 Video::~Video()
 {
-	delete workerThread;
+	for (Worker *worker : workers)
+		delete worker;
 }
 
 VideoStream *Video::newVideoStream(love::filesystem::File *file)
 {
 	TheoraVideoStream *stream = new TheoraVideoStream(file);
-	workerThread->addStream(stream);
+
+	// Give the stream to the least busy worker.
+	Worker *target = workers[0];
+	size_t targetCount = target->getStreamCount();
+	for (size_t i = 1; i < workers.size(); i++)
+	{
+		size_t count = workers[i]->getStreamCount();
+		if (count < targetCount)
+		{
+			target = workers[i];
+			targetCount = count;
+		}
+	}
+
+	target->addStream(stream);
 	return stream;
 }
 
@@ -70,6 +91,12 @@ void Worker::addStream(TheoraVideoStream *stream)
 	cond->broadcast();
 }
 
+size_t Worker::getStreamCount()
+{
+	love::thread::Lock l(mutex);
+	return streams.size();
+}
+
 void Worker::stop()
 {
 	{
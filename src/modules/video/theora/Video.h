@@ -48,8 +48,12 @@ class Video : public love::video::Video
 
 	VideoStream *newVideoStream(love::filesystem::File* file);
 
+	static const int MAX_WORKERS = 4;
+
 private:
-	Worker *workerThread;
+	// Streams are spread over the workers, so several videos can decode at
+	// the same time.
+	std::vector<Worker *> workers;
 }; // Video
 
 class Worker : public love::thread::Threadable
@@ -62,6 +66,7 @@ class Worker : public love::thread::Threadable
 	void threadFunction();
 
 	void addStream(TheoraVideoStream *stream);
+	size_t getStreamCount();
 	// Frees itself!
 	void stop();
 
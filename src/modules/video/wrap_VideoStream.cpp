@@ -102,6 +102,23 @@ int w_VideoStream_tell(lua_State *L)
 	return 1;
 }
 
+int w_VideoStream_setDecodeAhead(lua_State *L)
+{
+	auto stream = luax_checkvideostream(L, 1);
+	int frames = (int) luaL_checkinteger(L, 2);
+	if (frames < 1)
+		return luaL_error(L, "Decode-ahead frame count must be at least 1.");
+	stream->setDecodeAhead(frames);
+	return 0;
+}
+
+int w_VideoStream_getDecodeAhead(lua_State *L)
+{
+	auto stream = luax_checkvideostream(L, 1);
+	lua_pushinteger(L, stream->getDecodeAhead());
+	return 1;
+}
+
 int w_VideoStream_isPlaying(lua_State *L)
 {
 	auto stream = luax_checkvideostream(L, 1);
@@ -119,6 +136,8 @@ static const luaL_Reg videostream_functions[] =
 	{ "rewind", w_VideoStream_rewind },
 	{ "tell", w_VideoStream_tell },
 	{ "isPlaying", w_VideoStream_isPlaying },
+	{ "setDecodeAhead", w_VideoStream_setDecodeAhead },
+	{ "getDecodeAhead", w_VideoStream_getDecodeAhead },
 	{ 0, 0 }
 };
 
@@ -38,6 +38,7 @@ TestSuite = {
       joystick = {},
       love = {},
       keyboard = {},
+      loader = {},
       math = {},
       mouse = {},
       physics = {},
@@ -18,6 +18,7 @@ if love.graphics ~= nil then require('tests.graphics') end
 if love.image ~= nil then require('tests.image') end
 if love.joystick ~= nil then require('tests.joystick') end
 if love.keyboard ~= nil then require('tests.keyboard') end
+if love.loader ~= nil then require('tests.loader') end
 if love.math ~= nil then require('tests.math') end
 if love.mouse ~= nil then require('tests.mouse') end
 if love.physics ~= nil then require('tests.physics') end
@@ -80,7 +81,7 @@ love.load = function(args)
   local cmderr = 'Invalid flag used'
   local modules = {
     'audio', 'data', 'event', 'filesystem', 'font', 'graphics', 'image',
-    'joystick', 'keyboard', 'love', 'math', 'mouse', 'physics', 'sensor',
+    'joystick', 'keyboard', 'loader', 'love', 'math', 'mouse', 'physics', 'sensor',
     'sound', 'system', 'thread', 'timer', 'touch', 'video', 'window'
   }
   GITHUB_RUNNER = false
@@ -505,6 +505,55 @@ love.test.audio.setPosition = function(test)
 end
 
 
+-- love.audio.setSoftwareMixing
+love.test.audio.setSoftwareMixing = function(test)
+  -- check software mixing can be toggled
+  test:assertTrue(love.audio.setSoftwareMixing(true), 'check enabled')
+  test:assertTrue(love.audio.isSoftwareMixing(), 'check enabled state')
+  -- check sources past the hardware limit still play
+  local source = love.audio.newSource('resources/click.ogg', 'static')
+  source:setLooping(true)
+  local sources = {}
+  local count = love.audio.getMaxSources() + 8
+  for i=1,count do
+    sources[i] = source:clone()
+    sources[i]:setVolume(i / count)
+  end
+  test:assertTrue(love.audio.play(sources), 'check all played')
+  test:assertGreaterEqual(count, love.audio.getActiveSourceCount(), 'check active count')
+  test:assertGreaterEqual(1, love.audio.getVirtualSourceCount(), 'check virtual count')
+  test:assertTrue(sources[1]:isPlaying(), 'check virtual source playing')
+  love.audio.stop()
+  test:assertEquals(0, love.audio.getVirtualSourceCount(), 'check virtual stopped')
+  -- check disabling
+  test:assertTrue(love.audio.setSoftwareMixing(false), 'check disabled')
+  test:assertFalse(love.audio.isSoftwareMixing(), 'check disabled state')
+end
+
+
+-- love.audio.setSourceCacheBudget
+love.test.audio.setSourceCacheBudget = function(test)
+  -- check static sources from the same file are cached once
+  love.audio.clearSourceCache()
+  test:assertEquals(0, love.audio.getSourceCacheSize(), 'check cache empty')
+  local source1 = love.audio.newSource('resources/click.ogg', 'static')
+  local size = love.audio.getSourceCacheSize()
+  test:assertGreaterEqual(1, size, 'check source cached')
+  local source2 = love.audio.newSource('resources/click.ogg', 'static')
+  test:assertEquals(size, love.audio.getSourceCacheSize(), 'check cache reused')
+  test:assertEquals(source1:getDuration(), source2:getDuration(), 'check same audio')
+  -- check sources from the cache are independent
+  source1:setVolume(0.5)
+  test:assertEquals(1, source2:getVolume(), 'check separate volume')
+  -- check a smaller budget evicts entries
+  local budget = love.audio.getSourceCacheBudget()
+  love.audio.setSourceCacheBudget(0)
+  test:assertEquals(0, love.audio.getSourceCacheSize(), 'check evicted')
+  love.audio.setSourceCacheBudget(budget)
+  test:assertEquals(budget, love.audio.getSourceCacheBudget(), 'check budget')
+end
+
+
 -- love.audio.setVelocity
 love.test.audio.setVelocity = function(test)
   -- check setting velocity vals are returned
@@ -37,6 +37,13 @@ love.test.data.ByteData = function(test)
   data:setString('love!', 5)
   test:assertEquals('hellolove!', data:getString(), 'check change string')
 
+  -- check transferring the memory to a new bytedata
+  local transferred = data:transfer()
+  test:assertObject(transferred)
+  test:assertEquals('hellolove!', transferred:getString(), 'check transferred data')
+  local ok = pcall(data.getSize, data)
+  test:assertFalse(ok, 'check use after transfer errors')
+
 end
 
 
@@ -352,6 +352,41 @@ love.test.filesystem.load = function(test)
 end
 
 
+-- love.filesystem.map
+love.test.filesystem.map = function(test)
+  -- check mapping a file from the source
+  local data, mapped = love.filesystem.map('resources/test.txt')
+  test:assertObject(data)
+  test:assertTrue(mapped, 'check source file mapped')
+  test:assertEquals('helloworld', data:getString(), 'check content match')
+  test:assertEquals(10, data:getSize(), 'check size match')
+  test:assertEquals('txt', data:getExtension(), 'check extension')
+  -- check files in the save directory are read instead of memory mapped
+  love.filesystem.write('mapped.txt', 'mapped contents')
+  data, mapped = love.filesystem.map('mapped.txt')
+  test:assertFalse(mapped, 'check save dir file not mapped')
+  test:assertEquals('mapped contents', data:getString(), 'check mapped content match')
+  -- check clones are independent copies
+  local clone = data:clone()
+  test:assertEquals('mapped contents', clone:getString(), 'check clone content match')
+  -- check empty files fall back to reading
+  love.filesystem.write('mappedempty.txt', '')
+  data, mapped = love.filesystem.map('mappedempty.txt')
+  test:assertFalse(mapped, 'check empty file not mapped')
+  test:assertEquals(0, data:getSize(), 'check empty size')
+  -- check missing files return an error
+  local missing, err = love.filesystem.map('missing.txt')
+  test:assertEquals(nil, missing, 'check missing file nil')
+  test:assertNotEquals(nil, err, 'check missing file error')
+  -- cleanup
+  data = nil
+  clone = nil
+  collectgarbage('collect')
+  love.filesystem.remove('mapped.txt')
+  love.filesystem.remove('mappedempty.txt')
+end
+
+
 -- love.filesystem.mount
 love.test.filesystem.mount = function(test)
   -- write an example zip to savedir to use
@@ -510,6 +545,36 @@ love.test.filesystem.setCRequirePath = function(test)
 end
 
 
+-- love.filesystem.setFileIndexEnabled
+-- @NOTE also checks love.filesystem.isFileIndexEnabled
+love.test.filesystem.setFileIndexEnabled = function(test)
+  love.filesystem.setFileIndexEnabled(true)
+  test:assertTrue(love.filesystem.isFileIndexEnabled(), 'check index enabled')
+  -- check lookups match the normal results
+  local info = love.filesystem.getInfo('resources/test.txt')
+  test:assertNotEquals(nil, info, 'check file info')
+  test:assertEquals('file', info.type, 'check file type')
+  test:assertEquals(nil, love.filesystem.getInfo('resources/missing.txt'), 'check missing file')
+  test:assertNotEquals(nil, love.filesystem.getInfo('//resources/', 'directory'), 'check extra slashes')
+  local found = false
+  for _, item in ipairs(love.filesystem.getDirectoryItems('resources')) do
+    if item == 'test.txt' then found = true end
+  end
+  test:assertTrue(found, 'check directory items')
+  -- check writes and removals are seen
+  love.filesystem.write('fileindex.txt', 'helloworld')
+  info = love.filesystem.getInfo('fileindex.txt')
+  test:assertNotEquals(nil, info, 'check written file')
+  test:assertEquals(10, info.size, 'check written size')
+  love.filesystem.append('fileindex.txt', 'hello')
+  test:assertEquals(15, love.filesystem.getInfo('fileindex.txt').size, 'check appended size')
+  love.filesystem.remove('fileindex.txt')
+  test:assertEquals(nil, love.filesystem.getInfo('fileindex.txt'), 'check removed file')
+  love.filesystem.setFileIndexEnabled(false)
+  test:assertFalse(love.filesystem.isFileIndexEnabled(), 'check index disabled')
+end
+
+
 -- love.filesystem.setIdentity
 love.test.filesystem.setIdentity = function(test)
   -- check setting identity val is returned
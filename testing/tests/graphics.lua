@@ -260,6 +260,101 @@ love.test.graphics.Canvas = function(test)
 end
 
 
+-- DrawList (love.graphics.newDrawList)
+love.test.graphics.DrawList = function(test)
+
+  -- create draw list
+  local drawlist = love.graphics.newDrawList()
+  test:assertObject(drawlist)
+  test:assertEquals(0, drawlist:getDrawCount(), 'check initial draw count')
+  test:assertEquals(0, drawlist:getVertexCount(), 'check initial vertex count')
+
+  -- check active draw list
+  test:assertEquals(nil, love.graphics.getDrawList(), 'check no draw list')
+  love.graphics.setDrawList(drawlist)
+  test:assertEquals(drawlist, love.graphics.getDrawList(), 'check draw list set')
+
+  -- check recording, consecutive shapes should merge into one draw
+  love.graphics.setColor(1, 0, 0, 1)
+  love.graphics.rectangle('fill', 0, 0, 8, 8)
+  love.graphics.setColor(0, 1, 0, 1)
+  love.graphics.rectangle('fill', 8, 0, 8, 8)
+  love.graphics.setColor(1, 1, 1, 1)
+  love.graphics.setDrawList()
+  test:assertEquals(nil, love.graphics.getDrawList(), 'check draw list unset')
+  test:assertEquals(1, drawlist:getDrawCount(), 'check recorded draw count')
+  test:assertEquals(8, drawlist:getVertexCount(), 'check recorded vertex count')
+
+  -- check drawing replays the recorded shapes with their colors
+  local canvas = love.graphics.newCanvas(16, 16)
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.draw(drawlist, 0, 4)
+  love.graphics.setCanvas()
+  local imgdata = love.graphics.readbackTexture(canvas)
+  local r1, g1, b1 = imgdata:getPixel(2, 6)
+  local r2, g2, b2 = imgdata:getPixel(10, 6)
+  local r3, g3, b3 = imgdata:getPixel(2, 1)
+  test:assertEquals(1, r1, 'check first shape r')
+  test:assertEquals(0, g1, 'check first shape g')
+  test:assertEquals(0, r2, 'check second shape r')
+  test:assertEquals(1, g2, 'check second shape g')
+  test:assertEquals(0, r3 + g3 + b3, 'check transform applied')
+
+  -- check the blend mode is recorded and the caller's state is restored
+  local blendlist = love.graphics.newDrawList()
+  love.graphics.setDrawList(blendlist)
+  love.graphics.setBlendMode('add')
+  love.graphics.setColor(0.5, 0, 0, 1)
+  love.graphics.rectangle('fill', 0, 0, 16, 16)
+  love.graphics.setBlendMode('alpha')
+  love.graphics.setColor(1, 1, 1, 1)
+  love.graphics.setDrawList()
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0.5, 0, 0, 1)
+    love.graphics.setColor(0, 0, 1, 1)
+    love.graphics.draw(blendlist)
+    local cr, cg, cb = love.graphics.getColor()
+    love.graphics.setColor(1, 1, 1, 1)
+  love.graphics.setCanvas()
+  test:assertEquals('alpha', love.graphics.getBlendMode(), 'check blend mode restored')
+  test:assertEquals(1, cb, 'check color restored')
+  imgdata = love.graphics.readbackTexture(canvas)
+  local r4 = imgdata:getPixel(8, 8)
+  test:assertRange(r4, 0.99, 1, 'check recorded blend mode used')
+
+  -- check lists with more vertices than 16 bit indices can address
+  local biglist = love.graphics.newDrawList()
+  love.graphics.setDrawList(biglist)
+  for i = 0, 16400 do
+    love.graphics.rectangle('fill', (i % 16), 0, 1, 16)
+  end
+  love.graphics.setDrawList()
+  test:assertEquals(1, biglist:getDrawCount(), 'check big list draw count')
+  test:assertGreaterEqual(65536, biglist:getVertexCount(), 'check big list vertex count')
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.draw(biglist)
+  love.graphics.setCanvas()
+  imgdata = love.graphics.readbackTexture(canvas)
+  local r5, g5, b5 = imgdata:getPixel(15, 8)
+  test:assertEquals(3, r5 + g5 + b5, 'check big list drawn')
+
+  -- check non-batched draws are rejected while recording
+  local mesh = love.graphics.newMesh({{0, 0, 0, 0}, {1, 0, 1, 0}, {1, 1, 1, 1}}, 'triangles', 'static')
+  love.graphics.setDrawList(drawlist)
+  local ok = pcall(love.graphics.draw, mesh)
+  love.graphics.setDrawList()
+  test:assertFalse(ok, 'check mesh draw rejected')
+
+  -- check clearing
+  drawlist:clear()
+  test:assertEquals(0, drawlist:getDrawCount(), 'check cleared draw count')
+  test:assertEquals(0, drawlist:getVertexCount(), 'check cleared vertex count')
+
+end
+
+
 -- Font (love.graphics.newFont)
 love.test.graphics.Font = function(test)
 
@@ -594,6 +689,20 @@ love.test.graphics.ParticleSystem = function(test)
   psystem:reset()
   test:assertEquals(0, psystem:getCount(), 'check reset')
 
+  -- check dead particles are removed in every insert mode
+  for _, mode in ipairs({'top', 'bottom', 'random'}) do
+    psystem:setInsertMode(mode)
+    psystem:setParticleLifetime(1, 3)
+    psystem:emit(50)
+    psystem:update(0.5)
+    test:assertEquals(50, psystem:getCount(), 'check none removed ' .. mode)
+    psystem:update(4)
+    test:assertEquals(0, psystem:getCount(), 'check all removed ' .. mode)
+  end
+  psystem:setInsertMode('top')
+  psystem:setParticleLifetime(1, 2)
+  psystem:reset()
+
   -- check setting colors
   local colors1 = {psystem:getColors()}
   test:assertEquals(1, #colors1, 'check 1 color by def')
@@ -637,6 +746,38 @@ love.test.graphics.ParticleSystem = function(test)
   psystem:setInsertMode('random')
   test:assertEquals('random', psystem:getInsertMode(), 'check change insert mode')
 
+  -- check simulation mode
+  test:assertEquals('cpu', psystem:getSimulationMode(), 'check def simulation mode')
+  local supported = love.graphics.getSupported()
+  if supported.glsl4 and supported.indirectdraw then
+    local gpusystem = love.graphics.newParticleSystem(image, 1000, 'gpu')
+    test:assertEquals('gpu', gpusystem:getSimulationMode(), 'check gpu simulation mode')
+    gpusystem:setParticleLifetime(1, 2)
+    gpusystem:emit(10)
+    gpusystem:update(0.5)
+    test:assertEquals(10, gpusystem:getCount(), 'check gpu added particles')
+    -- without speed or acceleration the particles stay on the emitter
+    local gpucanvas = love.graphics.newCanvas(16, 16)
+    love.graphics.setCanvas(gpucanvas)
+      love.graphics.clear(0, 0, 0, 0)
+      love.graphics.draw(gpusystem, 8, 8, 0, 4, 4)
+    love.graphics.setCanvas()
+    local gpudata1 = love.graphics.readbackTexture(gpucanvas)
+    local _, _, _, a1 = gpudata1:getPixel(8, 8)
+    local _, _, _, a2 = gpudata1:getPixel(0, 0)
+    test:assertEquals(1, a1, 'check gpu particles drawn at emitter')
+    test:assertEquals(0, a2, 'check gpu particles not drawn elsewhere')
+    gpusystem:update(2)
+    test:assertEquals(0, gpusystem:getCount(), 'check gpu particles expired')
+    love.graphics.setCanvas(gpucanvas)
+      love.graphics.clear(0, 0, 0, 0)
+      love.graphics.draw(gpusystem, 8, 8, 0, 4, 4)
+    love.graphics.setCanvas()
+    local gpudata2 = love.graphics.readbackTexture(gpucanvas)
+    local _, _, _, a3 = gpudata2:getPixel(8, 8)
+    test:assertEquals(0, a3, 'check expired gpu particles not drawn')
+  end
+
   -- check linear acceleration
   local xmin1, ymin1, xmax1, ymax1 = psystem:getLinearAcceleration()
   test:assertEquals(0, xmin1, 'check def lin acceleration xmin')
@@ -2027,6 +2168,34 @@ love.test.graphics.isActive = function(test)
 end
 
 
+-- love.graphics.isArrayTextureBatching
+love.test.graphics.isArrayTextureBatching = function(test)
+  -- check off by default
+  test:assertFalse(love.graphics.isArrayTextureBatching(), 'check off by default')
+  -- check layer views of one array texture share a batch when enabled
+  local texture = love.graphics.newArrayImage({
+    'resources/love.png', 'resources/loveinv.png'
+  })
+  local view1 = love.graphics.newTextureView(texture, { type = '2d', layerstart = 1, layers = 1 })
+  local view2 = love.graphics.newTextureView(texture, { type = '2d', layerstart = 2, layers = 1 })
+  love.graphics.setArrayTextureBatching(true)
+  test:assertTrue(love.graphics.isArrayTextureBatching(), 'check batching is set')
+  local canvas = love.graphics.newCanvas(16, 16)
+  love.graphics.setCanvas(canvas)
+    love.graphics.flushBatch()
+    local initial = love.graphics.getStats()['drawcalls']
+    for i=1,4 do
+      love.graphics.draw(view1, 0, 0)
+      love.graphics.draw(view2, 0, 0)
+    end
+    love.graphics.flushBatch()
+    local after = love.graphics.getStats()['drawcalls']
+  love.graphics.setCanvas()
+  love.graphics.setArrayTextureBatching(false) -- reset
+  test:assertEquals(initial+1, after, 'check layer views drawn in one batch')
+end
+
+
 -- love.graphics.isGammaCorrect
 love.test.graphics.isGammaCorrect = function(test)
   -- we know the config so know this is false
@@ -2528,6 +2697,28 @@ love.test.graphics.pop = function(test)
 end
 
 
+-- love.graphics.pushProfileScope
+love.test.graphics.pushProfileScope = function(test)
+  -- check nested scopes can be pushed and popped
+  love.graphics.pushProfileScope('outer')
+    love.graphics.pushProfileScope('inner')
+      love.graphics.rectangle('fill', 0, 0, 1, 1)
+    love.graphics.popProfileScope()
+  love.graphics.popProfileScope()
+  -- check popping without a push errors
+  local ok = pcall(love.graphics.popProfileScope)
+  test:assertFalse(ok, 'check pop without push errors')
+  -- check reset discards scopes left open by an error
+  pcall(function()
+    love.graphics.pushProfileScope('unbalanced')
+    error('error inside a scope')
+  end)
+  love.graphics.reset()
+  ok = pcall(love.graphics.popProfileScope)
+  test:assertFalse(ok, 'check reset discards open scopes')
+end
+
+
 -- love.graphics.push
 love.test.graphics.push = function(test)
   -- if we push at the start, do some stuff, then another push
@@ -2774,6 +2965,18 @@ love.test.graphics.getTextureFormats = function(test)
 end
 
 
+-- love.graphics.getProfileTrace
+-- @NOTE scopes are only collected once a frame is presented, so just check
+-- the trace is well formed
+love.test.graphics.getProfileTrace = function(test)
+  local trace = love.graphics.getProfileTrace()
+  test:assertEquals('string', type(trace), 'check trace is a string')
+  test:assertNotEquals(nil, string.find(trace, '"traceEvents"', 1, true), 'check trace events key')
+  test:assertEquals('table', type(love.graphics.getProfileScopes()), 'check scopes table')
+  test:assertEquals(2, select('#', love.graphics.getProfileScopes()), 'check scopes value count')
+end
+
+
 -- love.graphics.getRendererInfo
 -- @NOTE hardware dependent so best can do is nil checking
 love.test.graphics.getRendererInfo = function(test)
@@ -2790,7 +2993,9 @@ end
 love.test.graphics.getStats = function(test)
   local stattypes = {
     'drawcalls', 'canvasswitches', 'texturememory', 'shaderswitches',
-    'drawcallsbatched', 'textures', 'fonts'
+    'drawcallsbatched', 'textures', 'fonts', 'pipelinecachehits',
+    'pipelinecachemisses', 'pipelinecacheunknown', 'batcheddrawsuint16indices',
+    'batcheddrawsuint32indices'
   }
   local stats = love.graphics.getStats()
   for s=1,#stattypes do
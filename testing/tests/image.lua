@@ -101,6 +101,16 @@ love.test.image.ImageData = function(test)
   idata:setLinear(true)
   test:assertTrue(idata:isLinear(), 'check now linear')
 
+  -- check transferring the pixels to a new imagedata
+  local tdata = idata:transfer()
+  test:assertObject(tdata)
+  test:assertEquals(64, tdata:getWidth(), 'check transferred w')
+  test:assertTrue(tdata:isLinear(), 'check transferred linear')
+  local r3, g3, b3 = tdata:getPixel(25, 25)
+  test:assertEquals(1, r3+g3+b3, 'check transferred pixel')
+  local ok = pcall(idata.getPixel, idata, 25, 25)
+  test:assertFalse(ok, 'check use after transfer errors')
+
 end
 
 
@@ -0,0 +1,196 @@
+-- love.loader
+
+
+-- finish loaded jobs until the given job is done, or give up after a second
+local function waitForJob(job)
+  local start = love.timer.getTime()
+  while not job:isFinished() and love.timer.getTime() - start < 1 do
+    love.loader.update(1)
+    love.timer.sleep(0.001)
+  end
+end
+
+
+--------------------------------------------------------------------------------
+--------------------------------------------------------------------------------
+----------------------------------OBJECTS---------------------------------------
+--------------------------------------------------------------------------------
+--------------------------------------------------------------------------------
+
+
+-- LoadJob (love.loader.newImageData)
+love.test.loader.LoadJob = function(test)
+
+  -- create obj
+  local job = love.loader.newImageData('resources/love.png', 2)
+  test:assertObject(job)
+
+  -- check properties
+  test:assertEquals('imagedata', job:getKind(), 'check kind')
+  test:assertEquals(2, job:getPriority(), 'check priority')
+  job:setPriority(5)
+  test:assertEquals(5, job:getPriority(), 'check set priority')
+
+  -- check completion callback
+  local called = nil
+  job:setCallback(function(j) called = j end)
+  test:assertNotEquals(nil, job:getCallback(), 'check callback set')
+  waitForJob(job)
+  test:assertEquals('done', job:getStatus(), 'check done')
+  test:assertTrue(job:isFinished(), 'check finished')
+  test:assertEquals(job, called, 'check callback called')
+  test:assertEquals(nil, job:getError(), 'check no error')
+  local imagedata = job:getResult()
+  test:assertObject(imagedata)
+  test:assertEquals(64, imagedata:getWidth(), 'check result width')
+
+  -- check failing job
+  local failed = love.loader.newSoundData('resources/missing.ogg')
+  waitForJob(failed)
+  test:assertEquals('failed', failed:getStatus(), 'check failed')
+  test:assertNotEquals(nil, failed:getError(), 'check error')
+  test:assertEquals(nil, failed:getResult(), 'check no result')
+
+  -- check cancelling
+  local cancelled = love.loader.newSoundData('resources/tone.ogg')
+  cancelled:cancel()
+  test:assertEquals('cancelled', cancelled:getStatus(), 'check cancelled')
+  test:assertTrue(cancelled:isFinished(), 'check cancelled finished')
+
+end
+
+
+--------------------------------------------------------------------------------
+--------------------------------------------------------------------------------
+----------------------------------METHODS---------------------------------------
+--------------------------------------------------------------------------------
+--------------------------------------------------------------------------------
+
+
+-- love.loader.cancelAll
+love.test.loader.cancelAll = function(test)
+  local jobs = {}
+  for i=1,8 do
+    table.insert(jobs, love.loader.newSoundData('resources/tone.ogg'))
+  end
+  love.loader.cancelAll()
+  love.timer.sleep(0.1)
+  love.loader.update(1)
+  test:assertEquals(0, love.loader.getPendingCount(), 'check none pending')
+  for i=1,#jobs do
+    test:assertEquals('cancelled', jobs[i]:getStatus(), 'check cancelled ' .. tostring(i))
+  end
+end
+
+
+-- love.loader.getFrameBudget
+love.test.loader.getFrameBudget = function(test)
+  test:assertGreaterEqual(0, love.loader.getFrameBudget(), 'check def budget')
+end
+
+
+-- love.loader.getPendingCount
+love.test.loader.getPendingCount = function(test)
+  local job = love.loader.newImageData('resources/love.png')
+  test:assertGreaterEqual(1, love.loader.getPendingCount(), 'check pending')
+  waitForJob(job)
+  test:assertEquals(0, love.loader.getPendingCount(), 'check none pending')
+end
+
+
+-- love.loader.newCompressedImageData
+love.test.loader.newCompressedImageData = function(test)
+  local job = love.loader.newCompressedImageData('resources/love.dxt1')
+  waitForJob(job)
+  test:assertObject(job:getResult())
+end
+
+
+-- love.loader.newFont
+love.test.loader.newFont = function(test)
+  local job = love.loader.newFont('resources/font.ttf', 16)
+  waitForJob(job)
+  test:assertEquals('font', job:getKind(), 'check kind')
+  local font = job:getResult()
+  test:assertObject(font)
+  test:assertEquals('Font', font:type(), 'check font created')
+  -- check several fonts decoded at once by the workers, alongside fonts
+  -- created and freed on the main thread
+  local jobs = {}
+  for i=1,8 do
+    table.insert(jobs, love.loader.newRasterizer('resources/font.ttf', 8 + i))
+  end
+  for i=1,8 do
+    love.font.newRasterizer('resources/font.ttf', 8 + i):release()
+  end
+  for i=1,#jobs do
+    waitForJob(jobs[i])
+    test:assertEquals('done', jobs[i]:getStatus(), 'check batch font ' .. i .. ' done')
+    test:assertObject(jobs[i]:getResult())
+  end
+end
+
+
+-- love.loader.newImage
+love.test.loader.newImage = function(test)
+  local job = love.loader.newImage('resources/love.png', { mipmaps = true })
+  waitForJob(job)
+  local image = job:getResult()
+  test:assertObject(image)
+  test:assertEquals(64, image:getWidth(), 'check image width')
+  test:assertGreaterEqual(2, image:getMipmapCount(), 'check settings used')
+end
+
+
+-- love.loader.newImageData
+love.test.loader.newImageData = function(test)
+  local data = love.filesystem.newFileData('resources/love.png')
+  local job = love.loader.newImageData(data)
+  waitForJob(job)
+  test:assertObject(job:getResult())
+end
+
+
+-- love.loader.newRasterizer
+love.test.loader.newRasterizer = function(test)
+  local job = love.loader.newRasterizer('resources/font.ttf', 16)
+  waitForJob(job)
+  local rasterizer = job:getResult()
+  test:assertObject(rasterizer)
+  test:assertGreaterEqual(1, rasterizer:getHeight(), 'check rasterizer created')
+end
+
+
+-- love.loader.newSoundData
+love.test.loader.newSoundData = function(test)
+  local job = love.loader.newSoundData('resources/click.ogg')
+  waitForJob(job)
+  local sounddata = job:getResult()
+  test:assertObject(sounddata)
+  test:assertGreaterEqual(1, sounddata:getSampleCount(), 'check samples decoded')
+end
+
+
+-- love.loader.setFrameBudget
+love.test.loader.setFrameBudget = function(test)
+  local budget = love.loader.getFrameBudget()
+  love.loader.setFrameBudget(0.01)
+  test:assertEquals(0.01, love.loader.getFrameBudget(), 'check set budget')
+  love.loader.setFrameBudget(budget)
+end
+
+
+-- love.loader.update
+love.test.loader.update = function(test)
+  local jobs = {}
+  for i=1,4 do
+    table.insert(jobs, love.loader.newImageData('resources/love.png', i))
+  end
+  love.timer.sleep(0.2)
+  -- a zero budget still finishes one job per call
+  test:assertEquals(1, love.loader.update(0), 'check budget respected')
+  test:assertEquals(3, love.loader.update(1), 'check rest finished')
+  for i=1,#jobs do
+    test:assertEquals('done', jobs[i]:getStatus(), 'check done ' .. tostring(i))
+  end
+end
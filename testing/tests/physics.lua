@@ -599,6 +599,148 @@ love.test.physics.World = function(test)
   world:setGravity(1, 1)
   test:assertEquals(1, world:getGravity(), 'check grav change')
 
+  -- check body states
+  body1:setPosition(5, 6)
+  body1:setAngle(0.5)
+  body1:setLinearVelocity(2, 3)
+  body1:setAngularVelocity(1)
+  local states = love.data.newByteData(2 * 6 * 4)
+  test:assertEquals(2, world:getBodyStates(states), 'check all body states')
+  test:assertEquals(1, world:getBodyStates(states, {body1}, 24), 'check selected body states')
+  local x, y, angle, vx, vy, av = states:getFloat(24, 6)
+  test:assertRange(x, 4.9, 5.1, 'check state x')
+  test:assertRange(y, 5.9, 6.1, 'check state y')
+  test:assertRange(angle, 0.49, 0.51, 'check state angle')
+  test:assertRange(vx, 1.9, 2.1, 'check state velocity x')
+  test:assertRange(vy, 2.9, 3.1, 'check state velocity y')
+  test:assertRange(av, 0.9, 1.1, 'check state angular velocity')
+  local ok = pcall(world.getBodyStates, world, love.data.newByteData(4))
+  test:assertFalse(ok, 'check data too small')
+  -- check unaligned data views are written correctly
+  local unaligned = love.data.newDataView(love.data.newByteData(1 + 6 * 4), 1, 6 * 4)
+  test:assertEquals(1, world:getBodyStates(unaligned, {body1}), 'check unaligned body states')
+  test:assertRange(unaligned:getFloat(0), 4.9, 5.1, 'check unaligned state x')
+
+  -- check buffered contact events
+  local eventworld = love.physics.newWorld(0, 0, false)
+  local eventbody1 = love.physics.newBody(eventworld, 0, 0, 'dynamic')
+  local eventshape1 = love.physics.newRectangleShape(eventbody1, 0, 0, 10, 10)
+  local eventbody2 = love.physics.newBody(eventworld, 5, 5, 'dynamic')
+  love.physics.newRectangleShape(eventbody2, 0, 0, 10, 10)
+  test:assertFalse(eventworld:areContactEventsBuffered(), 'check events not buffered')
+  local callbacks = 0
+  eventworld:setCallbacks(function() callbacks = callbacks + 1 end)
+  eventworld:setContactEventsBuffered(true)
+  test:assertTrue(eventworld:areContactEventsBuffered(), 'check events buffered')
+  eventworld:update(1/60)
+  test:assertEquals(0, callbacks, 'check callbacks not called')
+  test:assertNotEquals(0, eventworld:getContactEventCount(), 'check event count')
+  local begins, postsolves = 0, 0
+  for i, type, a, b, nx, ny, x1, y1, x2, y2, ni1 in eventworld:getContactEvents() do
+    if type == 'begin' then begins = begins + 1 end
+    if type == 'postsolve' then
+      postsolves = postsolves + 1
+      test:assertNotEquals(nil, ni1, 'check postsolve impulse')
+    end
+    test:assertTrue(a == eventshape1 or b == eventshape1, 'check event shapes')
+  end
+  test:assertEquals(1, begins, 'check begin events')
+  test:assertNotEquals(0, postsolves, 'check postsolve events')
+  eventworld:destroy()
+
+  -- check threaded solving matches single threaded solving
+  local function stackworld(threads)
+    local w = love.physics.newWorld(0, 9.81*64, false)
+    w:setThreadCount(threads)
+    local ground = love.physics.newBody(w, 0, 500, 'static')
+    love.physics.newRectangleShape(ground, 0, 0, 2000, 20)
+    local stacked = {}
+    for x = 1, 10 do
+      for y = 1, 10 do
+        local b = love.physics.newBody(w, x*40 - 200, 480 - y*21, 'dynamic')
+        love.physics.newRectangleShape(b, 0, 0, 20, 20)
+        table.insert(stacked, b)
+      end
+    end
+    for i = 1, 30 do w:update(1/60) end
+    return w, stacked
+  end
+  test:assertEquals(1, world:getThreadCount(), 'check default thread count')
+  local serialworld, serialbodies = stackworld(1)
+  local threadworld, threadbodies = stackworld(4)
+  test:assertEquals(4, threadworld:getThreadCount(), 'check thread count')
+  for i = 1, #serialbodies do
+    local sx, sy = serialbodies[i]:getPosition()
+    local tx, ty = threadbodies[i]:getPosition()
+    test:assertEquals(sx, tx, 'check threaded x ' .. i)
+    test:assertEquals(sy, ty, 'check threaded y ' .. i)
+  end
+  threadworld:setThreadCount(1)
+  test:assertEquals(1, threadworld:getThreadCount(), 'check thread count reset')
+  test:assertFalse(pcall(threadworld.setThreadCount, threadworld, 0), 'check invalid thread count')
+  serialworld:destroy()
+  threadworld:destroy()
+
+  -- check the wide broad phase layout finds the same shapes
+  local layoutworld = love.physics.newWorld(0, 0, false)
+  for i = 1, 50 do
+    local b = love.physics.newBody(layoutworld, (i % 10)*8, math.floor(i / 10)*8, 'dynamic')
+    love.physics.newCircleShape(b, 5)
+  end
+  test:assertEquals('binary', layoutworld:getBroadPhaseLayout(), 'check default layout')
+  local binaryarea = #layoutworld:getShapesInArea(0, 0, 60, 40)
+  local binaryclosest = layoutworld:rayCastClosest(-10, 2, 200, 2)
+  layoutworld:setBroadPhaseLayout('wide')
+  test:assertEquals('wide', layoutworld:getBroadPhaseLayout(), 'check wide layout')
+  test:assertEquals(binaryarea, #layoutworld:getShapesInArea(0, 0, 60, 40), 'check wide area query')
+  test:assertEquals(binaryclosest, layoutworld:rayCastClosest(-10, 2, 200, 2), 'check wide raycast')
+  layoutworld:update(1/60)
+  test:assertNotEquals(0, layoutworld:getContactCount(), 'check wide contacts')
+
+  -- check batched ray casts and area queries match single ones
+  layoutworld:setThreadCount(2)
+  local rays, boxes = {}, {}
+  for i = 1, 100 do
+    local y = (i % 50) - 5
+    table.insert(rays, -20); table.insert(rays, y)
+    table.insert(rays, 100); table.insert(rays, y + (i % 7))
+    table.insert(boxes, (i % 10)*8); table.insert(boxes, (i % 5)*8)
+    table.insert(boxes, (i % 10)*8 + 4); table.insert(boxes, (i % 5)*8 + 4)
+  end
+  local hits = layoutworld:rayCastBatch(rays)
+  test:assertEquals(600, #hits, 'check ray batch result count')
+  local shapes, counts = layoutworld:queryAreaBatch(boxes)
+  test:assertEquals(100, #counts, 'check area batch counts')
+  local first = 1
+  for i = 1, 100 do
+    local r = (i - 1)*4
+    local shape, x, y = layoutworld:rayCastClosest(rays[r+1], rays[r+2], rays[r+3], rays[r+4])
+    test:assertEquals(shape or false, hits[(i - 1)*6 + 1], 'check batch ray hit ' .. i)
+    if shape then
+      test:assertEquals(x, hits[(i - 1)*6 + 2], 'check batch ray x ' .. i)
+      test:assertEquals(y, hits[(i - 1)*6 + 3], 'check batch ray y ' .. i)
+    end
+    local area = layoutworld:getShapesInArea(boxes[r+1], boxes[r+2], boxes[r+3], boxes[r+4])
+    test:assertEquals(#area, counts[i], 'check batch area count ' .. i)
+    for j = 1, counts[i] do
+      local found = false
+      for _, s in ipairs(area) do found = found or s == shapes[first + j - 1] end
+      test:assertTrue(found, 'check batch area shape ' .. i)
+    end
+    first = first + counts[i]
+  end
+  local reused = layoutworld:rayCastBatch(love.data.pack('data', 'ffff', -20, 2, 100, 2), false, 0xFFFF, hits)
+  test:assertEquals(hits, reused, 'check reused results table')
+  test:assertEquals(6, #reused, 'check reused results trimmed')
+  -- check unaligned data views give the same results
+  local raydata = love.data.pack('data', 'Bffff', 0, -20, 2, 100, 2)
+  local unalignedhits = layoutworld:rayCastBatch(love.data.newDataView(raydata, 1, 16))
+  test:assertEquals(6, #unalignedhits, 'check unaligned ray batch count')
+  for i = 1, 6 do
+    test:assertEquals(reused[i], unalignedhits[i], 'check unaligned ray batch value ' .. i)
+  end
+  layoutworld:destroy()
+
   -- check destruction
   test:assertFalse(world:isDestroyed(), 'check not destroyed')
   world:destroy()
@@ -37,6 +37,18 @@ love.test.sound.Decoder = function(test)
   test:assertRange(clone:getDuration(), 0.06, 0.07, 'check cloned duration')
   test:assertEquals(44100, clone:getSampleRate(), 'check cloned sample rate')
 
+  -- check seeking matches decoding from the start
+  local full = love.sound.newSoundData('resources/tone.ogg')
+  local tone = love.sound.newDecoder('resources/tone.ogg')
+  local offset = math.floor(full:getSampleCount() / 2)
+  tone:seek(offset / tone:getSampleRate())
+  local seeked = tone:decode()
+  test:assertObject(seeked)
+  local expected = full:getSample(offset, 1)
+  test:assertRange(seeked:getSample(0, 1), expected - 0.01, expected + 0.01,
+    'check seeked sample')
+  test:assertObject(tone:clone():decode())
+
 end
 
 
@@ -92,6 +104,20 @@ love.test.sound.SoundData = function(test)
   local slice = copy1:slice(0, count)
   test:assertEquals(count, slice:getSampleCount(), 'check slice length')
 
+  -- check converting format
+  local converted = copy1:convert(8, 2)
+  test:assertEquals(8, converted:getBitDepth(), 'check converted bit depth')
+  test:assertEquals(2, converted:getChannelCount(), 'check converted channels')
+  test:assertEquals(copy1:getSampleCount(), converted:getSampleCount(), 'check converted length')
+  test:assertRange(converted:getSample(count, 2), copy1:getSample(count, 1) - 0.02,
+    copy1:getSample(count, 1) + 0.02, 'check converted sample')
+
+  -- check resampling
+  local resampled = copy1:resample(22050)
+  test:assertEquals(22050, resampled:getSampleRate(), 'check resampled rate')
+  test:assertRange(resampled:getDuration(), copy1:getDuration() - 0.001,
+    copy1:getDuration() + 0.001, 'check resampled duration')
+
 end
 
 
@@ -79,6 +79,50 @@ love.test.thread.Channel = function(test)
 end
 
 
+-- Channel (love.thread.newChannel with a capacity)
+love.test.thread.LockFreeChannel = function(test)
+
+  -- create channel, capacity is rounded up to a power of two
+  local channel = love.thread.newChannel(6)
+  test:assertObject(channel)
+  test:assertTrue(channel:isLockFree(), 'check lock-free')
+  test:assertEquals(8, channel:getCapacity(), 'check capacity')
+  test:assertFalse(love.thread.newChannel():isLockFree(), 'check default channel')
+
+  -- batch push and pop keep the order of values
+  local id = channel:pushMany({1, 'two', 3})
+  test:assertEquals(3, id, 'check last id')
+  test:assertEquals(3, channel:getCount(), 'check count')
+  local values = channel:popMany(2)
+  test:assertEquals(2, #values, 'check popped count')
+  test:assertEquals(1, values[1], 'check 1st value')
+  test:assertEquals('two', values[2], 'check 2nd value')
+  test:assertTrue(channel:hasRead(2), 'check read')
+  test:assertFalse(channel:hasRead(3), 'check not read')
+  channel:clear()
+  test:assertEquals(0, channel:getCount(), 'check cleared')
+  test:assertTrue(channel:hasRead(3), 'check clear reads')
+
+  -- a thread filling the channel past its capacity waits for us to pop
+  local threadcode = [[
+    local channel = ...
+    for i=1,100 do
+      channel:push(i)
+    end
+  ]]
+  local thread = love.thread.newThread(threadcode)
+  thread:start(channel)
+  local total = 0
+  for i=1,100 do
+    total = total + channel:demand(1)
+  end
+  thread:wait()
+  test:assertEquals(5050, total, 'check all values received')
+  test:assertEquals(nil, channel:demand(0), 'check demand timeout')
+
+end
+
+
 -- Thread (love.thread.newThread)
 love.test.thread.Thread = function(test)
 
@@ -127,6 +171,7 @@ end
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.thread.newChannel = function(test)
   test:assertObject(love.thread.newChannel())
+  test:assertObject(love.thread.newChannel(16))
 end
 
 
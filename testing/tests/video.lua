@@ -29,6 +29,13 @@ love.test.video.VideoStream = function(test)
   video:pause()
   test:assertFalse(video:isPlaying(), 'check paused')
 
+  -- check decode ahead
+  test:assertGreaterEqual(1, video:getDecodeAhead(), 'check def decode ahead')
+  video:setDecodeAhead(8)
+  test:assertEquals(8, video:getDecodeAhead(), 'check set decode ahead')
+  video:setDecodeAhead(1000)
+  test:assertEquals(32, video:getDecodeAhead(), 'check decode ahead clamped to max')
+
 end
 
 